@@ -0,0 +1,109 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_BASE_ADAPTIVE_WAIT_H_
+#define CYBER_BASE_ADAPTIVE_WAIT_H_
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+
+#include "cyber/base/lock_stats.h"
+#include "cyber/base/macros.h"
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+inline void FutexWait(std::atomic<int32_t>* word, int32_t value) {
+  syscall(SYS_futex, reinterpret_cast<int32_t*>(word), FUTEX_WAIT_PRIVATE,
+          value, nullptr, nullptr, 0);
+}
+
+inline void FutexWakeAll(std::atomic<int32_t>* word) {
+  syscall(SYS_futex, reinterpret_cast<int32_t*>(word), FUTEX_WAKE_PRIVATE,
+          INT_MAX, nullptr, nullptr, 0);
+}
+
+/**
+ * @brief Waiting side of a spin-then-park lock, one instance per acquisition.
+ *
+ * The first waits spin with exponential pause backoff, so short critical
+ * sections never leave the cpu. Once the budget is used up the thread parks
+ * on the lock word with a futex instead of yielding in a loop. The unlocking
+ * side must change the word before it checks sleepers and call
+ * FutexWakeAll when there are any.
+ */
+class AdaptiveWait {
+ public:
+  static const uint32_t kSpinRounds = 10;
+  static const uint32_t kMaxPauseShift = 6;
+
+  explicit AdaptiveWait(LockStats* stats) : stats_(stats) {}
+  ~AdaptiveWait() {
+    if (cyber_unlikely(waited_)) {
+      stats_->AddContended(spins_);
+    }
+  }
+  AdaptiveWait(const AdaptiveWait&) = delete;
+  AdaptiveWait& operator=(const AdaptiveWait&) = delete;
+
+  /**
+   * @brief Wait while the lock is unavailable and word holds value. May
+   * return early, callers re-check the lock state in a loop.
+   */
+  void Wait(std::atomic<int32_t>* word, int32_t value,
+            std::atomic<uint32_t>* sleepers) {
+    waited_ = true;
+    if (round_ < kSpinRounds) {
+      uint32_t shift = round_ < kMaxPauseShift ? round_ : kMaxPauseShift;
+      uint32_t pauses = 1U << shift;
+      for (uint32_t i = 0; i < pauses; ++i) {
+        cpu_relax();
+      }
+      spins_ += pauses;
+      ++round_;
+      return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    sleepers->fetch_add(1);
+    if (word->load() == value) {
+      FutexWait(word, value);
+    }
+    sleepers->fetch_sub(1);
+    stats_->AddPark(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count());
+  }
+
+ private:
+  LockStats* stats_;
+  uint32_t round_ = 0;
+  uint64_t spins_ = 0;
+  bool waited_ = false;
+};
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_BASE_ADAPTIVE_WAIT_H_
@@ -27,12 +27,17 @@
 #include <mutex>
 #include <thread>
 
+#include "cyber/base/adaptive_wait.h"
+#include "cyber/base/lock_stats.h"
+#include "cyber/base/macros.h"
 #include "cyber/base/rw_lock_guard.h"
 
 namespace apollo {
 namespace cyber {
 namespace base {
 
+// Readers and writers spin with backoff first and then park on a futex, see
+// AdaptiveWait. Contention is counted in AtomicRWLock::Stats().
 class AtomicRWLock {
   friend class ReadLockGuard<AtomicRWLock>;
   friend class WriteLockGuard<AtomicRWLock>;
@@ -44,6 +49,11 @@ class AtomicRWLock {
   AtomicRWLock() {}
   explicit AtomicRWLock(bool write_first) : write_first_(write_first) {}
 
+  static LockStats* Stats() {
+    static auto stats = new LockStats("AtomicRWLock");
+    return stats;
+  }
+
  private:
   // all these function only can used by ReadLockGuard/WriteLockGuard;
   void ReadLock();
@@ -52,66 +62,76 @@ class AtomicRWLock {
   void ReadUnlock();
   void WriteUnlock();
 
+  bool ReadBlocked(int32_t lock_num) const {
+    return lock_num < RW_LOCK_FREE ||
+           (write_first_ && write_lock_wait_num_.load() > 0);
+  }
+
   AtomicRWLock(const AtomicRWLock&) = delete;
   AtomicRWLock& operator=(const AtomicRWLock&) = delete;
   std::atomic<uint32_t> write_lock_wait_num_ = {0};
   std::atomic<int32_t> lock_num_ = {0};
+  std::atomic<uint32_t> sleepers_ = {0};
   bool write_first_ = true;
 };
 
 inline void AtomicRWLock::ReadLock() {
-  uint32_t retry_times = 0;
   int32_t lock_num = lock_num_.load();
-  if (write_first_) {
-    do {
-      while (lock_num < RW_LOCK_FREE || write_lock_wait_num_.load() > 0) {
-        if (++retry_times == MAX_RETRY_TIMES) {
-          // saving cpu
-          std::this_thread::yield();
-          retry_times = 0;
-        }
-        lock_num = lock_num_.load();
-      }
-    } while (!lock_num_.compare_exchange_weak(lock_num, lock_num + 1,
-                                              std::memory_order_acq_rel,
-                                              std::memory_order_relaxed));
-  } else {
-    do {
-      while (lock_num < RW_LOCK_FREE) {
-        if (++retry_times == MAX_RETRY_TIMES) {
-          // saving cpu
-          std::this_thread::yield();
-          retry_times = 0;
-        }
-        lock_num = lock_num_.load();
-      }
-    } while (!lock_num_.compare_exchange_weak(lock_num, lock_num + 1,
-                                              std::memory_order_acq_rel,
-                                              std::memory_order_relaxed));
+  if (cyber_likely(!ReadBlocked(lock_num) &&
+                   lock_num_.compare_exchange_weak(
+                       lock_num, lock_num + 1, std::memory_order_acq_rel,
+                       std::memory_order_relaxed))) {
+    return;
   }
+
+  AdaptiveWait wait(Stats());
+  do {
+    while (ReadBlocked(lock_num)) {
+      wait.Wait(&lock_num_, lock_num, &sleepers_);
+      lock_num = lock_num_.load();
+    }
+  } while (!lock_num_.compare_exchange_weak(lock_num, lock_num + 1,
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_relaxed));
 }
 
 inline void AtomicRWLock::WriteLock() {
   int32_t rw_lock_free = RW_LOCK_FREE;
-  uint32_t retry_times = 0;
   write_lock_wait_num_.fetch_add(1);
-  while (!lock_num_.compare_exchange_weak(rw_lock_free, WRITE_EXCLUSIVE,
-                                          std::memory_order_acq_rel,
-                                          std::memory_order_relaxed)) {
-    // rw_lock_free will change after CAS fail, so init agin
-    rw_lock_free = RW_LOCK_FREE;
-    if (++retry_times == MAX_RETRY_TIMES) {
-      // saving cpu
-      std::this_thread::yield();
-      retry_times = 0;
-    }
+  if (cyber_likely(lock_num_.compare_exchange_weak(
+          rw_lock_free, WRITE_EXCLUSIVE, std::memory_order_acq_rel,
+          std::memory_order_relaxed))) {
+    write_lock_wait_num_.fetch_sub(1);
+    return;
   }
+
+  AdaptiveWait wait(Stats());
+  do {
+    // CAS stored the current value, weak CAS may also fail spuriously
+    if (rw_lock_free != RW_LOCK_FREE) {
+      wait.Wait(&lock_num_, rw_lock_free, &sleepers_);
+    }
+    rw_lock_free = RW_LOCK_FREE;
+  } while (!lock_num_.compare_exchange_weak(rw_lock_free, WRITE_EXCLUSIVE,
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_relaxed));
   write_lock_wait_num_.fetch_sub(1);
 }
 
-inline void AtomicRWLock::ReadUnlock() { lock_num_.fetch_sub(1); }
+// only the transition to free can unblock anyone, waiters parked on an older
+// value are woken by it too
+inline void AtomicRWLock::ReadUnlock() {
+  if (lock_num_.fetch_sub(1) == 1 && cyber_unlikely(sleepers_.load() > 0)) {
+    FutexWakeAll(&lock_num_);
+  }
+}
 
-inline void AtomicRWLock::WriteUnlock() { lock_num_.fetch_add(1); }
+inline void AtomicRWLock::WriteUnlock() {
+  lock_num_.fetch_add(1);
+  if (cyber_unlikely(sleepers_.load() > 0)) {
+    FutexWakeAll(&lock_num_);
+  }
+}
 
 }  // namespace base
 }  // namespace cyber
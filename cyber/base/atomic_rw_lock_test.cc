@@ -16,7 +16,9 @@
 
 #include "cyber/base/atomic_rw_lock.h"
 
+#include <chrono>
 #include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -92,6 +94,59 @@ TEST(ReentrantRWLockTest, write_lock) {
   }
 }
 
+TEST(AtomicRWLockTest, contention) {
+  AtomicRWLock lock;
+  const int thread_num = 8;
+  const int loop = 20000;
+  int64_t sum = 0;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_num; ++i) {
+    threads.emplace_back([&, i]() {
+      for (int j = 0; j < loop; ++j) {
+        if ((i + j) % 4 == 0) {
+          WriteLockGuard<AtomicRWLock> lg(lock);
+          ++sum;
+        } else {
+          ReadLockGuard<AtomicRWLock> lg(lock);
+          EXPECT_GE(sum, 0);
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(thread_num * loop / 4, sum);
+}
+
+TEST(AtomicRWLockTest, park) {
+  AtomicRWLock lock;
+  auto before = AtomicRWLock::Stats()->GetSnapshot();
+  std::atomic<int> count = {0};
+  std::vector<std::thread> threads;
+  {
+    WriteLockGuard<AtomicRWLock> lg(lock);
+    for (int i = 0; i < 4; ++i) {
+      threads.emplace_back([&]() {
+        ReadLockGuard<AtomicRWLock> lg(lock);
+        count++;
+      });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(0, count.load());
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(4, count.load());
+
+  // blocked readers gave up spinning and slept on the lock
+  auto after = AtomicRWLock::Stats()->GetSnapshot();
+  EXPECT_GE(after.contended, before.contended + 4);
+  EXPECT_GT(after.parks, before.parks);
+  EXPECT_NE(std::string::npos, LockStats::Dump().find("AtomicRWLock"));
+}
+
 }  // namespace base
 }  // namespace cyber
 }  // namespace apollo
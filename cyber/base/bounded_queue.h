@@ -24,6 +24,8 @@
 #include <cstdint>
 #include <cstdlib>
 #include <memory>
+#include <thread>
+#include <utility>
 
 #include "cyber/base/macros.h"
 #include "cyber/base/wait_strategy.h"
@@ -51,6 +53,13 @@ class BoundedQueue {
   bool WaitEnqueue(T&& element);
   bool Dequeue(T* element);
   bool WaitDequeue(T* element);
+  // reserve up to num slots with one CAS and notify once, returns the number
+  // of elements taken from first
+  template <typename InputIt>
+  uint64_t EnqueueBulk(InputIt first, uint64_t num);
+  // take up to max_num elements with one CAS, returns the number taken
+  uint64_t DequeueBulk(T* elements, uint64_t max_num);
+  uint64_t WaitDequeueBulk(T* elements, uint64_t max_num);
   uint64_t Size();
   bool Empty();
   void SetWaitStrategy(WaitStrategy* WaitStrategy);
@@ -60,7 +69,10 @@ class BoundedQueue {
   uint64_t Commit() { return commit_.load(); }
 
  private:
+  static const uint32_t kCommitSpinTimes = 64;
+
   uint64_t GetIndex(uint64_t num);
+  void CommitTail(uint64_t old_tail, uint64_t new_tail);
 
   alignas(CACHELINE_SIZE) std::atomic<uint64_t> head_ = {0};
   alignas(CACHELINE_SIZE) std::atomic<uint64_t> tail_ = {1};
@@ -108,7 +120,6 @@ bool BoundedQueue<T>::Init(uint64_t size, WaitStrategy* strategy) {
 template <typename T>
 bool BoundedQueue<T>::Enqueue(const T& element) {
   uint64_t new_tail = 0;
-  uint64_t old_commit = 0;
   uint64_t old_tail = tail_.load(std::memory_order_acquire);
   do {
     new_tail = old_tail + 1;
@@ -119,11 +130,7 @@ bool BoundedQueue<T>::Enqueue(const T& element) {
                                         std::memory_order_acq_rel,
                                         std::memory_order_relaxed));
   pool_[GetIndex(old_tail)] = element;
-  do {
-    old_commit = old_tail;
-  } while (cyber_unlikely(!commit_.compare_exchange_weak(
-      old_commit, new_tail, std::memory_order_acq_rel,
-      std::memory_order_relaxed)));
+  CommitTail(old_tail, new_tail);
   wait_strategy_->NotifyOne();
   return true;
 }
@@ -131,7 +138,6 @@ bool BoundedQueue<T>::Enqueue(const T& element) {
 template <typename T>
 bool BoundedQueue<T>::Enqueue(T&& element) {
   uint64_t new_tail = 0;
-  uint64_t old_commit = 0;
   uint64_t old_tail = tail_.load(std::memory_order_acquire);
   do {
     new_tail = old_tail + 1;
@@ -141,12 +147,8 @@ bool BoundedQueue<T>::Enqueue(T&& element) {
   } while (!tail_.compare_exchange_weak(old_tail, new_tail,
                                         std::memory_order_acq_rel,
                                         std::memory_order_relaxed));
-  pool_[GetIndex(old_tail)] = element;
-  do {
-    old_commit = old_tail;
-  } while (cyber_unlikely(!commit_.compare_exchange_weak(
-      old_commit, new_tail, std::memory_order_acq_rel,
-      std::memory_order_relaxed)));
+  pool_[GetIndex(old_tail)] = std::move(element);
+  CommitTail(old_tail, new_tail);
   wait_strategy_->NotifyOne();
   return true;
 }
@@ -167,6 +169,63 @@ bool BoundedQueue<T>::Dequeue(T* element) {
   return true;
 }
 
+template <typename T>
+template <typename InputIt>
+uint64_t BoundedQueue<T>::EnqueueBulk(InputIt first, uint64_t num) {
+  if (num == 0) {
+    return 0;
+  }
+  // one slot between tail and head always stays empty
+  const uint64_t capacity = pool_size_ - 2;
+  uint64_t count = 0;
+  uint64_t new_tail = 0;
+  uint64_t old_tail = tail_.load(std::memory_order_acquire);
+  while (true) {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    if (cyber_unlikely(head >= old_tail)) {
+      // old_tail is stale, consumers already passed it
+      old_tail = tail_.load(std::memory_order_acquire);
+      continue;
+    }
+    uint64_t used = old_tail - head - 1;
+    if (used >= capacity) {
+      return 0;
+    }
+    count = std::min(num, capacity - used);
+    new_tail = old_tail + count;
+    if (tail_.compare_exchange_weak(old_tail, new_tail,
+                                    std::memory_order_acq_rel,
+                                    std::memory_order_relaxed)) {
+      break;
+    }
+  }
+  for (uint64_t i = 0; i < count; ++i, ++first) {
+    pool_[GetIndex(old_tail + i)] = *first;
+  }
+  CommitTail(old_tail, new_tail);
+  wait_strategy_->NotifyOne();
+  return count;
+}
+
+template <typename T>
+uint64_t BoundedQueue<T>::DequeueBulk(T* elements, uint64_t max_num) {
+  uint64_t count = 0;
+  uint64_t old_head = head_.load(std::memory_order_acquire);
+  do {
+    uint64_t commit = commit_.load(std::memory_order_acquire);
+    count = std::min(max_num, commit - old_head - 1);
+    if (count == 0) {
+      return 0;
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+      elements[i] = pool_[GetIndex(old_head + 1 + i)];
+    }
+  } while (!head_.compare_exchange_weak(old_head, old_head + count,
+                                        std::memory_order_acq_rel,
+                                        std::memory_order_relaxed));
+  return count;
+}
+
 template <typename T>
 bool BoundedQueue<T>::WaitEnqueue(const T& element) {
   while (!break_all_wait_) {
@@ -215,6 +274,23 @@ bool BoundedQueue<T>::WaitDequeue(T* element) {
   return false;
 }
 
+template <typename T>
+uint64_t BoundedQueue<T>::WaitDequeueBulk(T* elements, uint64_t max_num) {
+  while (!break_all_wait_) {
+    uint64_t count = DequeueBulk(elements, max_num);
+    if (count > 0) {
+      return count;
+    }
+    if (wait_strategy_->EmptyWait()) {
+      continue;
+    }
+    // wait timeout
+    break;
+  }
+
+  return 0;
+}
+
 template <typename T>
 inline uint64_t BoundedQueue<T>::Size() {
   return tail_ - head_ - 1;
@@ -230,6 +306,25 @@ inline uint64_t BoundedQueue<T>::GetIndex(uint64_t num) {
   return num - (num / pool_size_) * pool_size_;  // faster than %
 }
 
+// publish [old_tail, new_tail) once every earlier reservation is published
+template <typename T>
+inline void BoundedQueue<T>::CommitTail(uint64_t old_tail,
+                                         uint64_t new_tail) {
+  uint32_t spin_times = 0;
+  uint64_t old_commit = old_tail;
+  while (cyber_unlikely(!commit_.compare_exchange_weak(
+      old_commit, new_tail, std::memory_order_acq_rel,
+      std::memory_order_relaxed))) {
+    old_commit = old_tail;
+    // the earlier producer may have been preempted, don't burn its cpu
+    if (++spin_times < kCommitSpinTimes) {
+      cpu_relax();
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
 template <typename T>
 inline void BoundedQueue<T>::SetWaitStrategy(WaitStrategy* strategy) {
   wait_strategy_.reset(strategy);
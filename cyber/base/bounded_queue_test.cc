@@ -17,6 +17,7 @@
 #include "cyber/base/bounded_queue.h"
 
 #include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -98,6 +99,96 @@ TEST(BoundedQueueTest, concurrency) {
   EXPECT_EQ(count.load(), queue.Size());
 }
 
+TEST(BoundedQueueTest, bulk) {
+  BoundedQueue<int> queue;
+  queue.Init(100);
+  std::vector<int> input(150);
+  for (int i = 0; i < 150; i++) {
+    input[i] = i;
+  }
+  EXPECT_EQ(0, queue.EnqueueBulk(input.begin(), 0));
+  EXPECT_EQ(100, queue.EnqueueBulk(input.begin(), 150));
+  EXPECT_EQ(100, queue.Size());
+  EXPECT_EQ(0, queue.EnqueueBulk(input.begin(), 1));
+  EXPECT_FALSE(queue.Enqueue(100));
+
+  // wrap around the ring several times, order is kept
+  int output[64] = {0};
+  int next_in = 100;
+  int next_out = 0;
+  for (int round = 0; round < 10; round++) {
+    EXPECT_EQ(30, queue.DequeueBulk(output, 30));
+    for (int i = 0; i < 30; i++) {
+      EXPECT_EQ(next_out++, output[i]);
+    }
+    std::vector<int> more(30);
+    for (auto& value : more) {
+      value = next_in++;
+    }
+    EXPECT_EQ(30, queue.EnqueueBulk(more.begin(), more.size()));
+  }
+  EXPECT_EQ(100, queue.Size());
+  EXPECT_EQ(64, queue.DequeueBulk(output, 64));
+  EXPECT_EQ(next_out + 63, output[63]);
+  EXPECT_EQ(36, queue.WaitDequeueBulk(output, 64));
+  EXPECT_EQ(next_in - 1, output[35]);
+  EXPECT_EQ(0, queue.DequeueBulk(output, 64));
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(BoundedQueueTest, bulk_concurrency) {
+  BoundedQueue<int> queue;
+  queue.Init(64, new SleepWaitStrategy(100));
+  const int producer_num = 4;
+  const int consumer_num = 4;
+  const int loop = 5000;
+  std::atomic<int64_t> consumed_sum = {0};
+  std::atomic<int> consumed_num = {0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < consumer_num; i++) {
+    threads.emplace_back([&]() {
+      int values[16];
+      while (true) {
+        uint64_t num = queue.WaitDequeueBulk(values, 16);
+        if (num == 0) {
+          break;
+        }
+        for (uint64_t j = 0; j < num; j++) {
+          consumed_sum += values[j];
+        }
+        consumed_num += static_cast<int>(num);
+      }
+    });
+  }
+  std::vector<std::thread> producers;
+  for (int i = 0; i < producer_num; i++) {
+    producers.emplace_back([&]() {
+      std::vector<int> values(loop);
+      for (int j = 0; j < loop; j++) {
+        values[j] = j;
+      }
+      uint64_t sent = 0;
+      while (sent < values.size()) {
+        uint64_t batch = std::min<uint64_t>(7, values.size() - sent);
+        sent += queue.EnqueueBulk(values.begin() + sent, batch);
+      }
+    });
+  }
+  for (auto& t : producers) {
+    t.join();
+  }
+  while (consumed_num.load() < producer_num * loop) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  queue.BreakAllWait();
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(producer_num * loop, consumed_num.load());
+  EXPECT_EQ(static_cast<int64_t>(producer_num) * loop * (loop - 1) / 2,
+            consumed_sum.load());
+}
+
 TEST(BoundedQueueTest, WaitDequeue) {
   BoundedQueue<int> queue;
   queue.Init(100);
@@ -20,6 +20,7 @@
 #include <atomic>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
@@ -35,7 +36,14 @@ namespace base {
 template <typename T>
 class CCObjectPool : public std::enable_shared_from_this<CCObjectPool<T>> {
  public:
+  // allocates the node arena, memory must be zeroed
+  struct ArenaAllocator {
+    std::function<void *(std::size_t)> allocate;
+    std::function<void(void *, std::size_t)> deallocate;
+  };
+
   explicit CCObjectPool(uint32_t size);
+  CCObjectPool(uint32_t size, const ArenaAllocator &allocator);
   virtual ~CCObjectPool();
 
   template <typename... Args>
@@ -63,8 +71,10 @@ class CCObjectPool : public std::enable_shared_from_this<CCObjectPool<T>> {
   CCObjectPool(CCObjectPool &) = delete;
   CCObjectPool &operator=(CCObjectPool &) = delete;
   bool FindFreeHead(Head *head);
+  void InitFreeList();
 
   std::atomic<Head> free_head_;
+  ArenaAllocator allocator_;
   Node *node_arena_ = nullptr;
   uint32_t capacity_ = 0;
 };
@@ -72,6 +82,22 @@ class CCObjectPool : public std::enable_shared_from_this<CCObjectPool<T>> {
 template <typename T>
 CCObjectPool<T>::CCObjectPool(uint32_t size) : capacity_(size) {
   node_arena_ = static_cast<Node *>(CheckedCalloc(capacity_, sizeof(Node)));
+  InitFreeList();
+}
+
+template <typename T>
+CCObjectPool<T>::CCObjectPool(uint32_t size, const ArenaAllocator &allocator)
+    : allocator_(allocator), capacity_(size) {
+  node_arena_ =
+      static_cast<Node *>(allocator_.allocate(capacity_ * sizeof(Node)));
+  if (!node_arena_) {
+    throw std::bad_alloc();
+  }
+  InitFreeList();
+}
+
+template <typename T>
+void CCObjectPool<T>::InitFreeList() {
   FOR_EACH(i, 0, capacity_ - 1) { node_arena_[i].next = node_arena_ + 1 + i; }
   node_arena_[capacity_ - 1].next = nullptr;
   free_head_.store({0, node_arena_}, std::memory_order_relaxed);
@@ -87,7 +113,11 @@ void CCObjectPool<T>::ConstructAll(Args &&... args) {
 
 template <typename T>
 CCObjectPool<T>::~CCObjectPool() {
-  std::free(node_arena_);
+  if (allocator_.deallocate) {
+    allocator_.deallocate(node_arena_, capacity_ * sizeof(Node));
+  } else {
+    std::free(node_arena_);
+  }
 }
 
 template <typename T>
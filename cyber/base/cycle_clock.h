@@ -0,0 +1,93 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_BASE_CYCLE_CLOCK_H_
+#define CYBER_BASE_CYCLE_CLOCK_H_
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+/**
+ * @brief Cheap timestamps for hot paths.
+ *
+ * Now() reads the time stamp counter on x86_64 and the virtual counter on
+ * aarch64, a few nanoseconds against a clock_gettime. Both tick at a constant
+ * rate shared by all cores on the platforms cyber runs on, so counts of
+ * different threads and processes of a host can be compared. Other
+ * architectures fall back to the steady clock.
+ */
+class CycleClock {
+ public:
+  static uint64_t Now() {
+#if defined(__x86_64__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t cycles;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(cycles));
+    return cycles;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+  }
+
+  /**
+   * @brief Counts per nanosecond, measured against the steady clock on the
+   * first call, which takes 10ms.
+   */
+  static double CyclesPerNanosecond() {
+    static const double rate = Calibrate();
+    return rate;
+  }
+
+  static uint64_t ToNanosecond(uint64_t cycles) {
+    return static_cast<uint64_t>(static_cast<double>(cycles) /
+                                 CyclesPerNanosecond());
+  }
+
+ private:
+  static double Calibrate() {
+    auto start = std::chrono::steady_clock::now();
+    uint64_t start_cycles = Now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    uint64_t end_cycles = Now();
+    auto end = std::chrono::steady_clock::now();
+    auto ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+            .count();
+    if (ns <= 0 || end_cycles <= start_cycles) {
+      return 1.0;
+    }
+    return static_cast<double>(end_cycles - start_cycles) /
+           static_cast<double>(ns);
+  }
+};
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_BASE_CYCLE_CLOCK_H_
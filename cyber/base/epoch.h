@@ -0,0 +1,177 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_BASE_EPOCH_H_
+#define CYBER_BASE_EPOCH_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "cyber/base/macros.h"
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+/**
+ * @brief Epoch based memory reclamation for lock-free readers.
+ *
+ * Readers wrap every access to shared nodes in an EpochGuard. Writers unlink
+ * a node first and then Retire() it; the node is deleted once every reader
+ * that could still hold a reference has left its critical section. Reclaim
+ * never blocks, so it is safe to retire from inside a read-side section.
+ */
+class EpochDomain {
+ public:
+  EpochDomain() = default;
+  ~EpochDomain() { ReclaimAll(); }
+  EpochDomain(const EpochDomain &other) = delete;
+  EpochDomain &operator=(const EpochDomain &other) = delete;
+
+  std::atomic<uint32_t> *Enter() {
+    auto &slot = slots_[SlotIndex()];
+    while (true) {
+      uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+      auto counter = &slot.readers[epoch & 1];
+      counter->fetch_add(1, std::memory_order_seq_cst);
+      if (epoch_.load(std::memory_order_seq_cst) == epoch) {
+        return counter;
+      }
+      // a writer advanced the epoch in between, announce again
+      counter->fetch_sub(1, std::memory_order_release);
+    }
+  }
+
+  void Leave(std::atomic<uint32_t> *counter) {
+    counter->fetch_sub(1, std::memory_order_release);
+  }
+
+  template <typename T>
+  void Retire(T *ptr) {
+    Retire(ptr, [](void *p) { delete static_cast<T *>(p); });
+  }
+
+  void Retire(void *ptr, void (*deleter)(void *)) {
+    std::lock_guard<std::mutex> lock(retired_mutex_);
+    retired_.push_back({epoch_.load(std::memory_order_acquire), ptr, deleter});
+  }
+
+  /**
+   * @brief Advance the epoch if all readers of the previous one are gone and
+   * free everything retired at least two epochs ago.
+   */
+  void TryReclaim() {
+    std::vector<Retired> reclaimable;
+    {
+      std::lock_guard<std::mutex> lock(retired_mutex_);
+      if (retired_.empty()) {
+        return;
+      }
+      uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+      if (ActiveReaders((epoch + 1) & 1) == 0) {
+        epoch_.store(++epoch, std::memory_order_seq_cst);
+      }
+      auto it = retired_.begin();
+      while (it != retired_.end()) {
+        if (it->epoch + 2 <= epoch) {
+          reclaimable.emplace_back(*it);
+          it = retired_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+    for (auto &item : reclaimable) {
+      item.deleter(item.ptr);
+    }
+  }
+
+  std::size_t RetiredSize() {
+    std::lock_guard<std::mutex> lock(retired_mutex_);
+    return retired_.size();
+  }
+
+ private:
+  static const uint32_t kSlotNum = 32;
+
+  struct Retired {
+    uint64_t epoch;
+    void *ptr;
+    void (*deleter)(void *);
+  };
+
+  // Padded instead of aligned: domains live in heap objects, and new
+  // ignores over-alignment before C++17. Padding alone keeps every slot on
+  // a cache line of its own.
+  struct Slot {
+    std::atomic<uint32_t> readers[2] = {{0}, {0}};
+    char padding[CACHELINE_SIZE - 2 * sizeof(std::atomic<uint32_t>)];
+  };
+
+  static uint32_t SlotIndex() {
+    static std::atomic<uint32_t> next_index = {0};
+    thread_local uint32_t index =
+        next_index.fetch_add(1, std::memory_order_relaxed) % kSlotNum;
+    return index;
+  }
+
+  uint32_t ActiveReaders(uint64_t parity) {
+    uint32_t readers = 0;
+    for (auto &slot : slots_) {
+      readers += slot.readers[parity].load(std::memory_order_seq_cst);
+    }
+    return readers;
+  }
+
+  void ReclaimAll() {
+    std::lock_guard<std::mutex> lock(retired_mutex_);
+    for (auto &item : retired_) {
+      item.deleter(item.ptr);
+    }
+    retired_.clear();
+  }
+
+  std::atomic<uint64_t> epoch_ = {0};
+  char epoch_padding_[CACHELINE_SIZE - sizeof(std::atomic<uint64_t>)];
+  Slot slots_[kSlotNum];
+  std::mutex retired_mutex_;
+  std::vector<Retired> retired_;
+};
+
+static_assert(alignof(EpochDomain) <= alignof(std::max_align_t),
+              "EpochDomain must be safe to allocate with new");
+
+class EpochGuard {
+ public:
+  explicit EpochGuard(EpochDomain *domain)
+      : domain_(domain), counter_(domain->Enter()) {}
+  ~EpochGuard() { domain_->Leave(counter_); }
+  EpochGuard(const EpochGuard &other) = delete;
+  EpochGuard &operator=(const EpochGuard &other) = delete;
+
+ private:
+  EpochDomain *domain_;
+  std::atomic<uint32_t> *counter_;
+};
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_BASE_EPOCH_H_
@@ -0,0 +1,104 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_BASE_LOCK_STATS_H_
+#define CYBER_BASE_LOCK_STATS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "cyber/base/stats_registry.h"
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+/**
+ * @brief Contention counters shared by every lock of one kind.
+ *
+ * Only slow paths update the counters, an uncontended acquisition costs
+ * nothing. Instances register themselves on construction and live for the
+ * whole process, so they can be collected at any time.
+ */
+class LockStats {
+ public:
+  struct Snapshot {
+    std::string name;
+    uint64_t contended;
+    uint64_t spins;
+    uint64_t parks;
+    uint64_t park_ns;
+  };
+
+  explicit LockStats(const std::string& name) : name_(name) {
+    StatsRegistry<LockStats>::Add(this);
+  }
+  LockStats(const LockStats&) = delete;
+  LockStats& operator=(const LockStats&) = delete;
+
+  void AddContended(uint64_t spins) {
+    contended_.fetch_add(1, std::memory_order_relaxed);
+    spins_.fetch_add(spins, std::memory_order_relaxed);
+  }
+
+  void AddPark(uint64_t park_ns) {
+    parks_.fetch_add(1, std::memory_order_relaxed);
+    park_ns_.fetch_add(park_ns, std::memory_order_relaxed);
+  }
+
+  Snapshot GetSnapshot() const {
+    return {name_, contended_.load(std::memory_order_relaxed),
+            spins_.load(std::memory_order_relaxed),
+            parks_.load(std::memory_order_relaxed),
+            park_ns_.load(std::memory_order_relaxed)};
+  }
+
+  static std::vector<Snapshot> Collect() {
+    return StatsRegistry<LockStats>::Collect();
+  }
+
+  /**
+   * @brief One line per lock kind that has seen contention.
+   */
+  static std::string Dump() {
+    std::string info;
+    for (auto& snap : Collect()) {
+      if (snap.contended == 0) {
+        continue;
+      }
+      info.append(StatsLine(snap.name, {{"contended", snap.contended},
+                                        {"spins", snap.spins},
+                                        {"parks", snap.parks},
+                                        {"park_us", snap.park_ns / 1000}}));
+    }
+    return info;
+  }
+
+ private:
+  const std::string name_;
+  std::atomic<uint64_t> contended_ = {0};
+  std::atomic<uint64_t> spins_ = {0};
+  std::atomic<uint64_t> parks_ = {0};
+  std::atomic<uint64_t> park_ns_ = {0};
+};
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_BASE_LOCK_STATS_H_
@@ -111,6 +111,35 @@ TEST(CCObjectPoolTest, construct_all) {
   vec.clear();
 }
 
+TEST(CCObjectPoolTest, arena_allocator) {
+  const uint32_t capacity = 1024;
+  std::size_t allocated = 0;
+  std::size_t released = 0;
+  CCObjectPool<TestNode>::ArenaAllocator allocator;
+  allocator.allocate = [&allocated](std::size_t size) {
+    allocated += size;
+    return std::calloc(1, size);
+  };
+  allocator.deallocate = [&released](void* arena, std::size_t size) {
+    released += size;
+    std::free(arena);
+  };
+
+  auto pool = std::make_shared<CCObjectPool<TestNode>>(capacity, allocator);
+  EXPECT_GE(allocated, capacity * sizeof(TestNode));
+  {
+    std::vector<std::shared_ptr<TestNode>> vec;
+    FOR_EACH(i, 0, capacity) {
+      auto obj = pool->ConstructObject(i);
+      vec.push_back(obj);
+      EXPECT_EQ(i, obj->value);
+    }
+    EXPECT_EQ(nullptr, pool->ConstructObject(10));
+  }
+  pool.reset();
+  EXPECT_EQ(allocated, released);
+}
+
 TEST(ObjectPoolTest, get_object) {
   auto pool = std::make_shared<ObjectPool<TestNode>>(100, 10);
   FOR_EACH(i, 0, 10) { EXPECT_EQ(10, pool->GetObject()->value); }
@@ -0,0 +1,323 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_BASE_RESIZABLE_ATOMIC_HASH_MAP_H_
+#define CYBER_BASE_RESIZABLE_ATOMIC_HASH_MAP_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include "cyber/base/epoch.h"
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+/**
+ * @brief A hash map with lock-free reads, incremental resize and removal
+ *
+ * Readers never lock: they walk immutable nodes inside an epoch guard.
+ * Writers are serialized by a mutex; an update publishes a new node and
+ * retires the old one, so a value seen by a reader stays valid until the
+ * reader returns. When the load factor is exceeded a table of twice the
+ * size is created and every following write migrates a few buckets, old
+ * buckets forward readers to the new table once moved.
+ *
+ * @tparam K Type of key, must be integral
+ * @tparam V Type of value, must be copyable
+ * @tparam 0 Type traits, use for checking types of key
+ */
+template <typename K, typename V,
+          typename std::enable_if<std::is_integral<K>::value, int>::type = 0>
+class ResizableAtomicHashMap {
+ public:
+  explicit ResizableAtomicHashMap(std::size_t initial_buckets = 64)
+      : table_(new Table(RoundUpPowerOfTwo(initial_buckets))) {}
+  ResizableAtomicHashMap(const ResizableAtomicHashMap &other) = delete;
+  ResizableAtomicHashMap &operator=(const ResizableAtomicHashMap &other) =
+      delete;
+
+  ~ResizableAtomicHashMap() {
+    Table *table = table_.load(std::memory_order_acquire);
+    Table *next = table->next.load(std::memory_order_acquire);
+    DeleteTable(table);
+    if (next) {
+      DeleteTable(next);
+    }
+  }
+
+  bool Has(K key) {
+    EpochGuard guard(&domain_);
+    return FindNode(key) != nullptr;
+  }
+
+  bool Get(K key, V *value) {
+    EpochGuard guard(&domain_);
+    const Node *node = FindNode(key);
+    if (node == nullptr) {
+      return false;
+    }
+    *value = node->value;
+    return true;
+  }
+
+  /**
+   * @brief Call func with a const reference to the value of key, without
+   * copying it. The reference must not escape func, and func runs inside
+   * the read-side section, so keep it short and do not call out of it.
+   */
+  template <typename Func>
+  bool Visit(K key, Func &&func) {
+    EpochGuard guard(&domain_);
+    const Node *node = FindNode(key);
+    if (node == nullptr) {
+      return false;
+    }
+    func(node->value);
+    return true;
+  }
+
+  void Set(K key) { Insert(new Node(key)); }
+
+  void Set(K key, const V &value) { Insert(new Node(key, value)); }
+
+  void Set(K key, V &&value) { Insert(new Node(key, std::forward<V>(value))); }
+
+  bool Remove(K key) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    MigrateStep();
+    std::atomic<Node *> *link = nullptr;
+    Node *node = FindLink(key, &link);
+    if (node) {
+      link->store(node->next.load(std::memory_order_relaxed),
+                  std::memory_order_release);
+      domain_.Retire(node);
+      size_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    domain_.TryReclaim();
+    return node != nullptr;
+  }
+
+  std::size_t Size() const { return size_.load(std::memory_order_relaxed); }
+
+  std::size_t BucketCount() {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    Table *table = table_.load(std::memory_order_acquire);
+    Table *next = table->next.load(std::memory_order_acquire);
+    return next ? next->size : table->size;
+  }
+
+ private:
+  struct Node {
+    explicit Node(K key) : key(key), value() {}
+    Node(K key, const V &value) : key(key), value(value) {}
+    Node(K key, V &&value) : key(key), value(std::forward<V>(value)) {}
+
+    const K key;
+    const V value;
+    std::atomic<Node *> next = {nullptr};
+  };
+
+  struct Table {
+    explicit Table(std::size_t size)
+        : size(size), mask(size - 1), buckets(new std::atomic<Node *>[size]) {
+      for (std::size_t i = 0; i < size; ++i) {
+        buckets[i].store(nullptr, std::memory_order_relaxed);
+      }
+    }
+    ~Table() { delete[] buckets; }
+
+    const std::size_t size;
+    const std::size_t mask;
+    std::atomic<Node *> *buckets;
+    // set while this table is being migrated into a bigger one
+    std::atomic<Table *> next = {nullptr};
+  };
+
+  static const std::size_t kMaxLoadFactor = 1;
+  static const std::size_t kMigrateBucketsPerWrite = 16;
+
+  static Node *MovedMarker() {
+    return reinterpret_cast<Node *>(static_cast<uintptr_t>(1));
+  }
+
+  static std::size_t RoundUpPowerOfTwo(std::size_t n) {
+    std::size_t size = 1;
+    while (size < n) {
+      size <<= 1;
+    }
+    return size;
+  }
+
+  static uint64_t Hash(K key) {
+    uint64_t h = static_cast<uint64_t>(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  // must be called with an epoch guard held
+  const Node *FindNode(K key) const {
+    uint64_t hash = Hash(key);
+    Table *table = table_.load(std::memory_order_acquire);
+    Node *node = table->buckets[hash & table->mask].load(
+        std::memory_order_acquire);
+    // a reader can lag behind several resizes, each retired table forwards
+    // to the one it was migrated into and stays valid inside the guard
+    while (node == MovedMarker()) {
+      table = table->next.load(std::memory_order_acquire);
+      node = table->buckets[hash & table->mask].load(
+          std::memory_order_acquire);
+    }
+    while (node) {
+      if (node->key == key) {
+        return node;
+      }
+      node = node->next.load(std::memory_order_acquire);
+    }
+    return nullptr;
+  }
+
+  // must be called with write_mutex_ held, returns the live bucket of key
+  std::atomic<Node *> *Bucket(K key) {
+    uint64_t hash = Hash(key);
+    Table *table = table_.load(std::memory_order_relaxed);
+    std::atomic<Node *> *bucket = &table->buckets[hash & table->mask];
+    while (bucket->load(std::memory_order_relaxed) == MovedMarker()) {
+      table = table->next.load(std::memory_order_relaxed);
+      bucket = &table->buckets[hash & table->mask];
+    }
+    return bucket;
+  }
+
+  // must be called with write_mutex_ held
+  Node *FindLink(K key, std::atomic<Node *> **link) {
+    std::atomic<Node *> *prev = Bucket(key);
+    Node *node = prev->load(std::memory_order_relaxed);
+    while (node && node->key != key) {
+      prev = &node->next;
+      node = node->next.load(std::memory_order_relaxed);
+    }
+    *link = prev;
+    return node;
+  }
+
+  void Insert(Node *new_node) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    MigrateStep();
+    std::atomic<Node *> *link = nullptr;
+    Node *node = FindLink(new_node->key, &link);
+    if (node) {
+      // replace the node, readers holding the old one keep it until reclaim
+      new_node->next.store(node->next.load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+      link->store(new_node, std::memory_order_release);
+      domain_.Retire(node);
+    } else {
+      std::atomic<Node *> *bucket = Bucket(new_node->key);
+      new_node->next.store(bucket->load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+      bucket->store(new_node, std::memory_order_release);
+      size_.fetch_add(1, std::memory_order_relaxed);
+      MaybeGrow();
+    }
+    domain_.TryReclaim();
+  }
+
+  // must be called with write_mutex_ held
+  void MaybeGrow() {
+    Table *table = table_.load(std::memory_order_relaxed);
+    if (table->next.load(std::memory_order_relaxed) != nullptr) {
+      return;
+    }
+    if (size_.load(std::memory_order_relaxed) <=
+        table->size * kMaxLoadFactor) {
+      return;
+    }
+    table->next.store(new Table(table->size << 1), std::memory_order_release);
+    migrate_index_ = 0;
+  }
+
+  // must be called with write_mutex_ held
+  void MigrateStep() {
+    Table *table = table_.load(std::memory_order_relaxed);
+    Table *next = table->next.load(std::memory_order_relaxed);
+    if (next == nullptr) {
+      return;
+    }
+    std::size_t end = migrate_index_ + kMigrateBucketsPerWrite;
+    if (end > table->size) {
+      end = table->size;
+    }
+    for (; migrate_index_ < end; ++migrate_index_) {
+      MigrateBucket(table, next, migrate_index_);
+    }
+    if (migrate_index_ == table->size) {
+      table_.store(next, std::memory_order_release);
+      domain_.Retire(table);
+    }
+  }
+
+  void MigrateBucket(Table *table, Table *next, std::size_t index) {
+    std::atomic<Node *> *bucket = &table->buckets[index];
+    Node *node = bucket->load(std::memory_order_relaxed);
+    // copy nodes, readers may still be walking the old chain
+    for (Node *it = node; it; it = it->next.load(std::memory_order_relaxed)) {
+      Node *copy = new Node(it->key, it->value);
+      std::atomic<Node *> *target = &next->buckets[Hash(it->key) & next->mask];
+      copy->next.store(target->load(std::memory_order_relaxed),
+                       std::memory_order_relaxed);
+      target->store(copy, std::memory_order_release);
+    }
+    bucket->store(MovedMarker(), std::memory_order_release);
+    while (node) {
+      Node *tmp = node->next.load(std::memory_order_relaxed);
+      domain_.Retire(node);
+      node = tmp;
+    }
+  }
+
+  void DeleteTable(Table *table) {
+    for (std::size_t i = 0; i < table->size; ++i) {
+      Node *node = table->buckets[i].load(std::memory_order_acquire);
+      if (node == MovedMarker()) {
+        continue;
+      }
+      while (node) {
+        Node *tmp = node->next.load(std::memory_order_acquire);
+        delete node;
+        node = tmp;
+      }
+    }
+    delete table;
+  }
+
+  EpochDomain domain_;
+  std::atomic<Table *> table_;
+  std::atomic<std::size_t> size_ = {0};
+  std::size_t migrate_index_ = 0;
+  std::mutex write_mutex_;
+};
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_BASE_RESIZABLE_ATOMIC_HASH_MAP_H_
@@ -0,0 +1,177 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/base/resizable_atomic_hash_map.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+TEST(ResizableAtomicHashMapTest, int_int) {
+  ResizableAtomicHashMap<int, int> map(4);
+  int value = 0;
+  for (int i = 0; i < 1000; i++) {
+    map.Set(i, i);
+    EXPECT_TRUE(map.Has(i));
+    EXPECT_TRUE(map.Get(i, &value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_EQ(1000, map.Size());
+  EXPECT_GE(map.BucketCount(), 512);
+
+  for (int i = 0; i < 1000; i++) {
+    map.Set(1000 - i, i);
+    EXPECT_TRUE(map.Has(1000 - i));
+    EXPECT_TRUE(map.Get(1000 - i, &value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_EQ(1001, map.Size());
+}
+
+TEST(ResizableAtomicHashMapTest, int_str) {
+  ResizableAtomicHashMap<int, std::string> map;
+  std::string value("");
+  for (int i = 0; i < 1000; i++) {
+    map.Set(i, std::to_string(i));
+    EXPECT_TRUE(map.Has(i));
+    EXPECT_TRUE(map.Get(i, &value));
+    EXPECT_EQ(std::to_string(i), value);
+  }
+  map.Set(100);
+  EXPECT_TRUE(map.Get(100, &value));
+  EXPECT_TRUE(value.empty());
+  map.Set(100, std::move(std::string("test")));
+  EXPECT_TRUE(map.Visit(100, [&value](const std::string& v) { value = v; }));
+  EXPECT_EQ("test", value);
+  EXPECT_FALSE(map.Visit(1000, [](const std::string&) {}));
+}
+
+TEST(ResizableAtomicHashMapTest, remove) {
+  ResizableAtomicHashMap<uint64_t, std::string> map(8);
+  for (uint64_t i = 0; i < 100; i++) {
+    map.Set(i, std::to_string(i));
+  }
+  for (uint64_t i = 0; i < 100; i += 2) {
+    EXPECT_TRUE(map.Remove(i));
+    EXPECT_FALSE(map.Remove(i));
+  }
+  EXPECT_EQ(50, map.Size());
+  std::string value;
+  for (uint64_t i = 0; i < 100; i++) {
+    EXPECT_EQ(i % 2 == 1, map.Get(i, &value));
+  }
+  map.Set(0, "0");
+  EXPECT_TRUE(map.Get(0, &value));
+  EXPECT_EQ("0", value);
+}
+
+TEST(ResizableAtomicHashMapTest, concurrency) {
+  ResizableAtomicHashMap<int, std::string> map(2);
+  const int key_num = 4096;
+  std::atomic<bool> done = {false};
+  std::atomic<int> misses = {0};
+  for (int j = -1; j >= -64; j--) {
+    map.Set(j, std::to_string(j));
+  }
+
+  // readers must always see either no entry or a consistent value
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; i++) {
+    readers.emplace_back([&]() {
+      std::string value;
+      while (!done.load()) {
+        for (int j = 0; j < key_num; j++) {
+          if (map.Get(j, &value) && value != std::to_string(j)) {
+            misses++;
+          }
+        }
+        // keys that are never touched again must survive every resize
+        for (int j = -1; j >= -64; j--) {
+          if (!map.Get(j, &value)) {
+            misses++;
+          }
+        }
+      }
+    });
+  }
+
+  std::vector<std::thread> writers;
+  for (int i = 0; i < 4; i++) {
+    writers.emplace_back([&, i]() {
+      for (int j = i; j < key_num; j += 4) {
+        map.Set(j, std::to_string(j));
+        map.Remove(j);
+        map.Set(j, std::to_string(j));
+      }
+    });
+  }
+  for (auto& t : writers) {
+    t.join();
+  }
+  done = true;
+  for (auto& t : readers) {
+    t.join();
+  }
+
+  EXPECT_EQ(0, misses.load());
+  EXPECT_EQ(key_num + 64, map.Size());
+  std::string value;
+  for (int i = 0; i < key_num; i++) {
+    EXPECT_TRUE(map.Get(i, &value));
+    EXPECT_EQ(std::to_string(i), value);
+  }
+}
+
+TEST(ResizableAtomicHashMapTest, chained_resize) {
+  // a one bucket table resizes on almost every insert, readers that lag
+  // behind have to follow several retired tables
+  for (int round = 0; round < 20; round++) {
+    ResizableAtomicHashMap<int, int> map(1);
+    map.Set(0, 0);
+    std::atomic<bool> done = {false};
+    std::atomic<int> misses = {0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; i++) {
+      readers.emplace_back([&]() {
+        int value = 0;
+        while (!done.load()) {
+          if (!map.Get(0, &value)) {
+            misses++;
+          }
+        }
+      });
+    }
+    for (int j = 1; j < 20000; j++) {
+      map.Set(j, j);
+    }
+    done = true;
+    for (auto& t : readers) {
+      t.join();
+    }
+    EXPECT_EQ(0, misses.load());
+  }
+}
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
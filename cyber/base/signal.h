@@ -17,11 +17,13 @@
 #ifndef CYBER_BASE_SIGNAL_H_
 #define CYBER_BASE_SIGNAL_H_
 
-#include <algorithm>
+#include <atomic>
 #include <functional>
-#include <list>
 #include <memory>
 #include <mutex>
+#include <vector>
+
+#include "cyber/base/epoch.h"
 
 namespace apollo {
 namespace cyber {
@@ -38,40 +40,50 @@ class Slot;
 template <typename... Args>
 class Connection;
 
+inline EpochDomain* SignalEpochDomain() {
+  // shared by all signals and never destroyed, signals may outlive statics
+  static EpochDomain* domain = new EpochDomain();
+  return domain;
+}
+
+// The slot list is copy-on-write: Connect/Disconnect publish a new list and
+// retire the old one, so emitting takes no lock and allocates nothing. The
+// epoch guard only covers taking a reference to the list, slots run outside
+// of it, a slow one must not hold up reclamation for every signal.
 template <typename... Args>
 class Signal {
  public:
   using Callback = std::function<void(Args...)>;
   using SlotPtr = std::shared_ptr<Slot<Args...>>;
-  using SlotList = std::list<SlotPtr>;
+  using SlotList = std::vector<SlotPtr>;
+  using SlotListPtr = std::shared_ptr<const SlotList>;
   using ConnectionType = Connection<Args...>;
 
-  Signal() {}
-  virtual ~Signal() { DisconnectAllSlots(); }
+  Signal() : slots_(new SlotListPtr(std::make_shared<SlotList>())) {}
+  virtual ~Signal() {
+    DisconnectAllSlots();
+    delete slots_.load(std::memory_order_acquire);
+  }
 
   void operator()(Args... args) {
-    SlotList local;
+    SlotListPtr local;
     {
-      std::lock_guard<std::mutex> lock(mutex_);
-      for (auto& slot : slots_) {
-        local.emplace_back(slot);
-      }
+      EpochGuard guard(SignalEpochDomain());
+      local = *slots_.load(std::memory_order_acquire);
     }
-
-    if (!local.empty()) {
-      for (auto& slot : local) {
-        (*slot)(args...);
-      }
+    for (auto& slot : *local) {
+      (*slot)(args...);
     }
-
-    ClearDisconnectedSlots();
   }
 
   ConnectionType Connect(const Callback& cb) {
     auto slot = std::make_shared<Slot<Args...>>(cb);
     {
       std::lock_guard<std::mutex> lock(mutex_);
-      slots_.emplace_back(slot);
+      auto new_slots =
+          std::make_shared<SlotList>(**slots_.load(std::memory_order_relaxed));
+      new_slots->emplace_back(slot);
+      Publish(std::move(new_slots));
     }
 
     return ConnectionType(slot, this);
@@ -81,7 +93,7 @@ class Signal {
     bool find = false;
     {
       std::lock_guard<std::mutex> lock(mutex_);
-      for (auto& slot : slots_) {
+      for (auto& slot : **slots_.load(std::memory_order_relaxed)) {
         if (conn.HasSlot(slot)) {
           find = true;
           // 将slot标记为disconnect
@@ -99,10 +111,15 @@ class Signal {
 
   void DisconnectAllSlots() {
     std::lock_guard<std::mutex> lock(mutex_);
-    for (auto& slot : slots_) {
+    for (auto& slot : **slots_.load(std::memory_order_relaxed)) {
       slot->Disconnect();
     }
-    slots_.clear();
+    Publish(std::make_shared<SlotList>());
+  }
+
+  std::size_t SlotSize() {
+    EpochGuard guard(SignalEpochDomain());
+    return (*slots_.load(std::memory_order_acquire))->size();
   }
 
  private:
@@ -111,13 +128,27 @@ class Signal {
 
   void ClearDisconnectedSlots() {
     std::lock_guard<std::mutex> lock(mutex_);
-    slots_.erase(
-        std::remove_if(slots_.begin(), slots_.end(),
-                       [](const SlotPtr& slot) { return !slot->connected(); }),
-        slots_.end());
+    auto new_slots = std::make_shared<SlotList>();
+    for (auto& slot : **slots_.load(std::memory_order_relaxed)) {
+      if (slot->connected()) {
+        new_slots->emplace_back(slot);
+      }
+    }
+    Publish(std::move(new_slots));
+  }
+
+  // must be called with mutex_ held
+  void Publish(SlotListPtr new_slots) {
+    SlotListPtr* old_slots = slots_.exchange(
+        new SlotListPtr(std::move(new_slots)), std::memory_order_acq_rel);
+    auto domain = SignalEpochDomain();
+    domain->Retire(old_slots);
+    domain->TryReclaim();
   }
 
-  SlotList slots_;
+  // retired and reclaimed through the epoch domain, the list it points to
+  // lives on while an emit still walks it
+  std::atomic<SlotListPtr*> slots_;
   std::mutex mutex_;
 };
 
@@ -174,23 +205,23 @@ class Slot {
  public:
   using Callback = std::function<void(Args...)>;
   Slot(const Slot& another)
-      : cb_(another.cb_), connected_(another.connected_) {}
+      : cb_(another.cb_), connected_(another.connected()) {}
   explicit Slot(const Callback& cb, bool connected = true)
       : cb_(cb), connected_(connected) {}
   virtual ~Slot() {}
 
   void operator()(Args... args) {
-    if (connected_ && cb_) {
+    if (connected() && cb_) {
       cb_(args...);
     }
   }
 
-  void Disconnect() { connected_ = false; }
-  bool connected() const { return connected_; }
+  void Disconnect() { connected_.store(false, std::memory_order_release); }
+  bool connected() const { return connected_.load(std::memory_order_acquire); }
 
  private:
   Callback cb_;
-  bool connected_ = true;
+  std::atomic<bool> connected_ = {true};
 };
 
 }  // namespace base
@@ -16,7 +16,10 @@
 
 #include "cyber/base/signal.h"
 
+#include <atomic>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -135,6 +138,74 @@ TEST(SignalTest, module) {
   EXPECT_NE(sum_b, lhs + rhs);
 }
 
+TEST(SignalTest, connect_in_callback) {
+  Signal<int> sig;
+  int count = 0;
+  Connection<int> conn_b;
+  auto conn_a = sig.Connect([&](int) {
+    ++count;
+    if (!conn_b.IsConnected()) {
+      conn_b = sig.Connect([&count](int) { ++count; });
+    }
+  });
+  EXPECT_EQ(1, sig.SlotSize());
+
+  // the slot connected during emission is called from the next emission
+  sig(0);
+  EXPECT_EQ(1, count);
+  EXPECT_EQ(2, sig.SlotSize());
+  sig(0);
+  EXPECT_EQ(3, count);
+
+  EXPECT_TRUE(conn_a.Disconnect());
+  EXPECT_EQ(1, sig.SlotSize());
+  sig(0);
+  EXPECT_EQ(4, count);
+}
+
+TEST(SignalTest, concurrency) {
+  Signal<int> sig;
+  std::atomic<int> sum = {0};
+  std::atomic<bool> done = {false};
+  auto conn = sig.Connect([&sum](int v) { sum += v; });
+
+  std::vector<std::thread> emitters;
+  for (int i = 0; i < 4; ++i) {
+    emitters.emplace_back([&]() {
+      do {
+        sig(1);
+      } while (!done.load());
+    });
+  }
+  for (int i = 0; i < 1000; ++i) {
+    auto tmp = sig.Connect([](int) {});
+    tmp.Disconnect();
+  }
+  done = true;
+  for (auto& t : emitters) {
+    t.join();
+  }
+  EXPECT_GE(sum.load(), 4);
+  EXPECT_EQ(1, sig.SlotSize());
+}
+
+TEST(SignalTest, reclaim_while_emitting) {
+  Signal<> slow;
+  Signal<int> other;
+  std::size_t retired = 0;
+  // a slot that runs long must not keep other signals from reclaiming
+  auto conn = slow.Connect([&other, &retired]() {
+    for (int i = 0; i < 100; ++i) {
+      auto tmp = other.Connect([](int) {});
+      tmp.Disconnect();
+    }
+    retired = SignalEpochDomain()->RetiredSize();
+  });
+  slow();
+  EXPECT_LT(retired, 10);
+  EXPECT_EQ(0, other.SlotSize());
+}
+
 }  // namespace base
 }  // namespace cyber
 }  // namespace apollo
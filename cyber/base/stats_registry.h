@@ -0,0 +1,97 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_BASE_STATS_REGISTRY_H_
+#define CYBER_BASE_STATS_REGISTRY_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+/**
+ * @brief Process wide list of the live counter objects of one kind
+ *
+ * T provides a Snapshot type and GetSnapshot(). The list is leaked on
+ * purpose, counters may still register or unregister during static
+ * destruction.
+ */
+template <typename T>
+class StatsRegistry {
+ public:
+  static void Add(T* stats) {
+    std::lock_guard<std::mutex> lock(Mutex());
+    List().push_back(stats);
+  }
+
+  static void Remove(T* stats) {
+    std::lock_guard<std::mutex> lock(Mutex());
+    auto& list = List();
+    list.erase(std::remove(list.begin(), list.end(), stats), list.end());
+  }
+
+  static std::vector<typename T::Snapshot> Collect() {
+    std::vector<typename T::Snapshot> snapshots;
+    std::lock_guard<std::mutex> lock(Mutex());
+    for (auto stats : List()) {
+      snapshots.emplace_back(stats->GetSnapshot());
+    }
+    return snapshots;
+  }
+
+ private:
+  static std::vector<T*>& List() {
+    static auto list = new std::vector<T*>();
+    return *list;
+  }
+
+  static std::mutex& Mutex() {
+    static auto mutex = new std::mutex();
+    return *mutex;
+  }
+};
+
+/**
+ * @brief "name key: value, key: value\n", the line format of the Dump of
+ * every counter kind
+ */
+inline std::string StatsLine(
+    const std::string& name,
+    std::initializer_list<std::pair<const char*, uint64_t>> fields) {
+  std::string line(name);
+  const char* separator = " ";
+  for (auto& field : fields) {
+    line.append(separator)
+        .append(field.first)
+        .append(": ")
+        .append(std::to_string(field.second));
+    separator = ", ";
+  }
+  return line.append("\n");
+}
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_BASE_STATS_REGISTRY_H_
@@ -0,0 +1,68 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/base/stats_registry.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+namespace {
+
+struct FakeStats {
+  struct Snapshot {
+    int value;
+  };
+
+  explicit FakeStats(int value) : value(value) {
+    StatsRegistry<FakeStats>::Add(this);
+  }
+  ~FakeStats() { StatsRegistry<FakeStats>::Remove(this); }
+
+  Snapshot GetSnapshot() const { return {value}; }
+
+  int value;
+};
+
+}  // namespace
+
+TEST(StatsRegistryTest, collect) {
+  EXPECT_TRUE(StatsRegistry<FakeStats>::Collect().empty());
+  FakeStats first(1);
+  {
+    FakeStats second(2);
+    auto snapshots = StatsRegistry<FakeStats>::Collect();
+    ASSERT_EQ(2, snapshots.size());
+    EXPECT_EQ(1, snapshots[0].value);
+    EXPECT_EQ(2, snapshots[1].value);
+  }
+  auto snapshots = StatsRegistry<FakeStats>::Collect();
+  ASSERT_EQ(1, snapshots.size());
+  EXPECT_EQ(1, snapshots[0].value);
+}
+
+TEST(StatsRegistryTest, line) {
+  EXPECT_EQ("lock a: 1, b: 20\n", StatsLine("lock", {{"a", 1}, {"b", 20}}));
+  EXPECT_EQ("lock\n", StatsLine("lock", {}));
+}
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
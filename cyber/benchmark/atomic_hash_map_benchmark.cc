@@ -0,0 +1,82 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Lookup cost of the fixed size AtomicHashMap against ResizableAtomicHashMap
+// with hashed 64 bit keys, as channel and task ids are.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "cyber/base/atomic_hash_map.h"
+#include "cyber/base/resizable_atomic_hash_map.h"
+
+using apollo::cyber::base::AtomicHashMap;
+using apollo::cyber::base::ResizableAtomicHashMap;
+
+namespace {
+
+const int kLookups = 2000000;
+
+template <typename MapT>
+double LookupNs(MapT* map, const std::vector<uint64_t>& keys) {
+  uint64_t sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kLookups; ++i) {
+    uint64_t value = 0;
+    map->Get(keys[i % keys.size()], &value);
+    sum += value;
+  }
+  auto end = std::chrono::steady_clock::now();
+  if (sum == 0) {
+    std::printf("unexpected empty lookups\n");
+  }
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         kLookups;
+}
+
+void Run(std::size_t key_num) {
+  std::mt19937_64 rng(key_num);
+  std::vector<uint64_t> keys(key_num);
+  for (auto& key : keys) {
+    key = rng();
+  }
+
+  AtomicHashMap<uint64_t, uint64_t> fixed_map;
+  ResizableAtomicHashMap<uint64_t, uint64_t> resizable_map;
+  for (auto key : keys) {
+    fixed_map.Set(key, key | 1);
+    resizable_map.Set(key, key | 1);
+  }
+  std::shuffle(keys.begin(), keys.end(), rng);
+
+  std::printf("%8zu keys | AtomicHashMap %8.1f ns/get | "
+              "ResizableAtomicHashMap %8.1f ns/get (%zu buckets)\n",
+              key_num, LookupNs(&fixed_map, keys),
+              LookupNs(&resizable_map, keys), resizable_map.BucketCount());
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  for (std::size_t key_num : {100, 1000, 10000}) {
+    Run(key_num);
+  }
+  return 0;
+}
@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Producer/consumer throughput of base::BoundedQueue, element by element
+// against EnqueueBulk/DequeueBulk with several batch sizes.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "cyber/base/bounded_queue.h"
+
+using apollo::cyber::base::BoundedQueue;
+using apollo::cyber::base::YieldWaitStrategy;
+
+namespace {
+
+const uint64_t kItemsPerProducer = 1000000;
+const uint64_t kQueueSize = 4096;
+
+void Run(int producer_num, int consumer_num, uint64_t batch) {
+  BoundedQueue<uint64_t> queue;
+  queue.Init(kQueueSize, new YieldWaitStrategy());
+  const uint64_t total = kItemsPerProducer * producer_num;
+  std::atomic<uint64_t> consumed = {0};
+  std::atomic<uint64_t> checksum = {0};
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> consumers;
+  for (int i = 0; i < consumer_num; ++i) {
+    consumers.emplace_back([&]() {
+      std::vector<uint64_t> values(batch);
+      uint64_t sum = 0;
+      while (consumed.load(std::memory_order_relaxed) < total) {
+        uint64_t num = 0;
+        if (batch == 1) {
+          num = queue.Dequeue(&values[0]) ? 1 : 0;
+        } else {
+          num = queue.DequeueBulk(values.data(), batch);
+        }
+        if (num == 0) {
+          std::this_thread::yield();
+          continue;
+        }
+        for (uint64_t j = 0; j < num; ++j) {
+          sum += values[j];
+        }
+        consumed.fetch_add(num, std::memory_order_relaxed);
+      }
+      checksum += sum;
+    });
+  }
+
+  std::vector<std::thread> producers;
+  for (int i = 0; i < producer_num; ++i) {
+    producers.emplace_back([&]() {
+      std::vector<uint64_t> values(batch);
+      uint64_t next = 0;
+      while (next < kItemsPerProducer) {
+        uint64_t num = std::min(batch, kItemsPerProducer - next);
+        for (uint64_t j = 0; j < num; ++j) {
+          values[j] = next + j;
+        }
+        uint64_t sent = 0;
+        if (batch == 1) {
+          sent = queue.Enqueue(values[0]) ? 1 : 0;
+        } else {
+          sent = queue.EnqueueBulk(values.begin(), num);
+        }
+        if (sent == 0) {
+          std::this_thread::yield();
+        }
+        next += sent;
+      }
+    });
+  }
+
+  for (auto& t : producers) {
+    t.join();
+  }
+  for (auto& t : consumers) {
+    t.join();
+  }
+  auto end = std::chrono::steady_clock::now();
+  double sec = std::chrono::duration<double>(end - start).count();
+  std::printf("%dP%dC batch %3lu | %7.2f Mitems/s | %6.1f ns/item | sum %lu\n",
+              producer_num, consumer_num, static_cast<unsigned long>(batch),
+              total / sec / 1e6, sec * 1e9 / total,
+              static_cast<unsigned long>(checksum.load()));
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const int threads[][2] = {{1, 1}, {4, 1}, {4, 4}};
+  for (auto& pc : threads) {
+    for (uint64_t batch : {1, 8, 32, 128}) {
+      Run(pc[0], pc[1], batch);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,175 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Heap allocations and cost of the message metadata on the delivery paths.
+//
+//   message_info_benchmark [num]
+//
+// Global operator new is counted while each stage runs num (default
+// 1000000) times. The intra stage sends one preallocated message through an
+// intra transmitter and receiver, the shm/rtps stages replay what their
+// receivers do with the metadata of a sample: read it from the wire and hand
+// it to the listeners. The message objects themselves are not part of it.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+
+#include "cyber/common/util.h"
+#include "cyber/cyber.h"
+#include "cyber/message/raw_message.h"
+#include "cyber/transport/common/identity.h"
+#include "cyber/transport/message/listener_handler.h"
+#include "cyber/transport/message/message_info.h"
+#include "cyber/transport/transport.h"
+
+namespace {
+
+std::atomic<uint64_t> allocations = {0};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+using apollo::cyber::message::RawMessage;
+using apollo::cyber::proto::RoleAttributes;
+using apollo::cyber::transport::Identity;
+using apollo::cyber::transport::ListenerHandler;
+using apollo::cyber::transport::MessageInfo;
+using apollo::cyber::transport::Transport;
+
+namespace {
+
+void Report(const char* stage, uint64_t num,
+            const std::function<void(uint64_t)>& func) {
+  // the first round fills caches and lazily created state
+  func(0);
+  uint64_t before = allocations.load();
+  auto start = std::chrono::steady_clock::now();
+  for (uint64_t i = 1; i <= num; ++i) {
+    func(i);
+  }
+  auto end = std::chrono::steady_clock::now();
+  uint64_t count = allocations.load() - before;
+  double ns = std::chrono::duration<double, std::nano>(end - start).count();
+  std::printf("%-18s | %8.1f ns/msg | %6.3f allocs/msg\n", stage, ns / num,
+              static_cast<double>(count) / num);
+}
+
+void RunIntra(uint64_t num) {
+  RoleAttributes attr;
+  attr.set_channel_name("/message_info_benchmark");
+  attr.set_channel_id(apollo::cyber::common::Hash(attr.channel_name()));
+  Identity id;
+  attr.set_id(id.HashValue());
+
+  std::atomic<uint64_t> received = {0};
+  MessageInfo last;
+  auto receiver = Transport::Instance()->CreateReceiver<RawMessage>(
+      attr,
+      [&received, &last](const std::shared_ptr<RawMessage>&,
+                         const MessageInfo& info, const RoleAttributes&) {
+        last = info;
+        ++received;
+      },
+      apollo::cyber::proto::OptionalMode::INTRA);
+  auto transmitter = Transport::Instance()->CreateTransmitter<RawMessage>(
+      attr, apollo::cyber::proto::OptionalMode::INTRA);
+  if (receiver == nullptr || transmitter == nullptr) {
+    std::printf("failed to create the intra endpoints\n");
+    return;
+  }
+  receiver->Enable();
+
+  auto msg = std::make_shared<RawMessage>(std::string(64, 'x'));
+  Report("intra end to end", num,
+         [&transmitter, &msg](uint64_t) { transmitter->Transmit(msg); });
+  if (received.load() != num + 1) {
+    std::printf("intra lost %llu messages\n",
+                static_cast<unsigned long long>(num + 1 - received.load()));
+  }
+  transmitter->Disable();
+  receiver->Disable();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  uint64_t num = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+  if (num == 0) {
+    num = 1;
+  }
+  apollo::cyber::Init(argv[0]);
+
+  Identity sender;
+  Identity spare;
+  MessageInfo info(sender, 0, spare);
+  info.set_channel_id(apollo::cyber::common::Hash("/message_info_benchmark"));
+  MessageInfo copy;
+  Report("copy", num, [&info, &copy](uint64_t i) {
+    info.set_seq_num(i);
+    MessageInfo tmp(info);
+    copy = tmp;
+  });
+
+  char wire[64];
+  Report("serialize", num, [&info, &wire](uint64_t i) {
+    info.set_seq_num(i);
+    info.SerializeTo(wire, MessageInfo::kSize);
+  });
+  Report("deserialize", num, [&copy, &wire](uint64_t) {
+    copy.DeserializeFrom(wire, MessageInfo::kSize);
+  });
+
+  // what the shm and rtps receivers do per sample once the message exists
+  ListenerHandler<RawMessage> handler;
+  uint64_t seen = 0;
+  handler.Connect(spare.HashValue(),
+                  [&seen](const std::shared_ptr<RawMessage>&,
+                          const MessageInfo& msg_info) {
+                    seen += msg_info.seq_num();
+                  });
+  auto msg = std::make_shared<RawMessage>(std::string(64, 'x'));
+  Report("shm/rtps dispatch", num, [&](uint64_t i) {
+    info.set_seq_num(i);
+    info.SerializeTo(wire, MessageInfo::kSize);
+    MessageInfo received;
+    received.DeserializeFrom(wire, MessageInfo::kSize);
+    handler.Run(msg, received);
+  });
+
+  RunIntra(num);
+  std::printf("checksum %llu\n", static_cast<unsigned long long>(seen));
+  apollo::cyber::Clear();
+  return 0;
+}
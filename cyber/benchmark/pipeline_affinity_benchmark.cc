@@ -0,0 +1,331 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Cache misses of a croutine pipeline, with and without data affinity.
+//
+//   pipeline_affinity_benchmark [processors] [stages] [payload_kb]
+//
+// Each of the pipelines (one per processor) passes a message through
+// stages croutines of one classic group, every stage reads the payload
+// (default 128KB) the previous stage wrote and writes its own. The plain
+// run wakes any idle processor of the group, the affinity run wakes the
+// one closest in cache to the producing processor, as groups with
+// data_affinity set do. Misses are counted for the whole process with
+// perf_event_open, L2 misses as references to the last level cache, since
+// the kernel has no generic event for L2. Without access to perf events
+// (see /proc/sys/kernel/perf_event_paranoid) only the rates are printed.
+
+#include <linux/perf_event.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cyber/common/global_data.h"
+#include "cyber/croutine/croutine.h"
+#include "cyber/scheduler/common/pin_thread.h"
+#include "cyber/scheduler/policy/classic_context.h"
+#include "cyber/scheduler/processor.h"
+
+using apollo::cyber::common::GlobalData;
+using apollo::cyber::croutine::CRoutine;
+using apollo::cyber::croutine::RoutineState;
+using apollo::cyber::scheduler::ClassicContext;
+using apollo::cyber::scheduler::Processor;
+
+namespace {
+
+const size_t kWarmupMessages = 100;
+const size_t kMessages = 2000;
+
+uint64_t Now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+class PerfCounter {
+ public:
+  PerfCounter(uint32_t type, uint64_t config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    // processor threads started later are counted as well, their counts
+    // are added once they exit
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+
+  ~PerfCounter() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  bool valid() const { return fd_ >= 0; }
+
+  void Start() {
+    if (fd_ >= 0) {
+      ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+
+  void Stop() {
+    if (fd_ >= 0) {
+      ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+    }
+  }
+
+  // scaled up if the counter had to share the pmu
+  double Value() const {
+    uint64_t values[3] = {0, 0, 0};
+    if (fd_ < 0 || read(fd_, values, sizeof(values)) != sizeof(values) ||
+        values[2] == 0) {
+      return -1;
+    }
+    return static_cast<double>(values[0]) * values[1] / values[2];
+  }
+
+ private:
+  int fd_ = -1;
+};
+
+uint64_t CacheEvent(uint64_t cache, uint64_t result) {
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+}
+
+struct Pipeline {
+  std::vector<std::shared_ptr<CRoutine>> stages;
+  // buffers[i] is read by stage i and written by stage i - 1
+  std::vector<std::vector<uint64_t>> buffers;
+  uint64_t start = 0;
+  uint64_t checksum = 0;
+};
+
+class Bench {
+ public:
+  Bench(int processors, int stages, size_t payload, bool affinity)
+      : group_(affinity ? "pipeline_affinity" : "pipeline_plain"),
+        affinity_(affinity) {
+    pipelines_.resize(processors);
+    for (int p = 0; p < processors; ++p) {
+      auto& pipeline = pipelines_[p];
+      for (int s = 0; s <= stages; ++s) {
+        pipeline.buffers.emplace_back(payload / sizeof(uint64_t), s);
+      }
+      for (int s = 0; s < stages; ++s) {
+        auto cr = std::make_shared<CRoutine>(
+            std::bind(&Bench::Stage, this, p, s));
+        cr->set_id(GlobalData::RegisterTaskName(
+            group_ + std::to_string(p) + "_" + std::to_string(s)));
+        cr->set_group_name(group_);
+        ClassicContext::cr_group_[group_]
+            .at(cr->priority())
+            .emplace_back(cr);
+        pipeline.stages.emplace_back(cr);
+      }
+    }
+
+    std::vector<int> cpus;
+    for (int i = 0; i < processors; ++i) {
+      cpus.emplace_back(i);
+    }
+    for (int i = 0; i < processors; ++i) {
+      auto proc = std::make_shared<Processor>();
+      proc->BindContext(std::make_shared<ClassicContext>(group_));
+      apollo::cyber::scheduler::SetSchedAffinity(proc->Thread(), cpus,
+                                                 "1to1", i);
+      processors_.emplace_back(proc);
+    }
+  }
+
+  ~Bench() {
+    running_.store(false);
+    for (auto& proc : processors_) {
+      proc->Stop();
+    }
+    for (auto& rq : ClassicContext::cr_group_[group_]) {
+      rq.clear();
+    }
+  }
+
+  // returns the mean latency of a message through the pipeline in us
+  double Run(size_t messages) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    size_t kicked = 0;
+    for (size_t p = 0; p < pipelines_.size() && kicked < messages; ++p) {
+      Kick(p);
+      ++kicked;
+    }
+    uint64_t latency = 0;
+    for (size_t done = 0; done < messages; ++done) {
+      cv_.wait(lock, [this]() { return !finished_.empty(); });
+      size_t p = finished_.front();
+      finished_.pop_front();
+      latency += Now() - pipelines_[p].start;
+      if (kicked < messages) {
+        Kick(p);
+        ++kicked;
+      }
+    }
+    return static_cast<double>(latency) / 1e3 / messages;
+  }
+
+ private:
+  // callers hold mutex_, the driver plays the transport thread
+  void Kick(size_t p) {
+    auto& pipeline = pipelines_[p];
+    auto& buffer = pipeline.buffers[0];
+    for (size_t i = 0; i < buffer.size(); i += 8) {
+      buffer[i] += 1;
+    }
+    pipeline.start = Now();
+    Notify(pipeline.stages[0]);
+  }
+
+  void Notify(const std::shared_ptr<CRoutine>& cr) {
+    cr->SetUpdateFlag();
+    if (affinity_) {
+      ClassicContext::Notify(group_, cr, sched_getcpu());
+    } else {
+      ClassicContext::Notify(group_);
+    }
+  }
+
+  void Stage(int p, int s) {
+    auto& pipeline = pipelines_[p];
+    while (running_.load()) {
+      CRoutine::Yield(RoutineState::DATA_WAIT);
+      if (!running_.load()) {
+        break;
+      }
+      const auto& in = pipeline.buffers[s];
+      auto& out = pipeline.buffers[s + 1];
+      uint64_t sum = 0;
+      for (size_t i = 0; i < in.size(); ++i) {
+        sum += in[i];
+        out[i] = in[i] ^ sum;
+      }
+      if (s + 1 < static_cast<int>(pipeline.stages.size())) {
+        Notify(pipeline.stages[s + 1]);
+        continue;
+      }
+      pipeline.checksum += sum;
+      std::lock_guard<std::mutex> lock(mutex_);
+      finished_.push_back(p);
+      cv_.notify_one();
+    }
+  }
+
+  std::string group_;
+  bool affinity_;
+  std::atomic<bool> running_ = {true};
+  std::vector<Pipeline> pipelines_;
+  std::vector<std::shared_ptr<Processor>> processors_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<size_t> finished_;
+};
+
+void PrintPerMessage(double count, size_t messages) {
+  if (count < 0) {
+    std::printf(" %12s", "n/a");
+  } else {
+    std::printf(" %12.0f", count / messages);
+  }
+}
+
+void Measure(int processors, int stages, size_t payload, bool affinity) {
+  PerfCounter l1d(PERF_TYPE_HW_CACHE,
+                  CacheEvent(PERF_COUNT_HW_CACHE_L1D,
+                             PERF_COUNT_HW_CACHE_RESULT_MISS));
+  PerfCounter l2(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES);
+  PerfCounter llc(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+
+  auto hits = ClassicContext::AffinityHits();
+  auto hints = ClassicContext::AffinityHints();
+  double latency = 0;
+  uint64_t elapsed = 0;
+  {
+    // counters have to be open before the processor threads start, counts
+    // of the threads are added to them once the threads exit
+    Bench bench(processors, stages, payload, affinity);
+    bench.Run(kWarmupMessages);
+    l1d.Start();
+    l2.Start();
+    llc.Start();
+    uint64_t start = Now();
+    latency = bench.Run(kMessages);
+    elapsed = Now() - start;
+    l1d.Stop();
+    l2.Stop();
+    llc.Stop();
+  }
+
+  std::printf("%-8s | %10.0f %10.1f", affinity ? "affinity" : "plain",
+              kMessages * 1e9 / elapsed, latency);
+  PrintPerMessage(l1d.Value(), kMessages);
+  PrintPerMessage(l2.Value(), kMessages);
+  PrintPerMessage(llc.Value(), kMessages);
+  std::printf(" | %6.1f%%\n",
+              100.0 * (ClassicContext::AffinityHits() - hits) /
+                  std::max<uint64_t>(ClassicContext::AffinityHints() - hints,
+                                     1));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int processors = argc > 1 ? std::atoi(argv[1]) : 0;
+  if (processors <= 0) {
+    processors =
+        std::max(2, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+  int stages = argc > 2 ? std::max(1, std::atoi(argv[2])) : 4;
+  size_t payload = (argc > 3 ? std::max(1, std::atoi(argv[3])) : 128) * 1024;
+
+  std::printf("processors %d, stages %d, payload %zuKB, messages %zu\n",
+              processors, stages, payload / 1024, kMessages);
+  std::printf("%-8s | %10s %10s %12s %12s %12s | %7s\n", "mode", "msg/s",
+              "lat(us)", "L1D miss", "L2 miss", "LLC miss", "hits");
+  Measure(processors, stages, payload, false);
+  Measure(processors, stages, payload, true);
+  return 0;
+}
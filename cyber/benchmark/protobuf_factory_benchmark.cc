@@ -0,0 +1,217 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Cost of turning RawMessages of mixed types back into protobuf messages.
+//
+//   protobuf_factory_benchmark [num]
+//
+// num (default 100000) RawMessages cycle through generated types and types
+// only known to the dynamic pool, as a recorder or bridge sees them. The
+// pool stage looks every type up in the descriptor pools the way the
+// factory used to, the factory stage goes through the prototype cache of
+// ProtobufFactory. The register stages repeat the registration of one
+// descriptor string, which readers of every new channel do.
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/dynamic_message.h"
+
+#include "cyber/proto/role_attributes.pb.h"
+#include "cyber/proto/unit_test.pb.h"
+
+#include "cyber/message/protobuf_factory.h"
+#include "cyber/message/raw_message.h"
+
+using apollo::cyber::message::ProtobufFactory;
+using apollo::cyber::message::RawMessage;
+using google::protobuf::DescriptorPool;
+using google::protobuf::DynamicMessageFactory;
+using google::protobuf::FileDescriptorProto;
+using google::protobuf::Message;
+using google::protobuf::MessageFactory;
+
+namespace {
+
+const char kDynamicPackage[] = "apollo.cyber.benchmark";
+
+struct Sample {
+  std::string type;
+  RawMessage raw;
+};
+
+// the lookups ProtobufFactory did before the cache
+class PoolLookup {
+ public:
+  explicit PoolLookup(const FileDescriptorProto& file) : factory_(&pool_) {
+    pool_.BuildFile(file);
+  }
+
+  Message* Generate(const std::string& type) {
+    auto descriptor =
+        DescriptorPool::generated_pool()->FindMessageTypeByName(type);
+    if (descriptor != nullptr) {
+      return MessageFactory::generated_factory()
+          ->GetPrototype(descriptor)
+          ->New();
+    }
+    std::lock_guard<std::mutex> lg(mutex_);
+    descriptor = pool_.FindMessageTypeByName(type);
+    if (descriptor == nullptr) {
+      return nullptr;
+    }
+    return factory_.GetPrototype(descriptor)->New();
+  }
+
+ private:
+  std::mutex mutex_;
+  DescriptorPool pool_;
+  DynamicMessageFactory factory_;
+};
+
+std::vector<Sample> MakeSamples(int num) {
+  apollo::cyber::proto::UnitTest unit_test;
+  unit_test.set_class_name("ProtobufFactoryBenchmark");
+  unit_test.set_case_name("decode");
+  apollo::cyber::proto::Chatter chatter;
+  chatter.set_timestamp(1);
+  chatter.set_lidar_timestamp(2);
+  chatter.set_seq(3);
+  chatter.set_content(std::string(64, 'c'));
+  apollo::cyber::proto::RoleAttributes attr;
+  attr.set_host_name("localhost");
+  attr.set_process_id(1);
+  attr.set_channel_name("/apollo/benchmark");
+  attr.set_message_type("apollo.cyber.proto.Chatter");
+
+  std::string unit_test_str, chatter_str, attr_str;
+  unit_test.SerializeToString(&unit_test_str);
+  chatter.SerializeToString(&chatter_str);
+  attr.SerializeToString(&attr_str);
+  // the dynamic types share the wire format of the generated ones
+  const std::string dynamic = std::string(kDynamicPackage) + ".";
+  std::vector<std::pair<std::string, std::string>> kinds = {
+      {"apollo.cyber.proto.UnitTest", unit_test_str},
+      {"apollo.cyber.proto.Chatter", chatter_str},
+      {"apollo.cyber.proto.RoleAttributes", attr_str},
+      {dynamic + "UnitTest", unit_test_str},
+      {dynamic + "Chatter", chatter_str},
+  };
+
+  std::vector<Sample> samples(num);
+  for (int i = 0; i < num; ++i) {
+    const auto& kind = kinds[i % kinds.size()];
+    samples[i].type = kind.first;
+    samples[i].raw = RawMessage(kind.second, i);
+  }
+  return samples;
+}
+
+template <typename GenerateT>
+void RunDecode(const char* name, const std::vector<Sample>& samples,
+               GenerateT generate) {
+  uint64_t bytes = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (const auto& sample : samples) {
+    std::unique_ptr<Message> message(generate(sample.type));
+    if (message == nullptr ||
+        !message->ParseFromString(sample.raw.message)) {
+      std::printf("failed to decode %s\n", sample.type.c_str());
+      std::exit(1);
+    }
+    bytes += message->ByteSizeLong();
+  }
+  auto end = std::chrono::steady_clock::now();
+  std::printf("decode   %-8s %8.1f ns/msg (%zu msgs, %" PRIu64 " bytes)\n",
+              name,
+              std::chrono::duration<double, std::nano>(end - start).count() /
+                  samples.size(),
+              samples.size(), bytes);
+}
+
+template <typename RegisterT>
+void RunRegister(const char* name, int num, RegisterT do_register) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num; ++i) {
+    if (!do_register()) {
+      std::printf("failed to register\n");
+      std::exit(1);
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  std::printf("register %-8s %8.1f ns/call\n", name,
+              std::chrono::duration<double, std::nano>(end - start).count() /
+                  num);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  int num = 100000;
+  if (argc > 1) {
+    num = std::atoi(argv[1]);
+  }
+  if (num <= 0) {
+    std::printf("usage: %s [num]\n", argv[0]);
+    return 1;
+  }
+
+  FileDescriptorProto file;
+  apollo::cyber::proto::UnitTest::descriptor()->file()->CopyTo(&file);
+  file.set_name("protobuf_factory_benchmark.proto");
+  file.set_package(kDynamicPackage);
+  apollo::cyber::proto::ProtoDesc proto_desc;
+  file.SerializeToString(proto_desc.mutable_desc());
+  std::string proto_desc_str;
+  proto_desc.SerializeToString(&proto_desc_str);
+
+  auto factory = ProtobufFactory::Instance();
+  if (!factory->RegisterMessage(proto_desc_str)) {
+    std::printf("failed to register the dynamic types\n");
+    return 1;
+  }
+  PoolLookup pool_lookup(file);
+  auto samples = MakeSamples(num);
+
+  RunDecode("pool", samples, [&pool_lookup](const std::string& type) {
+    return pool_lookup.Generate(type);
+  });
+  RunDecode("factory", samples, [factory](const std::string& type) {
+    return factory->GenerateMessageByType(type);
+  });
+
+  DescriptorPool pool;
+  RunRegister("pool", num, [&pool, &proto_desc_str]() {
+    apollo::cyber::proto::ProtoDesc desc;
+    FileDescriptorProto file_desc;
+    return desc.ParseFromString(proto_desc_str) &&
+           file_desc.ParseFromString(desc.desc()) &&
+           pool.BuildFile(file_desc) != nullptr;
+  });
+  RunRegister("factory", num, [factory, &proto_desc_str]() {
+    return factory->RegisterMessage(proto_desc_str);
+  });
+  return 0;
+}
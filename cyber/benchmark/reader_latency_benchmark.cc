@@ -0,0 +1,199 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Writer to reader callback latency, croutine against inline delivery.
+//
+//   reader_latency_benchmark [inproc] [croutine|inline|both]
+//                       writer and reader in one process
+//   reader_latency_benchmark reader [croutine|inline]
+//                       only the reader
+//   reader_latency_benchmark writer
+//                       only the writer, against a reader process
+//
+// The writer sends a small message every millisecond, stamped with the
+// monotonic clock, which the callback compares to its arrival. Across
+// processes the transport follows transport_conf.communication_mode of
+// cyber.pb.conf.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cyber/cyber.h"
+#include "cyber/proto/unit_test.pb.h"
+
+using apollo::cyber::DeliveryMode;
+using apollo::cyber::proto::Chatter;
+
+namespace {
+
+const char kChannelName[] = "/reader_latency_benchmark";
+const size_t kWarmupMessages = 100;
+const size_t kMessages = 5000;
+
+uint64_t Now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+class LatencyCollector {
+ public:
+  LatencyCollector() { latencies_.reserve(kWarmupMessages + kMessages); }
+
+  void OnMessage(const std::shared_ptr<Chatter>& msg) {
+    double latency = (Now() - msg->timestamp()) / 1e3;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (latencies_.size() == kWarmupMessages + kMessages) {
+      return;
+    }
+    latencies_.push_back(latency);
+    received_.store(latencies_.size());
+  }
+
+  size_t received() const { return received_.load(); }
+
+  void Report(const std::string& mode) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (latencies_.size() <= kWarmupMessages) {
+      std::printf("%-8s | received %zu messages only\n", mode.c_str(),
+                  latencies_.size());
+      return;
+    }
+    std::vector<double> sorted(latencies_.begin() + kWarmupMessages,
+                               latencies_.end());
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (auto latency : sorted) {
+      sum += latency;
+    }
+    auto percentile = [&sorted](double p) {
+      return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+    };
+    std::printf(
+        "%-8s | mean %8.1f us | p50 %8.1f us | p99 %8.1f us | max %8.1f us "
+        "| lost %zu\n",
+        mode.c_str(), sum / sorted.size(), percentile(0.5), percentile(0.99),
+        sorted.back(), kWarmupMessages + kMessages - latencies_.size());
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<double> latencies_;
+  std::atomic<size_t> received_ = {0};
+};
+
+std::shared_ptr<apollo::cyber::Reader<Chatter>> CreateReader(
+    const std::shared_ptr<apollo::cyber::Node>& node,
+    const std::string& channel_name, const std::string& delivery_mode,
+    LatencyCollector* collector) {
+  apollo::cyber::ReaderConfig config;
+  config.channel_name = channel_name;
+  config.qos_profile.set_depth(10);
+  config.pending_queue_size = 10;
+  config.delivery_mode = delivery_mode == "inline" ? DeliveryMode::INLINE
+                                                   : DeliveryMode::CROUTINE;
+  return node->CreateReader<Chatter>(
+      config, [collector](const std::shared_ptr<Chatter>& msg) {
+        collector->OnMessage(msg);
+      });
+}
+
+void RunWriter(const std::shared_ptr<apollo::cyber::Node>& node,
+               const std::string& channel_name,
+               const LatencyCollector* collector) {
+  auto writer = node->CreateWriter<Chatter>(channel_name);
+  if (writer == nullptr) {
+    std::printf("failed to create the writer\n");
+    return;
+  }
+  // let the endpoints discover each other
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+  auto msg = std::make_shared<Chatter>();
+  msg->set_content(std::string(16, 'x'));
+  auto next = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < kWarmupMessages + kMessages; ++i) {
+    next += std::chrono::milliseconds(1);
+    std::this_thread::sleep_until(next);
+    msg->set_seq(i);
+    msg->set_timestamp(Now());
+    writer->Write(msg);
+  }
+  if (collector == nullptr) {
+    return;
+  }
+  auto end = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (collector->received() < kWarmupMessages + kMessages &&
+         std::chrono::steady_clock::now() < end) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+void RunInproc(const std::shared_ptr<apollo::cyber::Node>& node,
+               const std::string& delivery_mode) {
+  static int run = 0;
+  std::string channel_name = kChannelName + std::to_string(run++);
+  LatencyCollector collector;
+  auto reader = CreateReader(node, channel_name, delivery_mode, &collector);
+  if (reader == nullptr) {
+    std::printf("failed to create the reader\n");
+    return;
+  }
+  RunWriter(node, channel_name, &collector);
+  reader->Shutdown();
+  collector.Report(delivery_mode);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::string role = argc > 1 ? argv[1] : "inproc";
+  std::string delivery_mode = argc > 2 ? argv[2] : "both";
+  apollo::cyber::Init(argv[0]);
+  std::shared_ptr<apollo::cyber::Node> node(
+      apollo::cyber::CreateNode("reader_latency_benchmark_" + role));
+  if (node == nullptr) {
+    return -1;
+  }
+
+  if (role == "writer") {
+    RunWriter(node, kChannelName, nullptr);
+  } else if (role == "reader") {
+    LatencyCollector collector;
+    auto reader = CreateReader(node, kChannelName, delivery_mode, &collector);
+    while (apollo::cyber::OK() &&
+           collector.received() < kWarmupMessages + kMessages) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    reader->Shutdown();
+    collector.Report(delivery_mode);
+  } else {
+    for (const char* mode : {"croutine", "inline"}) {
+      if (delivery_mode == "both" || delivery_mode == mode) {
+        RunInproc(node, mode);
+      }
+    }
+  }
+  apollo::cyber::Clear();
+  return 0;
+}
@@ -0,0 +1,143 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Loopback throughput of the RTPS transport, one transmitter and one
+// receiver in the same process.
+//
+//   rtps_benchmark [batch_latency_us] [throughput_bytes] [period_ms]
+//
+// Every payload size is sent unbatched first, then coalesced within
+// batch_latency_us (default 1000) where messages are small enough to share
+// a sample. A non zero throughput_bytes limits the writer to that many bytes
+// per period_ms (default 10).
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "cyber/common/util.h"
+#include "cyber/cyber.h"
+#include "cyber/message/raw_message.h"
+#include "cyber/transport/common/identity.h"
+#include "cyber/transport/transport.h"
+
+using apollo::cyber::message::RawMessage;
+using apollo::cyber::proto::QosProfile;
+using apollo::cyber::proto::RoleAttributes;
+using apollo::cyber::transport::Identity;
+using apollo::cyber::transport::MessageInfo;
+using apollo::cyber::transport::Transport;
+
+namespace {
+
+const uint64_t kBytesPerRun = 64 * 1024 * 1024;
+const uint64_t kMinMessages = 10;
+const uint64_t kMaxMessages = 100000;
+const uint32_t kBatchMaxBytes = 60000;
+
+void Run(int payload_size, const QosProfile& qos) {
+  static int run = 0;
+  RoleAttributes attr;
+  attr.set_channel_name("/rtps_benchmark_" + std::to_string(run++));
+  attr.set_channel_id(apollo::cyber::common::Hash(attr.channel_name()));
+  Identity id;
+  attr.set_id(id.HashValue());
+  attr.mutable_qos_profile()->CopyFrom(qos);
+
+  uint64_t num = std::min(
+      kMaxMessages, std::max(kMinMessages, kBytesPerRun / payload_size));
+  std::atomic<uint64_t> received = {0};
+  auto receiver = Transport::Instance()->CreateReceiver<RawMessage>(
+      attr,
+      [&received](const std::shared_ptr<RawMessage>&, const MessageInfo&,
+                  const RoleAttributes&) { ++received; },
+      apollo::cyber::proto::OptionalMode::RTPS);
+  auto transmitter = Transport::Instance()->CreateTransmitter<RawMessage>(
+      attr, apollo::cyber::proto::OptionalMode::RTPS);
+  if (receiver == nullptr || transmitter == nullptr) {
+    std::printf("failed to create the rtps endpoints\n");
+    return;
+  }
+  receiver->Enable();
+  // let the endpoints discover each other
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+
+  auto msg = std::make_shared<RawMessage>(std::string(payload_size, 'x'));
+  auto start = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < num; ++i) {
+    transmitter->Transmit(msg);
+  }
+  // stop once everything arrived or nothing did for a second, the rate is
+  // taken up to the last arrival
+  auto end = std::chrono::steady_clock::now();
+  uint64_t last = 0;
+  while (received.load() < num &&
+         std::chrono::steady_clock::now() - end < std::chrono::seconds(1)) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (received.load() != last) {
+      last = received.load();
+      end = std::chrono::steady_clock::now();
+    }
+  }
+
+  double seconds = std::chrono::duration<double>(end - start).count();
+  uint64_t got = received.load();
+  std::printf(
+      "%8d bytes | %-9s | %10.0f msgs/s | %9.1f MB/s | lost %llu/%llu\n",
+      payload_size, qos.batch_latency_us() > 0 ? "batched" : "plain",
+      got / seconds, got * static_cast<double>(payload_size) / seconds / 1e6,
+      static_cast<unsigned long long>(num - got),
+      static_cast<unsigned long long>(num));
+  transmitter->Disable();
+  receiver->Disable();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  uint32_t batch_latency_us = argc > 1 ? std::atoi(argv[1]) : 1000;
+  uint32_t throughput_bytes = argc > 2 ? std::atoi(argv[2]) : 0;
+  uint32_t throughput_period_ms = argc > 3 ? std::atoi(argv[3]) : 10;
+  apollo::cyber::Init(argv[0]);
+
+  QosProfile qos;
+  qos.set_history(apollo::cyber::proto::HISTORY_KEEP_LAST);
+  qos.set_depth(1000);
+  qos.set_reliability(apollo::cyber::proto::RELIABILITY_RELIABLE);
+  qos.set_preallocate_history(true);
+  qos.set_throughput_bytes(throughput_bytes);
+  qos.set_throughput_period_ms(throughput_period_ms);
+
+  for (int payload_size :
+       {64, 512, 4 * 1024, 64 * 1024, 1024 * 1024, 4 * 1024 * 1024}) {
+    qos.set_batch_latency_us(0);
+    Run(payload_size, qos);
+    if (batch_latency_us > 0 &&
+        static_cast<uint32_t>(payload_size) < kBatchMaxBytes / 4) {
+      qos.set_batch_latency_us(batch_latency_us);
+      qos.set_batch_max_bytes(kBatchMaxBytes);
+      Run(payload_size, qos);
+    }
+  }
+  apollo::cyber::Clear();
+  return 0;
+}
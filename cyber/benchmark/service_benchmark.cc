@@ -0,0 +1,143 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Round-trip latency of Service/Client calls.
+//
+//   service_benchmark [inproc] [thread|croutine|inline]
+//                       service and client in one process
+//   service_benchmark server [thread|croutine|inline]
+//                       only the service
+//   service_benchmark client
+//                       only the client, against a server process
+//
+// The transport follows transport_conf.communication_mode of cyber.pb.conf,
+// the second argument picks the execution mode of the service.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cyber/cyber.h"
+#include "cyber/proto/unit_test.pb.h"
+
+using apollo::cyber::proto::Chatter;
+
+namespace {
+
+const char kServiceName[] = "service_benchmark";
+const int kWarmupCalls = 100;
+const int kCalls = 10000;
+
+std::shared_ptr<apollo::cyber::Service<Chatter, Chatter>> CreateService(
+    const std::shared_ptr<apollo::cyber::Node>& node,
+    const std::string& execution_mode) {
+  apollo::cyber::ServiceConfig config;
+  config.service_name = kServiceName;
+  if (execution_mode == "croutine") {
+    config.execution_mode = apollo::cyber::ServiceConfig::CROUTINE;
+  } else if (execution_mode == "inline") {
+    config.execution_mode = apollo::cyber::ServiceConfig::INLINE;
+  }
+  return node->CreateService<Chatter, Chatter>(
+      config, [](const std::shared_ptr<Chatter>& request,
+                 std::shared_ptr<Chatter>& response) {
+        response->set_seq(request->seq());
+        response->set_timestamp(request->timestamp());
+      });
+}
+
+bool RunClient(const std::shared_ptr<apollo::cyber::Node>& node,
+               int payload_size) {
+  auto client = node->CreateClient<Chatter, Chatter>(kServiceName);
+  if (client == nullptr ||
+      !client->WaitForService(std::chrono::seconds(10))) {
+    std::printf("service %s is not available\n", kServiceName);
+    return false;
+  }
+
+  auto request = std::make_shared<Chatter>();
+  request->set_content(std::string(payload_size, 'x'));
+  std::vector<double> latencies;
+  latencies.reserve(kCalls);
+  int failed = 0;
+  for (int i = 0; i < kWarmupCalls + kCalls; ++i) {
+    request->set_seq(i);
+    auto start = std::chrono::steady_clock::now();
+    auto response = client->SendRequest(request, std::chrono::seconds(1));
+    auto end = std::chrono::steady_clock::now();
+    if (response == nullptr || response->seq() != static_cast<uint64_t>(i)) {
+      ++failed;
+      continue;
+    }
+    if (i >= kWarmupCalls) {
+      latencies.push_back(
+          std::chrono::duration<double, std::micro>(end - start).count());
+    }
+  }
+  if (latencies.empty()) {
+    std::printf("%7d bytes | all calls failed\n", payload_size);
+    return false;
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  double sum = 0.0;
+  for (auto latency : latencies) {
+    sum += latency;
+  }
+  auto percentile = [&latencies](double p) {
+    return latencies[static_cast<size_t>(p * (latencies.size() - 1))];
+  };
+  std::printf(
+      "%7d bytes | mean %8.1f us | p50 %8.1f us | p99 %8.1f us | max %8.1f "
+      "us | failed %d\n",
+      payload_size, sum / latencies.size(), percentile(0.5), percentile(0.99),
+      latencies.back(), failed);
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::string role = argc > 1 ? argv[1] : "inproc";
+  std::string execution_mode = argc > 2 ? argv[2] : "thread";
+  apollo::cyber::Init(argv[0]);
+  std::shared_ptr<apollo::cyber::Node> node(
+      apollo::cyber::CreateNode("service_benchmark_" + role));
+  if (node == nullptr) {
+    return -1;
+  }
+
+  std::shared_ptr<apollo::cyber::Service<Chatter, Chatter>> service;
+  if (role != "client") {
+    service = CreateService(node, execution_mode);
+  }
+  if (role == "server") {
+    apollo::cyber::WaitForShutdown();
+    return 0;
+  }
+
+  for (int payload_size : {16, 1024, 64 * 1024}) {
+    if (!RunClient(node, payload_size)) {
+      break;
+    }
+  }
+  apollo::cyber::Clear();
+  return 0;
+}
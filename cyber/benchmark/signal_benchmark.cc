@@ -0,0 +1,64 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Emit cost of base::Signal by number of connected slots.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "cyber/base/signal.h"
+
+using apollo::cyber::base::Connection;
+using apollo::cyber::base::Signal;
+
+namespace {
+
+const int kEmits = 1000000;
+
+void Run(int slot_num) {
+  Signal<const std::shared_ptr<int>&, uint64_t> sig;
+  std::vector<Connection<const std::shared_ptr<int>&, uint64_t>> conns;
+  uint64_t sum = 0;
+  for (int i = 0; i < slot_num; ++i) {
+    conns.emplace_back(sig.Connect(
+        [&sum](const std::shared_ptr<int>& msg, uint64_t seq) {
+          sum += *msg + seq;
+        }));
+  }
+
+  auto msg = std::make_shared<int>(1);
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kEmits; ++i) {
+    sig(msg, i);
+  }
+  auto end = std::chrono::steady_clock::now();
+  double ns =
+      std::chrono::duration<double, std::nano>(end - start).count() / kEmits;
+  std::printf("%4d slots | %8.1f ns/emit | %6.1f ns/slot | checksum %lu\n",
+              slot_num, ns, ns / slot_num, static_cast<unsigned long>(sum));
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  for (int slot_num : {1, 2, 4, 8, 16, 64}) {
+    Run(slot_num);
+  }
+  return 0;
+}
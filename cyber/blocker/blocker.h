@@ -17,9 +17,11 @@
 #ifndef CYBER_BLOCKER_BLOCKER_H_
 #define CYBER_BLOCKER_BLOCKER_H_
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
-#include <list>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -60,6 +62,61 @@ struct BlockerAttr {
   std::string channel_name;
 };
 
+/**
+ * @class RingIterator
+ * @brief Walks a range of a message ring from the latest to the oldest entry
+ */
+template <typename T>
+class RingIterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = std::shared_ptr<T>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const value_type*;
+  using reference = const value_type&;
+
+  RingIterator() = default;
+  RingIterator(const value_type* slots, size_t size, uint64_t pos)
+      : slots_(slots), size_(size), pos_(pos) {}
+
+  reference operator*() const { return slots_[(pos_ - 1) % size_]; }
+  pointer operator->() const { return &**this; }
+
+  RingIterator& operator++() {
+    --pos_;
+    return *this;
+  }
+  RingIterator operator++(int) {
+    RingIterator tmp(*this);
+    --pos_;
+    return tmp;
+  }
+
+  bool operator==(const RingIterator& another) const {
+    return slots_ == another.slots_ && pos_ == another.pos_;
+  }
+  bool operator!=(const RingIterator& another) const {
+    return !(*this == another);
+  }
+
+ private:
+  const value_type* slots_ = nullptr;
+  size_t size_ = 0;
+  // one past the entry this iterator points to
+  uint64_t pos_ = 0;
+};
+
+/**
+ * @class Blocker
+ * @brief Keeps the latest `capacity` messages of a channel
+ *
+ * Messages live in a ring indexed by a running count. Observe only takes a
+ * reference to the ring and the range published so far, so it costs the
+ * same for any history depth. Publish never writes a slot of the observed
+ * range, once it would it continues on a copy of the published range and
+ * leaves the old ring to the observer. A ring left to the observer keeps
+ * the observed messages only.
+ */
 template <typename T>
 class Blocker : public BlockerBase {
   friend class BlockerManager;
@@ -67,10 +124,10 @@ class Blocker : public BlockerBase {
  public:
   using MessageType = T;
   using MessagePtr = std::shared_ptr<T>;
-  using MessageQueue = std::list<MessagePtr>;
+  using MessageRing = std::vector<MessagePtr>;
   using Callback = std::function<void(const MessagePtr&)>;
   using CallbackMap = std::unordered_map<std::string, Callback>;
-  using Iterator = typename std::list<std::shared_ptr<T>>::const_iterator;
+  using Iterator = RingIterator<T>;
 
   explicit Blocker(const BlockerAttr& attr);
   virtual ~Blocker();
@@ -100,13 +157,23 @@ class Blocker : public BlockerBase {
   const std::string& channel_name() const override;
 
  private:
+  static const size_t kMinRingSize = 16;
+
   void Reset() override;
   void Enqueue(const MessagePtr& msg);
   void Notify(const MessagePtr& msg);
+  void Rebuild(size_t size);
+  void DetachObservedRing();
 
   BlockerAttr attr_;
-  MessageQueue observed_msg_queue_;
-  MessageQueue published_msg_queue_;
+  // published messages are [published_begin_, published_end_) of ring_,
+  // the latest at published_end_ - 1
+  std::shared_ptr<MessageRing> ring_;
+  uint64_t published_begin_ = 0;
+  uint64_t published_end_ = 0;
+  std::shared_ptr<MessageRing> observed_ring_;
+  uint64_t observed_begin_ = 0;
+  uint64_t observed_end_ = 0;
   mutable std::mutex msg_mutex_;
 
   CallbackMap published_callbacks_;
@@ -120,8 +187,6 @@ Blocker<T>::Blocker(const BlockerAttr& attr) : attr_(attr), dummy_msg_() {}
 
 template <typename T>
 Blocker<T>::~Blocker() {
-  published_msg_queue_.clear();
-  observed_msg_queue_.clear();
   published_callbacks_.clear();
 }
 
@@ -140,8 +205,10 @@ template <typename T>
 void Blocker<T>::Reset() {
   {
     std::lock_guard<std::mutex> lock(msg_mutex_);
-    observed_msg_queue_.clear();
-    published_msg_queue_.clear();
+    ring_.reset();
+    published_begin_ = published_end_;
+    observed_ring_.reset();
+    observed_begin_ = observed_end_ = 0;
   }
   {
     std::lock_guard<std::mutex> lock(cb_mutex_);
@@ -152,31 +219,44 @@ void Blocker<T>::Reset() {
 template <typename T>
 void Blocker<T>::ClearObserved() {
   std::lock_guard<std::mutex> lock(msg_mutex_);
-  observed_msg_queue_.clear();
+  observed_ring_.reset();
+  observed_begin_ = observed_end_ = 0;
 }
 
 template <typename T>
 void Blocker<T>::ClearPublished() {
   std::lock_guard<std::mutex> lock(msg_mutex_);
-  published_msg_queue_.clear();
+  DetachObservedRing();
+  ring_.reset();
+  published_begin_ = published_end_;
 }
 
 template <typename T>
 void Blocker<T>::Observe() {
   std::lock_guard<std::mutex> lock(msg_mutex_);
-  observed_msg_queue_ = published_msg_queue_;
+  if (observed_ring_ == ring_ && ring_ != nullptr) {
+    // release what was only kept for the previous snapshot, each message
+    // at most once
+    uint64_t end = std::min(observed_end_, published_begin_);
+    for (uint64_t i = observed_begin_; i < end; ++i) {
+      (*ring_)[i % ring_->size()].reset();
+    }
+  }
+  observed_ring_ = ring_;
+  observed_begin_ = published_begin_;
+  observed_end_ = published_end_;
 }
 
 template <typename T>
 bool Blocker<T>::IsObservedEmpty() const {
   std::lock_guard<std::mutex> lock(msg_mutex_);
-  return observed_msg_queue_.empty();
+  return observed_begin_ == observed_end_;
 }
 
 template <typename T>
 bool Blocker<T>::IsPublishedEmpty() const {
   std::lock_guard<std::mutex> lock(msg_mutex_);
-  return published_msg_queue_.empty();
+  return published_begin_ == published_end_;
 }
 
 template <typename T>
@@ -199,47 +279,55 @@ bool Blocker<T>::Unsubscribe(const std::string& callback_id) {
 template <typename T>
 auto Blocker<T>::GetLatestObserved() const -> const MessageType& {
   std::lock_guard<std::mutex> lock(msg_mutex_);
-  if (observed_msg_queue_.empty()) {
+  if (observed_begin_ == observed_end_) {
     return dummy_msg_;
   }
-  return *observed_msg_queue_.front();
+  return *(*observed_ring_)[(observed_end_ - 1) % observed_ring_->size()];
 }
 
 template <typename T>
 auto Blocker<T>::GetLatestObservedPtr() const -> const MessagePtr {
   std::lock_guard<std::mutex> lock(msg_mutex_);
-  if (observed_msg_queue_.empty()) {
+  if (observed_begin_ == observed_end_) {
     return nullptr;
   }
-  return observed_msg_queue_.front();
+  return (*observed_ring_)[(observed_end_ - 1) % observed_ring_->size()];
 }
 
 template <typename T>
 auto Blocker<T>::GetOldestObservedPtr() const -> const MessagePtr {
   std::lock_guard<std::mutex> lock(msg_mutex_);
-  if (observed_msg_queue_.empty()) {
+  if (observed_begin_ == observed_end_) {
     return nullptr;
   }
-  return observed_msg_queue_.back();
+  return (*observed_ring_)[observed_begin_ % observed_ring_->size()];
 }
 
 template <typename T>
 auto Blocker<T>::GetLatestPublishedPtr() const -> const MessagePtr {
   std::lock_guard<std::mutex> lock(msg_mutex_);
-  if (published_msg_queue_.empty()) {
+  if (published_begin_ == published_end_) {
     return nullptr;
   }
-  return published_msg_queue_.front();
+  return (*ring_)[(published_end_ - 1) % ring_->size()];
 }
 
 template <typename T>
 auto Blocker<T>::ObservedBegin() const -> Iterator {
-  return observed_msg_queue_.begin();
+  if (observed_begin_ == observed_end_) {
+    return Iterator();
+  }
+  return Iterator(observed_ring_->data(), observed_ring_->size(),
+                  observed_end_);
 }
 
 template <typename T>
 auto Blocker<T>::ObservedEnd() const -> Iterator {
-  return observed_msg_queue_.end();
+  if (observed_begin_ == observed_end_) {
+    return Iterator();
+  }
+  return Iterator(observed_ring_->data(), observed_ring_->size(),
+                  observed_begin_);
 }
 
 template <typename T>
@@ -251,8 +339,15 @@ template <typename T>
 void Blocker<T>::set_capacity(size_t capacity) {
   std::lock_guard<std::mutex> lock(msg_mutex_);
   attr_.capacity = capacity;
-  while (published_msg_queue_.size() > capacity) {
-    published_msg_queue_.pop_back();
+  if (published_end_ - published_begin_ > capacity) {
+    published_begin_ = published_end_ - capacity;
+  }
+  if (capacity == 0) {
+    DetachObservedRing();
+    ring_.reset();
+  } else if (ring_ != nullptr) {
+    // releases the dropped messages as well
+    Rebuild(std::min(ring_->size(), 2 * capacity));
   }
 }
 
@@ -267,12 +362,52 @@ void Blocker<T>::Enqueue(const MessagePtr& msg) {
     return;
   }
   std::lock_guard<std::mutex> lock(msg_mutex_);
-  published_msg_queue_.push_front(msg);
-  while (published_msg_queue_.size() > attr_.capacity) {
-    published_msg_queue_.pop_back();
+  size_t size = ring_ == nullptr ? 0 : ring_->size();
+  if (published_end_ - published_begin_ >= attr_.capacity) {
+    // drop the oldest, unless the observer still holds it
+    uint64_t oldest = published_begin_++;
+    if (ring_ != observed_ring_ || oldest < observed_begin_ ||
+        oldest >= observed_end_) {
+      (*ring_)[oldest % size].reset();
+    }
+  }
+  if (published_end_ - published_begin_ >= size) {
+    // the ring grows up to twice the capacity, leaving room to publish a
+    // full history before an observed range is in the way
+    Rebuild(std::min(std::max(2 * size, kMinRingSize), 2 * attr_.capacity));
+  } else if (ring_ == observed_ring_ && observed_begin_ < observed_end_ &&
+             published_end_ >= observed_begin_ + size) {
+    Rebuild(size);
+  }
+  (*ring_)[published_end_ % ring_->size()] = msg;
+  ++published_end_;
+}
+
+template <typename T>
+void Blocker<T>::Rebuild(size_t size) {
+  auto ring = std::make_shared<MessageRing>(size);
+  for (uint64_t i = published_begin_; i < published_end_; ++i) {
+    (*ring)[i % size] = (*ring_)[i % ring_->size()];
   }
+  DetachObservedRing();
+  ring_ = std::move(ring);
 }
 
+template <typename T>
+void Blocker<T>::DetachObservedRing() {
+  if (ring_ == nullptr || ring_ != observed_ring_) {
+    return;
+  }
+  // the observer holds on to the ring, but not to what it never observed
+  size_t size = ring_->size();
+  for (uint64_t i = observed_end_; i < observed_begin_ + size; ++i) {
+    (*ring_)[i % size].reset();
+  }
+}
+
+template <typename T>
+const size_t Blocker<T>::kMinRingSize;
+
 template <typename T>
 void Blocker<T>::Notify(const MessagePtr& msg) {
   std::lock_guard<std::mutex> lock(cb_mutex_);
@@ -17,6 +17,8 @@
 #include "cyber/blocker/blocker.h"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -97,6 +99,104 @@ TEST(BlockerTest, publish) {
   EXPECT_TRUE(blocker.IsObservedEmpty());
 }
 
+TEST(BlockerTest, observe) {
+  BlockerAttr attr(3, "channel");
+  Blocker<UnitTest> blocker(attr);
+  auto publish = [&blocker](int i) {
+    auto msg = std::make_shared<UnitTest>();
+    msg->set_case_name(std::to_string(i));
+    blocker.Publish(msg);
+  };
+  auto observed = [&blocker]() {
+    std::vector<std::string> names;
+    for (auto it = blocker.ObservedBegin(); it != blocker.ObservedEnd();
+         ++it) {
+      names.emplace_back((*it)->case_name());
+    }
+    return names;
+  };
+
+  blocker.Observe();
+  EXPECT_EQ(blocker.ObservedBegin(), blocker.ObservedEnd());
+  for (int i = 0; i < 5; ++i) {
+    publish(i);
+  }
+  blocker.Observe();
+  EXPECT_EQ(std::vector<std::string>({"4", "3", "2"}), observed());
+  EXPECT_EQ("4", blocker.GetLatestObservedPtr()->case_name());
+  EXPECT_EQ("2", blocker.GetOldestObservedPtr()->case_name());
+
+  // the snapshot stays as it was, however much is published meanwhile
+  for (int i = 5; i < 100; ++i) {
+    publish(i);
+    ASSERT_EQ(std::vector<std::string>({"4", "3", "2"}), observed());
+  }
+  EXPECT_EQ("99", blocker.GetLatestPublishedPtr()->case_name());
+  blocker.Observe();
+  EXPECT_EQ(std::vector<std::string>({"99", "98", "97"}), observed());
+
+  blocker.set_capacity(2);
+  publish(100);
+  EXPECT_EQ(std::vector<std::string>({"99", "98", "97"}), observed());
+  blocker.Observe();
+  EXPECT_EQ(std::vector<std::string>({"100", "99"}), observed());
+  blocker.set_capacity(4);
+  publish(101);
+  publish(102);
+  blocker.Observe();
+  EXPECT_EQ(std::vector<std::string>({"102", "101", "100", "99"}),
+            observed());
+
+  blocker.ClearPublished();
+  EXPECT_EQ(4, observed().size());
+  blocker.Observe();
+  EXPECT_TRUE(blocker.IsObservedEmpty());
+  EXPECT_EQ(blocker.ObservedBegin(), blocker.ObservedEnd());
+}
+
+TEST(BlockerTest, release) {
+  BlockerAttr attr(2, "channel");
+  Blocker<UnitTest> blocker(attr);
+  auto msg = std::make_shared<UnitTest>();
+  blocker.Publish(msg);
+  blocker.Observe();
+  blocker.Publish(std::make_shared<UnitTest>());
+  blocker.Publish(std::make_shared<UnitTest>());
+  // dropped from the history but still observed
+  EXPECT_EQ(2, msg.use_count());
+  blocker.Observe();
+  EXPECT_EQ(1, msg.use_count());
+}
+
+TEST(BlockerTest, release_detached) {
+  BlockerAttr attr(4, "channel");
+  Blocker<UnitTest> blocker(attr);
+  auto observed = std::make_shared<UnitTest>();
+  blocker.Publish(observed);
+  blocker.Observe();
+  auto unobserved = std::make_shared<UnitTest>();
+  blocker.Publish(unobserved);
+  EXPECT_EQ(2, unobserved.use_count());
+
+  // the ring stays with the observer, the message it never saw does not
+  blocker.ClearPublished();
+  EXPECT_EQ(1, unobserved.use_count());
+  EXPECT_EQ(2, observed.use_count());
+  EXPECT_EQ(observed, blocker.GetLatestObservedPtr());
+
+  // a ring outgrown while observed is left the same way
+  blocker.Observe();
+  blocker.Publish(observed);
+  blocker.Observe();
+  for (int i = 0; i < 20; ++i) {
+    blocker.Publish(unobserved);
+  }
+  EXPECT_EQ(2, observed.use_count());
+  EXPECT_EQ(5, unobserved.use_count());
+  blocker.ClearPublished();
+  EXPECT_EQ(1, unobserved.use_count());
+}
+
 TEST(BlockerTest, subscribe) {
   BlockerAttr attr(10, "channel");
   Blocker<UnitTest> blocker(attr);
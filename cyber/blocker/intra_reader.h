@@ -18,7 +18,6 @@
 #define CYBER_BLOCKER_INTRA_READER_H_
 
 #include <functional>
-#include <list>
 #include <memory>
 
 #include "cyber/blocker/blocker_manager.h"
@@ -35,8 +34,7 @@ class IntraReader : public apollo::cyber::Reader<MessageT> {
  public:
   using MessagePtr = std::shared_ptr<MessageT>;
   using Callback = std::function<void(const std::shared_ptr<MessageT>&)>;
-  using Iterator =
-      typename std::list<std::shared_ptr<MessageT>>::const_iterator;
+  using Iterator = typename Blocker<MessageT>::Iterator;
 
   IntraReader(const proto::RoleAttributes& attr, const Callback& callback);
   virtual ~IntraReader();
@@ -191,7 +189,7 @@ auto IntraReader<MessageT>::End() const -> Iterator {
   auto blocker = BlockerManager::Instance()->GetBlocker<MessageT>(
       this->role_attr_.channel_name());
   ACHECK(blocker != nullptr);
-  return blocker->ObservedBegin();
+  return blocker->ObservedEnd();
 }
 
 template <typename MessageT>
@@ -17,7 +17,11 @@
 #ifndef CYBER_COMMON_ENVIRONMENT_H_
 #define CYBER_COMMON_ENVIRONMENT_H_
 
+#include <sys/stat.h>
+
 #include <cassert>
+#include <cstdlib>
+#include <exception>
 #include <string>
 
 #include "cyber/common/log.h"
@@ -45,6 +49,32 @@ inline const std::string WorkRoot() {
   return work_root;
 }
 
+/**
+ * @brief CYBER_DOMAIN_ID, with the same default as the rtps participant
+ */
+inline std::string DomainId() {
+  const char* val = ::getenv("CYBER_DOMAIN_ID");
+  if (val == nullptr) {
+    return "80";
+  }
+  try {
+    return std::to_string(std::stoi(val));
+  } catch (const std::exception& e) {
+    return val;
+  }
+}
+
+/**
+ * @brief Identifies the pid namespace, pids are only comparable within one
+ */
+inline std::string PidNamespace() {
+  struct stat st;
+  if (stat("/proc/self/ns/pid", &st) != 0) {
+    return "0";
+  }
+  return std::to_string(st.st_dev) + ":" + std::to_string(st.st_ino);
+}
+
 }  // namespace common
 }  // namespace cyber
 }  // namespace apollo
@@ -32,10 +32,10 @@ namespace apollo {
 namespace cyber {
 namespace common {
 
-AtomicHashMap<uint64_t, std::string, 512> GlobalData::node_id_map_;
-AtomicHashMap<uint64_t, std::string, 256> GlobalData::channel_id_map_;
-AtomicHashMap<uint64_t, std::string, 256> GlobalData::service_id_map_;
-AtomicHashMap<uint64_t, std::string, 256> GlobalData::task_id_map_;
+ResizableAtomicHashMap<uint64_t, std::string> GlobalData::node_id_map_(512);
+ResizableAtomicHashMap<uint64_t, std::string> GlobalData::channel_id_map_(256);
+ResizableAtomicHashMap<uint64_t, std::string> GlobalData::service_id_map_(256);
+ResizableAtomicHashMap<uint64_t, std::string> GlobalData::task_id_map_(256);
 
 namespace {
 const std::string& kEmptyString = "";
@@ -85,6 +85,16 @@ void GlobalData::SetSchedName(const std::string& sched_name) {
 }
 const std::string& GlobalData::SchedName() const { return sched_name_; }
 
+void GlobalData::SetProcessorCpus(const std::vector<int>& cpus) {
+  std::lock_guard<std::mutex> lock(processor_cpus_mutex_);
+  processor_cpus_ = cpus;
+}
+
+std::vector<int> GlobalData::ProcessorCpus() const {
+  std::lock_guard<std::mutex> lock(processor_cpus_mutex_);
+  return processor_cpus_;
+}
+
 const std::string& GlobalData::HostIp() const { return host_ip_; }
 
 const std::string& GlobalData::HostName() const { return host_name_; }
@@ -168,22 +178,22 @@ const CyberConfig& GlobalData::Config() const { return config_; }
 uint64_t GlobalData::RegisterNode(const std::string& node_name) {
   auto id = Hash(node_name);
   while (node_id_map_.Has(id)) {
-    std::string* name = nullptr;
+    std::string name;
     node_id_map_.Get(id, &name);
-    if (node_name == *name) {
+    if (node_name == name) {
       break;
     }
     ++id;
-    AWARN << " Node name hash collision: " << node_name << " <=> " << *name;
+    AWARN << " Node name hash collision: " << node_name << " <=> " << name;
   }
   node_id_map_.Set(id, node_name);
   return id;
 }
 
 std::string GlobalData::GetNodeById(uint64_t id) {
-  std::string* node_name = nullptr;
+  std::string node_name;
   if (node_id_map_.Get(id, &node_name)) {
-    return *node_name;
+    return node_name;
   }
   return kEmptyString;
 }
@@ -191,22 +201,22 @@ std::string GlobalData::GetNodeById(uint64_t id) {
 uint64_t GlobalData::RegisterChannel(const std::string& channel) {
   auto id = Hash(channel);
   while (channel_id_map_.Has(id)) {
-    std::string* name = nullptr;
+    std::string name;
     channel_id_map_.Get(id, &name);
-    if (channel == *name) {
+    if (channel == name) {
       break;
     }
     ++id;
-    AWARN << "Channel name hash collision: " << channel << " <=> " << *name;
+    AWARN << "Channel name hash collision: " << channel << " <=> " << name;
   }
   channel_id_map_.Set(id, channel);
   return id;
 }
 
 std::string GlobalData::GetChannelById(uint64_t id) {
-  std::string* channel = nullptr;
+  std::string channel;
   if (channel_id_map_.Get(id, &channel)) {
-    return *channel;
+    return channel;
   }
   return kEmptyString;
 }
@@ -214,22 +224,22 @@ std::string GlobalData::GetChannelById(uint64_t id) {
 uint64_t GlobalData::RegisterService(const std::string& service) {
   auto id = Hash(service);
   while (service_id_map_.Has(id)) {
-    std::string* name = nullptr;
+    std::string name;
     service_id_map_.Get(id, &name);
-    if (service == *name) {
+    if (service == name) {
       break;
     }
     ++id;
-    AWARN << "Service name hash collision: " << service << " <=> " << *name;
+    AWARN << "Service name hash collision: " << service << " <=> " << name;
   }
   service_id_map_.Set(id, service);
   return id;
 }
 
 std::string GlobalData::GetServiceById(uint64_t id) {
-  std::string* service = nullptr;
+  std::string service;
   if (service_id_map_.Get(id, &service)) {
-    return *service;
+    return service;
   }
   return kEmptyString;
 }
@@ -237,22 +247,22 @@ std::string GlobalData::GetServiceById(uint64_t id) {
 uint64_t GlobalData::RegisterTaskName(const std::string& task_name) {
   auto id = Hash(task_name);
   while (task_id_map_.Has(id)) {
-    std::string* name = nullptr;
+    std::string name;
     task_id_map_.Get(id, &name);
-    if (task_name == *name) {
+    if (task_name == name) {
       break;
     }
     ++id;
-    AWARN << "Task name hash collision: " << task_name << " <=> " << *name;
+    AWARN << "Task name hash collision: " << task_name << " <=> " << name;
   }
   task_id_map_.Set(id, task_name);
   return id;
 }
 
 std::string GlobalData::GetTaskNameById(uint64_t id) {
-  std::string* task_name = nullptr;
+  std::string task_name;
   if (task_id_map_.Get(id, &task_name)) {
-    return *task_name;
+    return task_name;
   }
   return kEmptyString;
 }
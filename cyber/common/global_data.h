@@ -17,13 +17,15 @@
 #ifndef CYBER_COMMON_GLOBAL_DATA_H_
 #define CYBER_COMMON_GLOBAL_DATA_H_
 
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "cyber/proto/cyber_conf.pb.h"
 
-#include "cyber/base/atomic_hash_map.h"
 #include "cyber/base/atomic_rw_lock.h"
+#include "cyber/base/resizable_atomic_hash_map.h"
 #include "cyber/common/log.h"
 #include "cyber/common/macros.h"
 #include "cyber/common/util.h"
@@ -32,7 +34,7 @@ namespace apollo {
 namespace cyber {
 namespace common {
 
-using ::apollo::cyber::base::AtomicHashMap;
+using ::apollo::cyber::base::ResizableAtomicHashMap;
 using ::apollo::cyber::proto::ClockMode;
 using ::apollo::cyber::proto::CyberConfig;
 using ::apollo::cyber::proto::RunMode;
@@ -52,6 +54,10 @@ class GlobalData {
   void SetSchedName(const std::string& sched_name);
   const std::string& SchedName() const;
 
+  // cpus the scheduler processors of this process are pinned to
+  void SetProcessorCpus(const std::vector<int>& cpus);
+  std::vector<int> ProcessorCpus() const;
+
   const std::string& HostIp() const;
 
   const std::string& HostName() const;
@@ -99,15 +105,17 @@ class GlobalData {
 
   // sched policy info
   std::string sched_name_ = "CYBER_DEFAULT";
+  std::vector<int> processor_cpus_;
+  mutable std::mutex processor_cpus_mutex_;
 
   // run mode
   RunMode run_mode_;
   ClockMode clock_mode_;
 
-  static AtomicHashMap<uint64_t, std::string, 512> node_id_map_;
-  static AtomicHashMap<uint64_t, std::string, 256> channel_id_map_;
-  static AtomicHashMap<uint64_t, std::string, 256> service_id_map_;
-  static AtomicHashMap<uint64_t, std::string, 256> task_id_map_;
+  static ResizableAtomicHashMap<uint64_t, std::string> node_id_map_;
+  static ResizableAtomicHashMap<uint64_t, std::string> channel_id_map_;
+  static ResizableAtomicHashMap<uint64_t, std::string> service_id_map_;
+  static ResizableAtomicHashMap<uint64_t, std::string> task_id_map_;
 
   DECLARE_SINGLETON(GlobalData)
 };
@@ -0,0 +1,280 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/common/numa.h"
+
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "cyber/common/log.h"
+
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 1
+#endif
+
+#ifndef MPOL_INTERLEAVE
+#define MPOL_INTERLEAVE 3
+#endif
+
+#ifndef MPOL_MF_MOVE
+#define MPOL_MF_MOVE (1 << 1)
+#endif
+
+namespace apollo {
+namespace cyber {
+namespace common {
+
+namespace {
+
+const char kNodeRoot[] = "/sys/devices/system/node";
+const char kCpuRoot[] = "/sys/devices/system/cpu";
+const std::size_t kDefaultHugePageSize = 2 * 1024 * 1024;
+const int kMaxNumaNodes = 1024;
+
+std::size_t RoundUp(std::size_t size, std::size_t align) {
+  return (size + align - 1) / align * align;
+}
+
+// parses the "0-3,8,10-11" format used by sysfs cpulist files
+std::vector<int> ParseCpuList(const std::string& str) {
+  std::vector<int> cpus;
+  std::stringstream ss(str);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    int first = 0;
+    int last = 0;
+    int num = std::sscanf(range.c_str(), "%d-%d", &first, &last);
+    if (num == 1) {
+      cpus.push_back(first);
+    } else if (num == 2) {
+      for (int i = first; i <= last; ++i) {
+        cpus.push_back(i);
+      }
+    }
+  }
+  return cpus;
+}
+
+// the lowest cpu sharing a cache identifies it
+struct CpuCaches {
+  int l2 = -1;
+  int llc = -1;
+};
+
+std::vector<CpuCaches> ReadCpuCaches() {
+  std::vector<CpuCaches> caches;
+  DIR* dir = opendir(kCpuRoot);
+  if (dir == nullptr) {
+    return caches;
+  }
+  struct dirent* entry = nullptr;
+  while ((entry = readdir(dir)) != nullptr) {
+    int cpu = 0;
+    char tail = 0;
+    if (std::sscanf(entry->d_name, "cpu%d%c", &cpu, &tail) != 1 || cpu < 0) {
+      continue;
+    }
+    if (static_cast<std::size_t>(cpu) >= caches.size()) {
+      caches.resize(cpu + 1);
+    }
+    int llc_level = 0;
+    for (int index = 0;; ++index) {
+      std::string path = std::string(kCpuRoot) + "/" + entry->d_name +
+                         "/cache/index" + std::to_string(index) + "/";
+      std::ifstream level_file(path + "level");
+      std::ifstream shared_file(path + "shared_cpu_list");
+      int level = 0;
+      std::string shared;
+      if (!(level_file >> level) || !std::getline(shared_file, shared)) {
+        break;
+      }
+      auto cpus = ParseCpuList(shared);
+      if (cpus.empty()) {
+        continue;
+      }
+      int first = *std::min_element(cpus.begin(), cpus.end());
+      if (level == 2) {
+        caches[cpu].l2 = first;
+      }
+      if (level >= llc_level) {
+        llc_level = level;
+        caches[cpu].llc = first;
+      }
+    }
+  }
+  closedir(dir);
+  return caches;
+}
+
+}  // namespace
+
+CacheDistance CpuCacheDistance(int cpu_a, int cpu_b) {
+  static const std::vector<CpuCaches> caches = ReadCpuCaches();
+  if (cpu_a < 0 || cpu_b < 0) {
+    return NO_SHARED_CACHE;
+  }
+  if (cpu_a == cpu_b) {
+    return SAME_CPU;
+  }
+  if (static_cast<std::size_t>(cpu_a) >= caches.size() ||
+      static_cast<std::size_t>(cpu_b) >= caches.size()) {
+    return NO_SHARED_CACHE;
+  }
+  const auto& a = caches[cpu_a];
+  const auto& b = caches[cpu_b];
+  if (a.l2 >= 0 && a.l2 == b.l2) {
+    return SHARED_L2;
+  }
+  if (a.llc >= 0 && a.llc == b.llc) {
+    return SHARED_LLC;
+  }
+  return NO_SHARED_CACHE;
+}
+
+std::size_t HugePageSize() {
+  static const std::size_t size = []() {
+    std::ifstream meminfo("/proc/meminfo");
+    std::string line;
+    while (std::getline(meminfo, line)) {
+      std::size_t kb = 0;
+      if (std::sscanf(line.c_str(), "Hugepagesize: %zu kB", &kb) == 1 &&
+          kb > 0) {
+        return kb * 1024;
+      }
+    }
+    return kDefaultHugePageSize;
+  }();
+  return size;
+}
+
+std::vector<int> NumaNodesOfCpus(const std::vector<int>& cpus) {
+  std::vector<int> nodes;
+  if (cpus.empty()) {
+    return nodes;
+  }
+  DIR* dir = opendir(kNodeRoot);
+  if (dir == nullptr) {
+    return nodes;
+  }
+  struct dirent* entry = nullptr;
+  while ((entry = readdir(dir)) != nullptr) {
+    int node = 0;
+    if (std::sscanf(entry->d_name, "node%d", &node) != 1) {
+      continue;
+    }
+    std::ifstream cpulist(std::string(kNodeRoot) + "/" + entry->d_name +
+                          "/cpulist");
+    std::string line;
+    if (!std::getline(cpulist, line)) {
+      continue;
+    }
+    for (auto cpu : ParseCpuList(line)) {
+      if (std::find(cpus.begin(), cpus.end(), cpu) != cpus.end()) {
+        nodes.push_back(node);
+        break;
+      }
+    }
+  }
+  closedir(dir);
+  std::sort(nodes.begin(), nodes.end());
+  nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+  return nodes;
+}
+
+bool BindToNumaNodes(void* addr, std::size_t length,
+                     const std::vector<int>& nodes) {
+  if (addr == nullptr || length == 0 || nodes.empty()) {
+    return false;
+  }
+  const int bits = static_cast<int>(sizeof(unsigned long) * 8);  // NOLINT
+  unsigned long mask[kMaxNumaNodes / bits] = {0};                // NOLINT
+  for (auto node : nodes) {
+    if (node < 0 || node >= kMaxNumaNodes) {
+      return false;
+    }
+    mask[node / bits] |= 1UL << (node % bits);
+  }
+
+  // mbind works on whole pages
+  auto page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  auto begin = reinterpret_cast<uintptr_t>(addr) & ~(page - 1);
+  auto end = RoundUp(reinterpret_cast<uintptr_t>(addr) + length, page);
+  int mode = nodes.size() == 1 ? MPOL_PREFERRED : MPOL_INTERLEAVE;
+  if (syscall(SYS_mbind, begin, end - begin, mode, mask, kMaxNumaNodes + 1,
+              MPOL_MF_MOVE) != 0) {
+    AWARN << "mbind failed: " << strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+void* AllocateArena(std::size_t size, bool hugepage,
+                    const std::vector<int>& nodes) {
+  if (size == 0) {
+    return nullptr;
+  }
+  std::size_t length = size;
+  void* addr = MAP_FAILED;
+  if (hugepage) {
+    length = RoundUp(size, HugePageSize());
+    addr = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (addr == MAP_FAILED) {
+      AINFO << "no huge pages reserved for " << length
+            << " bytes, fall back to transparent huge pages.";
+    }
+  }
+  if (addr == MAP_FAILED) {
+    addr = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED) {
+      AERROR << "mmap arena failed: " << strerror(errno);
+      return nullptr;
+    }
+#ifdef MADV_HUGEPAGE
+    if (hugepage) {
+      madvise(addr, length, MADV_HUGEPAGE);
+    }
+#endif
+  }
+  if (!nodes.empty()) {
+    BindToNumaNodes(addr, length, nodes);
+  }
+  return addr;
+}
+
+void FreeArena(void* addr, std::size_t size, bool hugepage) {
+  if (addr == nullptr) {
+    return;
+  }
+  munmap(addr, hugepage ? RoundUp(size, HugePageSize()) : size);
+}
+
+}  // namespace common
+}  // namespace cyber
+}  // namespace apollo
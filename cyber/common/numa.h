@@ -0,0 +1,79 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_COMMON_NUMA_H_
+#define CYBER_COMMON_NUMA_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace apollo {
+namespace cyber {
+namespace common {
+
+/**
+ * @brief Size of an explicit huge page in bytes, 2MB if unknown.
+ */
+std::size_t HugePageSize();
+
+/**
+ * @brief Numa nodes the given cpus belong to, sorted and unique. Empty if
+ * the host exposes no numa topology.
+ */
+std::vector<int> NumaNodesOfCpus(const std::vector<int>& cpus);
+
+enum CacheDistance {
+  SAME_CPU = 0,
+  // SMT siblings or a cluster sharing the L2 cache
+  SHARED_L2 = 1,
+  SHARED_LLC = 2,
+  NO_SHARED_CACHE = 3,
+};
+
+/**
+ * @brief How close two cpus are in the cache hierarchy, NO_SHARED_CACHE for
+ * unknown or negative cpus. The topology is read from sysfs once.
+ */
+CacheDistance CpuCacheDistance(int cpu_a, int cpu_b);
+
+/**
+ * @brief Set the memory policy of [addr, addr + length). One node is
+ * preferred, several nodes are interleaved. Pages that are already faulted
+ * in are migrated when the kernel allows it.
+ */
+bool BindToNumaNodes(void* addr, std::size_t length,
+                     const std::vector<int>& nodes);
+
+/**
+ * @brief Allocate a zeroed, page aligned arena for long lived pools.
+ *
+ * With hugepage, explicit huge pages are tried first and transparent huge
+ * pages are requested if none are reserved. The arena is bound to nodes
+ * when nodes is not empty. Returns nullptr on failure.
+ */
+void* AllocateArena(std::size_t size, bool hugepage,
+                    const std::vector<int>& nodes);
+
+/**
+ * @brief Release an arena, size and hugepage must match AllocateArena.
+ */
+void FreeArena(void* addr, std::size_t size, bool hugepage);
+
+}  // namespace common
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_COMMON_NUMA_H_
@@ -0,0 +1,70 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/common/numa.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace common {
+
+TEST(NumaTest, nodes_of_cpus) {
+  EXPECT_TRUE(NumaNodesOfCpus({}).empty());
+  EXPECT_LE(NumaNodesOfCpus({0}).size(), 1);
+  EXPECT_TRUE(NumaNodesOfCpus({-1}).empty());
+  auto nodes = NumaNodesOfCpus({0, 0, 1});
+  for (size_t i = 1; i < nodes.size(); ++i) {
+    EXPECT_LT(nodes[i - 1], nodes[i]);
+  }
+}
+
+TEST(NumaTest, cache_distance) {
+  EXPECT_EQ(SAME_CPU, CpuCacheDistance(0, 0));
+  EXPECT_EQ(NO_SHARED_CACHE, CpuCacheDistance(-1, 0));
+  EXPECT_EQ(NO_SHARED_CACHE, CpuCacheDistance(0, 1 << 20));
+  // symmetric
+  for (int a = 0; a < 4; ++a) {
+    for (int b = 0; b < 4; ++b) {
+      EXPECT_EQ(CpuCacheDistance(a, b), CpuCacheDistance(b, a));
+    }
+  }
+}
+
+TEST(NumaTest, arena) {
+  EXPECT_GE(HugePageSize(), 4096);
+  EXPECT_EQ(nullptr, AllocateArena(0, false, {}));
+  EXPECT_FALSE(BindToNumaNodes(nullptr, 4096, {0}));
+
+  const size_t size = 3 * 1024 * 1024 + 7;
+  for (bool hugepage : {false, true}) {
+    auto arena = static_cast<uint8_t*>(
+        AllocateArena(size, hugepage, NumaNodesOfCpus({0})));
+    ASSERT_NE(nullptr, arena);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(arena) % 4096);
+    EXPECT_EQ(0, arena[0]);
+    EXPECT_EQ(0, arena[size - 1]);
+    std::memset(arena, 0xff, size);
+    FreeArena(arena, size, hugepage);
+  }
+}
+
+}  // namespace common
+}  // namespace cyber
+}  // namespace apollo
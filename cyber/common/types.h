@@ -42,6 +42,9 @@ enum Relation : std::uint8_t {
 
 static const char SRV_CHANNEL_REQ_SUFFIX[] = "__SRV__REQUEST";
 static const char SRV_CHANNEL_RES_SUFFIX[] = "__SRV__RESPONSE";
+// set in the sequence number of the response to a request the Service
+// rejected without calling its callback
+static const uint64_t SRV_RESPONSE_REJECTED = 1ULL << 63;
 
 }  // namespace cyber
 }  // namespace apollo
@@ -17,6 +17,7 @@
 #ifndef CYBER_COMPONENT_COMPONENT_H_
 #define CYBER_COMPONENT_COMPONENT_H_
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -104,9 +105,19 @@ class Component<M0, NullType, NullType, NullType> : public ComponentBase {
   ~Component() override {}
   bool Initialize(const ComponentConfig& config) override;
   bool Process(const std::shared_ptr<M0>& msg);
+  bool Process(const std::vector<std::shared_ptr<M0>>& msgs);
 
  private:
   virtual bool Proc(const std::shared_ptr<M0>& msg) = 0;
+
+  /**
+   * @brief Called instead of the Proc above when readers[0].max_batch_size
+   * of the config is set, with the messages pending since the last call,
+   * oldest first. Falls back to Proc per message.
+   *
+   * @return returns true if successful, otherwise returns false
+   */
+  virtual bool Proc(const std::vector<std::shared_ptr<M0>>& msgs);
 };
 
 template <typename M0, typename M1>
@@ -147,6 +158,25 @@ bool Component<M0, NullType, NullType, NullType>::Process(
   return Proc(msg);
 }
 
+template <typename M0>
+bool Component<M0, NullType, NullType, NullType>::Process(
+    const std::vector<std::shared_ptr<M0>>& msgs) {
+  if (is_shutdown_.load()) {
+    return true;
+  }
+  return Proc(msgs);
+}
+
+template <typename M0>
+bool Component<M0, NullType, NullType, NullType>::Proc(
+    const std::vector<std::shared_ptr<M0>>& msgs) {
+  bool ret = true;
+  for (const auto& msg : msgs) {
+    ret = Proc(msg) && ret;
+  }
+  return ret;
+}
+
 inline bool Component<NullType, NullType, NullType>::Initialize(
     const ComponentConfig& config) {
   node_.reset(new Node(config.name()));
@@ -184,11 +214,16 @@ bool Component<M0, NullType, NullType, NullType>::Initialize(
 
   std::weak_ptr<Component<M0>> self =
       std::dynamic_pointer_cast<Component<M0>>(shared_from_this());
-  auto func = [self](const std::shared_ptr<M0>& msg) {
+  uint32_t max_batch_size = config.readers(0).max_batch_size();
+  auto func = [self, max_batch_size](const std::shared_ptr<M0>& msg) {
     auto ptr = self.lock();
     if (ptr) {
       // 调用Process函数，Process函数中调用派生类的Proc函数
-      ptr->Process(msg);
+      if (max_batch_size > 0) {
+        ptr->Process(std::vector<std::shared_ptr<M0>>{msg});
+      } else {
+        ptr->Process(msg);
+      }
     } else {
       AERROR << "Component object has been destroyed.";
     }
@@ -215,8 +250,22 @@ bool Component<M0, NullType, NullType, NullType>::Initialize(
   data::VisitorConfig conf = {readers_[0]->ChannelId(),
                               readers_[0]->PendingQueueSize()};
   auto dv = std::make_shared<data::DataVisitor<M0>>(conf);
-  croutine::RoutineFactory factory =
-      croutine::CreateRoutineFactory<M0>(func, dv);
+  croutine::RoutineFactory factory;
+  if (max_batch_size > 0) {
+    auto batch_func = [self](const std::vector<std::shared_ptr<M0>>& msgs) {
+      auto ptr = self.lock();
+      if (ptr) {
+        ptr->Process(msgs);
+      } else {
+        AERROR << "Component object has been destroyed.";
+      }
+    };
+    factory = croutine::CreateBatchRoutineFactory<M0>(
+        batch_func, dv,
+        std::max(1u, std::min(max_batch_size, conf.queue_size)));
+  } else {
+    factory = croutine::CreateRoutineFactory<M0>(func, dv);
+  }
   auto sched = scheduler::Instance();
   // 创建名为nodename的task,接收通道为readers_[0]->ChannelId()
   // component方式用这个task通信! 回调函数里面调用Proc函数!
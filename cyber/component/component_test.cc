@@ -17,6 +17,7 @@
 #include "cyber/component/component.h"
 
 #include <memory>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -103,6 +104,39 @@ TEST(CommonComponent, init) {
   EXPECT_TRUE(comA->Process(msg_str1, msg_str2, msg_str3, msg_str4));
 }
 
+template <typename M0>
+class Component_D : public Component<M0> {
+ public:
+  Component_D() {}
+  bool Init() { return ret_init; }
+  int single_calls = 0;
+
+ private:
+  bool Proc(const std::shared_ptr<M0> &) {
+    ++single_calls;
+    return ret_proc;
+  }
+};
+
+TEST(CommonComponent, batch) {
+  ret_proc = true;
+  ret_init = true;
+  apollo::cyber::proto::ComponentConfig compcfg;
+  compcfg.set_name("perception_batch");
+  auto read_opt = compcfg.add_readers();
+  read_opt->set_channel("/perception/batch_channel");
+  read_opt->set_pending_queue_size(10);
+  read_opt->set_max_batch_size(4);
+  auto comD = std::make_shared<Component_D<RawMessage>>();
+  EXPECT_TRUE(comD->Initialize(compcfg));
+
+  // without a batch Proc every message goes to the single one
+  std::vector<std::shared_ptr<RawMessage>> msgs(
+      3, std::make_shared<RawMessage>());
+  EXPECT_TRUE(comD->Process(msgs));
+  EXPECT_EQ(3, comD->single_calls);
+}
+
 TEST(CommonComponentFail, init) {
   ret_proc = false;
   ret_init = false;
@@ -18,10 +18,12 @@
 
 #include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "cyber/base/concurrent_object_pool.h"
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
+#include "cyber/common/numa.h"
 #include "cyber/croutine/detail/routine_context.h"
 
 namespace apollo {
@@ -35,6 +37,33 @@ namespace {
 std::shared_ptr<base::CCObjectPool<RoutineContext>> context_pool = nullptr;
 std::once_flag pool_init_flag;
 
+// routine stacks are the largest scheduler owned arena, place them next to
+// the processors that run them when configured
+std::shared_ptr<base::CCObjectPool<RoutineContext>> CreateContextPool(
+    uint32_t routine_num) {
+  auto &global_conf = common::GlobalData::Instance()->Config();
+  auto &sched_conf = global_conf.scheduler_conf();
+  if (!sched_conf.pool_numa_bind() && !sched_conf.pool_hugepage()) {
+    return std::make_shared<base::CCObjectPool<RoutineContext>>(routine_num);
+  }
+
+  std::vector<int> nodes;
+  if (sched_conf.pool_numa_bind()) {
+    nodes = common::NumaNodesOfCpus(
+        common::GlobalData::Instance()->ProcessorCpus());
+  }
+  bool hugepage = sched_conf.pool_hugepage();
+  base::CCObjectPool<RoutineContext>::ArenaAllocator allocator;
+  allocator.allocate = [hugepage, nodes](std::size_t size) {
+    return common::AllocateArena(size, hugepage, nodes);
+  };
+  allocator.deallocate = [hugepage](void *arena, std::size_t size) {
+    common::FreeArena(arena, size, hugepage);
+  };
+  return std::make_shared<base::CCObjectPool<RoutineContext>>(routine_num,
+                                                              allocator);
+}
+
 void CRoutineEntry(void *arg) {
   CRoutine *r = static_cast<CRoutine *>(arg);
   r->Run();
@@ -51,7 +80,7 @@ CRoutine::CRoutine(const std::function<void()> &func) : func_(func) {
       routine_num =
           std::max(routine_num, global_conf.scheduler_conf().routine_num());
     }
-    context_pool.reset(new base::CCObjectPool<RoutineContext>(routine_num));
+    context_pool = CreateContextPool(routine_num);
   });
 
   context_ = context_pool->GetObject();
@@ -25,6 +25,7 @@
 #include <set>
 #include <string>
 
+#include "cyber/base/cycle_clock.h"
 #include "cyber/common/log.h"
 #include "cyber/croutine/detail/routine_context.h"
 
@@ -57,6 +58,13 @@ class CRoutine {
   // SetUpdateFlag().
   void SetUpdateFlag();
 
+  // CycleClock count of the first SetUpdateFlag() since the last call, 0 if
+  // there was none. Processors take it on resume to measure wake up latency.
+  uint64_t TakeUpdateTime();
+  bool IsUpdatePending() const {
+    return update_cycles_.load(std::memory_order_relaxed) != 0;
+  }
+
   // acquire && release should be called before Resume
   // when work-steal like mechanism used
   RoutineState Resume();
@@ -110,6 +118,7 @@ class CRoutine {
 // atomic_flag原子布尔类型是免锁的
   std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
   std::atomic_flag updated_ = ATOMIC_FLAG_INIT;
+  std::atomic<uint64_t> update_cycles_ = {0};
 
   bool force_stop_ = false;
 
@@ -210,10 +219,20 @@ inline void CRoutine::Release() {
 // SchedulerXXX::NotifyProcessor中调用该函数将updated_设置为false
 // 也就是说此协程IO结束可以被调度运行了
 inline void CRoutine::SetUpdateFlag() {
+  if (update_cycles_.load(std::memory_order_relaxed) == 0) {
+    update_cycles_.store(base::CycleClock::Now(), std::memory_order_relaxed);
+  }
   // 原子地设置标志为false
   updated_.clear(std::memory_order_release);
 }
 
+inline uint64_t CRoutine::TakeUpdateTime() {
+  if (update_cycles_.load(std::memory_order_relaxed) == 0) {
+    return 0;
+  }
+  return update_cycles_.exchange(0, std::memory_order_relaxed);
+}
+
 }  // namespace croutine
 }  // namespace cyber
 }  // namespace apollo
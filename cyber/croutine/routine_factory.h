@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
@@ -75,6 +76,35 @@ RoutineFactory CreateRoutineFactory(
   return factory;
 }
 
+/**
+ * @brief Like CreateRoutineFactory for one channel, but every resume hands
+ * up to `max_batch_size` pending messages to `f` at once
+ */
+template <typename M0, typename F>
+RoutineFactory CreateBatchRoutineFactory(
+    F&& f, const std::shared_ptr<data::DataVisitor<M0>>& dv,
+    uint32_t max_batch_size) {
+  RoutineFactory factory;
+  factory.SetDataVisitor(dv);
+  factory.create_routine = [=]() {
+    return [=]() {
+      std::vector<std::shared_ptr<M0>> msgs;
+      msgs.reserve(max_batch_size);
+      for (;;) {
+        CRoutine::GetCurrentRoutine()->set_state(RoutineState::DATA_WAIT);
+        if (dv->TryFetch(max_batch_size, &msgs)) {
+          f(msgs);
+          msgs.clear();
+          CRoutine::Yield(RoutineState::READY);
+        } else {
+          CRoutine::Yield();
+        }
+      }
+    };
+  };
+  return factory;
+}
+
 template <typename M0, typename M1, typename F>
 RoutineFactory CreateRoutineFactory(
     F&& f, const std::shared_ptr<data::DataVisitor<M0, M1>>& dv) {
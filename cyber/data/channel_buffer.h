@@ -45,6 +45,16 @@ class ChannelBuffer {
 
   bool FetchMulti(uint64_t fetch_size, std::vector<std::shared_ptr<T>>* vec);
 
+  /**
+   * @brief Append up to `max_size` messages from `*index` on, oldest first,
+   * and move `*index` behind the last one. Messages overwritten before they
+   * were fetched are skipped and reported.
+   *
+   * @return number of messages appended
+   */
+  uint64_t FetchBatch(uint64_t* index, uint64_t max_size,
+                      std::vector<std::shared_ptr<T>>* vec);
+
   uint64_t channel_id() const { return channel_id_; }
   std::shared_ptr<BufferType> Buffer() const { return buffer_; }
 
@@ -104,6 +114,35 @@ bool ChannelBuffer<T>::FetchMulti(uint64_t fetch_size,
   return true;
 }
 
+template <typename T>
+uint64_t ChannelBuffer<T>::FetchBatch(uint64_t* index, uint64_t max_size,
+                                      std::vector<std::shared_ptr<T>>* vec) {
+  std::lock_guard<std::mutex> lock(buffer_->Mutex());
+  if (buffer_->Empty() || max_size == 0) {
+    return 0;
+  }
+
+  if (*index == 0) {
+    *index = buffer_->Tail();
+  } else if (*index == buffer_->Tail() + 1) {
+    return 0;
+  } else if (*index < buffer_->Head()) {
+    // unlike Fetch, continue with the oldest message still buffered
+    auto interval = buffer_->Head() - *index;
+    AWARN << "channel[" << GlobalData::GetChannelById(channel_id_) << "] "
+          << "read buffer overflow, drop_message[" << interval << "] pre_index["
+          << *index << "] current_index[" << buffer_->Head() << "] ";
+    *index = buffer_->Head();
+  }
+  auto end = std::min(buffer_->Tail(), *index + max_size - 1);
+  for (auto i = *index; i <= end; ++i) {
+    vec->emplace_back(buffer_->at(i));
+  }
+  auto num = end - *index + 1;
+  *index = end + 1;
+  return num;
+}
+
 }  // namespace data
 }  // namespace cyber
 }  // namespace apollo
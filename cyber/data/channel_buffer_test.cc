@@ -98,6 +98,42 @@ TEST(ChannelBufferTest, FetchMulti) {
   EXPECT_EQ(2, *vector[1]);
 }
 
+TEST(ChannelBufferTest, FetchBatch) {
+  auto cache_buffer = new CacheBuffer<std::shared_ptr<int>>(3);
+  auto buffer = std::make_shared<ChannelBuffer<int>>(channel0, cache_buffer);
+  std::vector<std::shared_ptr<int>> vector;
+  uint64_t index = 0;
+  EXPECT_EQ(0, buffer->FetchBatch(&index, 2, &vector));
+
+  // the first fetch starts with the latest message, like Fetch
+  buffer->Buffer()->Fill(std::make_shared<int>(1));
+  EXPECT_EQ(1, buffer->FetchBatch(&index, 2, &vector));
+  EXPECT_EQ(1, *vector[0]);
+  EXPECT_EQ(0, buffer->FetchBatch(&index, 2, &vector));
+
+  vector.clear();
+  for (int i = 2; i <= 4; ++i) {
+    buffer->Buffer()->Fill(std::make_shared<int>(i));
+  }
+  EXPECT_EQ(2, buffer->FetchBatch(&index, 2, &vector));
+  EXPECT_EQ(1, buffer->FetchBatch(&index, 2, &vector));
+  ASSERT_EQ(3, vector.size());
+  EXPECT_EQ(2, *vector[0]);
+  EXPECT_EQ(3, *vector[1]);
+  EXPECT_EQ(4, *vector[2]);
+
+  // overwritten messages are skipped, the rest keeps its order
+  vector.clear();
+  for (int i = 5; i <= 9; ++i) {
+    buffer->Buffer()->Fill(std::make_shared<int>(i));
+  }
+  EXPECT_EQ(3, buffer->FetchBatch(&index, 10, &vector));
+  ASSERT_EQ(3, vector.size());
+  EXPECT_EQ(7, *vector[0]);
+  EXPECT_EQ(9, *vector[2]);
+  EXPECT_EQ(0, buffer->FetchBatch(&index, 10, &vector));
+}
+
 }  // namespace data
 }  // namespace cyber
 }  // namespace apollo
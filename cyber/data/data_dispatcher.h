@@ -17,10 +17,13 @@
 #ifndef CYBER_DATA_DATA_DISPATCHER_H_
 #define CYBER_DATA_DATA_DISPATCHER_H_
 
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <vector>
 
+#include "cyber/base/resizable_atomic_hash_map.h"
 #include "cyber/common/log.h"
 #include "cyber/common/macros.h"
 #include "cyber/data/channel_buffer.h"
@@ -32,7 +35,7 @@ namespace cyber {
 namespace data {
 
 using apollo::cyber::Time;
-using apollo::cyber::base::AtomicHashMap;
+using apollo::cyber::base::ResizableAtomicHashMap;
 
 // 单例，进程唯一
 template <typename T>
@@ -40,16 +43,49 @@ class DataDispatcher {
  public:
   using BufferVector =
       std::vector<std::weak_ptr<CacheBuffer<std::shared_ptr<T>>>>;
+  using BufferVectorPtr = std::shared_ptr<const BufferVector>;
+  using InlineCallback = std::function<void(const std::shared_ptr<T>&)>;
   ~DataDispatcher() {}
 
   void AddBuffer(const ChannelBuffer<T>& channel_buffer);
 
+  /**
+   * @brief Call `callback` on the thread that dispatches a message of
+   * `channel_id`, after the buffers are filled and notified
+   *
+   * Calls of one callback are serialized.
+   *
+   * @return id to remove the callback with
+   */
+  uint64_t AddInlineCallback(uint64_t channel_id,
+                             const InlineCallback& callback);
+
+  /**
+   * @brief Remove a callback, a call in progress on another thread is
+   * waited for. It may be called from within the callback itself.
+   */
+  void RemoveInlineCallback(uint64_t channel_id, uint64_t id);
+
   bool Dispatch(const uint64_t channel_id, const std::shared_ptr<T>& msg);
 
  private:
+  struct InlineListener {
+    uint64_t id = 0;
+    InlineCallback callback;
+    std::recursive_mutex mutex;
+    bool removed = false;
+  };
+  using InlineVector = std::vector<std::shared_ptr<InlineListener>>;
+  using InlineVectorPtr = std::shared_ptr<const InlineVector>;
+
   DataNotifier* notifier_ = DataNotifier::Instance();
   std::mutex buffers_map_mutex_;
-  AtomicHashMap<uint64_t, BufferVector> buffers_map_;
+  ResizableAtomicHashMap<uint64_t, BufferVectorPtr> buffers_map_;
+
+  // channels with inline callbacks, skips the lookup for all others
+  std::atomic<uint32_t> inline_channel_num_ = {0};
+  uint64_t inline_id_ = 0;
+  ResizableAtomicHashMap<uint64_t, InlineVectorPtr> inline_map_;
 
   DECLARE_SINGLETON(DataDispatcher)
 };
@@ -61,13 +97,70 @@ template <typename T>
 void DataDispatcher<T>::AddBuffer(const ChannelBuffer<T>& channel_buffer) {
   std::lock_guard<std::mutex> lock(buffers_map_mutex_);
   auto buffer = channel_buffer.Buffer();
-  BufferVector* buffers = nullptr;
+  BufferVectorPtr buffers;
+  auto updated = std::make_shared<BufferVector>();
   if (buffers_map_.Get(channel_buffer.channel_id(), &buffers)) {
-    buffers->emplace_back(buffer);
+    // drop buffers of readers that are already gone
+    for (const auto& b : *buffers) {
+      if (!b.expired()) {
+        updated->emplace_back(b);
+      }
+    }
+  }
+  updated->emplace_back(buffer);
+  buffers_map_.Set(channel_buffer.channel_id(), std::move(updated));
+}
+
+template <typename T>
+uint64_t DataDispatcher<T>::AddInlineCallback(uint64_t channel_id,
+                                              const InlineCallback& callback) {
+  std::lock_guard<std::mutex> lock(buffers_map_mutex_);
+  auto listener = std::make_shared<InlineListener>();
+  listener->id = ++inline_id_;
+  listener->callback = callback;
+  InlineVectorPtr listeners;
+  auto updated = std::make_shared<InlineVector>();
+  if (inline_map_.Get(channel_id, &listeners)) {
+    *updated = *listeners;
   } else {
-    BufferVector new_buffers = {buffer};
-    buffers_map_.Set(channel_buffer.channel_id(), new_buffers);
+    inline_channel_num_.fetch_add(1, std::memory_order_release);
+  }
+  updated->emplace_back(listener);
+  inline_map_.Set(channel_id, std::move(updated));
+  return listener->id;
+}
+
+template <typename T>
+void DataDispatcher<T>::RemoveInlineCallback(uint64_t channel_id,
+                                             uint64_t id) {
+  std::shared_ptr<InlineListener> removed;
+  {
+    std::lock_guard<std::mutex> lock(buffers_map_mutex_);
+    InlineVectorPtr listeners;
+    if (!inline_map_.Get(channel_id, &listeners)) {
+      return;
+    }
+    auto updated = std::make_shared<InlineVector>();
+    for (const auto& listener : *listeners) {
+      if (listener->id == id) {
+        removed = listener;
+      } else {
+        updated->emplace_back(listener);
+      }
+    }
+    if (removed == nullptr) {
+      return;
+    }
+    if (updated->empty()) {
+      inline_map_.Remove(channel_id);
+      inline_channel_num_.fetch_sub(1, std::memory_order_release);
+    } else {
+      inline_map_.Set(channel_id, std::move(updated));
+    }
   }
+  // dispatching threads may still hold the old vector
+  std::lock_guard<std::recursive_mutex> lock(removed->mutex);
+  removed->removed = true;
 }
 
 // 将数据放入data_visitor的buffer中，并调用notifier_->Notify(cid)
@@ -78,21 +171,35 @@ void DataDispatcher<T>::AddBuffer(const ChannelBuffer<T>& channel_buffer) {
 template <typename T>
 bool DataDispatcher<T>::Dispatch(const uint64_t channel_id,
                                  const std::shared_ptr<T>& msg) {
-  BufferVector* buffers = nullptr;
   if (apollo::cyber::IsShutdown()) {
     return false;
   }
-  if (buffers_map_.Get(channel_id, &buffers)) {
+  // Fill may run a fusion callback, keep it out of the read-side section
+  BufferVectorPtr buffers;
+  bool found = buffers_map_.Get(channel_id, &buffers);
+  if (found) {
     for (auto& buffer_wptr : *buffers) {
       if (auto buffer = buffer_wptr.lock()) {
         std::lock_guard<std::mutex> lock(buffer->Mutex());
         buffer->Fill(msg);
       }
     }
-  } else {
-    return false;
   }
-  return notifier_->Notify(channel_id);
+  bool notified = found && notifier_->Notify(channel_id);
+  if (inline_channel_num_.load(std::memory_order_acquire) == 0) {
+    return notified;
+  }
+  InlineVectorPtr listeners;
+  if (!inline_map_.Get(channel_id, &listeners)) {
+    return notified;
+  }
+  for (const auto& listener : *listeners) {
+    std::lock_guard<std::recursive_mutex> lock(listener->mutex);
+    if (!listener->removed) {
+      listener->callback(msg);
+    }
+  }
+  return true;
 }
 
 }  // namespace data
@@ -16,7 +16,10 @@
 
 #include "cyber/data/data_dispatcher.h"
 
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <thread>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -58,6 +61,63 @@ TEST(DataDispatcher, Dispatch) {
   EXPECT_TRUE(dispatcher->Dispatch(channel0, msg));
 }
 
+TEST(DataDispatcher, InlineCallback) {
+  auto channel2 = common::Hash("/channel2");
+  auto dispatcher = DataDispatcher<int>::Instance();
+  auto msg = std::make_shared<int>(2);
+  EXPECT_FALSE(dispatcher->Dispatch(channel2, msg));
+
+  int sum = 0;
+  auto id1 = dispatcher->AddInlineCallback(
+      channel2, [&sum](const std::shared_ptr<int>& m) { sum += *m; });
+  auto id2 = dispatcher->AddInlineCallback(
+      channel2, [&sum](const std::shared_ptr<int>& m) { sum += 10 * *m; });
+  EXPECT_NE(id1, id2);
+  EXPECT_TRUE(dispatcher->Dispatch(channel2, msg));
+  EXPECT_EQ(22, sum);
+
+  dispatcher->RemoveInlineCallback(channel2, id2);
+  EXPECT_TRUE(dispatcher->Dispatch(channel2, msg));
+  EXPECT_EQ(24, sum);
+  dispatcher->RemoveInlineCallback(channel2, id1);
+  EXPECT_FALSE(dispatcher->Dispatch(channel2, msg));
+  EXPECT_EQ(24, sum);
+
+  // removing from within the callback does not deadlock
+  uint64_t id = 0;
+  int calls = 0;
+  id = dispatcher->AddInlineCallback(
+      channel2, [&](const std::shared_ptr<int>&) {
+        ++calls;
+        dispatcher->RemoveInlineCallback(channel2, id);
+      });
+  EXPECT_TRUE(dispatcher->Dispatch(channel2, msg));
+  EXPECT_FALSE(dispatcher->Dispatch(channel2, msg));
+  EXPECT_EQ(1, calls);
+}
+
+TEST(DataDispatcher, RemoveWaitsForInlineCallback) {
+  auto channel3 = common::Hash("/channel3");
+  auto dispatcher = DataDispatcher<int>::Instance();
+  std::atomic<bool> entered = {false};
+  std::atomic<bool> left = {false};
+  auto id = dispatcher->AddInlineCallback(
+      channel3, [&](const std::shared_ptr<int>&) {
+        entered = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        left = true;
+      });
+  std::thread dispatch([&]() {
+    dispatcher->Dispatch(channel3, std::make_shared<int>(3));
+  });
+  while (!entered) {
+    std::this_thread::yield();
+  }
+  dispatcher->RemoveInlineCallback(channel3, id);
+  EXPECT_TRUE(left);
+  dispatch.join();
+}
+
 }  // namespace data
 }  // namespace cyber
 }  // namespace apollo
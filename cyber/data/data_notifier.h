@@ -17,10 +17,12 @@
 #ifndef CYBER_DATA_DATA_NOTIFIER_H_
 #define CYBER_DATA_DATA_NOTIFIER_H_
 
+#include <algorithm>
 #include <memory>
 #include <mutex>
 #include <vector>
 
+#include "cyber/base/resizable_atomic_hash_map.h"
 #include "cyber/common/log.h"
 #include "cyber/common/macros.h"
 #include "cyber/data/cache_buffer.h"
@@ -32,7 +34,7 @@ namespace cyber {
 namespace data {
 
 using apollo::cyber::Time;
-using apollo::cyber::base::AtomicHashMap;
+using apollo::cyber::base::ResizableAtomicHashMap;
 using apollo::cyber::event::PerfEventCache;
 
 struct Notifier {
@@ -43,16 +45,20 @@ struct Notifier {
 class DataNotifier {
  public:
   using NotifyVector = std::vector<std::shared_ptr<Notifier>>;
+  using NotifyVectorPtr = std::shared_ptr<const NotifyVector>;
   ~DataNotifier() {}
 
   void AddNotifier(uint64_t channel_id,
                    const std::shared_ptr<Notifier>& notifier);
 
+  void RemoveNotifier(uint64_t channel_id,
+                      const std::shared_ptr<Notifier>& notifier);
+
   bool Notify(const uint64_t channel_id);
 
  private:
   std::mutex notifies_map_mutex_;
-  AtomicHashMap<uint64_t, NotifyVector> notifies_map_;
+  ResizableAtomicHashMap<uint64_t, NotifyVectorPtr> notifies_map_;
 
   DECLARE_SINGLETON(DataNotifier)
 };
@@ -62,27 +68,46 @@ inline DataNotifier::DataNotifier() {}
 inline void DataNotifier::AddNotifier(
     uint64_t channel_id, const std::shared_ptr<Notifier>& notifier) {
   std::lock_guard<std::mutex> lock(notifies_map_mutex_);
-  NotifyVector* notifies = nullptr;
+  // readers never lock, so publish a new vector instead of mutating in place
+  NotifyVectorPtr notifies;
+  auto updated = std::make_shared<NotifyVector>();
   if (notifies_map_.Get(channel_id, &notifies)) {
-    notifies->emplace_back(notifier);
+    *updated = *notifies;
+  }
+  updated->emplace_back(notifier);
+  notifies_map_.Set(channel_id, std::move(updated));
+}
+
+inline void DataNotifier::RemoveNotifier(
+    uint64_t channel_id, const std::shared_ptr<Notifier>& notifier) {
+  std::lock_guard<std::mutex> lock(notifies_map_mutex_);
+  NotifyVectorPtr notifies;
+  if (!notifies_map_.Get(channel_id, &notifies)) {
+    return;
+  }
+  auto updated = std::make_shared<NotifyVector>(*notifies);
+  updated->erase(std::remove(updated->begin(), updated->end(), notifier),
+                 updated->end());
+  if (updated->empty()) {
+    notifies_map_.Remove(channel_id);
   } else {
-    NotifyVector new_notify = {notifier};
-    notifies_map_.Set(channel_id, new_notify);
+    notifies_map_.Set(channel_id, std::move(updated));
   }
 }
 
 // 每个channel可对应1个或多个notifier，notifier是创建dv的时候创建的，每个dv对应1个notifier
 inline bool DataNotifier::Notify(const uint64_t channel_id) {
-  NotifyVector* notifies = nullptr;
-  if (notifies_map_.Get(channel_id, &notifies)) {
-    for (auto& notifier : *notifies) {
-      if (notifier && notifier->callback) {
-        notifier->callback();
-      }
+  // the callbacks run outside the read-side section of the map
+  NotifyVectorPtr notifies;
+  if (!notifies_map_.Get(channel_id, &notifies)) {
+    return false;
+  }
+  for (auto& notifier : *notifies) {
+    if (notifier && notifier->callback) {
+      notifier->callback();
     }
-    return true;
   }
-  return false;
+  return true;
 }
 
 }  // namespace data
@@ -60,7 +60,7 @@ class DataVisitor : public DataVisitorBase {
     DataDispatcher<M1>::Instance()->AddBuffer(buffer_m1_);
     DataDispatcher<M2>::Instance()->AddBuffer(buffer_m2_);
     DataDispatcher<M3>::Instance()->AddBuffer(buffer_m3_);
-    data_notifier_->AddNotifier(buffer_m0_.channel_id(), notifier_);
+    RegisterNotifier(buffer_m0_.channel_id());
     data_fusion_ = new fusion::AllLatest<M0, M1, M2, M3>(
         buffer_m0_, buffer_m1_, buffer_m2_, buffer_m3_);
   }
@@ -102,7 +102,7 @@ class DataVisitor<M0, M1, M2, NullType> : public DataVisitorBase {
     DataDispatcher<M0>::Instance()->AddBuffer(buffer_m0_);
     DataDispatcher<M1>::Instance()->AddBuffer(buffer_m1_);
     DataDispatcher<M2>::Instance()->AddBuffer(buffer_m2_);
-    data_notifier_->AddNotifier(buffer_m0_.channel_id(), notifier_);
+    RegisterNotifier(buffer_m0_.channel_id());
     data_fusion_ =
         new fusion::AllLatest<M0, M1, M2>(buffer_m0_, buffer_m1_, buffer_m2_);
   }
@@ -140,7 +140,7 @@ class DataVisitor<M0, M1, NullType, NullType> : public DataVisitorBase {
                    new BufferType<M1>(configs[1].queue_size)) {
     DataDispatcher<M0>::Instance()->AddBuffer(buffer_m0_);
     DataDispatcher<M1>::Instance()->AddBuffer(buffer_m1_);
-    data_notifier_->AddNotifier(buffer_m0_.channel_id(), notifier_);
+    RegisterNotifier(buffer_m0_.channel_id());
     data_fusion_ = new fusion::AllLatest<M0, M1>(buffer_m0_, buffer_m1_);
   }
 
@@ -171,7 +171,7 @@ class DataVisitor<M0, NullType, NullType, NullType> : public DataVisitorBase {
   explicit DataVisitor(const VisitorConfig& configs)
       : buffer_(configs.channel_id, new BufferType<M0>(configs.queue_size)) {
     DataDispatcher<M0>::Instance()->AddBuffer(buffer_);
-    data_notifier_->AddNotifier(buffer_.channel_id(), notifier_);
+    RegisterNotifier(buffer_.channel_id());
   }
 
   DataVisitor(uint64_t channel_id, uint32_t queue_size)
@@ -180,7 +180,7 @@ class DataVisitor<M0, NullType, NullType, NullType> : public DataVisitorBase {
     // 然后调用(Dispatcher中可以直接拿到DataNotifier::Instance())data_notifier::Notify()接口使协程READY执行来取数据
     // -> 具体实现参见Dispatcher::Dispatch()函数
     DataDispatcher<M0>::Instance()->AddBuffer(buffer_);
-    data_notifier_->AddNotifier(buffer_.channel_id(), notifier_);
+    RegisterNotifier(buffer_.channel_id());
   }
 
   bool TryFetch(std::shared_ptr<M0>& m0) {  // NOLINT
@@ -191,6 +191,14 @@ class DataVisitor<M0, NullType, NullType, NullType> : public DataVisitorBase {
     return false;
   }
 
+  /**
+   * @brief Append up to `max_size` pending messages to `msgs`, oldest first
+   */
+  bool TryFetch(uint64_t max_size,
+                std::vector<std::shared_ptr<M0>>* msgs) {
+    return buffer_.FetchBatch(&next_msg_index_, max_size, msgs) > 0;
+  }
+
  private:
   ChannelBuffer<M0> buffer_;
 };
@@ -33,6 +33,11 @@ namespace data {
 class DataVisitorBase {
  public:
   DataVisitorBase() : notifier_(new Notifier()) {}
+  ~DataVisitorBase() {
+    if (notify_registered_) {
+      data_notifier_->RemoveNotifier(notify_channel_id_, notifier_);
+    }
+  }
 
   void RegisterNotifyCallback(std::function<void()>&& callback) {
     notifier_->callback = callback;
@@ -42,9 +47,17 @@ class DataVisitorBase {
   DataVisitorBase(const DataVisitorBase&) = delete;
   DataVisitorBase& operator=(const DataVisitorBase&) = delete;
 
+  void RegisterNotifier(uint64_t channel_id) {
+    notify_channel_id_ = channel_id;
+    notify_registered_ = true;
+    data_notifier_->AddNotifier(channel_id, notifier_);
+  }
+
   uint64_t next_msg_index_ = 0;
   DataNotifier* data_notifier_ = DataNotifier::Instance();
   std::shared_ptr<Notifier> notifier_;
+  uint64_t notify_channel_id_ = 0;
+  bool notify_registered_ = false;
 };
 
 }  // namespace data
@@ -17,6 +17,7 @@
 #include "cyber/event/perf_event_cache.h"
 
 #include <string>
+#include <vector>
 
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
@@ -116,11 +117,14 @@ void PerfEventCache::AddTransportEvent(const TransPerf event_id,
 }
 
 void PerfEventCache::Run() {
-  EventBasePtr event;
+  std::vector<EventBasePtr> events(kDequeueBatchSize);
   int buf_size = 0;
   while (!shutdown_ && !apollo::cyber::IsShutdown()) {
-    if (event_queue_.WaitDequeue(&event)) {
-      of_ << event->SerializeToString() << std::endl;
+    auto num = event_queue_.WaitDequeueBulk(events.data(), events.size());
+    for (uint64_t i = 0; i < num; ++i) {
+      // flushed every kFlushSize events, not per line
+      of_ << events[i]->SerializeToString() << '\n';
+      events[i].reset();
       buf_size++;
       if (buf_size >= kFlushSize) {
         of_.flush();
@@ -64,6 +64,7 @@ class PerfEventCache {
 
   const int kFlushSize = 512;
   const uint64_t kEventQueueSize = 8192;
+  const uint64_t kDequeueBatchSize = 64;
 
   DECLARE_SINGLETON(PerfEventCache)
 };
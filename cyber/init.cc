@@ -40,6 +40,7 @@
 #include "cyber/task/task.h"
 #include "cyber/time/clock.h"
 #include "cyber/timer/timing_wheel.h"
+#include "cyber/transport/common/channel_stats.h"
 #include "cyber/transport/transport.h"
 
 namespace apollo {
@@ -141,6 +142,7 @@ void Clear() {
   scheduler::CleanUp();
   service_discovery::TopologyManager::CleanUp();
   transport::Transport::CleanUp();
+  transport::ChannelStats::CleanUp();
   StopLogger();
   SetState(STATE_SHUTDOWN);
 }
@@ -16,6 +16,10 @@
 
 #include "cyber/io/poll_handler.h"
 
+#include <poll.h>
+
+#include <cerrno>
+
 #include "cyber/common/log.h"
 #include "cyber/io/poller.h"
 #include "cyber/scheduler/scheduler_factory.h"
@@ -35,6 +39,12 @@ bool PollHandler::Block(int timeout_ms, bool is_read) {
     return false;
   }
 
+  // outside of a croutine there is nothing to yield to, wait in place
+  routine_ = CRoutine::GetCurrentRoutine();
+  if (routine_ == nullptr) {
+    return Wait(timeout_ms, is_read);
+  }
+
   if (is_blocking_.exchange(true)) {
     AINFO << "poll handler is blocking.";
     return false;
@@ -63,6 +73,10 @@ bool PollHandler::Block(int timeout_ms, bool is_read) {
 
 bool PollHandler::Unblock() {
   is_blocking_.store(false);
+  if (request_.callback == nullptr) {
+    // never registered with the poller
+    return true;
+  }
   return Poller::Instance()->Unregister(request_);
 }
 
@@ -78,15 +92,22 @@ bool PollHandler::Check(int timeout_ms) {
     return false;
   }
 
-  routine_ = CRoutine::GetCurrentRoutine();
-  if (routine_ == nullptr) {
-    AERROR << "routine nullptr, please use IO in routine context.";
-    return false;
-  }
-
   return true;
 }
 
+bool PollHandler::Wait(int timeout_ms, bool is_read) {
+  struct pollfd pfd;
+  pfd.fd = fd_;
+  pfd.events = is_read ? POLLIN : POLLOUT;
+  pfd.revents = 0;
+  int res = 0;
+  do {
+    res = poll(&pfd, 1, timeout_ms);
+  } while (res < 0 && errno == EINTR);
+  // errors and hang ups are reported by the call that follows
+  return res > 0;
+}
+
 void PollHandler::Fill(int timeout_ms, bool is_read) {
   is_read_.store(is_read);
 
@@ -40,6 +40,7 @@ class PollHandler {
 
  private:
   bool Check(int timeout_ms);
+  bool Wait(int timeout_ms, bool is_read);
   void Fill(int timeout_ms, bool is_read);
   void ResponseCallback(const PollResponse& rsp);
 
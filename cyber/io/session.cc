@@ -53,15 +53,20 @@ int Session::Bind(const struct sockaddr *addr, socklen_t addrlen) {
 }
 
  // Accept函数在协程的入口函数中调用，不可阻塞，设置成NOBLOCK
-auto Session::Accept(struct sockaddr *addr, socklen_t *addrlen) -> SessionPtr {
+auto Session::Accept(struct sockaddr *addr, socklen_t *addrlen,
+                     int timeout_ms) -> SessionPtr {
   ACHECK(fd_ != -1);
   
   int sock_fd = accept4(fd_, addr, addrlen, SOCK_NONBLOCK);
   while (sock_fd == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
     // Block()函数内部协程会YIELD
-    poll_handler_->Block(-1, true);
-    // 协程返回继续执行accept4应该会调用成功
-    sock_fd = accept4(fd_, addr, addrlen, SOCK_NONBLOCK);
+    if (poll_handler_->Block(timeout_ms, true) || timeout_ms < 0) {
+      // 协程返回继续执行accept4应该会调用成功
+      sock_fd = accept4(fd_, addr, addrlen, SOCK_NONBLOCK);
+    }
+    if (timeout_ms > 0) {
+      break;
+    }
   }
 
   if (sock_fd == -1) {
@@ -71,14 +76,18 @@ auto Session::Accept(struct sockaddr *addr, socklen_t *addrlen) -> SessionPtr {
   return std::make_shared<Session>(sock_fd);
 }
 
-int Session::Connect(const struct sockaddr *addr, socklen_t addrlen) {
+int Session::Connect(const struct sockaddr *addr, socklen_t addrlen,
+                     int timeout_ms) {
   ACHECK(fd_ != -1);
 
   int optval;
   socklen_t optlen = sizeof(optval);
   int res = connect(fd_, addr, addrlen);
   if (res == -1 && errno == EINPROGRESS) {
-    poll_handler_->Block(-1, false);
+    if (!poll_handler_->Block(timeout_ms, false) && timeout_ms > 0) {
+      errno = ETIMEDOUT;
+      return -1;
+    }
     getsockopt(fd_, SOL_SOCKET, SO_ERROR, reinterpret_cast<void *>(&optval),
                &optlen);
     if (optval == 0) {
@@ -184,6 +193,70 @@ ssize_t Session::SendTo(const void *buf, size_t len, int flags,
   return nbytes;
 }
 
+ssize_t Session::SendMsg(const struct msghdr *msg, int flags,
+                         int timeout_ms) {
+  ACHECK(msg != nullptr);
+  ACHECK(fd_ != -1);
+
+  ssize_t nbytes = sendmsg(fd_, msg, flags);
+  if (timeout_ms == 0) {
+    return nbytes;
+  }
+
+  while ((nbytes == -1) && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+    if (poll_handler_->Block(timeout_ms, false)) {
+      nbytes = sendmsg(fd_, msg, flags);
+    }
+    if (timeout_ms > 0) {
+      break;
+    }
+  }
+  return nbytes;
+}
+
+int Session::SendMmsg(struct mmsghdr *msgvec, unsigned int vlen, int flags,
+                      int timeout_ms) {
+  ACHECK(msgvec != nullptr);
+  ACHECK(fd_ != -1);
+
+  int nmsgs = sendmmsg(fd_, msgvec, vlen, flags);
+  if (timeout_ms == 0) {
+    return nmsgs;
+  }
+
+  while ((nmsgs == -1) && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+    if (poll_handler_->Block(timeout_ms, false)) {
+      nmsgs = sendmmsg(fd_, msgvec, vlen, flags);
+    }
+    if (timeout_ms > 0) {
+      break;
+    }
+  }
+  return nmsgs;
+}
+
+int Session::RecvMmsg(struct mmsghdr *msgvec, unsigned int vlen, int flags,
+                      int timeout_ms) {
+  ACHECK(msgvec != nullptr);
+  ACHECK(fd_ != -1);
+
+  // the socket is non-blocking, this returns whatever is queued
+  int nmsgs = recvmmsg(fd_, msgvec, vlen, flags, nullptr);
+  if (timeout_ms == 0) {
+    return nmsgs;
+  }
+
+  while ((nmsgs == -1) && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+    if (poll_handler_->Block(timeout_ms, true)) {
+      nmsgs = recvmmsg(fd_, msgvec, vlen, flags, nullptr);
+    }
+    if (timeout_ms > 0) {
+      break;
+    }
+  }
+  return nmsgs;
+}
+
 ssize_t Session::Read(void *buf, size_t count, int timeout_ms) {
   ACHECK(buf != nullptr);
   ACHECK(fd_ != -1);
@@ -42,8 +42,10 @@ class Session {
   int Socket(int domain, int type, int protocol);
   int Listen(int backlog);
   int Bind(const struct sockaddr *addr, socklen_t addrlen);
-  SessionPtr Accept(struct sockaddr *addr, socklen_t *addrlen);
-  int Connect(const struct sockaddr *addr, socklen_t addrlen);
+  SessionPtr Accept(struct sockaddr *addr, socklen_t *addrlen,
+                    int timeout_ms = -1);
+  int Connect(const struct sockaddr *addr, socklen_t addrlen,
+              int timeout_ms = -1);
   int Close();
 
   // timeout_ms < 0, keep trying until the operation is successfully
@@ -58,6 +60,14 @@ class Session {
                  const struct sockaddr *dest_addr, socklen_t addrlen,
                  int timeout_ms = -1);
 
+  // scatter-gather and batched variants, several buffers or datagrams
+  // per system call
+  ssize_t SendMsg(const struct msghdr *msg, int flags, int timeout_ms = -1);
+  int SendMmsg(struct mmsghdr *msgvec, unsigned int vlen, int flags,
+               int timeout_ms = -1);
+  int RecvMmsg(struct mmsghdr *msgvec, unsigned int vlen, int flags,
+               int timeout_ms = -1);
+
   ssize_t Read(void *buf, size_t count, int timeout_ms = -1);
   ssize_t Write(const void *buf, size_t count, int timeout_ms = -1);
 
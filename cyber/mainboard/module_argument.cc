@@ -19,6 +19,9 @@
 #include <getopt.h>
 #include <libgen.h>
 
+#include <cstdlib>
+#include <thread>
+
 using apollo::cyber::common::GlobalData;
 
 namespace apollo {
@@ -34,10 +37,14 @@ void ModuleArgument::DisplayUsage() {
            "namespace for running this module, default in manager process\n"
         << "    -s, --sched_name=sched_name: sched policy "
            "conf for hole process, sched_name should be conf in cyber.pb.conf\n"
+        << "    -j, --init_threads=N: initialize components on N threads, "
+           "following the depends of the dag conf, 0 for one per core, "
+           "default 1. All flag files are applied before the first Init, "
+           "components run one by one if two flag files set the same flag\n"
         << "Example:\n"
         << "    " << binary_name_ << " -h\n"
         << "    " << binary_name_ << " -d dag_conf_file1 -d dag_conf_file2 "
-        << "-p process_group -s sched_name\n";
+        << "-p process_group -s sched_name -j 4\n";
 }
 
 void ModuleArgument::ParseArgument(const int argc, char* const argv[]) {
@@ -64,12 +71,13 @@ void ModuleArgument::ParseArgument(const int argc, char* const argv[]) {
 void ModuleArgument::GetOptions(const int argc, char* const argv[]) {
   opterr = 0;  // extern int opterr
   int long_index = 0;
-  const std::string short_opts = "hd:p:s:";
+  const std::string short_opts = "hd:p:s:j:";
   static const struct option long_opts[] = {
       {"help", no_argument, nullptr, 'h'},
       {"dag_conf", required_argument, nullptr, 'd'},
       {"process_name", required_argument, nullptr, 'p'},
       {"sched_name", required_argument, nullptr, 's'},
+      {"init_threads", required_argument, nullptr, 'j'},
       {NULL, no_argument, nullptr, 0}};
 
   // log command for info
@@ -108,6 +116,15 @@ void ModuleArgument::GetOptions(const int argc, char* const argv[]) {
       case 's':
         sched_name_ = std::string(optarg);
         break;
+      case 'j': {
+        int threads = std::atoi(optarg);
+        init_threads_ = threads > 0 ? threads
+                                    : std::thread::hardware_concurrency();
+        if (init_threads_ == 0) {
+          init_threads_ = 1;
+        }
+        break;
+      }
       case 'h':
         DisplayUsage();
         exit(0);
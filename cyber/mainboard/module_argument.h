@@ -42,12 +42,15 @@ class ModuleArgument {
   const std::string& GetProcessGroup() const;
   const std::string& GetSchedName() const;
   const std::list<std::string>& GetDAGConfList() const;
+  // threads initializing components, 1 initializes them one by one
+  uint32_t GetInitThreads() const;
 
  private:
   std::list<std::string> dag_conf_list_;
   std::string binary_name_;
   std::string process_group_;
   std::string sched_name_;
+  uint32_t init_threads_ = 1;
 };
 
 inline const std::string& ModuleArgument::GetBinaryName() const {
@@ -66,6 +69,10 @@ inline const std::list<std::string>& ModuleArgument::GetDAGConfList() const {
   return dag_conf_list_;
 }
 
+inline uint32_t ModuleArgument::GetInitThreads() const {
+  return init_threads_;
+}
+
 }  // namespace mainboard
 }  // namespace cyber
 }  // namespace apollo
@@ -16,8 +16,19 @@
 
 #include "cyber/mainboard/module_controller.h"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
+#include "gflags/gflags.h"
+
+#include "cyber/base/thread_pool.h"
 #include "cyber/common/environment.h"
 #include "cyber/common/file.h"
 #include "cyber/component/component_base.h"
@@ -26,6 +37,92 @@ namespace apollo {
 namespace cyber {
 namespace mainboard {
 
+namespace {
+
+uint64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// the same as ComponentBase does in Initialize
+std::string FlagFileAbsolutePath(const std::string& flag_file_path) {
+  if (flag_file_path.empty() || flag_file_path[0] == '/') {
+    return flag_file_path;
+  }
+  return common::GetAbsolutePath(common::WorkRoot(), flag_file_path);
+}
+
+void ApplyFlagFile(const std::string& flag_file_path) {
+  if (flag_file_path.empty()) {
+    return;
+  }
+  google::SetCommandLineOption(
+      "flagfile", FlagFileAbsolutePath(flag_file_path).c_str());
+}
+
+// the flags a flag file sets, each with the file setting it, nested flag
+// files are expanded so a flag file shared by two components is no overlap
+void FlagsOfFile(const std::string& path,
+                 std::unordered_set<std::string>* visited,
+                 std::vector<std::pair<std::string, std::string>>* flags) {
+  if (!visited->insert(path).second) {
+    return;
+  }
+  std::ifstream fin(path);
+  std::string line;
+  while (std::getline(fin, line)) {
+    auto begin = line.find_first_not_of(" \t");
+    if (begin == std::string::npos || line[begin] != '-') {
+      continue;
+    }
+    begin = line.find_first_not_of('-', begin);
+    if (begin == std::string::npos) {
+      continue;
+    }
+    auto end = line.find_first_of("= \t\r", begin);
+    std::string name = line.substr(begin, end - begin);
+    if (name == "flagfile") {
+      if (end == std::string::npos || line[end] != '=') {
+        continue;
+      }
+      auto value_end = line.find_last_not_of(" \t\r");
+      FlagsOfFile(line.substr(end + 1, value_end - end), visited, flags);
+      continue;
+    }
+    google::CommandLineFlagInfo info;
+    if (name.compare(0, 2, "no") == 0 &&
+        !google::GetCommandLineFlagInfo(name.c_str(), &info)) {
+      name = name.substr(2);
+    }
+    flags->emplace_back(std::move(name), path);
+  }
+}
+
+template <typename ComponentInfoT>
+bool SetsFlagOfOtherFile(
+    const ComponentInfoT& info,
+    std::unordered_map<std::string, std::string>* flag_files) {
+  auto path = FlagFileAbsolutePath(info.config().flag_file_path());
+  if (path.empty()) {
+    return false;
+  }
+  std::unordered_set<std::string> visited;
+  std::vector<std::pair<std::string, std::string>> flags;
+  FlagsOfFile(path, &visited, &flags);
+  for (auto& flag : flags) {
+    auto itr = flag_files->emplace(flag).first;
+    if (itr->second != flag.second) {
+      AWARN << "Flag " << flag.first << " is set by " << itr->second
+            << " and " << flag.second << ".";
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
 void ModuleController::Clear() {
   for (auto& component : component_list_) {
     component->Shutdown();
@@ -57,10 +154,18 @@ bool ModuleController::LoadAll() {
     total_component_nums += GetComponentNum(module_path);
     paths.emplace_back(std::move(module_path));
   }
+  init_threads_ = args_.GetInitThreads();
+  if (init_threads_ > 1 && FlagFilesOverlap(paths)) {
+    // every component would see the flags of the last flag file in Init
+    AWARN << "Flag files of the components overlap, ignore init_threads and "
+             "initialize components one by one.";
+    init_threads_ = 1;
+  }
   if (has_timer_component) {
     total_component_nums += scheduler::Instance()->TaskPoolSize();
   }
   common::GlobalData::Instance()->SetComponentNums(total_component_nums);
+  auto start_ns = NowNs();
   for (auto module_path : paths) {
     AINFO << "Start initialize dag: " << module_path;
     if (!LoadModule(module_path)) {
@@ -68,6 +173,11 @@ bool ModuleController::LoadAll() {
       return false;
     }
   }
+  // libraries are loaded one by one above, only Initialize runs in parallel
+  if (init_threads_ > 1 && !InitializeParallel()) {
+    return false;
+  }
+  ReportInitTimings(NowNs() - start_ns);
   return true;
 }
 
@@ -91,28 +201,213 @@ bool ModuleController::LoadModule(const DagConfig& dag_config) {
     class_loader_manager_.LoadLibrary(load_path);
 
     for (auto& component : module_config.components()) {
-      const std::string& class_name = component.class_name();
-      std::shared_ptr<ComponentBase> base =
-          class_loader_manager_.CreateClassObj<ComponentBase>(class_name);
-      if (base == nullptr || !base->Initialize(component.config())) {
+      if (!AddComponent(component)) {
         return false;
       }
-      component_list_.emplace_back(std::move(base));
     }
 
     for (auto& component : module_config.timer_components()) {
-      const std::string& class_name = component.class_name();
-      std::shared_ptr<ComponentBase> base =
-          class_loader_manager_.CreateClassObj<ComponentBase>(class_name);
-      if (base == nullptr || !base->Initialize(component.config())) {
+      if (!AddComponent(component)) {
         return false;
       }
-      component_list_.emplace_back(std::move(base));
     }
   }
   return true;
 }
 
+template <typename ComponentInfoT>
+bool ModuleController::AddComponent(const ComponentInfoT& info) {
+  const std::string& class_name = info.class_name();
+  std::shared_ptr<ComponentBase> base =
+      class_loader_manager_.CreateClassObj<ComponentBase>(class_name);
+  if (base == nullptr) {
+    return false;
+  }
+
+  PendingComponent component;
+  component.name = info.config().name();
+  component.class_name = class_name;
+  component.depends.assign(info.depends().begin(), info.depends().end());
+  component.base = base;
+  auto config = info.config();
+  if (init_threads_ > 1) {
+    // gflags must not be written while other components read them in Init,
+    // so flag files are applied here, in dag order, and all of them before
+    // the first Init
+    ApplyFlagFile(config.flag_file_path());
+    config.clear_flag_file_path();
+    component.initialize = [base, config]() {
+      return base->Initialize(config);
+    };
+    pending_components_.emplace_back(std::move(component));
+    return true;
+  }
+
+  component.initialize = [base, config]() { return base->Initialize(config); };
+  if (!InitializeComponent(&component)) {
+    return false;
+  }
+  component_list_.emplace_back(std::move(base));
+  return true;
+}
+
+bool ModuleController::InitializeComponent(PendingComponent* component) {
+  auto start_ns = NowNs();
+  component->success = component->initialize();
+  ComponentInitTiming timing;
+  timing.name = component->name;
+  timing.class_name = component->class_name;
+  timing.init_ns = NowNs() - start_ns;
+  timing.success = component->success;
+  if (timing.success) {
+    AINFO << "Component " << timing.name << " [" << timing.class_name
+          << "] initialized in " << timing.init_ns / 1000000 << " ms.";
+  } else {
+    AERROR << "Component " << timing.name << " [" << timing.class_name
+           << "] failed to initialize after " << timing.init_ns / 1000000
+           << " ms.";
+  }
+  std::lock_guard<std::mutex> lock(init_timings_mutex_);
+  init_timings_.emplace_back(std::move(timing));
+  return component->success;
+}
+
+bool ModuleController::InitializeParallel() {
+  auto& components = pending_components_;
+  if (components.empty()) {
+    return true;
+  }
+
+  std::unordered_map<std::string, size_t> index;
+  for (size_t i = 0; i < components.size(); ++i) {
+    if (!components[i].name.empty() &&
+        !index.emplace(components[i].name, i).second) {
+      AERROR << "Component name " << components[i].name
+             << " is not unique, cannot resolve depends.";
+      return false;
+    }
+  }
+  for (size_t i = 0; i < components.size(); ++i) {
+    for (auto& depend : components[i].depends) {
+      if (!depend.empty() && depend == components[i].name) {
+        AERROR << "Component " << depend << " depends on itself.";
+        return false;
+      }
+      auto itr = index.find(depend);
+      if (itr == index.end()) {
+        AERROR << "Component " << components[i].name
+               << " depends on unknown component " << depend << ".";
+        return false;
+      }
+      components[itr->second].dependents.emplace_back(i);
+      ++components[i].unmet;
+    }
+  }
+
+  // refuse cycles before any Init runs
+  {
+    std::vector<size_t> unmet(components.size());
+    std::queue<size_t> ready;
+    for (size_t i = 0; i < components.size(); ++i) {
+      unmet[i] = components[i].unmet;
+      if (unmet[i] == 0) {
+        ready.push(i);
+      }
+    }
+    size_t ordered = 0;
+    while (!ready.empty()) {
+      auto i = ready.front();
+      ready.pop();
+      ++ordered;
+      for (auto dependent : components[i].dependents) {
+        if (--unmet[dependent] == 0) {
+          ready.push(dependent);
+        }
+      }
+    }
+    if (ordered != components.size()) {
+      AERROR << "Component depends contain a cycle.";
+      return false;
+    }
+  }
+
+  auto thread_num = std::min<size_t>(init_threads_, components.size());
+  AINFO << "Initialize " << components.size() << " components on "
+        << thread_num << " threads.";
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t running = 0;
+  bool failed = false;
+  {
+    base::ThreadPool pool(thread_num, components.size());
+    std::function<void(size_t)> run = [&](size_t i) {
+      bool success = false;
+      // an exception would get lost in the pool and leave us waiting
+      try {
+        success = InitializeComponent(&components[i]);
+      } catch (const std::exception& e) {
+        AERROR << "Component " << components[i].name
+               << " threw while initializing: " << e.what();
+      } catch (...) {
+        AERROR << "Component " << components[i].name
+               << " threw while initializing.";
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      --running;
+      if (!success) {
+        // let the running ones finish, start no more
+        failed = true;
+      }
+      if (!failed) {
+        for (auto dependent : components[i].dependents) {
+          if (--components[dependent].unmet == 0) {
+            ++running;
+            pool.Enqueue(run, dependent);
+          }
+        }
+      }
+      cv.notify_all();
+    };
+
+    std::unique_lock<std::mutex> lock(mutex);
+    for (size_t i = 0; i < components.size(); ++i) {
+      if (components[i].unmet == 0) {
+        ++running;
+        pool.Enqueue(run, i);
+      }
+    }
+    cv.wait(lock, [&running]() { return running == 0; });
+  }
+
+  for (auto& component : components) {
+    if (component.success) {
+      component_list_.emplace_back(std::move(component.base));
+    }
+  }
+  components.clear();
+  return !failed;
+}
+
+void ModuleController::ReportInitTimings(uint64_t total_ns) const {
+  std::vector<ComponentInitTiming> timings(init_timings_);
+  std::sort(timings.begin(), timings.end(),
+            [](const ComponentInitTiming& lhs, const ComponentInitTiming& rhs) {
+              return lhs.init_ns > rhs.init_ns;
+            });
+  uint64_t sum_ns = 0;
+  for (auto& timing : timings) {
+    sum_ns += timing.init_ns;
+  }
+  AINFO << "Initialized " << timings.size() << " components in "
+        << total_ns / 1000000 << " ms, their Init took " << sum_ns / 1000000
+        << " ms in total.";
+  // the slowest ones bound the start up time
+  for (size_t i = 0; i < timings.size() && i < 5; ++i) {
+    AINFO << "  " << timings[i].name << " [" << timings[i].class_name
+          << "]: " << timings[i].init_ns / 1000000 << " ms";
+  }
+}
+
 bool ModuleController::LoadModule(const std::string& path) {
   DagConfig dag_config;
   if (!common::GetProtoFromFile(path, &dag_config)) {
@@ -122,6 +417,31 @@ bool ModuleController::LoadModule(const std::string& path) {
   return LoadModule(dag_config);
 }
 
+bool ModuleController::FlagFilesOverlap(
+    const std::vector<std::string>& paths) {
+  // flag -> the flag file setting it
+  std::unordered_map<std::string, std::string> flag_files;
+  for (auto& path : paths) {
+    DagConfig dag_config;
+    if (!common::GetProtoFromFile(path, &dag_config)) {
+      continue;
+    }
+    for (auto& module_config : dag_config.module_config()) {
+      for (auto& component : module_config.components()) {
+        if (SetsFlagOfOtherFile(component, &flag_files)) {
+          return true;
+        }
+      }
+      for (auto& component : module_config.timer_components()) {
+        if (SetsFlagOfOtherFile(component, &flag_files)) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
 int ModuleController::GetComponentNum(const std::string& path) {
   DagConfig dag_config;
   int component_nums = 0;
@@ -16,7 +16,10 @@
 #ifndef CYBER_MAINBOARD_MODULE_CONTROLLER_H_
 #define CYBER_MAINBOARD_MODULE_CONTROLLER_H_
 
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -32,6 +35,13 @@ namespace mainboard {
 
 using apollo::cyber::proto::DagConfig;
 
+struct ComponentInitTiming {
+  std::string name;
+  std::string class_name;
+  uint64_t init_ns = 0;
+  bool success = false;
+};
+
 class ModuleController {
  public:
   explicit ModuleController(const ModuleArgument& args);
@@ -41,16 +51,48 @@ class ModuleController {
   bool LoadAll();
   void Clear();
 
+  // one entry per component whose Initialize ran, in the order they finished
+  const std::vector<ComponentInitTiming>& InitTimings() const {
+    return init_timings_;
+  }
+
  private:
+  friend class ModuleControllerTest;
+
+  struct PendingComponent {
+    std::string name;
+    std::string class_name;
+    std::vector<std::string> depends;
+    std::shared_ptr<ComponentBase> base;
+    std::function<bool()> initialize;
+    std::vector<size_t> dependents;
+    size_t unmet = 0;
+    bool success = false;
+  };
+
   bool LoadModule(const std::string& path);
   bool LoadModule(const DagConfig& dag_config);
+  template <typename ComponentInfoT>
+  bool AddComponent(const ComponentInfoT& info);
+  bool InitializeComponent(PendingComponent* component);
+  bool InitializeParallel();
+  void ReportInitTimings(uint64_t total_ns) const;
+  // two flag files of the dags set the same flag
+  bool FlagFilesOverlap(const std::vector<std::string>& paths);
   int GetComponentNum(const std::string& path);
   int total_component_nums = 0;
   bool has_timer_component = false;
 
   ModuleArgument args_;
+  // init_threads of the arguments, 1 when flag files overlap
+  uint32_t init_threads_ = 1;
   class_loader::ClassLoaderManager class_loader_manager_;
   std::vector<std::shared_ptr<ComponentBase>> component_list_;
+
+  // created but not initialized yet, in dag order
+  std::vector<PendingComponent> pending_components_;
+  std::vector<ComponentInitTiming> init_timings_;
+  std::mutex init_timings_mutex_;
 };
 
 inline ModuleController::ModuleController(const ModuleArgument& args)
@@ -0,0 +1,239 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/mainboard/module_controller.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace mainboard {
+
+using apollo::cyber::proto::ComponentConfig;
+
+// what the fake components did, shared by all of them in a test
+struct InitRecord {
+  std::mutex mutex;
+  std::vector<std::string> order;
+  std::atomic<int> running = {0};
+  std::atomic<int> peak = {0};
+};
+
+class FakeComponent : public ComponentBase {
+ public:
+  enum Result { kSuccess, kFailure, kThrow };
+
+  FakeComponent(InitRecord* record, int sleep_ms, Result result)
+      : record_(record), sleep_ms_(sleep_ms), result_(result) {}
+
+  bool Initialize(const ComponentConfig& config) override {
+    int running = ++record_->running;
+    int peak = record_->peak.load();
+    while (running > peak &&
+           !record_->peak.compare_exchange_weak(peak, running)) {
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(sleep_ms_));
+    --record_->running;
+    {
+      std::lock_guard<std::mutex> lock(record_->mutex);
+      record_->order.emplace_back(config.name());
+    }
+    if (result_ == kThrow) {
+      throw std::runtime_error("fake component throws");
+    }
+    return result_ == kSuccess;
+  }
+
+ protected:
+  bool Init() override { return true; }
+
+ private:
+  InitRecord* record_;
+  int sleep_ms_;
+  Result result_;
+};
+
+class ModuleControllerTest : public ::testing::Test {
+ protected:
+  void SetUp() override { SetThreads(4); }
+
+  void SetThreads(uint32_t threads) {
+    controller_.reset(new ModuleController(ModuleArgument()));
+    controller_->init_threads_ = threads;
+  }
+
+  // what AddComponent does for a component loaded from a dag
+  void Add(const std::string& name, const std::vector<std::string>& depends,
+           int sleep_ms = 1,
+           FakeComponent::Result result = FakeComponent::kSuccess) {
+    ModuleController::PendingComponent component;
+    component.name = name;
+    component.class_name = "FakeComponent";
+    component.depends = depends;
+    auto base = std::make_shared<FakeComponent>(&record_, sleep_ms, result);
+    component.base = base;
+    ComponentConfig config;
+    config.set_name(name);
+    component.initialize = [base, config]() {
+      return base->Initialize(config);
+    };
+    controller_->pending_components_.emplace_back(std::move(component));
+  }
+
+  bool InitializeParallel() { return controller_->InitializeParallel(); }
+
+  size_t ComponentNum() const { return controller_->component_list_.size(); }
+
+  size_t Count(const std::string& name) {
+    return std::count(record_.order.begin(), record_.order.end(), name);
+  }
+
+  bool FlagFilesOverlap(const std::vector<std::string>& paths) {
+    return controller_->FlagFilesOverlap(paths);
+  }
+
+  std::unique_ptr<ModuleController> controller_;
+  InitRecord record_;
+};
+
+TEST_F(ModuleControllerTest, parallel) {
+  Add("map", {}, 100);
+  Add("perception", {}, 100);
+  Add("prediction", {"perception", "map"});
+  Add("control", {}, 100);
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(InitializeParallel());
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_LT(elapsed, std::chrono::milliseconds(300));
+  EXPECT_EQ(3, record_.peak.load());
+  ASSERT_EQ(4, record_.order.size());
+  EXPECT_EQ("prediction", record_.order.back());
+  EXPECT_EQ(4, ComponentNum());
+  EXPECT_EQ(4, controller_->InitTimings().size());
+}
+
+TEST_F(ModuleControllerTest, bounded_by_threads) {
+  SetThreads(2);
+  for (int i = 0; i < 6; ++i) {
+    Add("component_" + std::to_string(i), {}, 20);
+  }
+  EXPECT_TRUE(InitializeParallel());
+  EXPECT_EQ(2, record_.peak.load());
+  EXPECT_EQ(6, ComponentNum());
+}
+
+TEST_F(ModuleControllerTest, cycle) {
+  Add("a", {"c"});
+  Add("b", {"a"});
+  Add("c", {"b"});
+  Add("d", {});
+  EXPECT_FALSE(InitializeParallel());
+  // refused before any Init runs
+  EXPECT_TRUE(record_.order.empty());
+  EXPECT_EQ(0, ComponentNum());
+}
+
+TEST_F(ModuleControllerTest, self_depend) {
+  Add("a", {});
+  Add("b", {"b"});
+  EXPECT_FALSE(InitializeParallel());
+  EXPECT_TRUE(record_.order.empty());
+}
+
+TEST_F(ModuleControllerTest, unknown_depend) {
+  Add("a", {});
+  Add("b", {"a", "unknown"});
+  EXPECT_FALSE(InitializeParallel());
+  EXPECT_TRUE(record_.order.empty());
+}
+
+TEST_F(ModuleControllerTest, duplicate_name) {
+  Add("a", {});
+  Add("a", {});
+  Add("b", {"a"});
+  EXPECT_FALSE(InitializeParallel());
+  EXPECT_TRUE(record_.order.empty());
+}
+
+TEST_F(ModuleControllerTest, failure) {
+  Add("a", {}, 1, FakeComponent::kFailure);
+  Add("b", {"a"});
+  Add("c", {}, 30);
+  EXPECT_FALSE(InitializeParallel());
+  // the running one finishes, the dependent of the failed one never starts
+  EXPECT_EQ(1, Count("c"));
+  EXPECT_EQ(0, Count("b"));
+  EXPECT_EQ(1, ComponentNum());
+}
+
+TEST_F(ModuleControllerTest, exception) {
+  Add("a", {}, 1, FakeComponent::kThrow);
+  Add("b", {"a"});
+  EXPECT_FALSE(InitializeParallel());
+  EXPECT_EQ(0, Count("b"));
+  EXPECT_EQ(0, ComponentNum());
+}
+
+TEST_F(ModuleControllerTest, flag_files_overlap) {
+  // a flag file including itself is read once
+  std::ofstream("/tmp/module_controller_test_common.flag")
+      << "--alpha=1\n"
+      << "--flagfile=/tmp/module_controller_test_common.flag\n";
+  std::ofstream("/tmp/module_controller_test_a.flag")
+      << "--flagfile=/tmp/module_controller_test_common.flag\n"
+      << "# comment\n"
+      << "--beta=2\n";
+  std::ofstream("/tmp/module_controller_test_b.flag")
+      << "  --flagfile=/tmp/module_controller_test_common.flag\n"
+      << "--gamma=3\n";
+  std::ofstream("/tmp/module_controller_test_c.flag") << "--nobeta\n";
+  auto write_dag = [](const std::string& path,
+                      const std::vector<std::string>& flag_files) {
+    std::ofstream fout(path);
+    fout << "module_config {\n  module_library: \"fake.so\"\n";
+    for (auto& flag_file : flag_files) {
+      fout << "  components {\n    class_name: \"FakeComponent\"\n"
+           << "    config {\n      name: \"" << flag_file << "\"\n"
+           << "      flag_file_path: \"" << flag_file << "\"\n    }\n  }\n";
+    }
+    fout << "}\n";
+  };
+  write_dag("/tmp/module_controller_test_1.dag",
+            {"/tmp/module_controller_test_a.flag",
+             "/tmp/module_controller_test_b.flag",
+             "/tmp/module_controller_test_a.flag"});
+  write_dag("/tmp/module_controller_test_2.dag",
+            {"/tmp/module_controller_test_c.flag"});
+  // both include the common flag file, neither sets a flag of the other
+  EXPECT_FALSE(FlagFilesOverlap({"/tmp/module_controller_test_1.dag"}));
+  EXPECT_TRUE(FlagFilesOverlap({"/tmp/module_controller_test_1.dag",
+                                "/tmp/module_controller_test_2.dag"}));
+}
+
+}  // namespace mainboard
+}  // namespace cyber
+}  // namespace apollo
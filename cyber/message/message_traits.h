@@ -31,6 +31,7 @@ namespace cyber {
 namespace message {
 
 DEFINE_TYPE_TRAIT(HasByteSize, ByteSizeLong)
+DEFINE_TYPE_TRAIT(HasCachedSize, GetCachedSize)
 DEFINE_TYPE_TRAIT(HasType, TypeName)
 DEFINE_TYPE_TRAIT(HasSetType, SetTypeName)
 DEFINE_TYPE_TRAIT(HasGetDescriptorString, GetDescriptorString)
@@ -132,6 +133,20 @@ typename std::enable_if<!HasByteSize<T>::value, int>::type ByteSize(
   return -1;
 }
 
+// size without walking the message, a protobuf message only knows it once
+// it has been serialized
+template <typename T>
+typename std::enable_if<HasCachedSize<T>::value, int>::type CachedByteSize(
+    const T& message) {
+  return message.GetCachedSize();
+}
+
+template <typename T>
+typename std::enable_if<!HasCachedSize<T>::value, int>::type CachedByteSize(
+    const T& message) {
+  return ByteSize(message);
+}
+
 template <typename T>
 int FullByteSize(const T& message) {
   int content_size = ByteSize(message);
@@ -17,6 +17,7 @@
 #include "cyber/message/protobuf_factory.h"
 
 #include "cyber/common/log.h"
+#include "cyber/common/util.h"
 
 namespace apollo {
 namespace cyber {
@@ -60,15 +61,50 @@ bool ProtobufFactory::RegisterMessage(const ProtoDesc& proto_desc) {
 }
 
 bool ProtobufFactory::RegisterPythonMessage(const std::string& proto_str) {
+  if (IsRegistered(proto_str)) {
+    return true;
+  }
   FileDescriptorProto file_desc_proto;
   file_desc_proto.ParseFromString(proto_str);
-  return RegisterMessage(file_desc_proto);
+  if (!RegisterMessage(file_desc_proto)) {
+    return false;
+  }
+  SetRegistered(proto_str);
+  return true;
 }
 
 bool ProtobufFactory::RegisterMessage(const std::string& proto_desc_str) {
+  // readers and tools pass the same descriptors for every new channel
+  if (IsRegistered(proto_desc_str)) {
+    return true;
+  }
   ProtoDesc proto_desc;
   proto_desc.ParseFromString(proto_desc_str);
-  return RegisterMessage(proto_desc);
+  if (!RegisterMessage(proto_desc)) {
+    return false;
+  }
+  SetRegistered(proto_desc_str);
+  return true;
+}
+
+bool ProtobufFactory::IsRegistered(const std::string& desc_str) const {
+  bool registered = false;
+  // a matching hash is not enough, compare without copying the entry
+  registered_.Visit(common::Hash(desc_str),
+                    [&desc_str, &registered](const std::string& entry) {
+                      registered = entry == desc_str;
+                    });
+  return registered;
+}
+
+void ProtobufFactory::SetRegistered(const std::string& desc_str) {
+  auto hash = common::Hash(desc_str);
+  // on a collision the first one keeps the entry, the other one is just
+  // registered again each time
+  std::lock_guard<std::mutex> lg(register_mutex_);
+  if (!registered_.Has(hash)) {
+    registered_.Set(hash, desc_str);
+  }
 }
 
 // Internal method
@@ -156,50 +192,55 @@ void ProtobufFactory::GetDescriptorString(const std::string& type,
 // Internal method
 google::protobuf::Message* ProtobufFactory::GenerateMessageByType(
     const std::string& type) const {
-  google::protobuf::Message* message = GetMessageByGeneratedType(type);
-  if (message != nullptr) {
-    return message;
-  }
-
-  const google::protobuf::Descriptor* descriptor =
-      pool_->FindMessageTypeByName(type);
-  if (descriptor == nullptr) {
-    AERROR << "cannot find [" << type << "] descriptor";
-    return nullptr;
-  }
-
-  const google::protobuf::Message* prototype =
-      factory_->GetPrototype(descriptor);
+  auto prototype = GetPrototype(type);
   if (prototype == nullptr) {
     AERROR << "cannot find [" << type << "] prototype";
     return nullptr;
   }
-
   return prototype->New();
 }
 
-google::protobuf::Message* ProtobufFactory::GetMessageByGeneratedType(
+const google::protobuf::Message* ProtobufFactory::GetPrototype(
     const std::string& type) const {
+  uint64_t key = common::Hash(type);
+  const google::protobuf::Message* prototype = nullptr;
+  if (prototypes_.Get(key, &prototype) &&
+      prototype->GetDescriptor()->full_name() == type) {
+    return prototype;
+  }
+
   auto descriptor =
       DescriptorPool::generated_pool()->FindMessageTypeByName(type);
-  if (descriptor == nullptr) {
-    // AERROR << "cannot find [" << type << "] descriptor";
-    return nullptr;
+  if (descriptor != nullptr) {
+    prototype = MessageFactory::generated_factory()->GetPrototype(descriptor);
+  } else {
+    std::lock_guard<std::mutex> lg(register_mutex_);
+    descriptor = pool_->FindMessageTypeByName(type);
+    if (descriptor == nullptr) {
+      return nullptr;
+    }
+    prototype = factory_->GetPrototype(descriptor);
   }
-
-  auto prototype =
-      MessageFactory::generated_factory()->GetPrototype(descriptor);
-  if (prototype == nullptr) {
-    // AERROR << "cannot find [" << type << "] prototype";
-    return nullptr;
+  if (prototype != nullptr) {
+    prototypes_.Set(key, prototype);
   }
-
-  return prototype->New();
+  return prototype;
 }
 
 const Descriptor* ProtobufFactory::FindMessageTypeByName(
     const std::string& name) const {
-  return pool_->FindMessageTypeByName(name);
+  uint64_t key = common::Hash(name);
+  const Descriptor* descriptor = nullptr;
+  if (descriptors_.Get(key, &descriptor) && descriptor->full_name() == name) {
+    return descriptor;
+  }
+
+  std::lock_guard<std::mutex> lg(register_mutex_);
+  descriptor = pool_->FindMessageTypeByName(name);
+  if (descriptor != nullptr) {
+    descriptors_.Set(key, descriptor);
+  }
+  return descriptor;
 }
 
 const google::protobuf::ServiceDescriptor* ProtobufFactory::FindServiceByName(
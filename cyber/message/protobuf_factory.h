@@ -29,6 +29,7 @@
 
 #include "cyber/proto/proto_desc.pb.h"
 
+#include "cyber/base/resizable_atomic_hash_map.h"
 #include "cyber/common/macros.h"
 
 namespace apollo {
@@ -87,6 +88,10 @@ class ProtobufFactory {
   google::protobuf::Message* GenerateMessageByType(
       const std::string& type) const;
 
+  // The prototype of a type, generated types first. Call New() on it to
+  // construct messages. Returns nullptr if no such message exists.
+  const google::protobuf::Message* GetPrototype(const std::string& type) const;
+
   // Find a top-level message type by name. Returns nullptr if not found.
   const Descriptor* FindMessageTypeByName(const std::string& type) const;
 
@@ -98,15 +103,29 @@ class ProtobufFactory {
 
  private:
   bool RegisterMessage(const ProtoDesc& proto_desc);
-  google::protobuf::Message* GetMessageByGeneratedType(
-      const std::string& type) const;
   static bool GetProtoDesc(const FileDescriptor* file_desc,
                            ProtoDesc* proto_desc);
 
-  std::mutex register_mutex_;
+  bool IsRegistered(const std::string& desc_str) const;
+  void SetRegistered(const std::string& desc_str);
+
+  // guards the pool and the factory, lookups that miss the caches below
+  // take it as well
+  mutable std::mutex register_mutex_;
   std::unique_ptr<DescriptorPool> pool_ = nullptr;
   std::unique_ptr<DynamicMessageFactory> factory_ = nullptr;
 
+  // lock free caches keyed by the hash of the type name, entries are never
+  // removed as the pool keeps its types for good. A hit is confirmed by
+  // comparing the full name.
+  mutable base::ResizableAtomicHashMap<uint64_t,
+                                       const google::protobuf::Message*>
+      prototypes_;
+  mutable base::ResizableAtomicHashMap<uint64_t, const Descriptor*>
+      descriptors_;
+  // descriptor strings registered already, keyed by their hash
+  mutable base::ResizableAtomicHashMap<uint64_t, std::string> registered_;
+
   DECLARE_SINGLETON(ProtobufFactory);
 };
 
@@ -16,6 +16,7 @@
 
 #include "cyber/message/protobuf_factory.h"
 
+#include <memory>
 #include <string>
 
 #include "gtest/gtest.h"
@@ -77,6 +78,56 @@ TEST(ProtobufFactory, register_and_generate) {
   EXPECT_NE(nullptr, desc_ptr);
 }
 
+TEST(ProtobufFactory, prototype_cache) {
+  auto factory = ProtobufFactory::Instance();
+  auto prototype = factory->GetPrototype("apollo.cyber.proto.UnitTest");
+  EXPECT_EQ(&proto::UnitTest::default_instance(), prototype);
+  EXPECT_EQ(prototype, factory->GetPrototype("apollo.cyber.proto.UnitTest"));
+
+  // misses are not cached, the type may be registered later
+  const std::string type = "apollo.cyber.test.DynamicType";
+  EXPECT_EQ(nullptr, factory->GetPrototype(type));
+  EXPECT_EQ(nullptr, factory->FindMessageTypeByName(type));
+
+  google::protobuf::FileDescriptorProto file_desc_proto;
+  file_desc_proto.set_name("protobuf_factory_test_dynamic.proto");
+  file_desc_proto.set_package("apollo.cyber.test");
+  auto message_type = file_desc_proto.add_message_type();
+  message_type->set_name("DynamicType");
+  auto field = message_type->add_field();
+  field->set_name("value");
+  field->set_number(1);
+  field->set_label(google::protobuf::FieldDescriptorProto::LABEL_OPTIONAL);
+  field->set_type(google::protobuf::FieldDescriptorProto::TYPE_UINT64);
+  proto::ProtoDesc proto_desc;
+  file_desc_proto.SerializeToString(proto_desc.mutable_desc());
+  std::string proto_desc_str;
+  proto_desc.SerializeToString(&proto_desc_str);
+  EXPECT_TRUE(factory->RegisterMessage(proto_desc_str));
+  // registered already
+  EXPECT_TRUE(factory->RegisterMessage(proto_desc_str));
+
+  auto descriptor = factory->FindMessageTypeByName(type);
+  ASSERT_NE(nullptr, descriptor);
+  EXPECT_EQ(descriptor, factory->FindMessageTypeByName(type));
+  prototype = factory->GetPrototype(type);
+  ASSERT_NE(nullptr, prototype);
+  EXPECT_EQ(descriptor, prototype->GetDescriptor());
+  EXPECT_EQ(prototype, factory->GetPrototype(type));
+
+  std::unique_ptr<google::protobuf::Message> message(
+      factory->GenerateMessageByType(type));
+  ASSERT_NE(nullptr, message);
+  auto reflection = message->GetReflection();
+  reflection->SetUInt64(message.get(), descriptor->FindFieldByName("value"),
+                        42);
+  std::string str;
+  EXPECT_TRUE(message->SerializeToString(&str));
+  std::unique_ptr<google::protobuf::Message> parsed(prototype->New());
+  EXPECT_TRUE(parsed->ParseFromString(str));
+  EXPECT_EQ(message->DebugString(), parsed->DebugString());
+}
+
 }  // namespace message
 }  // namespace cyber
 }  // namespace apollo
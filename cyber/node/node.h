@@ -109,6 +109,21 @@ class Node {
                     const CallbackFunc<MessageT>& reader_func = nullptr)
       -> std::shared_ptr<cyber::Reader<MessageT>>;
 
+  /**
+   * @brief Create a Reader that hands pending messages to `batch_func` in
+   * batches, up to `config.max_batch_size` per call and oldest first. Under
+   * load this saves a scheduler wake up per message.
+   *
+   * @tparam MessageT Message Type
+   * @param config instance of `ReaderConfig`
+   * @param batch_func invoked with the messages received since its last call
+   * @return std::shared_ptr<cyber::Reader<MessageT>> result Reader Object
+   */
+  template <typename MessageT>
+  auto CreateBatchReader(const ReaderConfig& config,
+                         const BatchCallbackFunc<MessageT>& batch_func)
+      -> std::shared_ptr<cyber::Reader<MessageT>>;
+
   /**
    * @brief Create a Reader object with `RoleAttributes`
    *
@@ -138,6 +153,21 @@ class Node {
                          service_callback)
       -> std::shared_ptr<Service<Request, Response>>;
 
+  /**
+   * @brief Create a Service object with specific `config`
+   *
+   * @tparam Request Message Type of the Request
+   * @tparam Response Message Type of the Response
+   * @param config service name, execution mode and queue size
+   * @param service_callback invoked when a service is called
+   * @return std::shared_ptr<Service<Request, Response>> result `Service`
+   */
+  template <typename Request, typename Response>
+  auto CreateService(const ServiceConfig& config,
+                     const typename Service<Request, Response>::ServiceCallback&
+                         service_callback)
+      -> std::shared_ptr<Service<Request, Response>>;
+
   /**
    * @brief Create a Client object to request Service with `service_name`
    *
@@ -233,6 +263,24 @@ auto Node::CreateReader(const ReaderConfig& config,
   return reader;
 }
 
+template <typename MessageT>
+auto Node::CreateBatchReader(const ReaderConfig& config,
+                             const BatchCallbackFunc<MessageT>& batch_func)
+    -> std::shared_ptr<cyber::Reader<MessageT>> {
+  std::lock_guard<std::mutex> lg(readers_mutex_);
+  if (readers_.find(config.channel_name) != readers_.end()) {
+    AWARN << "Failed to create reader: reader with the same channel already "
+             "exists.";
+    return nullptr;
+  }
+  auto reader = node_channel_impl_->template CreateBatchReader<MessageT>(
+      config, batch_func);
+  if (reader != nullptr) {
+    readers_.emplace(std::make_pair(config.channel_name, reader));
+  }
+  return reader;
+}
+
 template <typename MessageT>
 auto Node::CreateReader(const std::string& channel_name,
                         const CallbackFunc<MessageT>& reader_func)
@@ -260,6 +308,15 @@ auto Node::CreateService(
       service_name, service_callback);
 }
 
+template <typename Request, typename Response>
+auto Node::CreateService(
+    const ServiceConfig& config,
+    const typename Service<Request, Response>::ServiceCallback&
+        service_callback) -> std::shared_ptr<Service<Request, Response>> {
+  return node_service_impl_->template CreateService<Request, Response>(
+      config, service_callback);
+}
+
 template <typename Request, typename Response>
 auto Node::CreateClient(const std::string& service_name)
     -> std::shared_ptr<Client<Request, Response>> {
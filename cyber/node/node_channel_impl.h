@@ -48,7 +48,9 @@ struct ReaderConfig {  ///< configurations for a Reader
   ReaderConfig(const ReaderConfig& other)
       : channel_name(other.channel_name),
         qos_profile(other.qos_profile),
-        pending_queue_size(other.pending_queue_size) {}
+        pending_queue_size(other.pending_queue_size),
+        delivery_mode(other.delivery_mode),
+        max_batch_size(other.max_batch_size) {}
 
   std::string channel_name;       //< channel reads
   proto::QosProfile qos_profile;  //< the qos configuration
@@ -57,6 +59,20 @@ struct ReaderConfig {  ///< configurations for a Reader
    * Older messages will dropped if you have no time to handle
    */
   uint32_t pending_queue_size;
+  /**
+   * @brief INLINE skips the scheduler for tiny latency critical callbacks,
+   * such as heartbeats. The callback then runs on the transport thread that
+   * delivers the message (shm dispatcher, rtps listener or the writer itself
+   * within a process) and holds up every other reader served by it. It must
+   * return quickly, must not block or wait on croutines, and is called by
+   * one thread at a time. pending_queue_size does not apply.
+   */
+  DeliveryMode delivery_mode = DeliveryMode::CROUTINE;
+  /**
+   * @brief messages handed to one call of a batch reader, 0 for up to
+   * pending_queue_size. Batch readers always run on croutines.
+   */
+  uint32_t max_batch_size = 0;
 };
 
 /**
@@ -129,10 +145,16 @@ class NodeChannelImpl {
                     const CallbackFunc<MessageT>& reader_func)
       -> std::shared_ptr<Reader<MessageT>>;
 
+  template <typename MessageT>
+  auto CreateBatchReader(const ReaderConfig& config,
+                         const BatchCallbackFunc<MessageT>& batch_func)
+      -> std::shared_ptr<Reader<MessageT>>;
+
   template <typename MessageT>
   auto CreateReader(const proto::RoleAttributes& role_attr,
                     const CallbackFunc<MessageT>& reader_func,
-                    uint32_t pending_queue_size = DEFAULT_PENDING_QUEUE_SIZE)
+                    uint32_t pending_queue_size = DEFAULT_PENDING_QUEUE_SIZE,
+                    DeliveryMode delivery_mode = DeliveryMode::CROUTINE)
       -> std::shared_ptr<Reader<MessageT>>;
 
   template <typename MessageT>
@@ -196,7 +218,38 @@ auto NodeChannelImpl::CreateReader(const ReaderConfig& config,
   role_attr.set_channel_name(config.channel_name);
   role_attr.mutable_qos_profile()->CopyFrom(config.qos_profile);
   return this->template CreateReader<MessageT>(role_attr, reader_func,
-                                               config.pending_queue_size);
+                                               config.pending_queue_size,
+                                               config.delivery_mode);
+}
+
+template <typename MessageT>
+auto NodeChannelImpl::CreateBatchReader(
+    const ReaderConfig& config, const BatchCallbackFunc<MessageT>& batch_func)
+    -> std::shared_ptr<Reader<MessageT>> {
+  if (config.channel_name.empty()) {
+    AERROR << "Can't create a reader with empty channel name!";
+    return nullptr;
+  }
+
+  proto::RoleAttributes new_attr;
+  new_attr.set_channel_name(config.channel_name);
+  new_attr.mutable_qos_profile()->CopyFrom(config.qos_profile);
+  FillInAttr<MessageT>(&new_attr);
+
+  std::shared_ptr<Reader<MessageT>> reader_ptr = nullptr;
+  if (!is_reality_mode_) {
+    // published messages arrive one at a time anyway
+    reader_ptr = std::make_shared<blocker::IntraReader<MessageT>>(
+        new_attr, [batch_func](const std::shared_ptr<MessageT>& msg) {
+          batch_func({msg});
+        });
+  } else {
+    reader_ptr = std::make_shared<Reader<MessageT>>(
+        new_attr, batch_func, config.pending_queue_size,
+        config.max_batch_size);
+  }
+  RETURN_VAL_IF(!reader_ptr->Init(), nullptr);
+  return reader_ptr;
 }
 
 // 二进制方式创建reader时，reader_func != nullptr
@@ -204,7 +257,8 @@ auto NodeChannelImpl::CreateReader(const ReaderConfig& config,
 template <typename MessageT>
 auto NodeChannelImpl::CreateReader(const proto::RoleAttributes& role_attr,
                                    const CallbackFunc<MessageT>& reader_func,
-                                   uint32_t pending_queue_size)
+                                   uint32_t pending_queue_size,
+                                   DeliveryMode delivery_mode)
     -> std::shared_ptr<Reader<MessageT>> {
   if (!role_attr.has_channel_name() || role_attr.channel_name().empty()) {
     AERROR << "Can't create a reader with empty channel name!";
@@ -216,11 +270,12 @@ auto NodeChannelImpl::CreateReader(const proto::RoleAttributes& role_attr,
 
   std::shared_ptr<Reader<MessageT>> reader_ptr = nullptr;
   if (!is_reality_mode_) {
+    // the blocker calls back on the publishing thread in any case
     reader_ptr =
         std::make_shared<blocker::IntraReader<MessageT>>(new_attr, reader_func);
   } else {
-    reader_ptr = std::make_shared<Reader<MessageT>>(new_attr, reader_func,
-                                                    pending_queue_size);
+    reader_ptr = std::make_shared<Reader<MessageT>>(
+        new_attr, reader_func, pending_queue_size, delivery_mode);
   }
 
   RETURN_VAL_IF_NULL(reader_ptr, nullptr);
@@ -72,6 +72,12 @@ class NodeServiceImpl {
                          service_callback) ->
       typename std::shared_ptr<Service<Request, Response>>;
 
+  template <typename Request, typename Response>
+  auto CreateService(const ServiceConfig& config,
+                     const typename Service<Request, Response>::ServiceCallback&
+                         service_callback) ->
+      typename std::shared_ptr<Service<Request, Response>>;
+
   template <typename Request, typename Response>
   auto CreateClient(const std::string& service_name) ->
       typename std::shared_ptr<Client<Request, Response>>;
@@ -88,13 +94,24 @@ auto NodeServiceImpl::CreateService(
     const typename Service<Request, Response>::ServiceCallback&
         service_callback) ->
     typename std::shared_ptr<Service<Request, Response>> {
+  ServiceConfig config;
+  config.service_name = service_name;
+  return CreateService<Request, Response>(config, service_callback);
+}
+
+template <typename Request, typename Response>
+auto NodeServiceImpl::CreateService(
+    const ServiceConfig& config,
+    const typename Service<Request, Response>::ServiceCallback&
+        service_callback) ->
+    typename std::shared_ptr<Service<Request, Response>> {
   auto service_ptr = std::make_shared<Service<Request, Response>>(
-      node_name_, service_name, service_callback);
+      node_name_, config, service_callback);
   RETURN_VAL_IF(!service_ptr->Init(), nullptr);
 
   service_list_.emplace_back(service_ptr);
-  attr_.set_service_name(service_name);
-  auto service_id = common::GlobalData::RegisterService(service_name);
+  attr_.set_service_name(config.service_name);
+  auto service_id = common::GlobalData::RegisterService(config.service_name);
   attr_.set_service_id(service_id);
   service_discovery::TopologyManager::Instance()->service_manager()->Join(
       attr_, RoleType::ROLE_SERVER);
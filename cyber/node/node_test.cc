@@ -16,6 +16,11 @@
 
 #include "cyber/node/node.h"
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "cyber/proto/unit_test.pb.h"
@@ -64,6 +69,119 @@ TEST(NodeTest, cases) {
   node->ClearData();
 }
 
+TEST(NodeTest, service_config) {
+  auto node = CreateNode("node_service_config_test");
+  auto callback = [](const std::shared_ptr<Chatter>& request,
+                     std::shared_ptr<Chatter>& response) {
+    response->set_seq(request->seq() + 1);
+  };
+  for (auto mode : {ServiceConfig::CROUTINE, ServiceConfig::INLINE}) {
+    ServiceConfig config;
+    config.service_name =
+        "node_service_config_test_" + std::to_string(static_cast<int>(mode));
+    config.execution_mode = mode;
+    config.worker_num = 2;
+    auto server = node->CreateService<Chatter, Chatter>(config, callback);
+    ASSERT_NE(nullptr, server);
+    auto client = node->CreateClient<Chatter, Chatter>(config.service_name);
+    auto request = std::make_shared<Chatter>();
+    for (uint64_t i = 0; i < 10; ++i) {
+      request->set_seq(i);
+      auto res = client->SendRequest(request);
+      ASSERT_NE(nullptr, res);
+      EXPECT_EQ(i + 1, res->seq());
+    }
+    auto stats = server->Stats();
+    EXPECT_EQ(10, stats.received);
+    EXPECT_EQ(0, stats.rejected);
+  }
+}
+
+TEST(NodeTest, service_rejects_when_full) {
+  auto node = CreateNode("node_service_reject_test");
+  std::atomic<bool> release = {false};
+  ServiceConfig config;
+  config.service_name = "node_service_reject_test";
+  config.queue_size = 1;
+  auto server = node->CreateService<Chatter, Chatter>(
+      config, [&release](const std::shared_ptr<Chatter>& request,
+                         std::shared_ptr<Chatter>& response) {
+        while (!release.load()) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        response->set_seq(request->seq() + 1);
+      });
+  ASSERT_NE(nullptr, server);
+  auto client = node->CreateClient<Chatter, Chatter>(config.service_name);
+  std::vector<std::shared_ptr<Chatter>> requests;
+  for (uint64_t i = 0; i < 8; ++i) {
+    requests.emplace_back(std::make_shared<Chatter>());
+    requests.back()->set_seq(i);
+  }
+  // one request runs and at most one waits in the queue, the others are
+  // turned down long before their deadline
+  auto futures = client->AsyncSendRequests(requests);
+  for (int i = 0; i < 2000 && client->Stats().rejected < 6; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  auto rejected = client->Stats().rejected;
+  EXPECT_LE(6, rejected);
+  release = true;
+  uint64_t answered = 0;
+  for (auto& future : futures) {
+    if (future.get() != nullptr) {
+      ++answered;
+    }
+  }
+  EXPECT_EQ(requests.size() - rejected, answered);
+  auto stats = client->Stats();
+  EXPECT_EQ(rejected, stats.rejected);
+  EXPECT_EQ(stats.rejected, server->Stats().rejected);
+  EXPECT_EQ(0, stats.expired);
+}
+
+TEST(NodeTest, client_pipeline) {
+  auto node = CreateNode("node_client_pipeline_test");
+  auto server = node->CreateService<Chatter, Chatter>(
+      "node_client_pipeline_test",
+      [](const std::shared_ptr<Chatter>& request,
+         std::shared_ptr<Chatter>& response) {
+        response->set_seq(request->seq() + 1);
+      });
+  auto client =
+      node->CreateClient<Chatter, Chatter>("node_client_pipeline_test");
+  std::vector<std::shared_ptr<Chatter>> requests;
+  for (uint64_t i = 0; i < 16; ++i) {
+    requests.emplace_back(std::make_shared<Chatter>());
+    requests.back()->set_seq(i);
+  }
+  auto futures = client->AsyncSendRequests(requests);
+  ASSERT_EQ(requests.size(), futures.size());
+  for (uint64_t i = 0; i < futures.size(); ++i) {
+    auto res = futures[i].get();
+    ASSERT_NE(nullptr, res);
+    EXPECT_EQ(i + 1, res->seq());
+  }
+  auto stats = client->Stats();
+  EXPECT_EQ(16, stats.sent);
+  EXPECT_EQ(16, stats.completed);
+  EXPECT_EQ(0, stats.in_flight);
+
+  // nobody answers, the request expires instead of staying pending
+  auto orphan =
+      node->CreateClient<Chatter, Chatter>("node_client_pipeline_none");
+  bool called = false;
+  auto future = orphan->AsyncSendRequest(
+      requests.front(),
+      [&called](Client<Chatter, Chatter>::SharedFuture) { called = true; },
+      std::chrono::milliseconds(20));
+  EXPECT_EQ(nullptr, future.get());
+  EXPECT_TRUE(called);
+  stats = orphan->Stats();
+  EXPECT_EQ(1, stats.expired);
+  EXPECT_EQ(0, stats.in_flight);
+}
+
 }  // namespace cyber
 }  // namespace apollo
 
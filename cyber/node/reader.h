@@ -18,7 +18,6 @@
 #define CYBER_NODE_READER_H_
 
 #include <algorithm>
-#include <list>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -44,10 +43,22 @@ namespace cyber {
 template <typename M0>
 using CallbackFunc = std::function<void(const std::shared_ptr<M0>&)>;
 
+template <typename M0>
+using BatchCallbackFunc =
+    std::function<void(const std::vector<std::shared_ptr<M0>>&)>;
+
 using proto::RoleType;
 
 const uint32_t DEFAULT_PENDING_QUEUE_SIZE = 1;
 
+/**
+ * @brief Where the callback of a Reader runs
+ */
+enum class DeliveryMode {
+  CROUTINE = 0,  ///< a croutine on the cyber scheduler
+  INLINE,        ///< the transport thread the message arrives on
+};
+
 /**
  * @class Reader
  * @brief Reader subscribes a channel, it has two main functions:
@@ -71,8 +82,7 @@ class Reader : public ReaderBase {
   using ReceiverPtr = std::shared_ptr<transport::Receiver<MessageT>>;
   using ChangeConnection =
       typename service_discovery::Manager::ChangeConnection;
-  using Iterator =
-      typename std::list<std::shared_ptr<MessageT>>::const_iterator;
+  using Iterator = typename blocker::Blocker<MessageT>::Iterator;
 
   /**
    * Constructor a Reader object.
@@ -80,12 +90,26 @@ class Reader : public ReaderBase {
    * channel name and other info.
    * @param reader_func is the callback function, when the message is received.
    * @param pending_queue_size is the max depth of message cache queue.
+   * @param delivery_mode where reader_func runs, see `ReaderConfig`
    * @warning the received messages is enqueue a queue,the queue's depth is
    * pending_queue_size
    */
   explicit Reader(const proto::RoleAttributes& role_attr,
                   const CallbackFunc<MessageT>& reader_func = nullptr,
-                  uint32_t pending_queue_size = DEFAULT_PENDING_QUEUE_SIZE);
+                  uint32_t pending_queue_size = DEFAULT_PENDING_QUEUE_SIZE,
+                  DeliveryMode delivery_mode = DeliveryMode::CROUTINE);
+
+  /**
+   * Constructor a Reader object that handles messages in batches.
+   * @param batch_func is called with the messages pending since its last
+   * call, oldest first, on a croutine.
+   * @param pending_queue_size is the max depth of message cache queue.
+   * @param max_batch_size limits the messages of one call, 0 for up to
+   * pending_queue_size.
+   */
+  Reader(const proto::RoleAttributes& role_attr,
+         const BatchCallbackFunc<MessageT>& batch_func,
+         uint32_t pending_queue_size, uint32_t max_batch_size);
   virtual ~Reader();
 
   /**
@@ -217,8 +241,12 @@ class Reader : public ReaderBase {
   void OnChannelChange(const proto::ChangeMsg& change_msg);
 
   CallbackFunc<MessageT> reader_func_;
+  BatchCallbackFunc<MessageT> batch_func_;
+  uint32_t max_batch_size_ = 0;
   ReceiverPtr receiver_ = nullptr;
   std::string croutine_name_;
+  DeliveryMode delivery_mode_;
+  uint64_t inline_callback_id_ = 0;
 
   BlockerPtr blocker_ = nullptr;
 
@@ -229,14 +257,27 @@ class Reader : public ReaderBase {
 template <typename MessageT>
 Reader<MessageT>::Reader(const proto::RoleAttributes& role_attr,
                          const CallbackFunc<MessageT>& reader_func,
-                         uint32_t pending_queue_size)
+                         uint32_t pending_queue_size,
+                         DeliveryMode delivery_mode)
     : ReaderBase(role_attr),
       pending_queue_size_(pending_queue_size),
-      reader_func_(reader_func) {
+      reader_func_(reader_func),
+      delivery_mode_(delivery_mode) {
   blocker_.reset(new blocker::Blocker<MessageT>(blocker::BlockerAttr(
       role_attr.qos_profile().depth(), role_attr.channel_name())));
 }
 
+template <typename MessageT>
+Reader<MessageT>::Reader(const proto::RoleAttributes& role_attr,
+                         const BatchCallbackFunc<MessageT>& batch_func,
+                         uint32_t pending_queue_size, uint32_t max_batch_size)
+    : Reader(role_attr, nullptr, pending_queue_size) {
+  batch_func_ = batch_func;
+  max_batch_size_ = max_batch_size == 0
+                        ? pending_queue_size
+                        : std::min(max_batch_size, pending_queue_size);
+}
+
 template <typename MessageT>
 Reader<MessageT>::~Reader() {
   Shutdown();
@@ -273,24 +314,48 @@ bool Reader<MessageT>::Init() {
     // component方式的协程任务入口点函数
     func = [this](const std::shared_ptr<MessageT>& msg) { this->Enqueue(msg); };
   }
-  auto sched = scheduler::Instance();
-  croutine_name_ = role_attr_.node_name() + "_" + role_attr_.channel_name();
-  auto dv = std::make_shared<data::DataVisitor<MessageT>>(
-      role_attr_.channel_id(), pending_queue_size_);
-  // Using factory to wrap templates.
-  croutine::RoutineFactory factory =
-      croutine::CreateRoutineFactory<MessageT>(std::move(func), dv);
-  // 二进制方式的通信用这个task
-  // componet方式通信不用这个task，用名为nodename的task! 这个task将收到的数据缓存（enqueue到Blocker的published_queue中）
-  if (!sched->CreateTask(factory, croutine_name_)) {
-    AERROR << "Create Task Failed!";
-    init_.store(false);
-    return false;
+  if (delivery_mode_ == DeliveryMode::INLINE) {
+    // no croutine, the dispatching transport thread calls func directly
+    inline_callback_id_ =
+        data::DataDispatcher<MessageT>::Instance()->AddInlineCallback(
+            role_attr_.channel_id(), func);
+  } else {
+    auto sched = scheduler::Instance();
+    croutine_name_ = role_attr_.node_name() + "_" + role_attr_.channel_name();
+    auto dv = std::make_shared<data::DataVisitor<MessageT>>(
+        role_attr_.channel_id(), pending_queue_size_);
+    // Using factory to wrap templates.
+    croutine::RoutineFactory factory;
+    if (batch_func_ != nullptr) {
+      auto batch_func =
+          [this](const std::vector<std::shared_ptr<MessageT>>& msgs) {
+            for (const auto& msg : msgs) {
+              this->Enqueue(msg);
+            }
+            this->batch_func_(msgs);
+          };
+      factory = croutine::CreateBatchRoutineFactory<MessageT>(
+          std::move(batch_func), dv, std::max(max_batch_size_, 1u));
+    } else {
+      factory = croutine::CreateRoutineFactory<MessageT>(std::move(func), dv);
+    }
+    // 二进制方式的通信用这个task
+    // componet方式通信不用这个task，用名为nodename的task! 这个task将收到的数据缓存（enqueue到Blocker的published_queue中）
+    if (!sched->CreateTask(factory, croutine_name_)) {
+      AERROR << "Create Task Failed!";
+      init_.store(false);
+      return false;
+    }
   }
 
   // 创建Receiver(将DataDispathcer::Dispatch()接口注册给Receiver)
   receiver_ = ReceiverManager<MessageT>::Instance()->GetReceiver(role_attr_);
   this->role_attr_.set_id(receiver_->id().HashValue());
+  if (receiver_->attributes().has_socket_addr()) {
+    // writers on other hosts connect to it
+    this->role_attr_.mutable_socket_addr()->CopyFrom(
+        receiver_->attributes().socket_addr());
+  }
   channel_manager_ =
       service_discovery::TopologyManager::Instance()->channel_manager();
   JoinTheTopology();
@@ -310,6 +375,11 @@ void Reader<MessageT>::Shutdown() {
   if (!croutine_name_.empty()) {
     scheduler::Instance()->RemoveTask(croutine_name_);
   }
+  if (inline_callback_id_ != 0) {
+    data::DataDispatcher<MessageT>::Instance()->RemoveInlineCallback(
+        role_attr_.channel_id(), inline_callback_id_);
+    inline_callback_id_ = 0;
+  }
 }
 
 template <typename MessageT>
@@ -204,13 +204,19 @@ auto ReceiverManager<MessageT>::GetReceiver(
   // so reader for datacache we use map to keep one instance for per channel
   const std::string& channel_name = role_attr.channel_name();
   if (receiver_map_.count(channel_name) == 0) {
+    transport::ChannelStats::Slot* stats_slot = nullptr;
+    auto stats = transport::ChannelStats::Instance();
+    if (stats != nullptr) {
+      stats_slot = stats->GetSlot(role_attr.channel_id(), channel_name);
+    }
     receiver_map_[channel_name] =
         transport::Transport::Instance()->CreateReceiver<MessageT>(
-            role_attr, [](const std::shared_ptr<MessageT>& msg,
-                          const transport::MessageInfo& msg_info,
-                          const proto::RoleAttributes& reader_attr) {
+            role_attr, [stats_slot](const std::shared_ptr<MessageT>& msg,
+                                    const transport::MessageInfo& msg_info,
+                                    const proto::RoleAttributes& reader_attr) {
               (void)msg_info;
               (void)reader_attr;
+              transport::ChannelStats::OnReceive(stats_slot);
               PerfEventCache::Instance()->AddTransportEvent(
                   TransPerf::DISPATCH, reader_attr.channel_id(),
                   msg_info.seq_num());
@@ -14,6 +14,8 @@
  * limitations under the License.
  *****************************************************************************/
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <thread>
@@ -164,6 +166,95 @@ TEST(WriterReaderTest, messaging) {
   reader_b.Shutdown();
 }
 
+TEST(WriterReaderTest, inline_delivery) {
+  proto::RoleAttributes attr;
+  attr.set_node_name("writer");
+  attr.set_channel_name("inline_delivery");
+  auto channel_id = common::GlobalData::RegisterChannel(attr.channel_name());
+  attr.set_channel_id(channel_id);
+
+  Writer<proto::UnitTest> writer(attr);
+  EXPECT_TRUE(writer.Init());
+
+  std::atomic<int> received = {0};
+  std::atomic<bool> in_croutine = {false};
+  attr.set_node_name("reader");
+  Reader<proto::UnitTest> reader(
+      attr,
+      [&](const std::shared_ptr<proto::UnitTest>& msg) {
+        if (croutine::CRoutine::GetCurrentRoutine() != nullptr) {
+          in_croutine = true;
+        }
+        ++received;
+      },
+      DEFAULT_PENDING_QUEUE_SIZE, DeliveryMode::INLINE);
+  EXPECT_TRUE(reader.Init());
+
+  auto msg = std::make_shared<proto::UnitTest>();
+  msg->set_class_name("WriterReaderTest");
+  msg->set_case_name("inline_delivery");
+  writer.Write(msg);
+  writer.Write(msg);
+  std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(500));
+
+  EXPECT_EQ(2, received.load());
+  EXPECT_FALSE(in_croutine.load());
+  reader.Observe();
+  EXPECT_FALSE(reader.Empty());
+
+  // no more calls once shut down
+  reader.Shutdown();
+  writer.Write(msg);
+  std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(100));
+  EXPECT_EQ(2, received.load());
+  writer.Shutdown();
+}
+
+TEST(WriterReaderTest, batch_delivery) {
+  proto::RoleAttributes attr;
+  attr.set_node_name("writer");
+  attr.set_channel_name("batch_delivery");
+  auto channel_id = common::GlobalData::RegisterChannel(attr.channel_name());
+  attr.set_channel_id(channel_id);
+
+  Writer<proto::UnitTest> writer(attr);
+  EXPECT_TRUE(writer.Init());
+
+  std::mutex mtx;
+  std::vector<int> recv_seqs;
+  size_t max_batch = 0;
+  attr.set_node_name("reader");
+  Reader<proto::UnitTest> reader(
+      attr,
+      [&](const std::vector<std::shared_ptr<proto::UnitTest>>& msgs) {
+        std::lock_guard<std::mutex> lck(mtx);
+        max_batch = std::max(max_batch, msgs.size());
+        for (const auto& msg : msgs) {
+          recv_seqs.push_back(std::stoi(msg->case_name()));
+        }
+      },
+      10, 4);
+  EXPECT_TRUE(reader.Init());
+
+  for (int i = 0; i < 20; ++i) {
+    auto msg = std::make_shared<proto::UnitTest>();
+    msg->set_class_name("WriterReaderTest");
+    msg->set_case_name(std::to_string(i));
+    writer.Write(msg);
+  }
+  std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(500));
+
+  std::lock_guard<std::mutex> lck(mtx);
+  ASSERT_FALSE(recv_seqs.empty());
+  EXPECT_LE(max_batch, 4);
+  EXPECT_EQ(19, recv_seqs.back());
+  EXPECT_TRUE(std::is_sorted(recv_seqs.begin(), recv_seqs.end()));
+  reader.Observe();
+  EXPECT_FALSE(reader.Empty());
+  reader.Shutdown();
+  writer.Shutdown();
+}
+
 TEST(WriterReaderTest, observe) {
   proto::RoleAttributes attr;
   attr.set_node_name("node");
@@ -23,6 +23,7 @@
 using apollo::cyber::Node;
 using apollo::cyber::PyChannelUtils;
 using apollo::cyber::PyClient;
+using apollo::cyber::PyMessageQueue;
 using apollo::cyber::PyNode;
 using apollo::cyber::PyReader;
 using apollo::cyber::PyService;
@@ -99,6 +100,52 @@ T PyObjectToPtr(PyObject *pyobj, const std::string &type_ptr) {
   return obj_ptr;
 }
 
+// Read-only buffer over a received message, keeps the message alive for as
+// long as python holds a memoryview of it.
+struct PyMessageBuffer {
+  PyObject_HEAD
+  PyReader::MessagePtr *msg;
+};
+
+static int message_buffer_getbuffer(PyObject *self, Py_buffer *view,
+                                    int flags) {
+  const auto &msg = *reinterpret_cast<PyMessageBuffer *>(self)->msg;
+  return PyBuffer_FillInfo(view, self, const_cast<char *>(msg->data()),
+                           msg->size(), 1, flags);
+}
+
+static void message_buffer_dealloc(PyObject *self) {
+  delete reinterpret_cast<PyMessageBuffer *>(self)->msg;
+  Py_TYPE(self)->tp_free(self);
+}
+
+static PyBufferProcs message_buffer_procs;
+static PyTypeObject message_buffer_type = {PyVarObject_HEAD_INIT(nullptr, 0)};
+
+static bool InitMessageBufferType() {
+  message_buffer_procs.bf_getbuffer = message_buffer_getbuffer;
+  message_buffer_type.tp_name = "cyber.MessageBuffer";
+  message_buffer_type.tp_basicsize = sizeof(PyMessageBuffer);
+  message_buffer_type.tp_dealloc = message_buffer_dealloc;
+  message_buffer_type.tp_as_buffer = &message_buffer_procs;
+  message_buffer_type.tp_flags = Py_TPFLAGS_DEFAULT;
+#if PY_MAJOR_VERSION < 3
+  message_buffer_type.tp_flags |= Py_TPFLAGS_HAVE_NEWBUFFER;
+#endif
+  return PyType_Ready(&message_buffer_type) == 0;
+}
+
+static PyObject *MessageToMemoryView(const PyReader::MessagePtr &msg) {
+  auto buffer = PyObject_New(PyMessageBuffer, &message_buffer_type);
+  if (buffer == nullptr) {
+    return nullptr;
+  }
+  buffer->msg = new PyReader::MessagePtr(msg);
+  auto view = PyMemoryView_FromObject(reinterpret_cast<PyObject *>(buffer));
+  Py_DECREF(buffer);
+  return view;
+}
+
 PyObject *cyber_new_PyWriter(PyObject *self, PyObject *args) {
   char *channel_name = nullptr;
   char *data_type = nullptr;
@@ -236,6 +283,69 @@ PyObject *cyber_PyReader_read(PyObject *self, PyObject *args) {
   return C_STR_TO_PY_BYTES(reader_ret);
 }
 
+PyObject *cyber_PyReader_read_batch(PyObject *self, PyObject *args) {
+  PyObject *pyobj_reader = nullptr;
+  unsigned int max_num = 0;
+  int timeout_ms = 0;
+  PyObject *pyobj_memoryview = nullptr;
+
+  if (!PyArg_ParseTuple(args,
+                        const_cast<char *>("OIiO:cyber_PyReader_read_batch"),
+                        &pyobj_reader, &max_num, &timeout_ms,
+                        &pyobj_memoryview)) {
+    AERROR << "cyber_PyReader_read_batch:PyArg_ParseTuple failed!";
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+  PyReader *reader =
+      PyObjectToPtr<PyReader *>(pyobj_reader, "apollo_cyber_pyreader");
+  if (nullptr == reader) {
+    AERROR << "cyber_PyReader_read_batch:PyReader ptr is null!";
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+  bool as_memoryview = PyObject_IsTrue(pyobj_memoryview) == 1;
+
+  std::vector<PyReader::MessagePtr> msgs;
+  // the callbacks of other readers need the GIL while we wait
+  Py_BEGIN_ALLOW_THREADS
+  msgs = reader->read_batch(max_num, timeout_ms);
+  Py_END_ALLOW_THREADS
+
+  PyObject *pyobj_list = PyList_New(msgs.size());
+  if (pyobj_list == nullptr) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < msgs.size(); ++i) {
+    PyObject *item = as_memoryview ? MessageToMemoryView(msgs[i])
+                                   : C_STR_TO_PY_BYTES((*msgs[i]));
+    if (item == nullptr) {
+      Py_DECREF(pyobj_list);
+      return nullptr;
+    }
+    PyList_SetItem(pyobj_list, i, item);
+  }
+  return pyobj_list;
+}
+
+PyObject *cyber_PyReader_dropped(PyObject *self, PyObject *args) {
+  PyObject *pyobj_reader = nullptr;
+  if (!PyArg_ParseTuple(args, const_cast<char *>("O:cyber_PyReader_dropped"),
+                        &pyobj_reader)) {
+    AERROR << "cyber_PyReader_dropped:PyArg_ParseTuple failed!";
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+  PyReader *reader =
+      PyObjectToPtr<PyReader *>(pyobj_reader, "apollo_cyber_pyreader");
+  if (nullptr == reader) {
+    AERROR << "cyber_PyReader_dropped:PyReader ptr is null!";
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+  return PyLong_FromUnsignedLongLong(reader->dropped());
+}
+
 PyObject *cyber_PyReader_register_func(PyObject *self, PyObject *args) {
   PyObject *pyobj_regist_fun = nullptr;
   PyObject *pyobj_reader = nullptr;
@@ -498,9 +608,12 @@ PyObject *cyber_PyNode_create_reader(PyObject *self, PyObject *args) {
   char *channel_name = nullptr;
   char *type_name = nullptr;
   PyObject *pyobj_node = nullptr;
+  unsigned int cache_size = PyReader::kDefaultCacheSize;
+  int drop_policy = PyMessageQueue::DROP_OLDEST;
 
-  if (!PyArg_ParseTuple(args, const_cast<char *>("Oss:PyNode_create_reader"),
-                        &pyobj_node, &channel_name, &type_name)) {
+  if (!PyArg_ParseTuple(args, const_cast<char *>("Oss|Ii:PyNode_create_reader"),
+                        &pyobj_node, &channel_name, &type_name, &cache_size,
+                        &drop_policy)) {
     AERROR << "PyNode_create_reader:PyArg_ParseTuple failed!";
     Py_INCREF(Py_None);
     return Py_None;
@@ -513,8 +626,12 @@ PyObject *cyber_PyNode_create_reader(PyObject *self, PyObject *args) {
     return Py_None;
   }
 
+  auto policy = drop_policy == PyMessageQueue::DROP_NEWEST
+                    ? PyMessageQueue::DROP_NEWEST
+                    : PyMessageQueue::DROP_OLDEST;
   PyReader *reader = reinterpret_cast<PyReader *>((node->create_reader(
-      (std::string const &)channel_name, (std::string const &)type_name)));
+      (std::string const &)channel_name, (std::string const &)type_name,
+      cache_size, policy)));
   CHECK(reader) << "PyReader is NULL!";
 
   PyObject *pyobj_reader =
@@ -855,6 +972,8 @@ static PyMethodDef _cyber_methods[] = {
     {"delete_PyReader", cyber_delete_PyReader, METH_VARARGS, ""},
     {"PyReader_register_func", cyber_PyReader_register_func, METH_VARARGS, ""},
     {"PyReader_read", cyber_PyReader_read, METH_VARARGS, ""},
+    {"PyReader_read_batch", cyber_PyReader_read_batch, METH_VARARGS, ""},
+    {"PyReader_dropped", cyber_PyReader_dropped, METH_VARARGS, ""},
 
     // PyClient fun
     {"new_PyClient", cyber_new_PyClient, METH_VARARGS, ""},
@@ -920,8 +1039,16 @@ PyMODINIT_FUNC PyInit__cyber_py3(void) {
       nullptr,
   };
 
+  if (!InitMessageBufferType()) {
+    return nullptr;
+  }
   return PyModule_Create(&module_def);
 }
 #else
-PyMODINIT_FUNC init_cyber(void) { Py_InitModule("_cyber", _cyber_methods); }
+PyMODINIT_FUNC init_cyber(void) {
+  if (!InitMessageBufferType()) {
+    return;
+  }
+  Py_InitModule("_cyber", _cyber_methods);
+}
 #endif
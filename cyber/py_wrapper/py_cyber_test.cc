@@ -18,6 +18,8 @@
 
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -47,6 +49,46 @@ TEST(PyCyberTest, create_reader) {
   });
 }
 
+TEST(PyCyberTest, message_queue) {
+  using MessagePtr = PyMessageQueue::MessagePtr;
+  std::vector<MessagePtr> msgs;
+  for (int i = 0; i < 5; ++i) {
+    msgs.emplace_back(std::make_shared<std::string>(std::to_string(i)));
+  }
+
+  PyMessageQueue oldest(3, PyMessageQueue::DROP_OLDEST);
+  for (const auto& msg : msgs) {
+    EXPECT_TRUE(oldest.Push(msg));
+  }
+  EXPECT_EQ(3, oldest.Size());
+  EXPECT_EQ(2, oldest.Dropped());
+  std::vector<MessagePtr> out;
+  EXPECT_EQ(2, oldest.Pop(2, 0, &out));
+  EXPECT_EQ(1, oldest.Pop(10, 0, &out));
+  ASSERT_EQ(3, out.size());
+  EXPECT_EQ("2", *out[0]);
+  EXPECT_EQ("4", *out[2]);
+  // the queue shares the message, no copy is made
+  EXPECT_EQ(msgs[2].get(), out[0].get());
+
+  PyMessageQueue newest(3, PyMessageQueue::DROP_NEWEST);
+  for (size_t i = 0; i < msgs.size(); ++i) {
+    EXPECT_EQ(i < 3, newest.Push(msgs[i]));
+  }
+  out.clear();
+  EXPECT_EQ(3, newest.Pop(10, 0, &out));
+  EXPECT_EQ("0", *out[0]);
+  EXPECT_EQ("2", *out[2]);
+  EXPECT_EQ(2, newest.Dropped());
+
+  // times out empty, wakes up on push
+  out.clear();
+  EXPECT_EQ(0, newest.Pop(10, 10, &out));
+  std::thread producer([&]() { newest.Push(msgs[0]); });
+  EXPECT_EQ(1, newest.Pop(10, -1, &out));
+  producer.join();
+}
+
 TEST(PyCyberTest, create_writer) {
   EXPECT_TRUE(OK());
   auto msgChat = std::make_shared<proto::Chatter>();
@@ -122,6 +122,37 @@ class Reader(object):
         self.reader = reader
         self.data_type = data_type
 
+    ##
+    # @brief take up to max_num cached messages with one call.
+    #
+    # @param max_num is the most messages to return.
+    # @param timeout_ms is how long to wait for the first message, forever if
+    # negative.
+    # @param raw returns the serialized messages instead of parsing them.
+    # @param zero_copy returns read-only memoryviews of the received buffers
+    # instead of bytes, implies raw.
+    #
+    # @return list of messages, empty on timeout.
+    def read_batch(self, max_num, timeout_ms=0, raw=False, zero_copy=False):
+        """
+        read cached messages in a batch
+        """
+        msgs = _CYBER.PyReader_read_batch(self.reader, max_num, timeout_ms,
+                                          zero_copy)
+        if raw or zero_copy or self.data_type == "RawData":
+            return msgs
+        protos = []
+        for msg_str in msgs:
+            proto = self.data_type()
+            proto.ParseFromString(msg_str)
+            protos.append(proto)
+        return protos
+
+    ##
+    # @brief messages dropped because the cache was full.
+    def dropped(self):
+        return _CYBER.PyReader_dropped(self.reader)
+
 
 class Client(object):
 
@@ -244,9 +275,14 @@ class Node(object):
     # args is set, the function must accept the args as a second argument,
     # i.e. fn(data, args)
     # @param args additional arguments to pass to the callback
-    #
-    # @return return the writer object.
-    def create_reader(self, name, data_type, callback, args=None):
+    # @param cache_size is the most messages kept for python.
+    # @param drop_oldest overwrites the oldest message of a full cache,
+    # otherwise new messages are dropped.
+    # Without callback the messages are fetched with Reader.read_batch.
+    #
+    # @return return the reader object.
+    def create_reader(self, name, data_type, callback, args=None,
+                      cache_size=1000, drop_oldest=True):
         """
         create a channel reader for receive message from another channel.
         """
@@ -258,7 +294,8 @@ class Node(object):
 
         # datatype = data_type.DESCRIPTOR.full_name
         reader = _CYBER.PyNode_create_reader(
-            self.node, name, str(data_type))
+            self.node, name, str(data_type), cache_size,
+            0 if drop_oldest else 1)
         if reader is None:
             return None
         self.list_reader.append(reader)
@@ -267,6 +304,8 @@ class Node(object):
         self.mutex.acquire()
         self.subs[name] = sub
         self.mutex.release()
+        if callback is None:
+            return Reader(name, reader, data_type)
         fun_reader_cb = PY_CALLBACK_TYPE(self.reader_callback)
         self.callbacks[name] = fun_reader_cb
         f_ptr = ctypes.cast(self.callbacks[name], ctypes.c_void_p).value
@@ -274,11 +313,13 @@ class Node(object):
 
         return Reader(name, reader, data_type)
 
-    def create_rawdata_reader(self, name, callback, args=None):
+    def create_rawdata_reader(self, name, callback, args=None,
+                              cache_size=1000, drop_oldest=True):
         """
         Create RawData reader:listener RawMessage
         """
-        return self.create_reader(name, "RawData", callback, args)
+        return self.create_reader(name, "RawData", callback, args,
+                                  cache_size, drop_oldest)
 
     ##
     # @brief create client for the c/s.
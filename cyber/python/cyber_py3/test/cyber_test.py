@@ -70,6 +70,39 @@ class TestCyber(unittest.TestCase):
         time.sleep(0.1)
 
 
+    def test_read_batch(self):
+        """
+        Unit test of batch read from a bounded cache.
+        """
+        self.assertTrue(cyber.ok())
+        reader_node = cyber.Node("batch_listener")
+        reader = reader_node.create_reader("channel/batch_chatter",
+                                           SimpleMessage, None,
+                                           cache_size=4)
+        writer_node = cyber.Node("batch_writer")
+        writer = writer_node.create_writer("channel/batch_chatter",
+                                           SimpleMessage, 10)
+        msg = SimpleMessage()
+        for i in range(10):
+            msg.integer = i
+            writer.write(msg)
+
+        # Wait for all of them to arrive, the oldest are overwritten.
+        time.sleep(0.1)
+        self.assertEqual(reader.read_batch(0), [])
+        msgs = reader.read_batch(10, timeout_ms=100)
+        self.assertEqual(len(msgs), 4)
+        self.assertEqual(msgs[-1].integer, 9)
+        self.assertEqual(reader.dropped(), 6)
+
+        msg.integer = 10
+        writer.write(msg)
+        views = reader.read_batch(10, timeout_ms=1000, zero_copy=True)
+        self.assertEqual(len(views), 1)
+        parsed = SimpleMessage()
+        parsed.ParseFromString(views[0].tobytes())
+        self.assertEqual(parsed.integer, 10)
+
 if __name__ == '__main__':
     cyber.init()
     unittest.main()
@@ -20,6 +20,8 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <deque>
 #include <iostream>
 #include <memory>
@@ -106,10 +108,98 @@ class PyWriter {
 };
 
 const char RAWDATATYPE[] = "RawData";
+/**
+ * @class PyMessageQueue
+ * @brief Bounded ring of received messages waiting for python
+ *
+ * Messages are kept by reference to the received buffer, nothing is copied
+ * until python asks for bytes. Once the ring is full either the oldest
+ * message is overwritten or the new one is dropped.
+ */
+class PyMessageQueue {
+ public:
+  enum DropPolicy { DROP_OLDEST = 0, DROP_NEWEST = 1 };
+  using MessagePtr = std::shared_ptr<const std::string>;
+
+  explicit PyMessageQueue(size_t capacity, DropPolicy policy = DROP_OLDEST)
+      : ring_(std::max<size_t>(capacity, 1)), policy_(policy) {}
+
+  /**
+   * @return false if `msg` was dropped
+   */
+  bool Push(const MessagePtr& msg) {
+    {
+      std::lock_guard<std::mutex> lg(mutex_);
+      if (size_ == ring_.size()) {
+        ++dropped_;
+        if (policy_ == DROP_NEWEST) {
+          return false;
+        }
+        ring_[head_] = msg;
+        head_ = (head_ + 1) % ring_.size();
+      } else {
+        ring_[(head_ + size_) % ring_.size()] = msg;
+        ++size_;
+      }
+    }
+    cond_.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief Take up to `max_num` messages, waiting at most `timeout_ms` for
+   * the first one, forever if negative
+   */
+  size_t Pop(size_t max_num, int timeout_ms, std::vector<MessagePtr>* msgs) {
+    std::unique_lock<std::mutex> ul(mutex_);
+    auto ready = [this] { return size_ > 0; };
+    if (timeout_ms < 0) {
+      cond_.wait(ul, ready);
+    } else if (timeout_ms > 0) {
+      cond_.wait_for(ul, std::chrono::milliseconds(timeout_ms), ready);
+    }
+    size_t num = std::min(max_num, size_);
+    for (size_t i = 0; i < num; ++i) {
+      msgs->emplace_back(std::move(ring_[head_]));
+      head_ = (head_ + 1) % ring_.size();
+    }
+    size_ -= num;
+    return num;
+  }
+
+  size_t Size() {
+    std::lock_guard<std::mutex> lg(mutex_);
+    return size_;
+  }
+
+  uint64_t Dropped() {
+    std::lock_guard<std::mutex> lg(mutex_);
+    return dropped_;
+  }
+
+ private:
+  std::vector<MessagePtr> ring_;
+  size_t head_ = 0;
+  size_t size_ = 0;
+  uint64_t dropped_ = 0;
+  DropPolicy policy_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+};
+
 class PyReader {
  public:
-  PyReader(const std::string& channel, const std::string& type, Node* node)
-      : channel_name_(channel), data_type_(type), node_(node), func_(nullptr) {
+  using MessagePtr = PyMessageQueue::MessagePtr;
+  static const size_t kDefaultCacheSize = 1000;
+
+  PyReader(const std::string& channel, const std::string& type, Node* node,
+           size_t cache_size = kDefaultCacheSize,
+           PyMessageQueue::DropPolicy policy = PyMessageQueue::DROP_OLDEST)
+      : channel_name_(channel),
+        data_type_(type),
+        node_(node),
+        func_(nullptr),
+        cache_(cache_size, policy) {
     if (data_type_.compare(RAWDATATYPE) == 0) {
       auto f =
           [this](const std::shared_ptr<const message::PyMessageWrap>& request) {
@@ -128,47 +218,40 @@ class PyReader {
   void register_func(int (*func)(const char*)) { func_ = func; }
 
   std::string read(bool wait = false) {
-    std::string msg("");
-    std::unique_lock<std::mutex> ul(msg_lock_);
-    if (!cache_.empty()) {
-      msg = std::move(cache_.front());
-      cache_.pop_front();
-    }
-
-    if (!wait) {
-      return msg;
-    }
-
-    msg_cond_.wait(ul, [this] { return !this->cache_.empty(); });
-    if (!cache_.empty()) {
-      msg = std::move(cache_.front());
-      cache_.pop_front();
+    std::vector<MessagePtr> msgs;
+    if (cache_.Pop(1, wait ? -1 : 0, &msgs) == 0) {
+      return "";
     }
+    return *msgs.front();
+  }
 
-    return msg;
+  /**
+   * @brief Take up to `max_num` cached messages in one call, waiting at most
+   * `timeout_ms` for the first one
+   */
+  std::vector<MessagePtr> read_batch(size_t max_num, int timeout_ms) {
+    std::vector<MessagePtr> msgs;
+    msgs.reserve(std::min(max_num, cache_.Size()));
+    cache_.Pop(max_num, timeout_ms, &msgs);
+    return msgs;
   }
 
+  uint64_t dropped() { return cache_.Dropped(); }
+
  private:
   void cb(const std::shared_ptr<const message::PyMessageWrap>& message) {
-    {
-      std::lock_guard<std::mutex> lg(msg_lock_);
-      cache_.push_back(message->data());
-    }
-    if (func_) {
-      func_(channel_name_.c_str());
-    }
-    msg_cond_.notify_one();
+    // share the received buffer instead of copying it
+    Deliver(MessagePtr(message, &message->data()));
   }
 
   void cb_rawmsg(const std::shared_ptr<const message::RawMessage>& message) {
-    {
-      std::lock_guard<std::mutex> lg(msg_lock_);
-      cache_.push_back(message->message);
-    }
-    if (func_) {
+    Deliver(MessagePtr(message, &message->message));
+  }
+
+  void Deliver(const MessagePtr& msg) {
+    if (cache_.Push(msg) && func_) {
       func_(channel_name_.c_str());
     }
-    msg_cond_.notify_one();
   }
 
   std::string channel_name_;
@@ -176,9 +259,7 @@ class PyReader {
   Node* node_ = nullptr;
   int (*func_)(const char*) = nullptr;
   std::shared_ptr<Reader<message::PyMessageWrap>> reader_ = nullptr;
-  std::deque<std::string> cache_;
-  std::mutex msg_lock_;
-  std::condition_variable msg_cond_;
+  PyMessageQueue cache_;
 
   std::shared_ptr<Reader<message::RawMessage>> reader_rawmsg_ = nullptr;
 };
@@ -306,9 +387,12 @@ class PyNode {
     message::ProtobufFactory::Instance()->RegisterPythonMessage(desc);
   }
 
-  PyReader* create_reader(const std::string& channel, const std::string& type) {
+  PyReader* create_reader(
+      const std::string& channel, const std::string& type,
+      size_t cache_size = PyReader::kDefaultCacheSize,
+      PyMessageQueue::DropPolicy policy = PyMessageQueue::DROP_OLDEST) {
     if (node_) {
-      return new PyReader(channel, type, node_.get());
+      return new PyReader(channel, type, node_.get(), cache_size, policy);
     }
     return nullptr;
   }
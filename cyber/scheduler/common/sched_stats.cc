@@ -0,0 +1,454 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/common/sched_stats.h"
+
+#include <signal.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#include "cyber/base/cycle_clock.h"
+#include "cyber/base/macros.h"
+#include "cyber/common/log.h"
+#include "cyber/common/util.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using base::CycleClock;
+using common::Hash;
+
+namespace {
+
+const uint32_t kReadyMagic = 0x53435354;
+// keeps the slots cache line aligned
+const std::size_t kHeaderSize = 64;
+const double kFullRetryNs = 1e9;
+
+bool IsAlive(int pid) { return kill(pid, 0) == 0 || errno != ESRCH; }
+
+// every slot has a single writer at a time
+void Add(std::atomic<uint64_t>* counter, uint64_t value) {
+  counter->store(counter->load(std::memory_order_relaxed) + value,
+                 std::memory_order_relaxed);
+}
+
+void Max(std::atomic<uint64_t>* counter, uint64_t value) {
+  if (value > counter->load(std::memory_order_relaxed)) {
+    counter->store(value, std::memory_order_relaxed);
+  }
+}
+
+uint64_t LoadNanosecond(const std::atomic<uint64_t>& cycles) {
+  return CycleClock::ToNanosecond(cycles.load(std::memory_order_relaxed));
+}
+
+}  // namespace
+
+struct SchedStats::Header {
+  std::atomic<uint32_t> ready = {0};
+  uint32_t routine_slot_num = 0;
+  uint32_t routine_slot_size = 0;
+  uint32_t processor_slot_num = 0;
+  uint32_t processor_slot_size = 0;
+};
+
+struct alignas(CACHELINE_SIZE) SchedStats::RoutineSlot {
+  // 0 while the slot is free
+  std::atomic<int32_t> pid;
+  std::atomic<int32_t> processor;
+  std::atomic<uint32_t> name_ready;
+  std::atomic<uint64_t> routine_id;
+  char name[kNameSize];
+  std::atomic<uint64_t> runs;
+  std::atomic<uint64_t> run_cycles;
+  std::atomic<uint64_t> max_run_cycles;
+  std::atomic<uint64_t> wakeups;
+  std::atomic<uint64_t> wakeup_cycles;
+  std::atomic<uint64_t> max_wakeup_cycles;
+};
+
+struct alignas(CACHELINE_SIZE) SchedStats::ProcessorSlot {
+  // 0 while the slot is free
+  std::atomic<int32_t> pid;
+  std::atomic<int32_t> tid;
+  std::atomic<uint64_t> runs;
+  std::atomic<uint64_t> busy_cycles;
+  std::atomic<uint64_t> waits;
+};
+
+const uint32_t SchedStats::kRoutineSlotNum;
+const uint32_t SchedStats::kProcessorSlotNum;
+const uint32_t SchedStats::kNameSize;
+
+SchedStats::SchedStats() : SchedStats("/apollo/cyber/sched_stats") {}
+
+SchedStats::SchedStats(const std::string& name) : pid_(getpid()) {
+  static_assert(sizeof(Header) <= kHeaderSize, "header does not fit");
+  key_ = static_cast<key_t>(Hash(name));
+  shm_size_ = kHeaderSize + kRoutineSlotNum * sizeof(RoutineSlot) +
+              kProcessorSlotNum * sizeof(ProcessorSlot);
+  if (!OpenOrCreate()) {
+    AWARN << "scheduler statistics are not available.";
+    if (managed_shm_ != nullptr) {
+      shmdt(managed_shm_);
+      managed_shm_ = nullptr;
+    }
+    routine_slots_ = nullptr;
+    processor_slots_ = nullptr;
+  }
+}
+
+SchedStats::~SchedStats() {
+  if (managed_shm_ != nullptr) {
+    shmdt(managed_shm_);
+    managed_shm_ = nullptr;
+  }
+}
+
+template <typename SlotT>
+SlotT* SchedStats::TakeSlot(SlotT* slots, uint32_t slot_num,
+                            uint32_t start) {
+  for (uint32_t i = 0; i < slot_num; ++i) {
+    SlotT* slot = &slots[(start + i) % slot_num];
+    int32_t pid = slot->pid.load(std::memory_order_acquire);
+    if (pid != 0 && (pid == pid_ || IsAlive(pid))) {
+      continue;
+    }
+    if (slot->pid.compare_exchange_strong(pid, pid_,
+                                          std::memory_order_acq_rel)) {
+      return slot;
+    }
+  }
+  return nullptr;
+}
+
+auto SchedStats::GetRoutineSlot(uint64_t routine_id, const std::string& name)
+    -> RoutineSlot* {
+  if (!IsReady()) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = own_routines_.find(routine_id);
+  if (it != own_routines_.end()) {
+    return it->second;
+  }
+  // slots are freed by other processes too, so a full page is scanned again
+  // once in a while
+  uint64_t now = CycleClock::Now();
+  if (now < full_retry_cycles_) {
+    return nullptr;
+  }
+
+  auto slot = TakeSlot(routine_slots_, kRoutineSlotNum,
+                       static_cast<uint32_t>(routine_id % kRoutineSlotNum));
+  if (slot == nullptr) {
+    AWARN << "scheduler statistics page is full, " << name
+          << " is not counted.";
+    full_retry_cycles_ =
+        now + static_cast<uint64_t>(CycleClock::CyclesPerNanosecond() *
+                                    kFullRetryNs);
+    return nullptr;
+  }
+  // may have belonged to a process that died
+  slot->name_ready.store(0, std::memory_order_relaxed);
+  slot->processor.store(0, std::memory_order_relaxed);
+  slot->runs.store(0, std::memory_order_relaxed);
+  slot->run_cycles.store(0, std::memory_order_relaxed);
+  slot->max_run_cycles.store(0, std::memory_order_relaxed);
+  slot->wakeups.store(0, std::memory_order_relaxed);
+  slot->wakeup_cycles.store(0, std::memory_order_relaxed);
+  slot->max_wakeup_cycles.store(0, std::memory_order_relaxed);
+  slot->routine_id.store(routine_id, std::memory_order_relaxed);
+  std::memset(slot->name, 0, kNameSize);
+  std::strncpy(slot->name, name.c_str(), kNameSize - 1);
+  slot->name_ready.store(1, std::memory_order_release);
+  own_routines_[routine_id] = slot;
+  return slot;
+}
+
+auto SchedStats::GetProcessorSlot(int tid) -> ProcessorSlot* {
+  if (!IsReady()) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = own_processors_.find(tid);
+  if (it != own_processors_.end()) {
+    return it->second;
+  }
+
+  auto slot = TakeSlot(processor_slots_, kProcessorSlotNum,
+                       static_cast<uint32_t>(tid) % kProcessorSlotNum);
+  if (slot == nullptr) {
+    AWARN << "scheduler statistics page is full, processor " << tid
+          << " is not counted.";
+    return nullptr;
+  }
+  slot->runs.store(0, std::memory_order_relaxed);
+  slot->busy_cycles.store(0, std::memory_order_relaxed);
+  slot->waits.store(0, std::memory_order_relaxed);
+  slot->tid.store(tid, std::memory_order_release);
+  own_processors_[tid] = slot;
+  return slot;
+}
+
+void SchedStats::ReleaseRoutineSlot(uint64_t routine_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = own_routines_.find(routine_id);
+  if (it == own_routines_.end()) {
+    return;
+  }
+  it->second->name_ready.store(0, std::memory_order_relaxed);
+  it->second->pid.store(0, std::memory_order_release);
+  own_routines_.erase(it);
+  full_retry_cycles_ = 0;
+  routine_releases_.fetch_add(1, std::memory_order_release);
+}
+
+void SchedStats::Release() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& it : own_routines_) {
+    it.second->name_ready.store(0, std::memory_order_relaxed);
+    it.second->pid.store(0, std::memory_order_release);
+  }
+  own_routines_.clear();
+  full_retry_cycles_ = 0;
+  routine_releases_.fetch_add(1, std::memory_order_release);
+  for (auto& it : own_processors_) {
+    it.second->tid.store(0, std::memory_order_relaxed);
+    it.second->pid.store(0, std::memory_order_release);
+  }
+  own_processors_.clear();
+}
+
+void SchedStats::OnRun(RoutineSlot* slot, int processor, uint64_t run_cycles,
+                       uint64_t wakeup_cycles) {
+  if (slot == nullptr) {
+    return;
+  }
+  Add(&slot->runs, 1);
+  Add(&slot->run_cycles, run_cycles);
+  Max(&slot->max_run_cycles, run_cycles);
+  if (wakeup_cycles != 0) {
+    Add(&slot->wakeups, 1);
+    Add(&slot->wakeup_cycles, wakeup_cycles);
+    Max(&slot->max_wakeup_cycles, wakeup_cycles);
+  }
+  if (slot->processor.load(std::memory_order_relaxed) != processor) {
+    slot->processor.store(processor, std::memory_order_relaxed);
+  }
+}
+
+void SchedStats::OnRun(ProcessorSlot* slot, uint64_t run_cycles) {
+  if (slot == nullptr) {
+    return;
+  }
+  Add(&slot->runs, 1);
+  Add(&slot->busy_cycles, run_cycles);
+}
+
+void SchedStats::OnWait(ProcessorSlot* slot) {
+  if (slot == nullptr) {
+    return;
+  }
+  Add(&slot->waits, 1);
+}
+
+std::vector<RoutineStatsSnapshot> SchedStats::ReadRoutines(int pid) const {
+  std::vector<RoutineStatsSnapshot> snapshots;
+  if (!IsReady()) {
+    return snapshots;
+  }
+  for (uint32_t i = 0; i < kRoutineSlotNum; ++i) {
+    const RoutineSlot& slot = routine_slots_[i];
+    int32_t owner = slot.pid.load(std::memory_order_acquire);
+    if (owner == 0 || (pid != 0 && owner != pid) ||
+        slot.name_ready.load(std::memory_order_acquire) == 0) {
+      continue;
+    }
+    snapshots.emplace_back();
+    auto& snapshot = snapshots.back();
+    snapshot.pid = owner;
+    snapshot.processor = slot.processor.load(std::memory_order_relaxed);
+    snapshot.routine_id = slot.routine_id.load(std::memory_order_relaxed);
+    snapshot.name.assign(slot.name, strnlen(slot.name, kNameSize));
+    snapshot.runs = slot.runs.load(std::memory_order_relaxed);
+    snapshot.run_ns = LoadNanosecond(slot.run_cycles);
+    snapshot.max_run_ns = LoadNanosecond(slot.max_run_cycles);
+    snapshot.wakeups = slot.wakeups.load(std::memory_order_relaxed);
+    snapshot.wakeup_ns = LoadNanosecond(slot.wakeup_cycles);
+    snapshot.max_wakeup_ns = LoadNanosecond(slot.max_wakeup_cycles);
+  }
+  return snapshots;
+}
+
+std::vector<ProcessorStatsSnapshot> SchedStats::ReadProcessors(
+    int pid) const {
+  std::vector<ProcessorStatsSnapshot> snapshots;
+  if (!IsReady()) {
+    return snapshots;
+  }
+  for (uint32_t i = 0; i < kProcessorSlotNum; ++i) {
+    const ProcessorSlot& slot = processor_slots_[i];
+    int32_t owner = slot.pid.load(std::memory_order_acquire);
+    int32_t tid = slot.tid.load(std::memory_order_acquire);
+    if (owner == 0 || tid == 0 || (pid != 0 && owner != pid)) {
+      continue;
+    }
+    snapshots.emplace_back();
+    auto& snapshot = snapshots.back();
+    snapshot.pid = owner;
+    snapshot.tid = tid;
+    snapshot.runs = slot.runs.load(std::memory_order_relaxed);
+    snapshot.busy_ns = LoadNanosecond(slot.busy_cycles);
+    snapshot.waits = slot.waits.load(std::memory_order_relaxed);
+  }
+  return snapshots;
+}
+
+std::string SchedStats::Dump(int pid) const {
+  std::string info;
+  for (auto& proc : ReadProcessors(pid)) {
+    info.append("processor ")
+        .append(std::to_string(proc.tid))
+        .append(" runs: ")
+        .append(std::to_string(proc.runs))
+        .append(", busy_ms: ")
+        .append(std::to_string(proc.busy_ns / 1000000))
+        .append(", waits: ")
+        .append(std::to_string(proc.waits))
+        .append("\n");
+  }
+
+  auto routines = ReadRoutines(pid);
+  std::sort(routines.begin(), routines.end(),
+            [](const RoutineStatsSnapshot& lhs,
+               const RoutineStatsSnapshot& rhs) {
+              return lhs.run_ns > rhs.run_ns;
+            });
+  for (auto& routine : routines) {
+    if (routine.runs == 0) {
+      continue;
+    }
+    uint64_t wakeups = routine.wakeups == 0 ? 1 : routine.wakeups;
+    info.append(routine.name)
+        .append(" processor: ")
+        .append(std::to_string(routine.processor))
+        .append(", runs: ")
+        .append(std::to_string(routine.runs))
+        .append(", run_ms: ")
+        .append(std::to_string(routine.run_ns / 1000000))
+        .append(", avg_run_us: ")
+        .append(std::to_string(routine.run_ns / routine.runs / 1000))
+        .append(", max_run_us: ")
+        .append(std::to_string(routine.max_run_ns / 1000))
+        .append(", avg_wakeup_us: ")
+        .append(std::to_string(routine.wakeup_ns / wakeups / 1000))
+        .append(", max_wakeup_us: ")
+        .append(std::to_string(routine.max_wakeup_ns / 1000))
+        .append("\n");
+  }
+  return info;
+}
+
+bool SchedStats::OpenOrCreate() {
+  int shmid = shmget(key_, shm_size_, 0644 | IPC_CREAT | IPC_EXCL);
+  if (shmid == -1 && EINVAL == errno) {
+    // left behind by a build with another layout
+    int old = shmget(key_, 0, 0644);
+    if (old != -1 && shmctl(old, IPC_RMID, 0) == 0) {
+      shmid = shmget(key_, shm_size_, 0644 | IPC_CREAT | IPC_EXCL);
+    }
+  }
+  if (shmid == -1) {
+    if (EEXIST == errno) {
+      return OpenOnly();
+    }
+    AERROR << "create shm failed, error: " << strerror(errno);
+    return false;
+  }
+
+  managed_shm_ = shmat(shmid, nullptr, 0);
+  if (managed_shm_ == reinterpret_cast<void*>(-1)) {
+    AERROR << "attach shm failed, error: " << strerror(errno);
+    managed_shm_ = nullptr;
+    shmctl(shmid, IPC_RMID, 0);
+    return false;
+  }
+
+  // the segment comes zero filled, which is every slot free
+  auto header = new (managed_shm_) Header();
+  header->routine_slot_num = kRoutineSlotNum;
+  header->routine_slot_size = sizeof(RoutineSlot);
+  header->processor_slot_num = kProcessorSlotNum;
+  header->processor_slot_size = sizeof(ProcessorSlot);
+  routine_slots_ = reinterpret_cast<RoutineSlot*>(
+      static_cast<char*>(managed_shm_) + kHeaderSize);
+  processor_slots_ =
+      reinterpret_cast<ProcessorSlot*>(routine_slots_ + kRoutineSlotNum);
+  header->ready.store(kReadyMagic, std::memory_order_release);
+  return true;
+}
+
+bool SchedStats::OpenOnly() {
+  int shmid = shmget(key_, 0, 0644);
+  if (shmid == -1) {
+    AERROR << "get shm failed, error: " << strerror(errno);
+    return false;
+  }
+
+  managed_shm_ = shmat(shmid, nullptr, 0);
+  if (managed_shm_ == reinterpret_cast<void*>(-1)) {
+    AERROR << "attach shm failed, error: " << strerror(errno);
+    managed_shm_ = nullptr;
+    return false;
+  }
+
+  auto header = reinterpret_cast<Header*>(managed_shm_);
+  // the creator may still be filling in the header
+  for (int i = 0; i < 100; ++i) {
+    if (header->ready.load(std::memory_order_acquire) == kReadyMagic) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  if (header->ready.load(std::memory_order_acquire) != kReadyMagic ||
+      header->routine_slot_num != kRoutineSlotNum ||
+      header->routine_slot_size != sizeof(RoutineSlot) ||
+      header->processor_slot_num != kProcessorSlotNum ||
+      header->processor_slot_size != sizeof(ProcessorSlot)) {
+    AERROR << "scheduler statistics layout mismatch.";
+    return false;
+  }
+  routine_slots_ = reinterpret_cast<RoutineSlot*>(
+      static_cast<char*>(managed_shm_) + kHeaderSize);
+  processor_slots_ =
+      reinterpret_cast<ProcessorSlot*>(routine_slots_ + kRoutineSlotNum);
+  return true;
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
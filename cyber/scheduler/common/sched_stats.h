@@ -0,0 +1,160 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SCHEDULER_COMMON_SCHED_STATS_H_
+#define CYBER_SCHEDULER_COMMON_SCHED_STATS_H_
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cyber/common/macros.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+struct RoutineStatsSnapshot {
+  int pid = 0;
+  // thread id of the processor that resumed the routine last
+  int processor = 0;
+  uint64_t routine_id = 0;
+  std::string name;
+  // resumes, a routine yields back to its processor after each message
+  uint64_t runs = 0;
+  uint64_t run_ns = 0;
+  uint64_t max_run_ns = 0;
+  // resumes after a notification, with the time in between
+  uint64_t wakeups = 0;
+  uint64_t wakeup_ns = 0;
+  uint64_t max_wakeup_ns = 0;
+};
+
+struct ProcessorStatsSnapshot {
+  int pid = 0;
+  int tid = 0;
+  uint64_t runs = 0;
+  uint64_t busy_ns = 0;
+  // waits for work while no routine was ready
+  uint64_t waits = 0;
+};
+
+/**
+ * @class SchedStats
+ * @brief Per croutine and per processor run time in a shared memory page
+ *
+ * Processors add the time of every resume to the slot of the routine and to
+ * their own slot, measured with CycleClock, so tools like cyber_sched_top
+ * see the load of all processes of the host. A routine runs on one
+ * processor at a time, so each slot has a single writer and updates are
+ * plain relaxed stores without locked instructions. Slots are cache line
+ * aligned and never shared by two routines or processors. Slots of
+ * processes that died are taken over by others.
+ */
+class SchedStats {
+ public:
+  struct RoutineSlot;
+  struct ProcessorSlot;
+
+  static const uint32_t kRoutineSlotNum = 4096;
+  static const uint32_t kProcessorSlotNum = 1024;
+  static const uint32_t kNameSize = 128;
+
+  /**
+   * @param name identifies the page, processes sharing a name see each other
+   */
+  explicit SchedStats(const std::string& name);
+  virtual ~SchedStats();
+
+  bool IsReady() const { return routine_slots_ != nullptr; }
+
+  /**
+   * @brief Slot of a routine of this process, taken on first use
+   *
+   * @return nullptr if there is no page or it is full
+   */
+  RoutineSlot* GetRoutineSlot(uint64_t routine_id, const std::string& name);
+  ProcessorSlot* GetProcessorSlot(int tid);
+
+  /**
+   * @brief Free the slot of a routine that is not going to run anymore
+   */
+  void ReleaseRoutineSlot(uint64_t routine_id);
+
+  /**
+   * @brief Free all slots of this process
+   */
+  void Release();
+
+  /**
+   * @brief Bumped whenever routine slots are freed, slot pointers kept
+   * from before may belong to other routines by now
+   */
+  uint64_t routine_releases() const {
+    return routine_releases_.load(std::memory_order_acquire);
+  }
+
+  // cycles are CycleClock counts
+  static void OnRun(RoutineSlot* slot, int processor, uint64_t run_cycles,
+                    uint64_t wakeup_cycles);
+  static void OnRun(ProcessorSlot* slot, uint64_t run_cycles);
+  static void OnWait(ProcessorSlot* slot);
+
+  // all processes for a pid of 0
+  std::vector<RoutineStatsSnapshot> ReadRoutines(int pid = 0) const;
+  std::vector<ProcessorStatsSnapshot> ReadProcessors(int pid = 0) const;
+
+  /**
+   * @brief One line per routine of the process that has run, the busiest
+   * first
+   */
+  std::string Dump(int pid) const;
+
+ private:
+  struct Header;
+
+  bool OpenOrCreate();
+  bool OpenOnly();
+  template <typename SlotT>
+  SlotT* TakeSlot(SlotT* slots, uint32_t slot_num, uint32_t start);
+
+  key_t key_ = 0;
+  std::size_t shm_size_ = 0;
+  void* managed_shm_ = nullptr;
+  RoutineSlot* routine_slots_ = nullptr;
+  ProcessorSlot* processor_slots_ = nullptr;
+  int pid_ = 0;
+
+  std::mutex mutex_;
+  std::unordered_map<uint64_t, RoutineSlot*> own_routines_;
+  std::unordered_map<int, ProcessorSlot*> own_processors_;
+  // CycleClock count before which a full page is not scanned again
+  uint64_t full_retry_cycles_ = 0;
+  std::atomic<uint64_t> routine_releases_ = {0};
+
+  DECLARE_SINGLETON(SchedStats)
+};
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SCHEDULER_COMMON_SCHED_STATS_H_
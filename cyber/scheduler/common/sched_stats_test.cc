@@ -0,0 +1,146 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/common/sched_stats.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "cyber/base/cycle_clock.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using base::CycleClock;
+
+namespace {
+
+const char kStatsName[] = "/apollo/cyber/test/sched_stats";
+
+const RoutineStatsSnapshot* Find(
+    const std::vector<RoutineStatsSnapshot>& snapshots, uint64_t id) {
+  for (auto& snapshot : snapshots) {
+    if (snapshot.routine_id == id) {
+      return &snapshot;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+TEST(SchedStatsTest, count) {
+  SchedStats stats(kStatsName);
+  ASSERT_TRUE(stats.IsReady());
+
+  const uint64_t routine_id = 0x5eed;
+  auto slot = stats.GetRoutineSlot(routine_id, "sched_stats_test");
+  ASSERT_NE(nullptr, slot);
+  EXPECT_EQ(slot, stats.GetRoutineSlot(routine_id, "sched_stats_test"));
+  // a routine whose home slot is taken moves on to the next one
+  auto other = stats.GetRoutineSlot(routine_id + SchedStats::kRoutineSlotNum,
+                                    "sched_stats_test_other");
+  ASSERT_NE(nullptr, other);
+  EXPECT_NE(slot, other);
+
+  uint64_t ms = static_cast<uint64_t>(CycleClock::CyclesPerNanosecond() *
+                                      1000000);
+  SchedStats::OnRun(slot, 42, ms, 0);
+  SchedStats::OnRun(slot, 43, 3 * ms, 2 * ms);
+
+  auto routines = stats.ReadRoutines(getpid());
+  auto snapshot = Find(routines, routine_id);
+  ASSERT_NE(nullptr, snapshot);
+  EXPECT_EQ("sched_stats_test", snapshot->name);
+  EXPECT_EQ(getpid(), snapshot->pid);
+  EXPECT_EQ(43, snapshot->processor);
+  EXPECT_EQ(2, snapshot->runs);
+  EXPECT_NEAR(4000000, snapshot->run_ns, 1000);
+  EXPECT_NEAR(3000000, snapshot->max_run_ns, 1000);
+  EXPECT_EQ(1, snapshot->wakeups);
+  EXPECT_NEAR(2000000, snapshot->wakeup_ns, 1000);
+  EXPECT_NEAR(2000000, snapshot->max_wakeup_ns, 1000);
+  EXPECT_NE(std::string::npos,
+            stats.Dump(getpid()).find("sched_stats_test processor: 43"));
+
+  auto proc = stats.GetProcessorSlot(4242);
+  ASSERT_NE(nullptr, proc);
+  SchedStats::OnRun(proc, ms);
+  SchedStats::OnWait(proc);
+  auto processors = stats.ReadProcessors(getpid());
+  ASSERT_EQ(1, processors.size());
+  EXPECT_EQ(4242, processors[0].tid);
+  EXPECT_EQ(1, processors[0].runs);
+  EXPECT_EQ(1, processors[0].waits);
+  EXPECT_NEAR(1000000, processors[0].busy_ns, 1000);
+
+  stats.Release();
+  EXPECT_TRUE(stats.ReadRoutines(getpid()).empty());
+  EXPECT_TRUE(stats.ReadProcessors(getpid()).empty());
+}
+
+TEST(SchedStatsTest, release_routine) {
+  SchedStats stats(kStatsName);
+  ASSERT_TRUE(stats.IsReady());
+
+  const uint64_t routine_id = 0xf4ee;
+  uint64_t releases = stats.routine_releases();
+  ASSERT_NE(nullptr, stats.GetRoutineSlot(routine_id, "sched_stats_release"));
+  ASSERT_NE(nullptr, stats.GetRoutineSlot(routine_id + 1, "sched_stats_kept"));
+  stats.ReleaseRoutineSlot(routine_id);
+  EXPECT_NE(releases, stats.routine_releases());
+  auto routines = stats.ReadRoutines(getpid());
+  EXPECT_EQ(nullptr, Find(routines, routine_id));
+  EXPECT_NE(nullptr, Find(routines, routine_id + 1));
+
+  // unknown routines are ignored
+  releases = stats.routine_releases();
+  stats.ReleaseRoutineSlot(routine_id);
+  EXPECT_EQ(releases, stats.routine_releases());
+  stats.Release();
+}
+
+TEST(SchedStatsTest, take_over_dead_process) {
+  const uint64_t routine_id = 0xdead;
+  pid_t child = fork();
+  ASSERT_NE(-1, child);
+  if (child == 0) {
+    SchedStats stats(kStatsName);
+    _exit(stats.GetRoutineSlot(routine_id, "sched_stats_dead") ? 0 : 1);
+  }
+  int status = 0;
+  ASSERT_EQ(child, waitpid(child, &status, 0));
+  ASSERT_EQ(0, WEXITSTATUS(status));
+
+  SchedStats stats(kStatsName);
+  ASSERT_EQ(1, stats.ReadRoutines(child).size());
+  auto slot = stats.GetRoutineSlot(routine_id, "sched_stats_alive");
+  ASSERT_NE(nullptr, slot);
+  EXPECT_TRUE(stats.ReadRoutines(child).empty());
+  auto routines = stats.ReadRoutines(getpid());
+  auto snapshot = Find(routines, routine_id);
+  ASSERT_NE(nullptr, snapshot);
+  EXPECT_EQ("sched_stats_alive", snapshot->name);
+  EXPECT_EQ(0, snapshot->runs);
+  stats.Release();
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
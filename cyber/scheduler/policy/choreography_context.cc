@@ -16,11 +16,15 @@
 
 #include "cyber/scheduler/policy/choreography_context.h"
 
+#include <algorithm>
+#include <chrono>
 #include <limits>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "cyber/common/log.h"
 #include "cyber/common/types.h"
 
 namespace apollo {
@@ -32,19 +36,42 @@ using apollo::cyber::base::WriteLockGuard;
 
 using apollo::cyber::croutine::RoutineState;
 
+namespace {
+
+uint64_t ToNanosecond(const std::chrono::steady_clock::time_point& time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             time.time_since_epoch())
+      .count();
+}
+
+uint64_t NowNanosecond() {
+  return ToNanosecond(std::chrono::steady_clock::now());
+}
+
+}  // namespace
+
 std::shared_ptr<CRoutine> ChoreographyContext::NextRoutine() {
   if (cyber_unlikely(stop_.load())) {
     return nullptr;
   }
 
+  auto now = NowNanosecond();
+  Complete(now);
+  if (policy_ == Policy::EDF) {
+    return NextEarliestDeadline(now);
+  }
+
   ReadLockGuard<AtomicRWLock> lock(rq_lk_);
-  for (auto it : cr_queue_) {
-    auto cr = it.second;
+  for (auto& it : cr_queue_) {
+    auto& task = it.second;
+    auto& cr = task->cr;
     if (!cr->Acquire()) {
       continue;
     }
 
     if (cr->UpdateState() == RoutineState::READY) {
+      Release(task, now);
+      running_ = task;
       return cr;
     }
     cr->Release();
@@ -52,9 +79,136 @@ std::shared_ptr<CRoutine> ChoreographyContext::NextRoutine() {
   return nullptr;
 }
 
-bool ChoreographyContext::Enqueue(const std::shared_ptr<CRoutine>& cr) {
-  WriteLockGuard<AtomicRWLock> lock(rq_lk_);
-  cr_queue_.emplace(cr->priority(), cr);
+std::shared_ptr<CRoutine> ChoreographyContext::NextEarliestDeadline(
+    uint64_t now) {
+  std::lock_guard<std::mutex> lg(ready_mtx_);
+  next_wake_ns_ = 0;
+  for (auto it = sleeping_.begin(); it != sleeping_.end();) {
+    auto task = *it;
+    auto wake_ns = ToNanosecond(task->cr->wake_time());
+    if (task->removed.load()) {
+      task->queued = false;
+    } else if (wake_ns < now) {
+      Release(task, wake_ns);
+      PushReady(task);
+    } else {
+      if (next_wake_ns_ == 0 || wake_ns < next_wake_ns_) {
+        next_wake_ns_ = wake_ns;
+      }
+      ++it;
+      continue;
+    }
+    it = sleeping_.erase(it);
+  }
+
+  while (!ready_.empty()) {
+    auto task = ready_.top().task;
+    ready_.pop();
+    task->queued = false;
+    if (task->removed.load()) {
+      continue;
+    }
+    auto& cr = task->cr;
+    if (!cr->Acquire()) {
+      continue;
+    }
+
+    if (cr->UpdateState() == RoutineState::READY) {
+      Release(task, now);
+      running_ = task;
+      return cr;
+    }
+    // notified without data, the next notification releases it again
+    cr->Release();
+  }
+  return nullptr;
+}
+
+void ChoreographyContext::Release(const std::shared_ptr<Task>& task,
+                                  uint64_t now) {
+  uint64_t none = 0;
+  task->release_ns.compare_exchange_strong(none, now);
+}
+
+void ChoreographyContext::PushReady(const std::shared_ptr<Task>& task) {
+  task->queued = true;
+  uint64_t deadline = std::numeric_limits<uint64_t>::max();
+  if (task->deadline_ns != 0) {
+    deadline = task->release_ns.load() + task->deadline_ns;
+  }
+  ready_.push({deadline, ready_seq_++, task});
+}
+
+void ChoreographyContext::Complete(uint64_t now) {
+  if (running_ == nullptr) {
+    return;
+  }
+  auto task = std::move(running_);
+  running_ = nullptr;
+  if (task->removed.load()) {
+    return;
+  }
+
+  auto state = task->cr->state();
+  if (state == RoutineState::READY) {
+    // yielded, the job goes on
+    if (policy_ == Policy::EDF) {
+      std::lock_guard<std::mutex> lg(ready_mtx_);
+      if (!task->queued) {
+        PushReady(task);
+      }
+    }
+    return;
+  }
+
+  auto release = task->release_ns.exchange(0);
+  if (release != 0 && task->deadline_ns != 0) {
+    task->jobs.fetch_add(1, std::memory_order_relaxed);
+    auto deadline = release + task->deadline_ns;
+    if (now > deadline) {
+      auto lateness = now - deadline;
+      task->misses.fetch_add(1, std::memory_order_relaxed);
+      if (lateness > task->max_lateness_ns.load(std::memory_order_relaxed)) {
+        task->max_lateness_ns.store(lateness, std::memory_order_relaxed);
+      }
+      AWARN_EVERY(100) << task->cr->name() << " missed its deadline by "
+                       << lateness / 1000 << "us";
+    }
+  }
+
+  if (policy_ == Policy::EDF && state == RoutineState::SLEEP) {
+    std::lock_guard<std::mutex> lg(ready_mtx_);
+    if (!task->queued) {
+      task->queued = true;
+      sleeping_.emplace_back(task);
+    }
+  }
+}
+
+bool ChoreographyContext::Enqueue(const std::shared_ptr<CRoutine>& cr,
+                                  uint64_t period_ns, uint64_t deadline_ns) {
+  auto task = std::make_shared<Task>();
+  task->cr = cr;
+  task->period_ns = period_ns;
+  task->deadline_ns = deadline_ns != 0 ? deadline_ns : period_ns;
+
+  uint64_t rank = cr->priority();
+  if (policy_ == Policy::RATE_MONOTONIC && period_ns != 0) {
+    // above every static priority, the shorter the period the higher
+    rank = std::numeric_limits<uint64_t>::max() - period_ns;
+  }
+  {
+    WriteLockGuard<AtomicRWLock> lock(rq_lk_);
+    cr_queue_.emplace(rank, task);
+    tasks_[cr->id()] = task;
+  }
+
+  if (policy_ == Policy::EDF) {
+    // new croutines are ready to run
+    Release(task, NowNanosecond());
+    std::lock_guard<std::mutex> lg(ready_mtx_);
+    PushReady(task);
+  }
   return true;
 }
 
@@ -65,10 +219,37 @@ void ChoreographyContext::Notify() {
   cv_wq_.notify_one();
 }
 
+void ChoreographyContext::Notify(uint64_t crid) {
+  std::shared_ptr<Task> task;
+  {
+    ReadLockGuard<AtomicRWLock> lock(rq_lk_);
+    auto it = tasks_.find(crid);
+    if (it != tasks_.end()) {
+      task = it->second;
+    }
+  }
+  if (task != nullptr) {
+    Release(task, NowNanosecond());
+    if (policy_ == Policy::EDF) {
+      std::lock_guard<std::mutex> lg(ready_mtx_);
+      if (!task->queued) {
+        PushReady(task);
+      }
+    }
+  }
+  Notify();
+}
+
 void ChoreographyContext::Wait() {
+  auto timeout = std::chrono::nanoseconds(std::chrono::milliseconds(1000));
+  if (next_wake_ns_ != 0) {
+    auto now = NowNanosecond();
+    auto wake_in = std::chrono::nanoseconds(
+        next_wake_ns_ > now ? next_wake_ns_ - now : 0);
+    timeout = std::min(timeout, wake_in);
+  }
   std::unique_lock<std::mutex> lk(mtx_wq_);
-  cv_wq_.wait_for(lk, std::chrono::milliseconds(1000),
-                  [&]() { return notify > 0; });
+  cv_wq_.wait_for(lk, timeout, [&]() { return notify > 0; });
   if (notify > 0) {
     notify--;
   }
@@ -84,22 +265,47 @@ void ChoreographyContext::Shutdown() {
 
 bool ChoreographyContext::RemoveCRoutine(uint64_t crid) {
   WriteLockGuard<AtomicRWLock> lock(rq_lk_);
-  for (auto it = cr_queue_.begin(); it != cr_queue_.end();) {
-    auto cr = it->second;
-    if (cr->id() == crid) {
-      cr->Stop();
-      while (!cr->Acquire()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        AINFO_EVERY(1000) << "waiting for task " << cr->name() << " completion";
-      }
-      it = cr_queue_.erase(it);
-      cr->Release();
-      return true;
+  auto it = tasks_.find(crid);
+  if (it == tasks_.end()) {
+    return false;
+  }
+  auto task = it->second;
+  auto& cr = task->cr;
+  cr->Stop();
+  while (!cr->Acquire()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    AINFO_EVERY(1000) << "waiting for task " << cr->name() << " completion";
+  }
+  // entries left in the EDF queues are dropped when they come up
+  task->removed.store(true);
+  tasks_.erase(it);
+  for (auto itr = cr_queue_.begin(); itr != cr_queue_.end(); ++itr) {
+    if (itr->second == task) {
+      cr_queue_.erase(itr);
+      break;
     }
-    ++it;
   }
-  return false;
+  cr->Release();
+  return true;
 }
+
+std::vector<ChoreographyContext::DeadlineStats>
+ChoreographyContext::GetDeadlineStats() {
+  std::vector<DeadlineStats> stats;
+  ReadLockGuard<AtomicRWLock> lock(rq_lk_);
+  for (auto& it : tasks_) {
+    auto& task = it.second;
+    if (task->deadline_ns == 0) {
+      continue;
+    }
+    stats.push_back({task->cr->name(), task->period_ns, task->deadline_ns,
+                     task->jobs.load(std::memory_order_relaxed),
+                     task->misses.load(std::memory_order_relaxed),
+                     task->max_lateness_ns.load(std::memory_order_relaxed)});
+  }
+  return stats;
+}
+
 }  // namespace scheduler
 }  // namespace cyber
 }  // namespace apollo
@@ -17,12 +17,17 @@
 #ifndef CYBER_SCHEDULER_POLICY_CHOREOGRAPHY_CONTEXT_H_
 #define CYBER_SCHEDULER_POLICY_CHOREOGRAPHY_CONTEXT_H_
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <queue>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "cyber/base/atomic_rw_lock.h"
 #include "cyber/croutine/croutine.h"
@@ -35,24 +40,107 @@ namespace scheduler {
 using apollo::cyber::base::AtomicRWLock;
 using croutine::CRoutine;
 
+/**
+ * @brief Runqueue of one choreography processor.
+ *
+ * PRIORITY runs the ready task of the highest static priority,
+ * RATE_MONOTONIC the one of the shortest period, tasks without a period
+ * come after all periodic ones in priority order. EDF keeps released jobs
+ * in a heap ordered by absolute deadline, a job is released when the task
+ * is notified or wakes up from sleeping and completes when the task waits
+ * again. Tasks without a deadline run after all others in release order.
+ *
+ * Jobs of tasks with a deadline are checked against it on completion
+ * under every policy.
+ */
 class ChoreographyContext : public ProcessorContext {
  public:
+  enum class Policy { PRIORITY, RATE_MONOTONIC, EDF };
+
+  struct DeadlineStats {
+    std::string name;
+    uint64_t period_ns;
+    uint64_t deadline_ns;
+    uint64_t jobs;
+    uint64_t misses;
+    uint64_t max_lateness_ns;
+  };
+
+  ChoreographyContext() = default;
+  explicit ChoreographyContext(Policy policy) : policy_(policy) {}
+
   bool RemoveCRoutine(uint64_t crid);
   std::shared_ptr<CRoutine> NextRoutine() override;
 
-  bool Enqueue(const std::shared_ptr<CRoutine>&);
+  // period_ns and deadline_ns of 0 leave the task without one, the
+  // deadline is relative to the release of a job and defaults to the period
+  bool Enqueue(const std::shared_ptr<CRoutine>&, uint64_t period_ns = 0,
+               uint64_t deadline_ns = 0);
   void Notify();
+  // releases a job of the task
+  void Notify(uint64_t crid);
   void Wait() override;
   void Shutdown() override;
 
+  Policy policy() const { return policy_; }
+  std::vector<DeadlineStats> GetDeadlineStats();
+
  private:
+  struct Task {
+    std::shared_ptr<CRoutine> cr;
+    uint64_t period_ns = 0;
+    uint64_t deadline_ns = 0;
+    // release time of the running job, 0 if there is none
+    std::atomic<uint64_t> release_ns = {0};
+    std::atomic<uint64_t> jobs = {0};
+    std::atomic<uint64_t> misses = {0};
+    std::atomic<uint64_t> max_lateness_ns = {0};
+    std::atomic<bool> removed = {false};
+    // in ready_ or sleeping_, guarded by ready_mtx_
+    bool queued = false;
+  };
+
+  struct ReadyTask {
+    uint64_t deadline;
+    uint64_t seq;
+    std::shared_ptr<Task> task;
+  };
+
+  struct LaterDeadline {
+    bool operator()(const ReadyTask& lhs, const ReadyTask& rhs) const {
+      return lhs.deadline != rhs.deadline ? lhs.deadline > rhs.deadline
+                                          : lhs.seq > rhs.seq;
+    }
+  };
+
+  std::shared_ptr<CRoutine> NextEarliestDeadline(uint64_t now);
+  void Release(const std::shared_ptr<Task>& task, uint64_t now);
+  void PushReady(const std::shared_ptr<Task>& task);
+  void Complete(uint64_t now);
+
+  Policy policy_ = Policy::PRIORITY;
+
   std::mutex mtx_wq_;
   std::condition_variable cv_wq_;
   int notify = 0;
 
   AtomicRWLock rq_lk_;
-  std::multimap<uint32_t, std::shared_ptr<CRoutine>, std::greater<uint32_t>>
+  // PRIORITY and RATE_MONOTONIC scan order, highest rank first
+  std::multimap<uint64_t, std::shared_ptr<Task>, std::greater<uint64_t>>
       cr_queue_;
+  std::unordered_map<uint64_t, std::shared_ptr<Task>> tasks_;
+
+  // EDF
+  std::mutex ready_mtx_;
+  std::priority_queue<ReadyTask, std::vector<ReadyTask>, LaterDeadline>
+      ready_;
+  std::vector<std::shared_ptr<Task>> sleeping_;
+  uint64_t ready_seq_ = 0;
+
+  // only touched by the processor, the task returned by the last
+  // NextRoutine and the earliest wake up time of sleeping_
+  std::shared_ptr<Task> running_;
+  uint64_t next_wake_ns_ = 0;
 };
 
 }  // namespace scheduler
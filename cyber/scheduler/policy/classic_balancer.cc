@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/policy/classic_balancer.h"
+
+#include <cmath>
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+ClassicBalancer::ClassicBalancer(const ClassicBalancerConf& conf)
+    : conf_(conf) {}
+
+double ClassicBalancer::Load(const GroupLoad& group) {
+  if (group.processor_num == 0) {
+    return 0.0;
+  }
+  return group.utilization +
+         static_cast<double>(group.pending) / group.processor_num;
+}
+
+bool ClassicBalancer::Balance(uint64_t now_ns,
+                              const std::vector<GroupLoad>& groups,
+                              const std::vector<RoutineLoad>& movable,
+                              Migration* migration) {
+  const GroupLoad* busiest = nullptr;
+  const GroupLoad* idlest = nullptr;
+  for (auto& group : groups) {
+    if (group.processor_num == 0) {
+      continue;
+    }
+    if (busiest == nullptr || Load(group) > Load(*busiest)) {
+      busiest = &group;
+    }
+    if (idlest == nullptr || Load(group) < Load(*idlest)) {
+      idlest = &group;
+    }
+  }
+  if (busiest == nullptr || busiest == idlest) {
+    imbalanced_samples_ = 0;
+    return false;
+  }
+
+  double from_load = Load(*busiest);
+  double to_load = Load(*idlest);
+  double gap = from_load - to_load;
+  if (from_load < conf_.high_watermark() || gap < conf_.min_imbalance()) {
+    imbalanced_samples_ = 0;
+    return false;
+  }
+  // the same pair of groups has to stay apart
+  if (busiest->name != busiest_ || idlest->name != idlest_) {
+    busiest_ = busiest->name;
+    idlest_ = idlest->name;
+    imbalanced_samples_ = 0;
+  }
+  if (++imbalanced_samples_ < conf_.sustain_samples()) {
+    return false;
+  }
+  uint64_t cooldown_ns = conf_.cooldown_ms() * 1000000ULL;
+  if (last_migration_ns_ != 0 && now_ns < last_migration_ns_ + cooldown_ns) {
+    return false;
+  }
+
+  const RoutineLoad* best = nullptr;
+  double best_gap = gap;
+  for (auto& routine : movable) {
+    if (routine.group != busiest->name) {
+      continue;
+    }
+    double load = routine.utilization + (routine.pending ? 1.0 : 0.0);
+    if (load <= 0.0) {
+      continue;
+    }
+    double new_gap = std::fabs(from_load - load / busiest->processor_num -
+                               to_load - load / idlest->processor_num);
+    if (new_gap < best_gap) {
+      best = &routine;
+      best_gap = new_gap;
+    }
+  }
+  if (best == nullptr) {
+    return false;
+  }
+
+  migration->routine_id = best->id;
+  migration->from = busiest->name;
+  migration->to = idlest->name;
+  migration->from_load = from_load;
+  migration->to_load = to_load;
+  imbalanced_samples_ = 0;
+  last_migration_ns_ = now_ns;
+  return true;
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,94 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SCHEDULER_POLICY_CLASSIC_BALANCER_H_
+#define CYBER_SCHEDULER_POLICY_CLASSIC_BALANCER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "cyber/proto/classic_conf.pb.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::proto::ClassicBalancerConf;
+
+struct GroupLoad {
+  std::string name;
+  uint32_t processor_num = 0;
+  // busy share of the processors of the group since the last sample
+  double utilization = 0.0;
+  // routines notified but not resumed yet
+  uint32_t pending = 0;
+};
+
+struct RoutineLoad {
+  uint64_t id = 0;
+  std::string group;
+  // processors kept busy by the routine since the last sample
+  double utilization = 0.0;
+  bool pending = false;
+};
+
+struct Migration {
+  uint64_t routine_id = 0;
+  std::string from;
+  std::string to;
+  double from_load = 0.0;
+  double to_load = 0.0;
+};
+
+/**
+ * @class ClassicBalancer
+ * @brief Decides when a croutine moves to another classic group
+ *
+ * A routine moves from the busiest to the least loaded group once the
+ * busiest group is above the high watermark and ahead of the other one by
+ * the minimum imbalance for a number of consecutive samples. The routine
+ * whose move leaves the two groups closest is taken, and only if that
+ * narrows the gap, so a routine does not bounce back on the next sample.
+ * No routine moves again before the cool down has passed.
+ */
+class ClassicBalancer {
+ public:
+  explicit ClassicBalancer(const ClassicBalancerConf& conf);
+
+  static double Load(const GroupLoad& group);
+
+  /**
+   * @param movable the routines that are not pinned to a group by config
+   *
+   * @return true if `migration` holds a routine to move
+   */
+  bool Balance(uint64_t now_ns, const std::vector<GroupLoad>& groups,
+               const std::vector<RoutineLoad>& movable, Migration* migration);
+
+ private:
+  ClassicBalancerConf conf_;
+  std::string busiest_;
+  std::string idlest_;
+  uint32_t imbalanced_samples_ = 0;
+  uint64_t last_migration_ns_ = 0;
+};
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SCHEDULER_POLICY_CLASSIC_BALANCER_H_
@@ -0,0 +1,144 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/policy/classic_balancer.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+namespace {
+
+const uint64_t kSecond = 1000000000ULL;
+
+GroupLoad MakeGroup(const std::string& name, uint32_t processor_num,
+                    double utilization, uint32_t pending = 0) {
+  GroupLoad group;
+  group.name = name;
+  group.processor_num = processor_num;
+  group.utilization = utilization;
+  group.pending = pending;
+  return group;
+}
+
+RoutineLoad MakeRoutine(uint64_t id, const std::string& group,
+                        double utilization, bool pending = false) {
+  RoutineLoad routine;
+  routine.id = id;
+  routine.group = group;
+  routine.utilization = utilization;
+  routine.pending = pending;
+  return routine;
+}
+
+ClassicBalancerConf MakeConf() {
+  ClassicBalancerConf conf;
+  conf.set_enable(true);
+  conf.set_sustain_samples(3);
+  conf.set_cooldown_ms(5000);
+  return conf;
+}
+
+}  // namespace
+
+TEST(ClassicBalancerTest, load) {
+  EXPECT_DOUBLE_EQ(0.0, ClassicBalancer::Load(MakeGroup("a", 0, 1.0, 3)));
+  EXPECT_DOUBLE_EQ(0.5, ClassicBalancer::Load(MakeGroup("a", 2, 0.5)));
+  EXPECT_DOUBLE_EQ(1.5, ClassicBalancer::Load(MakeGroup("a", 2, 0.5, 2)));
+}
+
+TEST(ClassicBalancerTest, sustained_imbalance) {
+  ClassicBalancer balancer(MakeConf());
+  std::vector<GroupLoad> groups = {MakeGroup("busy", 2, 1.0, 2),
+                                   MakeGroup("idle", 2, 0.1)};
+  std::vector<RoutineLoad> routines = {MakeRoutine(1, "busy", 0.2),
+                                       MakeRoutine(2, "busy", 0.9, true),
+                                       MakeRoutine(3, "idle", 0.2)};
+  Migration migration;
+  uint64_t now = kSecond;
+  EXPECT_FALSE(balancer.Balance(now, groups, routines, &migration));
+  EXPECT_FALSE(balancer.Balance(now += kSecond, groups, routines, &migration));
+  ASSERT_TRUE(balancer.Balance(now += kSecond, groups, routines, &migration));
+  // 2.0 against 0.1, moving routine 2 leaves them closest
+  EXPECT_EQ(2, migration.routine_id);
+  EXPECT_EQ("busy", migration.from);
+  EXPECT_EQ("idle", migration.to);
+  EXPECT_DOUBLE_EQ(2.0, migration.from_load);
+  EXPECT_DOUBLE_EQ(0.1, migration.to_load);
+
+  // cool down
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_FALSE(
+        balancer.Balance(now += kSecond, groups, routines, &migration));
+  }
+  ASSERT_TRUE(balancer.Balance(now += kSecond, groups, routines, &migration));
+}
+
+TEST(ClassicBalancerTest, hysteresis) {
+  ClassicBalancer balancer(MakeConf());
+  std::vector<GroupLoad> busy = {MakeGroup("a", 1, 1.0),
+                                 MakeGroup("b", 1, 0.2)};
+  std::vector<GroupLoad> even = {MakeGroup("a", 1, 0.6),
+                                 MakeGroup("b", 1, 0.5)};
+  std::vector<RoutineLoad> routines = {MakeRoutine(1, "a", 0.3)};
+  Migration migration;
+  uint64_t now = kSecond;
+  // spikes shorter than the sustain samples do not move anything
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_FALSE(balancer.Balance(now += kSecond, busy, routines, &migration));
+    EXPECT_FALSE(balancer.Balance(now += kSecond, busy, routines, &migration));
+    EXPECT_FALSE(balancer.Balance(now += kSecond, even, routines, &migration));
+  }
+
+  // nothing saturates
+  std::vector<GroupLoad> low = {MakeGroup("a", 1, 0.7),
+                                MakeGroup("b", 1, 0.0)};
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_FALSE(balancer.Balance(now += kSecond, low, routines, &migration));
+  }
+
+  // a routine that would make the idle group the busy one stays
+  routines = {MakeRoutine(1, "a", 0.95)};
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_FALSE(balancer.Balance(now += kSecond, busy, routines, &migration));
+  }
+  // the imbalance lasted, the first routine that fits moves
+  routines = {MakeRoutine(1, "a", 0.95), MakeRoutine(2, "a", 0.05)};
+  ASSERT_TRUE(balancer.Balance(now += kSecond, busy, routines, &migration));
+  EXPECT_EQ(2, migration.routine_id);
+}
+
+TEST(ClassicBalancerTest, pinned) {
+  ClassicBalancer balancer(MakeConf());
+  std::vector<GroupLoad> groups = {MakeGroup("a", 4, 1.0),
+                                   MakeGroup("b", 4, 0.0)};
+  // only routines of other groups are movable
+  std::vector<RoutineLoad> routines = {MakeRoutine(1, "b", 0.5)};
+  Migration migration;
+  uint64_t now = kSecond;
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_FALSE(
+        balancer.Balance(now += kSecond, groups, routines, &migration));
+  }
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
@@ -16,8 +16,13 @@
 
 #include "cyber/scheduler/policy/classic_context.h"
 
+#include <sched.h>
+
+#include <algorithm>
 #include <limits>
 
+#include "cyber/common/numa.h"
+
 namespace apollo {
 namespace cyber {
 namespace scheduler {
@@ -25,14 +30,25 @@ namespace scheduler {
 using apollo::cyber::base::AtomicRWLock;
 using apollo::cyber::base::ReadLockGuard;
 using apollo::cyber::base::WriteLockGuard;
+using apollo::cyber::common::CpuCacheDistance;
 using apollo::cyber::croutine::CRoutine;
 using apollo::cyber::croutine::RoutineState;
 
 alignas(CACHELINE_SIZE) GRP_WQ_MUTEX ClassicContext::mtx_wq_;
-alignas(CACHELINE_SIZE) GRP_WQ_CV ClassicContext::cv_wq_;
 alignas(CACHELINE_SIZE) RQ_LOCK_GROUP ClassicContext::rq_locks_;
 alignas(CACHELINE_SIZE) CR_GROUP ClassicContext::cr_group_;
 alignas(CACHELINE_SIZE) NOTIFY_GRP ClassicContext::notify_grp_;
+alignas(CACHELINE_SIZE) IDLE_GRP ClassicContext::idle_grp_;
+
+namespace {
+
+// the context of the processor running on this thread
+thread_local ClassicContext* current_context = nullptr;
+
+std::atomic<uint64_t> affinity_hits = {0};
+std::atomic<uint64_t> affinity_hints = {0};
+
+}  // namespace
 
 ClassicContext::ClassicContext() { InitGroup(DEFAULT_GROUP_NAME); }
 
@@ -40,11 +56,16 @@ ClassicContext::ClassicContext(const std::string& group_name) {
   InitGroup(group_name);
 }
 
+ClassicContext::~ClassicContext() {
+  std::lock_guard<std::mutex> lk(mtx_wrapper_->Mutex());
+  idle_->erase(std::remove(idle_->begin(), idle_->end(), this), idle_->end());
+}
+
 void ClassicContext::InitGroup(const std::string& group_name) {
   multi_pri_rq_ = &cr_group_[group_name];
   lq_ = &rq_locks_[group_name];
   mtx_wrapper_ = &mtx_wq_[group_name];
-  cw_ = &cv_wq_[group_name];
+  idle_ = &idle_grp_[group_name];
   notify_grp_[group_name] = 0;
   current_grp = group_name;
 }
@@ -53,8 +74,22 @@ std::shared_ptr<CRoutine> ClassicContext::NextRoutine() {
   if (cyber_unlikely(stop_.load())) {
     return nullptr;
   }
+  current_context = this;
 
+  auto hint = TakeHint();
   for (int i = MAX_PRIO - 1; i >= 0; --i) {
+    // the hinted routine goes first among those of its priority
+    if (hint != nullptr && hint->priority() == static_cast<uint32_t>(i)) {
+      if (hint->Acquire()) {
+        if (hint->UpdateState() == RoutineState::READY) {
+          affinity_hits.fetch_add(1, std::memory_order_relaxed);
+          return hint;
+        }
+        hint->Release();
+      }
+      hint.reset();
+    }
+
     ReadLockGuard<AtomicRWLock> lk(lq_->at(i));
     for (auto& cr : multi_pri_rq_->at(i)) {
       //协程已经被Acquire则continue
@@ -77,26 +112,104 @@ std::shared_ptr<CRoutine> ClassicContext::NextRoutine() {
 
 void ClassicContext::Wait() {
   std::unique_lock<std::mutex> lk(mtx_wrapper_->Mutex());
-  cw_->Cv().wait_for(lk, std::chrono::milliseconds(1000),
-                     [&]() { return notify_grp_[current_grp] > 0; });
-  if (notify_grp_[current_grp] > 0) {
-    notify_grp_[current_grp]--;
+  auto& notify = notify_grp_[current_grp];
+  if (notify == 0) {
+    cpu_ = sched_getcpu();
+    woken_ = false;
+    idle_->push_back(this);
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(1000);
+    // woken up without a notification left when another processor took it
+    while (notify == 0 && !woken_) {
+      if (cv_.wait_until(lk, deadline) == std::cv_status::timeout) {
+        break;
+      }
+    }
+    if (!woken_) {
+      idle_->erase(std::remove(idle_->begin(), idle_->end(), this),
+                   idle_->end());
+    }
+  }
+  if (notify > 0) {
+    notify--;
   }
 }
 
 void ClassicContext::Shutdown() {
   stop_.store(true);
-  mtx_wrapper_->Mutex().lock();
+  std::lock_guard<std::mutex> lk(mtx_wrapper_->Mutex());
   notify_grp_[current_grp] = std::numeric_limits<unsigned char>::max();
-  mtx_wrapper_->Mutex().unlock();
-  cw_->Cv().notify_all();
+  while (!idle_->empty()) {
+    idle_->back()->WakeUp();
+  }
+}
+
+void ClassicContext::WakeUp() {
+  idle_->erase(std::remove(idle_->begin(), idle_->end(), this), idle_->end());
+  woken_ = true;
+  cv_.notify_one();
+}
+
+void ClassicContext::SetHint(const std::shared_ptr<CRoutine>& cr) {
+  std::lock_guard<std::mutex> lk(hint_mutex_);
+  hint_ = cr;
+  has_hint_.store(true, std::memory_order_release);
+  affinity_hints.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::shared_ptr<CRoutine> ClassicContext::TakeHint() {
+  std::shared_ptr<CRoutine> hint;
+  if (!has_hint_.load(std::memory_order_acquire)) {
+    return hint;
+  }
+  std::lock_guard<std::mutex> lk(hint_mutex_);
+  hint.swap(hint_);
+  has_hint_.store(false, std::memory_order_relaxed);
+  return hint;
 }
 
 void ClassicContext::Notify(const std::string& group_name) {
-  (&mtx_wq_[group_name])->Mutex().lock();
+  std::lock_guard<std::mutex> lk(mtx_wq_[group_name].Mutex());
+  notify_grp_[group_name]++;
+  auto& idle = idle_grp_[group_name];
+  if (!idle.empty()) {
+    idle.back()->WakeUp();
+  }
+}
+
+void ClassicContext::Notify(const std::string& group_name,
+                            const std::shared_ptr<CRoutine>& cr, int cpu) {
+  std::lock_guard<std::mutex> lk(mtx_wq_[group_name].Mutex());
   notify_grp_[group_name]++;
-  (&mtx_wq_[group_name])->Mutex().unlock();
-  cv_wq_[group_name].Cv().notify_one();
+  auto& idle = idle_grp_[group_name];
+  ClassicContext* target = nullptr;
+  auto distance = common::NO_SHARED_CACHE;
+  for (auto ctx : idle) {
+    auto d = CpuCacheDistance(cpu, ctx->cpu_);
+    if (target == nullptr || d < distance) {
+      target = ctx;
+      distance = d;
+    }
+  }
+
+  if (target != nullptr && distance != common::NO_SHARED_CACHE) {
+    target->SetHint(cr);
+  } else if (current_context != nullptr &&
+             current_context->current_grp == group_name) {
+    current_context->SetHint(cr);
+  }
+  // a far processor still runs the routine rather than none
+  if (target != nullptr) {
+    target->WakeUp();
+  }
+}
+
+uint64_t ClassicContext::AffinityHits() {
+  return affinity_hits.load(std::memory_order_relaxed);
+}
+
+uint64_t ClassicContext::AffinityHints() {
+  return affinity_hints.load(std::memory_order_relaxed);
 }
 
 bool ClassicContext::RemoveCRoutine(const std::shared_ptr<CRoutine>& cr) {
@@ -18,6 +18,8 @@
 #define CYBER_SCHEDULER_POLICY_CLASSIC_CONTEXT_H_
 
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -27,7 +29,6 @@
 
 #include "cyber/base/atomic_rw_lock.h"
 #include "cyber/croutine/croutine.h"
-#include "cyber/scheduler/common/cv_wrapper.h"
 #include "cyber/scheduler/common/mutex_wrapper.h"
 #include "cyber/scheduler/processor_context.h"
 
@@ -46,29 +47,51 @@ using LOCK_QUEUE = std::array<base::AtomicRWLock, MAX_PRIO>;
 using RQ_LOCK_GROUP = std::unordered_map<std::string, LOCK_QUEUE>;
 
 using GRP_WQ_MUTEX = std::unordered_map<std::string, MutexWrapper>;
-using GRP_WQ_CV = std::unordered_map<std::string, CvWrapper>;
 using NOTIFY_GRP = std::unordered_map<std::string, int>;
 
+class ClassicContext;
+using IDLE_GRP = std::unordered_map<std::string, std::vector<ClassicContext *>>;
+
 class ClassicContext : public ProcessorContext {
  public:
   ClassicContext();
   explicit ClassicContext(const std::string &group_name);
+  ~ClassicContext();
 
   std::shared_ptr<CRoutine> NextRoutine() override;
   void Wait() override;
   void Shutdown() override;
 
   static void Notify(const std::string &group_name);
+
+  /**
+   * @brief Wake the idle processor of the group closest in cache to `cpu`,
+   * the cpu the data for `cr` was produced on, and have it try `cr` first.
+   * Without an idle processor sharing a cache, `cr` is left to the calling
+   * processor if it belongs to the group, it runs `cr` once the producer
+   * yields unless a woken processor took it before.
+   */
+  static void Notify(const std::string &group_name,
+                     const std::shared_ptr<CRoutine> &cr, int cpu);
   static bool RemoveCRoutine(const std::shared_ptr<CRoutine> &cr);
 
+  // routines run from a hint, and the hints given
+  static uint64_t AffinityHits();
+  static uint64_t AffinityHints();
+
   alignas(CACHELINE_SIZE) static CR_GROUP cr_group_;
   alignas(CACHELINE_SIZE) static RQ_LOCK_GROUP rq_locks_;
-  alignas(CACHELINE_SIZE) static GRP_WQ_CV cv_wq_;
   alignas(CACHELINE_SIZE) static GRP_WQ_MUTEX mtx_wq_;
   alignas(CACHELINE_SIZE) static NOTIFY_GRP notify_grp_;
+  // processors of a group waiting for work, under mtx_wq_ of the group
+  alignas(CACHELINE_SIZE) static IDLE_GRP idle_grp_;
 
  private:
   void InitGroup(const std::string &group_name);
+  // callers hold mtx_wq_ of the group
+  void WakeUp();
+  void SetHint(const std::shared_ptr<CRoutine> &cr);
+  std::shared_ptr<CRoutine> TakeHint();
 
   std::chrono::steady_clock::time_point wake_time_;
   bool need_sleep_ = false;
@@ -76,9 +99,19 @@ class ClassicContext : public ProcessorContext {
   MULTI_PRIO_QUEUE *multi_pri_rq_ = nullptr;
   LOCK_QUEUE *lq_ = nullptr;
   MutexWrapper *mtx_wrapper_ = nullptr;
-  CvWrapper *cw_ = nullptr;
+  std::vector<ClassicContext *> *idle_ = nullptr;
 
   std::string current_grp;
+
+  // each processor waits on its own cv so a notification can pick one
+  std::condition_variable cv_;
+  bool woken_ = false;
+  // cpu the processor was on when it went idle
+  int cpu_ = -1;
+
+  std::atomic<bool> has_hint_ = {false};
+  std::mutex hint_mutex_;
+  std::shared_ptr<CRoutine> hint_;
 };
 
 }  // namespace scheduler
@@ -22,6 +22,7 @@
 
 #include "cyber/common/environment.h"
 #include "cyber/common/file.h"
+#include "cyber/scheduler/common/sched_stats.h"
 #include "cyber/scheduler/policy/choreography_context.h"
 #include "cyber/scheduler/policy/classic_context.h"
 #include "cyber/scheduler/processor.h"
@@ -77,6 +78,16 @@ SchedulerChoreography::SchedulerChoreography()
     for (const auto& task : choreography_conf.tasks()) {
       cr_confs_[task.name()] = task;
     }
+
+    const auto& policy = choreography_conf.choreography_policy();
+    if (policy == "edf") {
+      choreography_policy_ = ChoreographyContext::Policy::EDF;
+    } else if (policy == "rm") {
+      choreography_policy_ = ChoreographyContext::Policy::RATE_MONOTONIC;
+    } else if (policy != "priority") {
+      AWARN << "unknown choreography policy " << policy
+            << ", using priority";
+    }
   }
 
   if (proc_num_ == 0) {
@@ -96,7 +107,7 @@ SchedulerChoreography::SchedulerChoreography()
 void SchedulerChoreography::CreateProcessor() {
   for (uint32_t i = 0; i < proc_num_; i++) {
     auto proc = std::make_shared<Processor>();
-    auto ctx = std::make_shared<ChoreographyContext>();
+    auto ctx = std::make_shared<ChoreographyContext>(choreography_policy_);
 
     proc->BindContext(ctx);
     SetSchedAffinity(proc->Thread(), choreography_cpuset_,
@@ -118,6 +129,11 @@ void SchedulerChoreography::CreateProcessor() {
     pctxs_.emplace_back(ctx);
     processors_.emplace_back(proc);
   }
+
+  std::vector<int> processor_cpus(choreography_cpuset_);
+  processor_cpus.insert(processor_cpus.end(), pool_cpuset_.begin(),
+                        pool_cpuset_.end());
+  PublishProcessorCpus(processor_cpus);
 }
 
 bool SchedulerChoreography::DispatchTask(const std::shared_ptr<CRoutine>& cr) {
@@ -136,6 +152,8 @@ bool SchedulerChoreography::DispatchTask(const std::shared_ptr<CRoutine>& cr) {
   std::lock_guard<std::mutex> lg(wrapper->Mutex());
 
   // Assign sched cfg to tasks according to configuration.
+  uint64_t period_ns = 0;
+  uint64_t deadline_ns = 0;
   if (cr_confs_.find(cr->name()) != cr_confs_.end()) {
     ChoreographyTask taskconf = cr_confs_[cr->name()];
     cr->set_priority(taskconf.prio());
@@ -143,6 +161,8 @@ bool SchedulerChoreography::DispatchTask(const std::shared_ptr<CRoutine>& cr) {
     if (taskconf.has_processor()) {
       cr->set_processor_id(taskconf.processor());
     }
+    period_ns = taskconf.period_us() * 1000;
+    deadline_ns = taskconf.deadline_us() * 1000;
   }
 
   {
@@ -157,7 +177,8 @@ bool SchedulerChoreography::DispatchTask(const std::shared_ptr<CRoutine>& cr) {
   uint32_t pid = cr->processor_id();
   if (pid < proc_num_) {
     // Enqueue task to Choreo Policy.
-    static_cast<ChoreographyContext*>(pctxs_[pid].get())->Enqueue(cr);
+    static_cast<ChoreographyContext*>(pctxs_[pid].get())
+        ->Enqueue(cr, period_ns, deadline_ns);
   } else {
     // Check if task prio is reasonable.
     if (cr->priority() >= MAX_PRIO) {
@@ -219,12 +240,17 @@ bool SchedulerChoreography::RemoveCRoutine(uint64_t crid) {
   }
 
   // rm cr from pool if rt not in choreo context
+  bool removed = false;
   if (pid < proc_num_) {
-    return static_cast<ChoreographyContext*>(pctxs_[pid].get())
-        ->RemoveCRoutine(crid);
+    removed = static_cast<ChoreographyContext*>(pctxs_[pid].get())
+                  ->RemoveCRoutine(crid);
   } else {
-    return ClassicContext::RemoveCRoutine(cr);
+    removed = ClassicContext::RemoveCRoutine(cr);
   }
+  if (removed) {
+    SchedStats::Instance()->ReleaseRoutineSlot(crid);
+  }
+  return removed;
 }
 
 bool SchedulerChoreography::NotifyProcessor(uint64_t crid) {
@@ -252,7 +278,7 @@ bool SchedulerChoreography::NotifyProcessor(uint64_t crid) {
   }
 
   if (pid < proc_num_) {
-    static_cast<ChoreographyContext*>(pctxs_[pid].get())->Notify();
+    static_cast<ChoreographyContext*>(pctxs_[pid].get())->Notify(crid);
   } else {
     ClassicContext::Notify(cr->group_name());
   }
@@ -260,6 +286,37 @@ bool SchedulerChoreography::NotifyProcessor(uint64_t crid) {
   return true;
 }
 
+std::vector<ChoreographyContext::DeadlineStats>
+SchedulerChoreography::GetDeadlineStats() {
+  std::vector<ChoreographyContext::DeadlineStats> stats;
+  for (uint32_t i = 0; i < proc_num_ && i < pctxs_.size(); ++i) {
+    auto ctx_stats =
+        static_cast<ChoreographyContext*>(pctxs_[i].get())->GetDeadlineStats();
+    stats.insert(stats.end(), ctx_stats.begin(), ctx_stats.end());
+  }
+  return stats;
+}
+
+std::string SchedulerChoreography::DumpDeadlineStats() {
+  std::string info;
+  for (auto& stats : GetDeadlineStats()) {
+    if (stats.jobs == 0) {
+      continue;
+    }
+    info.append(stats.name)
+        .append(" deadline_us: ")
+        .append(std::to_string(stats.deadline_ns / 1000))
+        .append(", jobs: ")
+        .append(std::to_string(stats.jobs))
+        .append(", misses: ")
+        .append(std::to_string(stats.misses))
+        .append(", max_lateness_us: ")
+        .append(std::to_string(stats.max_lateness_ns / 1000))
+        .append("\n");
+  }
+  return info;
+}
+
 }  // namespace scheduler
 }  // namespace cyber
 }  // namespace apollo
@@ -24,6 +24,7 @@
 
 #include "cyber/croutine/croutine.h"
 #include "cyber/proto/choreography_conf.pb.h"
+#include "cyber/scheduler/policy/choreography_context.h"
 #include "cyber/scheduler/scheduler.h"
 
 namespace apollo {
@@ -39,6 +40,10 @@ class SchedulerChoreography : public Scheduler {
   bool RemoveTask(const std::string& name) override;
   bool DispatchTask(const std::shared_ptr<CRoutine>&) override;
 
+  // jobs and deadline misses of the choreography tasks with a deadline
+  std::vector<ChoreographyContext::DeadlineStats> GetDeadlineStats();
+  std::string DumpDeadlineStats();
+
  private:
   friend Scheduler* Instance();
   SchedulerChoreography();
@@ -47,6 +52,8 @@ class SchedulerChoreography : public Scheduler {
   bool NotifyProcessor(uint64_t crid) override;
 
   std::unordered_map<std::string, ChoreographyTask> cr_confs_;
+  ChoreographyContext::Policy choreography_policy_ =
+      ChoreographyContext::Policy::PRIORITY;
 
   int32_t choreography_processor_prio_;
   int32_t pool_processor_prio_;
@@ -16,14 +16,18 @@
 
 #include "cyber/scheduler/policy/scheduler_classic.h"
 
+#include <sched.h>
+
 #include <algorithm>
 #include <memory>
 #include <utility>
 
 #include "cyber/common/environment.h"
 #include "cyber/common/file.h"
+#include "cyber/scheduler/common/sched_stats.h"
 #include "cyber/scheduler/policy/classic_context.h"
 #include "cyber/scheduler/processor.h"
+#include "cyber/time/time.h"
 
 namespace apollo {
 namespace cyber {
@@ -37,6 +41,7 @@ using apollo::cyber::common::GlobalData;
 using apollo::cyber::common::PathExists;
 using apollo::cyber::common::WorkRoot;
 using apollo::cyber::croutine::RoutineState;
+using apollo::cyber::Time;
 
 SchedulerClassic::SchedulerClassic() {
   std::string conf("conf/");
@@ -57,6 +62,9 @@ SchedulerClassic::SchedulerClassic() {
     classic_conf_ = cfg.scheduler_conf().classic_conf();
     for (auto& group : classic_conf_.groups()) {
       auto& group_name = group.name();
+      if (group.data_affinity()) {
+        affinity_groups_.insert(group_name);
+      }
       for (auto task : group.tasks()) {
         task.set_group_name(group_name);
         cr_confs_[task.name()] = task;
@@ -79,9 +87,19 @@ SchedulerClassic::SchedulerClassic() {
   }
 
   CreateProcessor();
+
+  auto& balancer_conf = classic_conf_.balancer();
+  if (balancer_conf.enable() && balancer_conf.interval_ms() > 0 &&
+      classic_conf_.groups_size() > 1) {
+    balancer_.reset(new ClassicBalancer(balancer_conf));
+    balancer_thread_ =
+        std::thread(&SchedulerClassic::BalancerThreadFunc, this);
+    SetInnerThreadAttr("sched_balancer", &balancer_thread_);
+  }
 }
 
 void SchedulerClassic::CreateProcessor() {
+  std::vector<int> processor_cpus;
   for (auto& group : classic_conf_.groups()) {
     auto& group_name = group.name();
     auto proc_num = group.processor_num();
@@ -94,6 +112,7 @@ void SchedulerClassic::CreateProcessor() {
     auto processor_prio = group.processor_prio();
     std::vector<int> cpuset;
     ParseCpuset(group.cpuset(), &cpuset);
+    processor_cpus.insert(processor_cpus.end(), cpuset.begin(), cpuset.end());
 
     for (uint32_t i = 0; i < proc_num; i++) {
       auto ctx = std::make_shared<ClassicContext>(group_name);
@@ -105,8 +124,10 @@ void SchedulerClassic::CreateProcessor() {
       SetSchedPolicy(proc->Thread(), processor_policy, processor_prio,
                      proc->Tid());
       processors_.emplace_back(proc);
+      processor_groups_.emplace_back(group_name);
     }
   }
+  PublishProcessorCpus(processor_cpus);
 }
 
 bool SchedulerClassic::DispatchTask(const std::shared_ptr<CRoutine>& cr) {
@@ -176,7 +197,13 @@ bool SchedulerClassic::NotifyProcessor(uint64_t crid) {
         cr->SetUpdateFlag();
       }
       // 然后通知group
-      ClassicContext::Notify(cr->group_name());
+      if (!affinity_groups_.empty() &&
+          affinity_groups_.count(cr->group_name()) > 0) {
+        // the data was produced on the cpu of this thread
+        ClassicContext::Notify(cr->group_name(), cr, sched_getcpu());
+      } else {
+        ClassicContext::Notify(cr->group_name());
+      }
       return true;
     }
   }
@@ -218,7 +245,210 @@ bool SchedulerClassic::RemoveCRoutine(uint64_t crid) {
       return false;
     }
   }
-  return ClassicContext::RemoveCRoutine(cr);
+  if (!ClassicContext::RemoveCRoutine(cr)) {
+    return false;
+  }
+  SchedStats::Instance()->ReleaseRoutineSlot(crid);
+  return true;
+}
+
+bool SchedulerClassic::MigrateCRoutine(uint64_t crid,
+                                       const std::string& group_name) {
+  if (cyber_unlikely(stop_)) {
+    return false;
+  }
+  // routines of a group without processors would never run again
+  if (std::find(processor_groups_.begin(), processor_groups_.end(),
+                group_name) == processor_groups_.end()) {
+    AWARN << "cannot migrate to group " << group_name
+          << " without processors.";
+    return false;
+  }
+
+  MutexWrapper* wrapper = nullptr;
+  if (!id_map_mutex_.Get(crid, &wrapper)) {
+    {
+      std::lock_guard<std::mutex> wl_lg(cr_wl_mtx_);
+      if (!id_map_mutex_.Get(crid, &wrapper)) {
+        wrapper = new MutexWrapper();
+        id_map_mutex_.Set(crid, wrapper);
+      }
+    }
+  }
+  std::lock_guard<std::mutex> lg(wrapper->Mutex());
+
+  std::shared_ptr<CRoutine> cr = nullptr;
+  {
+    ReadLockGuard<AtomicRWLock> lk(id_cr_lock_);
+    auto itr = id_cr_.find(crid);
+    if (itr == id_cr_.end()) {
+      return false;
+    }
+    cr = itr->second;
+  }
+
+  // the group only changes under the wrapper lock held here
+  auto from = cr->group_name();
+  if (from == group_name) {
+    return true;
+  }
+  auto prio = cr->priority();
+  {
+    WriteLockGuard<AtomicRWLock> lk(ClassicContext::rq_locks_[from].at(prio));
+    auto& croutines = ClassicContext::cr_group_[from].at(prio);
+    auto itr = std::find(croutines.begin(), croutines.end(), cr);
+    if (itr == croutines.end()) {
+      return false;
+    }
+    // a running routine stays, it is not worth to wait for it here
+    if (!cr->Acquire()) {
+      ADEBUG << "croutine " << cr->name() << " is running, not migrated.";
+      return false;
+    }
+    croutines.erase(itr);
+  }
+
+  {
+    // NotifyProcessor reads the group under the read lock
+    WriteLockGuard<AtomicRWLock> lk(id_cr_lock_);
+    cr->set_group_name(group_name);
+  }
+  {
+    WriteLockGuard<AtomicRWLock> lk(
+        ClassicContext::rq_locks_[group_name].at(prio));
+    ClassicContext::cr_group_[group_name].at(prio).emplace_back(cr);
+  }
+  cr->Release();
+  ClassicContext::Notify(group_name);
+
+  AINFO << "migrated croutine " << cr->name() << " from group " << from
+        << " to group " << group_name << ".";
+  return true;
+}
+
+void SchedulerClassic::BalanceLoad() {
+  if (balancer_ == nullptr || cyber_unlikely(stop_)) {
+    return;
+  }
+
+  uint64_t now = Time::MonoTime().ToNanosecond();
+  uint64_t elapsed = last_sample_ns_ == 0 ? 0 : now - last_sample_ns_;
+  last_sample_ns_ = now;
+
+  std::vector<GroupLoad> groups;
+  std::unordered_map<std::string, size_t> group_index;
+  for (auto& group : classic_conf_.groups()) {
+    group_index[group.name()] = groups.size();
+    groups.emplace_back();
+    groups.back().name = group.name();
+  }
+  std::unordered_map<int, size_t> processor_index;
+  for (size_t i = 0; i < processors_.size(); ++i) {
+    auto idx = group_index[processor_groups_[i]];
+    ++groups[idx].processor_num;
+    processor_index[processors_[i]->Tid().load()] = idx;
+  }
+
+  // busy and run time grow monotonically, the load is the difference to
+  // the last sample
+  std::unordered_map<int, uint64_t> processor_busy_ns;
+  for (auto& stats : ProcessorStats()) {
+    auto itr = processor_index.find(stats.tid);
+    if (itr == processor_index.end()) {
+      continue;
+    }
+    auto last = processor_busy_ns_.find(stats.tid);
+    if (elapsed > 0 && last != processor_busy_ns_.end() &&
+        stats.busy_ns > last->second) {
+      groups[itr->second].utilization +=
+          static_cast<double>(stats.busy_ns - last->second) / elapsed;
+    }
+    processor_busy_ns[stats.tid] = stats.busy_ns;
+  }
+  processor_busy_ns_.swap(processor_busy_ns);
+  for (auto& group : groups) {
+    if (group.processor_num > 0) {
+      group.utilization /= group.processor_num;
+    }
+  }
+
+  std::unordered_map<uint64_t, double> routine_utilization;
+  std::unordered_map<uint64_t, uint64_t> routine_run_ns;
+  for (auto& stats : RoutineStats()) {
+    auto last = routine_run_ns_.find(stats.routine_id);
+    if (elapsed > 0 && last != routine_run_ns_.end() &&
+        stats.run_ns > last->second) {
+      routine_utilization[stats.routine_id] =
+          static_cast<double>(stats.run_ns - last->second) / elapsed;
+    }
+    routine_run_ns[stats.routine_id] = stats.run_ns;
+  }
+  routine_run_ns_.swap(routine_run_ns);
+
+  std::vector<RoutineLoad> movable;
+  {
+    ReadLockGuard<AtomicRWLock> lk(id_cr_lock_);
+    for (auto& item : id_cr_) {
+      auto& cr = item.second;
+      auto itr = group_index.find(cr->group_name());
+      if (itr == group_index.end()) {
+        continue;
+      }
+      bool pending = cr->IsUpdatePending();
+      if (pending) {
+        ++groups[itr->second].pending;
+      }
+      if (cr_confs_.find(cr->name()) != cr_confs_.end()) {
+        continue;
+      }
+      RoutineLoad load;
+      load.id = cr->id();
+      load.group = cr->group_name();
+      load.pending = pending;
+      auto utilization = routine_utilization.find(cr->id());
+      if (utilization != routine_utilization.end()) {
+        load.utilization = utilization->second;
+      }
+      movable.emplace_back(load);
+    }
+  }
+
+  // the first sample is only the base of the next one
+  if (elapsed == 0) {
+    return;
+  }
+  Migration migration;
+  if (!balancer_->Balance(now, groups, movable, &migration)) {
+    return;
+  }
+  AINFO << "group " << migration.from << " load " << migration.from_load
+        << ", group " << migration.to << " load " << migration.to_load
+        << ", balancing.";
+  MigrateCRoutine(migration.routine_id, migration.to);
+}
+
+void SchedulerClassic::BalancerThreadFunc() {
+  std::chrono::milliseconds interval(classic_conf_.balancer().interval_ms());
+  std::unique_lock<std::mutex> lk(balancer_mutex_);
+  while (!stop_.load()) {
+    balancer_cv_.wait_for(lk, interval, [this]() { return stop_.load(); });
+    if (stop_.load()) {
+      break;
+    }
+    lk.unlock();
+    BalanceLoad();
+    lk.lock();
+  }
+}
+
+void SchedulerClassic::StopPolicyThreads() {
+  {
+    std::lock_guard<std::mutex> lk(balancer_mutex_);
+  }
+  balancer_cv_.notify_all();
+  if (balancer_thread_.joinable()) {
+    balancer_thread_.join();
+  }
 }
 
 }  // namespace scheduler
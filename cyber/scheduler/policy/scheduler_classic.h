@@ -17,13 +17,19 @@
 #ifndef CYBER_SCHEDULER_POLICY_SCHEDULER_CLASSIC_H_
 #define CYBER_SCHEDULER_POLICY_SCHEDULER_CLASSIC_H_
 
+#include <condition_variable>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "cyber/croutine/croutine.h"
 #include "cyber/proto/classic_conf.pb.h"
+#include "cyber/scheduler/policy/classic_balancer.h"
 #include "cyber/scheduler/scheduler.h"
 
 namespace apollo {
@@ -40,16 +46,46 @@ class SchedulerClassic : public Scheduler {
   bool RemoveTask(const std::string& name) override;
   bool DispatchTask(const std::shared_ptr<CRoutine>&) override;
 
+  /**
+   * @brief Move a routine to the runqueue of another group, it keeps its
+   * priority
+   *
+   * @return false if the routine or group is unknown, or the routine is
+   * running and could not be taken off its runqueue
+   */
+  bool MigrateCRoutine(uint64_t crid, const std::string& group_name);
+
+  /**
+   * @brief Sample the load of the groups and migrate one routine if the
+   * balancer decides so, called by the balancer thread every interval
+   */
+  void BalanceLoad();
+
  private:
   friend Scheduler* Instance();
   SchedulerClassic();
 
   void CreateProcessor();
   bool NotifyProcessor(uint64_t crid) override;
+  void StopPolicyThreads() override;
+  void BalancerThreadFunc();
 
   std::unordered_map<std::string, ClassicTask> cr_confs_;
 
   ClassicConf classic_conf_;
+  std::unordered_set<std::string> affinity_groups_;
+
+  // group of each processor, in the order of processors_
+  std::vector<std::string> processor_groups_;
+
+  std::unique_ptr<ClassicBalancer> balancer_;
+  std::thread balancer_thread_;
+  std::mutex balancer_mutex_;
+  std::condition_variable balancer_cv_;
+  // cumulative run time of the last sample
+  uint64_t last_sample_ns_ = 0;
+  std::unordered_map<int, uint64_t> processor_busy_ns_;
+  std::unordered_map<uint64_t, uint64_t> routine_run_ns_;
 };
 
 }  // namespace scheduler
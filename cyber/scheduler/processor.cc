@@ -22,10 +22,10 @@
 
 #include <chrono>
 
+#include "cyber/base/cycle_clock.h"
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
 #include "cyber/croutine/croutine.h"
-#include "cyber/time/time.h"
 
 namespace apollo {
 namespace cyber {
@@ -41,19 +41,32 @@ void Processor::Run() {
   tid_.store(static_cast<int>(syscall(SYS_gettid)));
   AINFO << "processor_tid: " << tid_;
   snap_shot_->processor_id.store(tid_);
+  stats_slot_ = SchedStats::Instance()->GetProcessorSlot(tid_);
 
+  uint64_t last_routine_id = 0;
   while (cyber_likely(running_.load())) {
     if (cyber_likely(context_ != nullptr)) {
       auto croutine = context_->NextRoutine();
       if (croutine) {
-        snap_shot_->execute_start_time.store(cyber::Time::Now().ToNanosecond());
-        snap_shot_->routine_name = croutine->name();
+        uint64_t start = base::CycleClock::Now();
+        snap_shot_->execute_start_cycles.store(start);
+        if (croutine->id() != last_routine_id) {
+          snap_shot_->routine_name = croutine->name();
+          last_routine_id = croutine->id();
+        }
+        uint64_t update = croutine->TakeUpdateTime();
         // 将thread_local类型的变量current_coutine_设置为当前协程然后执行它的入口函数
         croutine->Resume();
+        uint64_t run = base::CycleClock::Now() - start;
+        // before Release, another processor may resume it right after
+        SchedStats::OnRun(GetRoutineSlot(*croutine), tid_, run,
+                          update != 0 && start > update ? start - update : 0);
+        SchedStats::OnRun(stats_slot_, run);
         // 反Acquire()操作
         croutine->Release();
       } else {
-        snap_shot_->execute_start_time.store(0);
+        snap_shot_->execute_start_cycles.store(0);
+        SchedStats::OnWait(stats_slot_);
         context_->Wait();
       }
     } else {
@@ -84,6 +97,26 @@ void Processor::BindContext(const std::shared_ptr<ProcessorContext>& context) {
                  [this]() { thread_ = std::thread(&Processor::Run, this); });
 }
 
+SchedStats::RoutineSlot* Processor::GetRoutineSlot(const CRoutine& cr) {
+  auto stats = SchedStats::Instance();
+  // slots of removed routines may belong to others by now
+  uint64_t releases = stats->routine_releases();
+  if (releases != routine_releases_) {
+    routine_slots_.clear();
+    routine_releases_ = releases;
+  }
+  auto it = routine_slots_.find(cr.id());
+  if (it != routine_slots_.end()) {
+    return it->second;
+  }
+  auto slot = stats->GetRoutineSlot(cr.id(), cr.name());
+  // asked again while the page is full
+  if (slot != nullptr) {
+    routine_slots_[cr.id()] = slot;
+  }
+  return slot;
+}
+
 std::atomic<pid_t>& Processor::Tid() {
   while (tid_.load() == -1) {
     cpu_relax();
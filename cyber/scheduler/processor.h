@@ -23,11 +23,13 @@
 #include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "cyber/proto/scheduler_conf.pb.h"
 
 #include "cyber/croutine/croutine.h"
+#include "cyber/scheduler/common/sched_stats.h"
 #include "cyber/scheduler/processor_context.h"
 
 namespace apollo {
@@ -37,7 +39,8 @@ namespace scheduler {
 using croutine::CRoutine;
 
 struct Snapshot {
-  std::atomic<uint64_t> execute_start_time = {0};
+  // CycleClock count at the resume of the running routine, 0 while idle
+  std::atomic<uint64_t> execute_start_cycles = {0};
   std::atomic<pid_t> processor_id = {0};
   std::string routine_name;
 };
@@ -56,6 +59,8 @@ class Processor {
   std::shared_ptr<Snapshot> ProcSnapshot() { return snap_shot_; }
 
  private:
+  SchedStats::RoutineSlot* GetRoutineSlot(const CRoutine& cr);
+
   std::shared_ptr<ProcessorContext> context_;
 
   std::condition_variable cv_ctx_;
@@ -67,6 +72,11 @@ class Processor {
   std::atomic<bool> running_{false};
 
   std::shared_ptr<Snapshot> snap_shot_ = std::make_shared<Snapshot>();
+
+  // only touched by the processor thread
+  SchedStats::ProcessorSlot* stats_slot_ = nullptr;
+  std::unordered_map<uint64_t, SchedStats::RoutineSlot*> routine_slots_;
+  uint64_t routine_releases_ = 0;
 };
 
 }  // namespace scheduler
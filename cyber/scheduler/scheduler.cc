@@ -18,8 +18,12 @@
 
 #include <sched.h>
 
+#include <unistd.h>
+
+#include <algorithm>
 #include <utility>
 
+#include "cyber/base/cycle_clock.h"
 #include "cyber/common/environment.h"
 #include "cyber/common/file.h"
 #include "cyber/common/global_data.h"
@@ -92,6 +96,16 @@ void Scheduler::ProcessLevelResourceControl() {
   pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
 }
 
+void Scheduler::PublishProcessorCpus(const std::vector<int>& cpus) {
+  std::vector<int> all(cpus);
+  if (all.empty() && !process_level_cpuset_.empty()) {
+    ParseCpuset(process_level_cpuset_, &all);
+  }
+  std::sort(all.begin(), all.end());
+  all.erase(std::unique(all.begin(), all.end()), all.end());
+  GlobalData::Instance()->SetProcessorCpus(all);
+}
+
 void Scheduler::SetInnerThreadAttr(const std::string& name, std::thread* thr) {
   if (thr != nullptr && inner_thr_confs_.find(name) != inner_thr_confs_.end()) {
     auto th_conf = inner_thr_confs_[name];
@@ -107,10 +121,16 @@ void Scheduler::SetInnerThreadAttr(const std::string& name, std::thread* thr) {
 void Scheduler::CheckSchedStatus() {
   std::string snap_info;
   auto now = Time::Now().ToNanosecond();
+  auto now_cycles = base::CycleClock::Now();
   for (auto processor : processors_) {
     auto snap = processor->ProcSnapshot();
-    if (snap->execute_start_time.load()) {
-      auto execute_time = (now - snap->execute_start_time.load()) / 1000000;
+    auto start_cycles = snap->execute_start_cycles.load();
+    if (start_cycles) {
+      auto execute_time =
+          now_cycles > start_cycles
+              ? base::CycleClock::ToNanosecond(now_cycles - start_cycles) /
+                    1000000
+              : 0;
       snap_info.append(std::to_string(snap->processor_id.load()))
           .append(":")
           .append(snap->routine_name)
@@ -132,6 +152,7 @@ void Scheduler::Shutdown() {
     return;
   }
 
+  StopPolicyThreads();
   for (auto& ctx : pctxs_) {
     ctx->Shutdown();
   }
@@ -154,6 +175,15 @@ void Scheduler::Shutdown() {
 
   processors_.clear();
   pctxs_.clear();
+  SchedStats::Instance()->Release();
+}
+
+std::vector<RoutineStatsSnapshot> Scheduler::RoutineStats() const {
+  return SchedStats::Instance()->ReadRoutines(getpid());
+}
+
+std::vector<ProcessorStatsSnapshot> Scheduler::ProcessorStats() const {
+  return SchedStats::Instance()->ReadProcessors(getpid());
 }
 }  // namespace scheduler
 }  // namespace cyber
@@ -39,6 +39,7 @@
 #include "cyber/croutine/routine_factory.h"
 #include "cyber/scheduler/common/mutex_wrapper.h"
 #include "cyber/scheduler/common/pin_thread.h"
+#include "cyber/scheduler/common/sched_stats.h"
 
 namespace apollo {
 namespace cyber {
@@ -79,6 +80,11 @@ class Scheduler {
 
   void CheckSchedStatus();
 
+  // run time and wake up latency of the routines and processors of this
+  // process, cumulative since they first ran
+  std::vector<RoutineStatsSnapshot> RoutineStats() const;
+  std::vector<ProcessorStatsSnapshot> ProcessorStats() const;
+
   void SetInnerThreadConfs(
       const std::unordered_map<std::string, InnerThread>& confs) {
     inner_thr_confs_ = confs;
@@ -87,6 +93,12 @@ class Scheduler {
  protected:
   Scheduler() : stop_(false) {}
 
+  // records the cpus processors run on, memory placement follows them
+  void PublishProcessorCpus(const std::vector<int>& cpus);
+
+  // stops the threads of the policy, before the routines are removed
+  virtual void StopPolicyThreads() {}
+
   AtomicRWLock id_cr_lock_;
   AtomicHashMap<uint64_t, MutexWrapper*> id_map_mutex_;
   std::mutex cr_wl_mtx_;
@@ -15,6 +15,10 @@
  *****************************************************************************/
 
 #include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -30,6 +34,8 @@ namespace apollo {
 namespace cyber {
 namespace scheduler {
 
+using apollo::cyber::croutine::RoutineState;
+
 void func() {}
 
 TEST(SchedulerChoreoTest, choreo) {
@@ -44,6 +50,110 @@ TEST(SchedulerChoreoTest, choreo) {
   ctx->Shutdown();
 }
 
+TEST(SchedulerChoreoTest, earliest_deadline_first) {
+  ChoreographyContext ctx(ChoreographyContext::Policy::EDF);
+  std::vector<std::shared_ptr<CRoutine>> crs;
+  // deadlines 30ms, 10ms, none and 20ms
+  for (uint64_t deadline_ms : {30, 10, 0, 20}) {
+    auto cr = std::make_shared<CRoutine>(func);
+    cr->set_id(GlobalData::RegisterTaskName("choreo_edf" +
+                                            std::to_string(crs.size())));
+    cr->set_name("choreo_edf" + std::to_string(crs.size()));
+    EXPECT_TRUE(ctx.Enqueue(cr, 0, deadline_ms * 1000000));
+    crs.emplace_back(cr);
+  }
+
+  // runs each task once and leaves it waiting for data
+  auto run_next = [&ctx]() {
+    auto cr = ctx.NextRoutine();
+    if (cr != nullptr) {
+      cr->set_state(RoutineState::DATA_WAIT);
+      cr->Release();
+    }
+    return cr;
+  };
+  EXPECT_EQ(crs[1], run_next());
+  EXPECT_EQ(crs[3], run_next());
+  EXPECT_EQ(crs[0], run_next());
+  EXPECT_EQ(crs[2], run_next());
+  EXPECT_EQ(nullptr, run_next());
+
+  // released by notifications, in deadline order again
+  for (auto idx : {2, 3, 0, 1}) {
+    crs[idx]->SetUpdateFlag();
+    ctx.Notify(crs[idx]->id());
+  }
+  EXPECT_EQ(crs[1], run_next());
+  EXPECT_EQ(crs[3], run_next());
+  EXPECT_EQ(crs[0], run_next());
+  EXPECT_EQ(crs[2], run_next());
+  EXPECT_EQ(nullptr, run_next());
+
+  for (auto& stats : ctx.GetDeadlineStats()) {
+    EXPECT_EQ(2, stats.jobs);
+    EXPECT_EQ(0, stats.misses);
+  }
+  EXPECT_EQ(3, ctx.GetDeadlineStats().size());
+
+  EXPECT_TRUE(ctx.RemoveCRoutine(crs[1]->id()));
+  EXPECT_FALSE(ctx.RemoveCRoutine(crs[1]->id()));
+  crs[1]->SetUpdateFlag();
+  ctx.Notify(crs[1]->id());
+  EXPECT_EQ(nullptr, run_next());
+  ctx.Shutdown();
+}
+
+TEST(SchedulerChoreoTest, deadline_miss) {
+  ChoreographyContext ctx;
+  auto cr = std::make_shared<CRoutine>(func);
+  cr->set_id(GlobalData::RegisterTaskName("choreo_deadline_miss"));
+  cr->set_name("choreo_deadline_miss");
+  // a period of 1ms is the deadline as well
+  EXPECT_TRUE(ctx.Enqueue(cr, 1000000));
+
+  EXPECT_EQ(cr, ctx.NextRoutine());
+  cr->set_state(RoutineState::DATA_WAIT);
+  cr->Release();
+  EXPECT_EQ(nullptr, ctx.NextRoutine());
+
+  cr->SetUpdateFlag();
+  ctx.Notify(cr->id());
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  EXPECT_EQ(cr, ctx.NextRoutine());
+  cr->set_state(RoutineState::DATA_WAIT);
+  cr->Release();
+  EXPECT_EQ(nullptr, ctx.NextRoutine());
+
+  auto stats = ctx.GetDeadlineStats();
+  ASSERT_EQ(1, stats.size());
+  EXPECT_EQ(1000000, stats[0].deadline_ns);
+  EXPECT_EQ(2, stats[0].jobs);
+  EXPECT_EQ(1, stats[0].misses);
+  EXPECT_LE(4000000, stats[0].max_lateness_ns);
+  ctx.Shutdown();
+}
+
+TEST(SchedulerChoreoTest, rate_monotonic) {
+  ChoreographyContext ctx(ChoreographyContext::Policy::RATE_MONOTONIC);
+  std::vector<std::shared_ptr<CRoutine>> crs;
+  // periods 100ms, none with a high priority and 10ms
+  for (uint64_t period_ms : {100, 0, 10}) {
+    auto cr = std::make_shared<CRoutine>(func);
+    cr->set_id(
+        GlobalData::RegisterTaskName("choreo_rm" + std::to_string(crs.size())));
+    cr->set_priority(10);
+    EXPECT_TRUE(ctx.Enqueue(cr, period_ms * 1000000));
+    crs.emplace_back(cr);
+  }
+  for (auto idx : {2, 0, 1}) {
+    auto cr = ctx.NextRoutine();
+    EXPECT_EQ(crs[idx], cr);
+    cr->set_state(RoutineState::DATA_WAIT);
+    cr->Release();
+  }
+  ctx.Shutdown();
+}
+
 TEST(SchedulerChoreoTest, sched_choreo) {
   GlobalData::Instance()->SetProcessGroup("example_sched_choreography");
   auto sched = dynamic_cast<SchedulerChoreography*>(scheduler::Instance());
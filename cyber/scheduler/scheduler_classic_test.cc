@@ -16,6 +16,11 @@
 
 #include "cyber/scheduler/policy/scheduler_classic.h"
 
+#include <sched.h>
+
+#include <algorithm>
+#include <thread>
+
 #include "gtest/gtest.h"
 
 #include "cyber/base/for_each.h"
@@ -60,6 +65,68 @@ TEST(SchedulerClassicTest, classic) {
   processor->Stop();
 }
 
+TEST(SchedulerClassicTest, data_affinity) {
+  const std::string group("data_affinity_grp");
+  ClassicContext producer(group);
+  ClassicContext consumer(group);
+  std::vector<std::shared_ptr<CRoutine>> crs;
+  for (int i = 0; i < 2; ++i) {
+    auto cr = std::make_shared<CRoutine>(func);
+    cr->set_id(GlobalData::RegisterTaskName("data_affinity" +
+                                            std::to_string(i)));
+    cr->set_group_name(group);
+    ClassicContext::cr_group_[group].at(cr->priority()).emplace_back(cr);
+    crs.emplace_back(cr);
+  }
+
+  // nobody is idle, the calling processor runs the routine next
+  EXPECT_EQ(crs[0], producer.NextRoutine());
+  crs[0]->Release();
+  auto hits = ClassicContext::AffinityHits();
+  ClassicContext::Notify(group, crs[1], sched_getcpu());
+  EXPECT_EQ(crs[1], producer.NextRoutine());
+  crs[1]->Release();
+  EXPECT_EQ(hits + 1, ClassicContext::AffinityHits());
+  // takes the notification left by nobody waiting
+  producer.Wait();
+
+  // an idle processor on the same cpu is woken up and given the routine
+  auto& idle = ClassicContext::idle_grp_[group];
+  auto is_idle = [&]() {
+    std::lock_guard<std::mutex> lk(ClassicContext::mtx_wq_[group].Mutex());
+    return std::find(idle.begin(), idle.end(), &consumer) != idle.end();
+  };
+  // both on one cpu, the scheduler may move threads between any two
+  int cpu = sched_getcpu();
+  ASSERT_LE(0, cpu);
+  cpu_set_t saved;
+  ASSERT_EQ(0, sched_getaffinity(0, sizeof(saved), &saved));
+  cpu_set_t pinned;
+  CPU_ZERO(&pinned);
+  CPU_SET(cpu, &pinned);
+  ASSERT_EQ(0, sched_setaffinity(0, sizeof(pinned), &pinned));
+  std::thread waiter([&consumer, &pinned]() {
+    sched_setaffinity(0, sizeof(pinned), &pinned);
+    consumer.Wait();
+  });
+  while (!is_idle()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ClassicContext::Notify(group, crs[1], cpu);
+  waiter.join();
+  sched_setaffinity(0, sizeof(saved), &saved);
+  EXPECT_FALSE(is_idle());
+  EXPECT_EQ(crs[1], consumer.NextRoutine());
+  crs[1]->Release();
+  EXPECT_EQ(hits + 2, ClassicContext::AffinityHits());
+
+  // without a hint the runqueue order holds
+  EXPECT_EQ(crs[0], consumer.NextRoutine());
+  crs[0]->Release();
+  ClassicContext::cr_group_[group].at(crs[0]->priority()).clear();
+  producer.Shutdown();
+}
+
 TEST(SchedulerClassicTest, sched_classic) {
   // read example_sched_classic.conf
   GlobalData::Instance()->SetProcessGroup("example_sched_classic");
@@ -17,23 +17,54 @@
 #ifndef CYBER_SERVICE_CLIENT_H_
 #define CYBER_SERVICE_CLIENT_H_
 
+#include <atomic>
+#include <functional>
 #include <future>
 #include <map>
 #include <memory>
+#include <queue>
 #include <sstream>
 #include <string>
-#include <tuple>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
 #include "cyber/common/types.h"
 #include "cyber/node/node_channel_impl.h"
 #include "cyber/service/client_base.h"
+#include "cyber/service/transport_mode.h"
+#include "cyber/service_discovery/topology_manager.h"
+#include "cyber/time/time.h"
+#include "cyber/timer/timer_task.h"
+#include "cyber/timer/timing_wheel.h"
 
 namespace apollo {
 namespace cyber {
 
+/**
+ * @brief How long an asynchronous request waits for its response by default
+ */
+const uint32_t DEFAULT_REQUEST_TIMEOUT_MS = 5000;
+
+/**
+ * @brief Period of the sweep that expires overdue requests, it only runs
+ * while requests are pending
+ */
+const uint32_t REQUEST_EXPIRE_PERIOD_MS = 10;
+
+/**
+ * @brief Request counters of one Client
+ */
+struct ClientStats {
+  uint64_t sent = 0;       // requests transmitted
+  uint64_t completed = 0;  // responses received in time
+  uint64_t expired = 0;    // requests that got no response in time
+  uint64_t rejected = 0;   // requests the Service turned down
+  uint64_t in_flight = 0;  // requests waiting for their response
+};
+
 /**
  * @class Client
  * @brief Client get `Response` from a responding `Service` by sending a Request
@@ -41,6 +72,14 @@ namespace cyber {
  * @tparam Request the `Service` request type
  * @tparam Response the `Service` response type
  *
+ * Requests go out on the mode the communication mode mapping picks for the
+ * Service's location, responses are received on every mode of the mapping.
+ * Any number of requests may be in flight. Each one carries a deadline, once
+ * it passes without a response the future is completed with an empty
+ * response and the callback is invoked.
+ * A request the Service rejects is completed the same way as soon as the
+ * rejection arrives.
+ *
  * @warning One Client can only request one Service
  */
 template <typename Request, typename Response>
@@ -64,14 +103,18 @@ class Client : public ClientBase {
         node_name_(node_name),
         request_channel_(service_name + SRV_CHANNEL_REQ_SUFFIX),
         response_channel_(service_name + SRV_CHANNEL_RES_SUFFIX),
-        sequence_number_(0) {}
+        sequence_number_(0),
+        sent_(0),
+        completed_(0),
+        expired_(0),
+        rejected_(0) {}
 
   /**
    * @brief forbid Constructing a new Client object with empty params
    */
   Client() = delete;
 
-  virtual ~Client() {}
+  virtual ~Client() { Destroy(); }
 
   /**
    * @brief Init the Client
@@ -123,6 +166,39 @@ class Client : public ClientBase {
    */
   SharedFuture AsyncSendRequest(SharedRequest request, CallbackType&& cb);
 
+  /**
+   * @brief Send Request shared ptr asynchronously and invoke `cb` after we get
+   * response or the request expired
+   *
+   * @param request Request shared ptr
+   * @param cb callback function after we get response
+   * @param timeout if no response arrives in time, response will be empty
+   * @return SharedFuture a `std::future` shared ptr
+   */
+  SharedFuture AsyncSendRequest(SharedRequest request, CallbackType&& cb,
+                                const std::chrono::milliseconds& timeout);
+
+  /**
+   * @brief Send several requests back to back, registering all of them at
+   * once
+   *
+   * Only the bookkeeping is shared, every request is still a message of its
+   * own, the Service has no notion of a batch.
+   *
+   * @param requests Request shared ptrs
+   * @param timeout if no response arrives in time, response will be empty
+   * @return std::vector<SharedFuture> one future per request, in order
+   */
+  std::vector<SharedFuture> AsyncSendRequests(
+      const std::vector<SharedRequest>& requests,
+      const std::chrono::milliseconds& timeout =
+          std::chrono::milliseconds(DEFAULT_REQUEST_TIMEOUT_MS));
+
+  /**
+   * @brief Get the request counters of this Client
+   */
+  ClientStats Stats();
+
   /**
    * @brief Is the Service is ready?
    */
@@ -149,10 +225,49 @@ class Client : public ClientBase {
   }
 
  private:
+  using RequestTransmitterMap =
+      std::unordered_map<proto::OptionalMode,
+                         std::shared_ptr<transport::Transmitter<Request>>,
+                         std::hash<int>>;
+  using ResponseReceiverMap =
+      std::unordered_map<proto::OptionalMode,
+                         std::shared_ptr<transport::Receiver<Response>>,
+                         std::hash<int>>;
+
+  struct PendingRequest {
+    Promise promise;
+    SharedFuture future;
+    CallbackType callback;
+  };
+  // deadline in nanoseconds and sequence number, earliest first
+  using Deadline = std::pair<uint64_t, uint64_t>;
+  using DeadlineQueue =
+      std::priority_queue<Deadline, std::vector<Deadline>,
+                          std::greater<Deadline>>;
+
+  // must be called with pending_requests_mutex_ held
+  uint64_t AddPendingRequest(CallbackType&& cb, uint64_t deadline,
+                             SharedFuture* future);
+
+  void CompleteRequest(PendingRequest* pending,
+                       const SharedResponse& response);
+
+  void ExpireRequests();
+
+  void ExpireRequest(uint64_t sequence_number);
+
+  SharedFuture SendAsync(const SharedRequest& request, CallbackType&& cb,
+                         const std::chrono::milliseconds& timeout,
+                         uint64_t* sequence_number);
+
   void HandleResponse(const std::shared_ptr<Response>& response,
                       const transport::MessageInfo& request_info);
 
-  bool IsInit(void) const { return response_receiver_ != nullptr; }
+  void OnServiceChange(const proto::ChangeMsg& change_msg);
+
+  const std::shared_ptr<transport::Transmitter<Request>>& RequestTransmitter();
+
+  bool IsInit(void) const { return !response_receivers_.empty(); }
 
   std::string node_name_;
 
@@ -160,22 +275,48 @@ class Client : public ClientBase {
                      const transport::MessageInfo&)>
       response_callback_;
 
-  std::unordered_map<uint64_t,
-                     std::tuple<SharedPromise, CallbackType, SharedFuture>>
-      pending_requests_;
+  std::unordered_map<uint64_t, PendingRequest> pending_requests_;
+  // answered requests are dropped lazily once their deadline comes up
+  DeadlineQueue deadlines_;
   std::mutex pending_requests_mutex_;
-
-  std::shared_ptr<transport::Transmitter<Request>> request_transmitter_;
-  std::shared_ptr<transport::Receiver<Response>> response_receiver_;
+  // the sweep, on the timing wheel only while requests are pending
+  std::shared_ptr<TimerTask> expire_task_;
+  // guarded by pending_requests_mutex_
+  bool expire_task_armed_ = false;
+
+  TransportMode transport_mode_;
+  RequestTransmitterMap request_transmitters_;
+  ResponseReceiverMap response_receivers_;
+  // mode to reach the Service, HYBRID until it is found in the topology
+  std::atomic<int> server_mode_ = {proto::OptionalMode::HYBRID};
+  service_discovery::Manager::ChangeConnection change_conn_;
   std::string request_channel_;
   std::string response_channel_;
 
   transport::Identity writer_id_;
   uint64_t sequence_number_;
+
+  std::atomic<uint64_t> sent_;
+  std::atomic<uint64_t> completed_;
+  std::atomic<uint64_t> expired_;
+  std::atomic<uint64_t> rejected_;
 };
 
 template <typename Request, typename Response>
-void Client<Request, Response>::Destroy() {}
+void Client<Request, Response>::Destroy() {
+  if (change_conn_.IsConnected()) {
+    service_discovery::TopologyManager::Instance()
+        ->service_manager()
+        ->RemoveChangeListener(change_conn_);
+  }
+  if (expire_task_ != nullptr) {
+    // waits for a running sweep, the wheel only holds a weak reference
+    auto task = expire_task_;
+    std::lock_guard<std::mutex> lock(task->mutex);
+    task->interval_ms = 0;
+    expire_task_.reset();
+  }
+}
 
 template <typename Request, typename Response>
 bool Client<Request, Response>::Init() {
@@ -187,13 +328,35 @@ bool Client<Request, Response>::Init() {
   role.mutable_qos_profile()->CopyFrom(
       transport::QosProfileConf::QOS_PROFILE_SERVICES_DEFAULT);
   auto transport = transport::Transport::Instance();
-  request_transmitter_ =
-      transport->CreateTransmitter<Request>(role, proto::OptionalMode::RTPS);
-  if (request_transmitter_ == nullptr) {
-    AERROR << "Create request pub failed.";
-    return false;
+  for (auto mode : transport_mode_.modes()) {
+    auto transmitter = transport->CreateTransmitter<Request>(role, mode);
+    if (transmitter == nullptr) {
+      AERROR << "Create request pub failed.";
+      request_transmitters_.clear();
+      return false;
+    }
+    request_transmitters_[mode] = transmitter;
+  }
+  // responses carry it as spare id whatever mode they are sent on
+  writer_id_ = request_transmitters_.begin()->second->id();
+  // the sweep only runs in reality mode, see SendRequest
+  if (common::GlobalData::Instance()->IsRealityMode()) {
+    expire_task_ = std::make_shared<TimerTask>(0);
+    expire_task_->interval_ms = REQUEST_EXPIRE_PERIOD_MS;
+    expire_task_->next_fire_duration_ms = REQUEST_EXPIRE_PERIOD_MS;
+    std::weak_ptr<TimerTask> weak_task = expire_task_;
+    expire_task_->callback = [this, weak_task]() {
+      auto task = weak_task.lock();
+      if (task == nullptr) {
+        return;
+      }
+      std::lock_guard<std::mutex> lock(task->mutex);
+      // a zero interval marks a task Destroy has taken back
+      if (task->interval_ms != 0) {
+        ExpireRequests();
+      }
+    };
   }
-  writer_id_ = request_transmitter_->id();
 
   response_callback_ =
       std::bind(&Client<Request, Response>::HandleResponse, this,
@@ -202,24 +365,67 @@ bool Client<Request, Response>::Init() {
   role.set_channel_name(response_channel_);
   channel_id = common::GlobalData::RegisterChannel(response_channel_);
   role.set_channel_id(channel_id);
-  response_receiver_ = transport->CreateReceiver<Response>(
-      role,
-      [=](const std::shared_ptr<Response>& response,
-          const transport::MessageInfo& message_info,
-          const proto::RoleAttributes& reader_attr) {
-        (void)message_info;
-        (void)reader_attr;
-        response_callback_(response, message_info);
-      },
-      proto::OptionalMode::RTPS);
-  if (response_receiver_ == nullptr) {
-    AERROR << "Create response sub failed.";
-    request_transmitter_.reset();
-    return false;
+  ResponseReceiverMap receivers;
+  for (auto mode : transport_mode_.modes()) {
+    auto receiver = transport->CreateReceiver<Response>(
+        role,
+        [=](const std::shared_ptr<Response>& response,
+            const transport::MessageInfo& message_info,
+            const proto::RoleAttributes& reader_attr) {
+          (void)reader_attr;
+          response_callback_(response, message_info);
+        },
+        mode);
+    if (receiver == nullptr) {
+      AERROR << "Create response sub failed.";
+      request_transmitters_.clear();
+      return false;
+    }
+    receivers[mode] = receiver;
   }
+  response_receivers_ = std::move(receivers);
+
+  change_conn_ =
+      service_discovery::TopologyManager::Instance()
+          ->service_manager()
+          ->AddChangeListener(
+              std::bind(&Client<Request, Response>::OnServiceChange, this,
+                        std::placeholders::_1));
   return true;
 }
 
+template <typename Request, typename Response>
+void Client<Request, Response>::OnServiceChange(
+    const proto::ChangeMsg& change_msg) {
+  if (change_msg.role_type() != proto::RoleType::ROLE_SERVER ||
+      change_msg.role_attr().service_name() != ServiceName()) {
+    return;
+  }
+  // the Service moved, look it up again on the next request
+  server_mode_.store(proto::OptionalMode::HYBRID, std::memory_order_release);
+}
+
+template <typename Request, typename Response>
+const std::shared_ptr<transport::Transmitter<Request>>&
+Client<Request, Response>::RequestTransmitter() {
+  int mode = server_mode_.load(std::memory_order_acquire);
+  if (mode == proto::OptionalMode::HYBRID) {
+    proto::RoleAttributes server;
+    if (service_discovery::TopologyManager::Instance()
+            ->service_manager()
+            ->GetServer(ServiceName(), &server)) {
+      mode = transport_mode_.Get(server);
+      server_mode_.store(mode, std::memory_order_release);
+    } else {
+      // not discovered yet, the Service may live on another host
+      mode = transport_mode_.Get(DIFF_HOST);
+    }
+  }
+  // every mode of the mapping has a transmitter
+  return request_transmitters_.find(static_cast<proto::OptionalMode>(mode))
+      ->second;
+}
+
 template <typename Request, typename Response>
 typename Client<Request, Response>::SharedResponse
 Client<Request, Response>::SendRequest(SharedRequest request,
@@ -227,16 +433,20 @@ Client<Request, Response>::SendRequest(SharedRequest request,
   if (!IsInit()) {
     return nullptr;
   }
-  auto future = AsyncSendRequest(request);
+  uint64_t sequence_number = 0;
+  auto future = SendAsync(request, [](SharedFuture) {},
+                          std::chrono::milliseconds(timeout_s),
+                          &sequence_number);
   if (!future.valid()) {
     return nullptr;
   }
   auto status = future.wait_for(timeout_s);
   if (status == std::future_status::ready) {
     return future.get();
-  } else {
-    return nullptr;
   }
+  // the sweep only runs in reality mode, do not leave it behind
+  ExpireRequest(sequence_number);
+  return nullptr;
 }
 
 template <typename Request, typename Response>
@@ -246,14 +456,14 @@ Client<Request, Response>::SendRequest(const Request& request,
   if (!IsInit()) {
     return nullptr;
   }
-  auto request_ptr = std::make_shared<const Request>(request);
+  auto request_ptr = std::make_shared<Request>(request);
   return SendRequest(request_ptr, timeout_s);
 }
 
 template <typename Request, typename Response>
 typename Client<Request, Response>::SharedFuture
 Client<Request, Response>::AsyncSendRequest(const Request& request) {
-  auto request_ptr = std::make_shared<const Request>(request);
+  auto request_ptr = std::make_shared<Request>(request);
   return AsyncSendRequest(request_ptr);
 }
 
@@ -267,19 +477,159 @@ template <typename Request, typename Response>
 typename Client<Request, Response>::SharedFuture
 Client<Request, Response>::AsyncSendRequest(SharedRequest request,
                                             CallbackType&& cb) {
-  if (IsInit()) {
-    std::lock_guard<std::mutex> lock(pending_requests_mutex_);
-    sequence_number_++;
-    transport::MessageInfo info(writer_id_, sequence_number_, writer_id_);
-    request_transmitter_->Transmit(request, info);
-    SharedPromise call_promise = std::make_shared<Promise>();
-    SharedFuture f(call_promise->get_future());
-    pending_requests_[info.seq_num()] =
-        std::make_tuple(call_promise, std::forward<CallbackType>(cb), f);
-    return f;
-  } else {
+  return AsyncSendRequest(
+      request, std::forward<CallbackType>(cb),
+      std::chrono::milliseconds(DEFAULT_REQUEST_TIMEOUT_MS));
+}
+
+template <typename Request, typename Response>
+typename Client<Request, Response>::SharedFuture
+Client<Request, Response>::AsyncSendRequest(
+    SharedRequest request, CallbackType&& cb,
+    const std::chrono::milliseconds& timeout) {
+  uint64_t sequence_number = 0;
+  return SendAsync(request, std::forward<CallbackType>(cb), timeout,
+                   &sequence_number);
+}
+
+template <typename Request, typename Response>
+typename Client<Request, Response>::SharedFuture
+Client<Request, Response>::SendAsync(const SharedRequest& request,
+                                     CallbackType&& cb,
+                                     const std::chrono::milliseconds& timeout,
+                                     uint64_t* sequence_number) {
+  if (!IsInit()) {
     return std::shared_future<std::shared_ptr<Response>>();
   }
+  uint64_t deadline = Time::MonoTime().ToNanosecond() +
+                      std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          timeout)
+                          .count();
+  SharedFuture f;
+  {
+    std::lock_guard<std::mutex> lock(pending_requests_mutex_);
+    *sequence_number =
+        AddPendingRequest(std::forward<CallbackType>(cb), deadline, &f);
+  }
+  // intra-process the response may arrive before Transmit returns
+  transport::MessageInfo info(writer_id_, *sequence_number, writer_id_);
+  RequestTransmitter()->Transmit(request, info);
+  sent_.fetch_add(1, std::memory_order_relaxed);
+  return f;
+}
+
+template <typename Request, typename Response>
+std::vector<typename Client<Request, Response>::SharedFuture>
+Client<Request, Response>::AsyncSendRequests(
+    const std::vector<SharedRequest>& requests,
+    const std::chrono::milliseconds& timeout) {
+  std::vector<SharedFuture> futures(requests.size());
+  if (!IsInit() || requests.empty()) {
+    return futures;
+  }
+  uint64_t deadline = Time::MonoTime().ToNanosecond() +
+                      std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          timeout)
+                          .count();
+  std::vector<uint64_t> sequence_numbers(requests.size());
+  {
+    std::lock_guard<std::mutex> lock(pending_requests_mutex_);
+    for (size_t i = 0; i < requests.size(); ++i) {
+      sequence_numbers[i] =
+          AddPendingRequest([](SharedFuture) {}, deadline, &futures[i]);
+    }
+  }
+  const auto& transmitter = RequestTransmitter();
+  for (size_t i = 0; i < requests.size(); ++i) {
+    transport::MessageInfo info(writer_id_, sequence_numbers[i], writer_id_);
+    transmitter->Transmit(requests[i], info);
+  }
+  sent_.fetch_add(requests.size(), std::memory_order_relaxed);
+  return futures;
+}
+
+template <typename Request, typename Response>
+uint64_t Client<Request, Response>::AddPendingRequest(CallbackType&& cb,
+                                                      uint64_t deadline,
+                                                      SharedFuture* future) {
+  uint64_t sequence_number = ++sequence_number_;
+  auto& pending = pending_requests_[sequence_number];
+  pending.future = pending.promise.get_future().share();
+  pending.callback = std::forward<CallbackType>(cb);
+  *future = pending.future;
+  deadlines_.emplace(deadline, sequence_number);
+  if (expire_task_ != nullptr && !expire_task_armed_) {
+    expire_task_armed_ = true;
+    TimingWheel::Instance()->AddTask(expire_task_);
+  }
+  return sequence_number;
+}
+
+template <typename Request, typename Response>
+void Client<Request, Response>::CompleteRequest(
+    PendingRequest* pending, const SharedResponse& response) {
+  pending->promise.set_value(response);
+  pending->callback(pending->future);
+}
+
+template <typename Request, typename Response>
+void Client<Request, Response>::ExpireRequests() {
+  uint64_t now = Time::MonoTime().ToNanosecond();
+  std::vector<PendingRequest> expired;
+  {
+    std::lock_guard<std::mutex> lock(pending_requests_mutex_);
+    while (!deadlines_.empty() && deadlines_.top().first <= now) {
+      auto itr = pending_requests_.find(deadlines_.top().second);
+      deadlines_.pop();
+      if (itr == pending_requests_.end()) {
+        continue;
+      }
+      expired.emplace_back(std::move(itr->second));
+      pending_requests_.erase(itr);
+    }
+    if (pending_requests_.empty()) {
+      // leave the wheel until the next request, answered ones go with it
+      deadlines_ = DeadlineQueue();
+      expire_task_armed_ = false;
+    } else {
+      TimingWheel::Instance()->AddTask(expire_task_);
+    }
+  }
+  if (expired.empty()) {
+    return;
+  }
+  expired_.fetch_add(expired.size(), std::memory_order_relaxed);
+  for (auto& pending : expired) {
+    CompleteRequest(&pending, nullptr);
+  }
+}
+
+template <typename Request, typename Response>
+void Client<Request, Response>::ExpireRequest(uint64_t sequence_number) {
+  PendingRequest pending;
+  {
+    std::lock_guard<std::mutex> lock(pending_requests_mutex_);
+    auto itr = pending_requests_.find(sequence_number);
+    if (itr == pending_requests_.end()) {
+      return;
+    }
+    pending = std::move(itr->second);
+    pending_requests_.erase(itr);
+  }
+  expired_.fetch_add(1, std::memory_order_relaxed);
+  CompleteRequest(&pending, nullptr);
+}
+
+template <typename Request, typename Response>
+ClientStats Client<Request, Response>::Stats() {
+  ClientStats stats;
+  stats.sent = sent_.load(std::memory_order_relaxed);
+  stats.completed = completed_.load(std::memory_order_relaxed);
+  stats.expired = expired_.load(std::memory_order_relaxed);
+  stats.rejected = rejected_.load(std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(pending_requests_mutex_);
+  stats.in_flight = pending_requests_.size();
+  return stats;
 }
 
 template <typename Request, typename Response>
@@ -292,21 +642,30 @@ void Client<Request, Response>::HandleResponse(
     const std::shared_ptr<Response>& response,
     const transport::MessageInfo& request_header) {
   ADEBUG << "client recv response.";
-  std::lock_guard<std::mutex> lock(pending_requests_mutex_);
   if (request_header.spare_id() != writer_id_) {
     return;
   }
-  uint64_t sequence_number = request_header.seq_num();
-  if (this->pending_requests_.count(sequence_number) == 0) {
+  bool rejected = (request_header.seq_num() & SRV_RESPONSE_REJECTED) != 0;
+  uint64_t sequence_number = request_header.seq_num() & ~SRV_RESPONSE_REJECTED;
+  PendingRequest pending;
+  {
+    std::lock_guard<std::mutex> lock(pending_requests_mutex_);
+    auto itr = pending_requests_.find(sequence_number);
+    if (itr == pending_requests_.end()) {
+      // expired already
+      return;
+    }
+    pending = std::move(itr->second);
+    pending_requests_.erase(itr);
+  }
+  // outside the lock, the callback may send the next request
+  if (rejected) {
+    rejected_.fetch_add(1, std::memory_order_relaxed);
+    CompleteRequest(&pending, nullptr);
     return;
   }
-  auto tuple = this->pending_requests_[sequence_number];
-  auto call_promise = std::get<0>(tuple);
-  auto callback = std::get<1>(tuple);
-  auto future = std::get<2>(tuple);
-  this->pending_requests_.erase(sequence_number);
-  call_promise->set_value(response);
-  callback(future);
+  completed_.fetch_add(1, std::memory_order_relaxed);
+  CompleteRequest(&pending, response);
 }
 
 }  // namespace cyber
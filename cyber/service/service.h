@@ -17,24 +17,58 @@
 #ifndef CYBER_SERVICE_SERVICE_H_
 #define CYBER_SERVICE_SERVICE_H_
 
-#include <list>
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "cyber/base/bounded_queue.h"
 #include "cyber/common/types.h"
+#include "cyber/croutine/croutine.h"
+#include "cyber/croutine/routine_factory.h"
 #include "cyber/node/node_channel_impl.h"
-#include "cyber/scheduler/scheduler.h"
+#include "cyber/scheduler/scheduler_factory.h"
 #include "cyber/service/service_base.h"
+#include "cyber/service/service_stats.h"
+#include "cyber/service/transport_mode.h"
 
 namespace apollo {
 namespace cyber {
 
+const uint32_t DEFAULT_SERVICE_QUEUE_SIZE = 256;
+
+struct ServiceConfig {  ///< configurations for a Service
+  enum ExecutionMode {
+    THREAD = 0,  ///< one dedicated thread, requests are handled in order
+    CROUTINE,    ///< `worker_num` croutines on the cyber scheduler
+    INLINE,      ///< on the transport thread the request arrives on
+  };
+
+  std::string service_name;  //< the service name we provide
+  ExecutionMode execution_mode = THREAD;
+  /**
+   * @brief croutines handling requests in CROUTINE mode. With more than one
+   * worker, or in INLINE mode, the callback runs concurrently.
+   */
+  uint32_t worker_num = 1;
+  /**
+   * @brief requests waiting for THREAD or CROUTINE workers. Requests beyond
+   * it are rejected, the client gets an empty response right away.
+   */
+  uint32_t queue_size = DEFAULT_SERVICE_QUEUE_SIZE;
+};
+
 /**
  * @class Service
  * @brief Service handles `Request` from the Client, and send a `Response` to
  * it.
  *
+ * Requests are received on every mode of the communication mode mapping, the
+ * response goes back on the mode its request came in.
+ *
  * @tparam Request the request type
  * @tparam Response the response type
  */
@@ -52,11 +86,7 @@ class Service : public ServiceBase {
    */
   Service(const std::string& node_name, const std::string& service_name,
           const ServiceCallback& service_callback)
-      : ServiceBase(service_name),
-        node_name_(node_name),
-        service_callback_(service_callback),
-        request_channel_(service_name + SRV_CHANNEL_REQ_SUFFIX),
-        response_channel_(service_name + SRV_CHANNEL_RES_SUFFIX) {}
+      : Service(node_name, MakeConfig(service_name), service_callback) {}
 
   /**
    * @brief Construct a new Service object
@@ -67,11 +97,25 @@ class Service : public ServiceBase {
    */
   Service(const std::string& node_name, const std::string& service_name,
           ServiceCallback&& service_callback)
-      : ServiceBase(service_name),
+      : Service(node_name, MakeConfig(service_name),
+                std::move(service_callback)) {}
+
+  /**
+   * @brief Construct a new Service object
+   *
+   * @param node_name used to fill RoleAttribute when join the topology
+   * @param config the service name and how requests are handled
+   * @param service_callback reference of `ServiceCallback` object
+   */
+  Service(const std::string& node_name, const ServiceConfig& config,
+          const ServiceCallback& service_callback)
+      : ServiceBase(config.service_name),
         node_name_(node_name),
+        config_(config),
         service_callback_(service_callback),
-        request_channel_(service_name + SRV_CHANNEL_REQ_SUFFIX),
-        response_channel_(service_name + SRV_CHANNEL_RES_SUFFIX) {}
+        request_channel_(config.service_name + SRV_CHANNEL_REQ_SUFFIX),
+        response_channel_(config.service_name + SRV_CHANNEL_RES_SUFFIX),
+        stats_(config.service_name) {}
 
   /**
    * @brief Forbid default constructing
@@ -90,70 +134,204 @@ class Service : public ServiceBase {
    */
   void destroy();
 
+  /**
+   * @brief Request counters, queue depth and handler latency
+   */
+  ServiceStats::Snapshot Stats() const { return stats_.GetSnapshot(); }
+
  private:
+  using ResponseTransmitterMap =
+      std::unordered_map<proto::OptionalMode,
+                         std::shared_ptr<transport::Transmitter<Response>>,
+                         std::hash<int>>;
+  using RequestReceiverMap =
+      std::unordered_map<proto::OptionalMode,
+                         std::shared_ptr<transport::Receiver<Request>>,
+                         std::hash<int>>;
+  using Task = std::function<void()>;
+
+  static ServiceConfig MakeConfig(const std::string& service_name) {
+    ServiceConfig config;
+    config.service_name = service_name;
+    return config;
+  }
+
+  static uint64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  void OnRequest(const std::shared_ptr<Request>& request,
+                 const transport::MessageInfo& message_info,
+                 proto::OptionalMode mode);
+
   void HandleRequest(const std::shared_ptr<Request>& request,
-                     const transport::MessageInfo& message_info);
+                     const transport::MessageInfo& message_info,
+                     proto::OptionalMode mode);
 
   void SendResponse(const transport::MessageInfo& message_info,
-                    const std::shared_ptr<Response>& response);
+                    const std::shared_ptr<Response>& response,
+                    proto::OptionalMode mode);
+
+  void RejectRequest(const transport::MessageInfo& message_info,
+                     proto::OptionalMode mode);
 
-  bool IsInit(void) const { return request_receiver_ != nullptr; }
+  bool IsInit(void) const { return inited_; }
+
+  bool StartWorkers();
+  bool Enqueue(Task&& task);
+  void Process();
+  void SetWorkerIdle(uint64_t id, bool idle);
 
   std::string node_name_;
+  ServiceConfig config_;
   ServiceCallback service_callback_;
 
-  std::function<void(const std::shared_ptr<Request>&,
-                     const transport::MessageInfo&)>
-      request_callback_;
-  std::shared_ptr<transport::Transmitter<Response>> response_transmitter_;
-  std::shared_ptr<transport::Receiver<Request>> request_receiver_;
+  TransportMode transport_mode_;
+  ResponseTransmitterMap response_transmitters_;
+  RequestReceiverMap request_receivers_;
   std::string request_channel_;
   std::string response_channel_;
-  std::mutex service_handle_request_mutex_;
+  ServiceStats stats_;
 
   volatile bool inited_ = false;
-  void Enqueue(std::function<void()>&& task);
-  void Process();
+  std::unique_ptr<base::BoundedQueue<Task>> tasks_;
+  // THREAD mode
   std::thread thread_;
   std::mutex queue_mutex_;
   std::condition_variable condition_;
-  std::list<std::function<void()>> tasks_;
+  // CROUTINE mode
+  std::vector<std::string> worker_names_;
+  // workers hung up waiting for requests, each request wakes one
+  std::mutex idle_mutex_;
+  std::vector<uint64_t> idle_workers_;
 };
 
 template <typename Request, typename Response>
 void Service<Request, Response>::destroy() {
-  inited_ = false;
   {
     std::lock_guard<std::mutex> lg(queue_mutex_);
-    this->tasks_.clear();
+    inited_ = false;
   }
   condition_.notify_all();
   if (thread_.joinable()) {
     thread_.join();
   }
+  for (auto& name : worker_names_) {
+    scheduler::Instance()->RemoveTask(name);
+  }
+  worker_names_.clear();
+  {
+    std::lock_guard<std::mutex> lg(idle_mutex_);
+    idle_workers_.clear();
+  }
+  if (tasks_ != nullptr) {
+    Task task;
+    while (tasks_->Dequeue(&task)) {
+    }
+  }
 }
 
 template <typename Request, typename Response>
-inline void Service<Request, Response>::Enqueue(std::function<void()>&& task) {
-  std::lock_guard<std::mutex> lg(queue_mutex_);
-  tasks_.emplace_back(std::move(task));
-  condition_.notify_one();
+bool Service<Request, Response>::Enqueue(Task&& task) {
+  if (!tasks_->Enqueue(std::move(task))) {
+    return false;
+  }
+  stats_.SetQueueDepth(tasks_->Size());
+  if (config_.execution_mode == ServiceConfig::CROUTINE) {
+    uint64_t id = 0;
+    {
+      std::lock_guard<std::mutex> lg(idle_mutex_);
+      if (idle_workers_.empty()) {
+        // all busy, they take the request before hanging up again
+        return true;
+      }
+      id = idle_workers_.back();
+      idle_workers_.pop_back();
+    }
+    scheduler::Instance()->NotifyTask(id);
+  } else {
+    // pairs with the predicate check under the lock in Process
+    { std::lock_guard<std::mutex> lg(queue_mutex_); }
+    condition_.notify_one();
+  }
+  return true;
 }
 
 template <typename Request, typename Response>
 void Service<Request, Response>::Process() {
+  Task task;
   while (!cyber::IsShutdown()) {
+    if (tasks_->Dequeue(&task)) {
+      stats_.SetQueueDepth(tasks_->Size());
+      task();
+      task = nullptr;
+      continue;
+    }
     std::unique_lock<std::mutex> ul(queue_mutex_);
-    condition_.wait(ul, [this]() { return !inited_ || !this->tasks_.empty(); });
+    condition_.wait(ul, [this]() { return !inited_ || !tasks_->Empty(); });
     if (!inited_) {
       break;
     }
-    if (!tasks_.empty()) {
-      auto task = tasks_.front();
-      tasks_.pop_front();
-      ul.unlock();
+  }
+}
+
+template <typename Request, typename Response>
+bool Service<Request, Response>::StartWorkers() {
+  if (config_.execution_mode == ServiceConfig::INLINE) {
+    return true;
+  }
+  tasks_.reset(new base::BoundedQueue<Task>());
+  if (!tasks_->Init(config_.queue_size > 0 ? config_.queue_size : 1)) {
+    AERROR << "Service queue init failed: " << service_name_;
+    return false;
+  }
+  if (config_.execution_mode == ServiceConfig::THREAD) {
+    thread_ = std::thread(&Service<Request, Response>::Process, this);
+    return true;
+  }
+
+  auto func = [this]() {
+    auto routine = croutine::CRoutine::GetCurrentRoutine();
+    Task task;
+    while (inited_) {
+      if (!tasks_->Dequeue(&task)) {
+        // look again once listed, a request enqueued in between would find
+        // no idle worker to wake
+        SetWorkerIdle(routine->id(), true);
+        if (!tasks_->Dequeue(&task)) {
+          routine->HangUp();
+          continue;
+        }
+        SetWorkerIdle(routine->id(), false);
+      }
+      stats_.SetQueueDepth(tasks_->Size());
       task();
+      task = nullptr;
+    }
+  };
+  auto factory = croutine::CreateRoutineFactory(std::move(func));
+  uint32_t worker_num = config_.worker_num > 0 ? config_.worker_num : 1;
+  for (uint32_t i = 0; i < worker_num; ++i) {
+    auto name = "/internal/service/" + service_name_ + "/" + std::to_string(i);
+    if (!scheduler::Instance()->CreateTask(factory, name)) {
+      AERROR << "CreateTask failed: " << name;
+      return false;
     }
+    worker_names_.push_back(name);
+  }
+  return true;
+}
+
+template <typename Request, typename Response>
+void Service<Request, Response>::SetWorkerIdle(uint64_t id, bool idle) {
+  std::lock_guard<std::mutex> lg(idle_mutex_);
+  auto itr = std::find(idle_workers_.begin(), idle_workers_.end(), id);
+  if (idle && itr == idle_workers_.end()) {
+    idle_workers_.push_back(id);
+  } else if (!idle && itr != idle_workers_.end()) {
+    idle_workers_.erase(itr);
   }
 }
 
@@ -171,71 +349,117 @@ bool Service<Request, Response>::Init() {
   role.mutable_qos_profile()->CopyFrom(
       transport::QosProfileConf::QOS_PROFILE_SERVICES_DEFAULT);
   auto transport = transport::Transport::Instance();
-  response_transmitter_ =
-      transport->CreateTransmitter<Response>(role, proto::OptionalMode::RTPS);
-  if (response_transmitter_ == nullptr) {
-    AERROR << " Create response pub failed.";
-    return false;
+  for (auto mode : transport_mode_.modes()) {
+    auto transmitter = transport->CreateTransmitter<Response>(role, mode);
+    if (transmitter == nullptr) {
+      AERROR << " Create response pub failed.";
+      response_transmitters_.clear();
+      return false;
+    }
+    response_transmitters_[mode] = transmitter;
   }
 
-  request_callback_ =
-      std::bind(&Service<Request, Response>::HandleRequest, this,
-                std::placeholders::_1, std::placeholders::_2);
   // 创建receiver用于订阅request
   role.set_channel_name(request_channel_);
   channel_id = common::GlobalData::RegisterChannel(request_channel_);
   role.set_channel_id(channel_id);
-  request_receiver_ = transport->CreateReceiver<Request>(
-      role,
-      [=](const std::shared_ptr<Request>& request,
-          const transport::MessageInfo& message_info,
-          const proto::RoleAttributes& reader_attr) {
-        (void)reader_attr;
-        auto task = [this, request, message_info]() {
-          this->HandleRequest(request, message_info);
-        };
-        Enqueue(std::move(task));
-      },
-      proto::OptionalMode::RTPS);
   inited_ = true;
-  thread_ = std::thread(&Service<Request, Response>::Process, this);
-  if (request_receiver_ == nullptr) {
-    AERROR << " Create request sub failed." << request_channel_;
-    response_transmitter_.reset();
+  if (!StartWorkers()) {
+    destroy();
+    response_transmitters_.clear();
     return false;
   }
+  RequestReceiverMap receivers;
+  for (auto mode : transport_mode_.modes()) {
+    auto receiver = transport->CreateReceiver<Request>(
+        role,
+        [this, mode](const std::shared_ptr<Request>& request,
+                     const transport::MessageInfo& message_info,
+                     const proto::RoleAttributes& reader_attr) {
+          (void)reader_attr;
+          this->OnRequest(request, message_info, mode);
+        },
+        mode);
+    if (receiver == nullptr) {
+      AERROR << " Create request sub failed." << request_channel_;
+      receivers.clear();
+      destroy();
+      response_transmitters_.clear();
+      return false;
+    }
+    receivers[mode] = receiver;
+  }
+  request_receivers_ = std::move(receivers);
   return true;
 }
 
+template <typename Request, typename Response>
+void Service<Request, Response>::OnRequest(
+    const std::shared_ptr<Request>& request,
+    const transport::MessageInfo& message_info, proto::OptionalMode mode) {
+  if (!IsInit()) {
+    return;
+  }
+  stats_.AddReceived();
+  if (config_.execution_mode == ServiceConfig::INLINE) {
+    HandleRequest(request, message_info, mode);
+    return;
+  }
+  uint64_t enqueue_ns = NowNs();
+  auto task = [this, request, message_info, mode, enqueue_ns]() {
+    stats_.AddWait(NowNs() - enqueue_ns);
+    this->HandleRequest(request, message_info, mode);
+  };
+  if (!Enqueue(std::move(task))) {
+    stats_.AddRejected();
+    AWARN_EVERY(100) << "Service " << service_name_
+                     << " queue is full, request rejected.";
+    RejectRequest(message_info, mode);
+  }
+}
+
+template <typename Request, typename Response>
+void Service<Request, Response>::RejectRequest(
+    const transport::MessageInfo& message_info, proto::OptionalMode mode) {
+  // the client completes the request with an empty response
+  transport::MessageInfo msg_info(message_info);
+  msg_info.set_seq_num(message_info.seq_num() | SRV_RESPONSE_REJECTED);
+  SendResponse(msg_info, std::make_shared<Response>(), mode);
+}
+
 template <typename Request, typename Response>
 void Service<Request, Response>::HandleRequest(
     const std::shared_ptr<Request>& request,
-    const transport::MessageInfo& message_info) {
+    const transport::MessageInfo& message_info, proto::OptionalMode mode) {
   if (!IsInit()) {
     // LOG_DEBUG << "not inited error.";
     return;
   }
   ADEBUG << "handling request:" << request_channel_;
-  std::lock_guard<std::mutex> lk(service_handle_request_mutex_);
+  uint64_t start_ns = NowNs();
   auto response = std::make_shared<Response>();
   // 调用service callback
   service_callback_(request, response);
-  transport::MessageInfo msg_info(message_info);
-  msg_info.set_sender_id(response_transmitter_->id());
-  SendResponse(msg_info, response);
+  SendResponse(message_info, response, mode);
+  stats_.AddHandled(NowNs() - start_ns);
 }
 
 template <typename Request, typename Response>
 void Service<Request, Response>::SendResponse(
     const transport::MessageInfo& message_info,
-    const std::shared_ptr<Response>& response) {
+    const std::shared_ptr<Response>& response, proto::OptionalMode mode) {
   if (!IsInit()) {
     // LOG_DEBUG << "not inited error.";
     return;
   }
-  // publish return value ?
-  // LOG_DEBUG << "send response id:" << message_id.sequence_number;
-  response_transmitter_->Transmit(response, message_info);
+  // answer on the mode the request came in, the client listens on it
+  auto itr = response_transmitters_.find(mode);
+  if (itr == response_transmitters_.end()) {
+    return;
+  }
+  transport::MessageInfo msg_info(message_info);
+  msg_info.set_sender_id(itr->second->id());
+  itr->second->Transmit(response, msg_info);
 }
 
 }  // namespace cyber
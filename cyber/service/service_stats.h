@@ -0,0 +1,141 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SERVICE_SERVICE_STATS_H_
+#define CYBER_SERVICE_SERVICE_STATS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "cyber/base/stats_registry.h"
+
+namespace apollo {
+namespace cyber {
+
+/**
+ * @brief Request counters of one Service.
+ *
+ * Instances register themselves while they are alive so that they can be
+ * collected at any time, e.g. by SysMo.
+ */
+class ServiceStats {
+ public:
+  struct Snapshot {
+    std::string name;
+    uint64_t received;
+    uint64_t rejected;
+    uint64_t handled;
+    uint64_t queue_depth;
+    uint64_t max_queue_depth;
+    uint64_t wait_ns;
+    uint64_t handle_ns;
+    uint64_t max_handle_ns;
+  };
+
+  explicit ServiceStats(const std::string& name) : name_(name) {
+    base::StatsRegistry<ServiceStats>::Add(this);
+  }
+
+  ~ServiceStats() { base::StatsRegistry<ServiceStats>::Remove(this); }
+
+  ServiceStats(const ServiceStats&) = delete;
+  ServiceStats& operator=(const ServiceStats&) = delete;
+
+  void AddReceived() { received_.fetch_add(1, std::memory_order_relaxed); }
+
+  void AddRejected() { rejected_.fetch_add(1, std::memory_order_relaxed); }
+
+  void SetQueueDepth(uint64_t depth) {
+    queue_depth_.store(depth, std::memory_order_relaxed);
+    UpdateMax(&max_queue_depth_, depth);
+  }
+
+  // time a request spent in the queue
+  void AddWait(uint64_t wait_ns) {
+    wait_ns_.fetch_add(wait_ns, std::memory_order_relaxed);
+  }
+
+  // time spent in the service callback and sending the response
+  void AddHandled(uint64_t handle_ns) {
+    handled_.fetch_add(1, std::memory_order_relaxed);
+    handle_ns_.fetch_add(handle_ns, std::memory_order_relaxed);
+    UpdateMax(&max_handle_ns_, handle_ns);
+  }
+
+  Snapshot GetSnapshot() const {
+    return {name_,
+            received_.load(std::memory_order_relaxed),
+            rejected_.load(std::memory_order_relaxed),
+            handled_.load(std::memory_order_relaxed),
+            queue_depth_.load(std::memory_order_relaxed),
+            max_queue_depth_.load(std::memory_order_relaxed),
+            wait_ns_.load(std::memory_order_relaxed),
+            handle_ns_.load(std::memory_order_relaxed),
+            max_handle_ns_.load(std::memory_order_relaxed)};
+  }
+
+  static std::vector<Snapshot> Collect() {
+    return base::StatsRegistry<ServiceStats>::Collect();
+  }
+
+  /**
+   * @brief One line per service that has received requests.
+   */
+  static std::string Dump() {
+    std::string info;
+    for (auto& snap : Collect()) {
+      if (snap.received == 0) {
+        continue;
+      }
+      uint64_t handled = snap.handled == 0 ? 1 : snap.handled;
+      info.append(base::StatsLine(
+          snap.name, {{"received", snap.received},
+                      {"rejected", snap.rejected},
+                      {"queue", snap.queue_depth},
+                      {"max_queue", snap.max_queue_depth},
+                      {"avg_wait_us", snap.wait_ns / handled / 1000},
+                      {"avg_handle_us", snap.handle_ns / handled / 1000},
+                      {"max_handle_us", snap.max_handle_ns / 1000}}));
+    }
+    return info;
+  }
+
+ private:
+  static void UpdateMax(std::atomic<uint64_t>* max, uint64_t value) {
+    uint64_t old_value = max->load(std::memory_order_relaxed);
+    while (value > old_value &&
+           !max->compare_exchange_weak(old_value, value,
+                                       std::memory_order_relaxed)) {
+    }
+  }
+
+  const std::string name_;
+  std::atomic<uint64_t> received_ = {0};
+  std::atomic<uint64_t> rejected_ = {0};
+  std::atomic<uint64_t> handled_ = {0};
+  std::atomic<uint64_t> queue_depth_ = {0};
+  std::atomic<uint64_t> max_queue_depth_ = {0};
+  std::atomic<uint64_t> wait_ns_ = {0};
+  std::atomic<uint64_t> handle_ns_ = {0};
+  std::atomic<uint64_t> max_handle_ns_ = {0};
+};
+
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SERVICE_SERVICE_STATS_H_
@@ -0,0 +1,66 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/service/service_stats.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+
+TEST(ServiceStatsTest, counters) {
+  ServiceStats stats("stats_test");
+  stats.AddReceived();
+  stats.AddReceived();
+  stats.AddReceived();
+  stats.AddRejected();
+  stats.SetQueueDepth(5);
+  stats.SetQueueDepth(2);
+  stats.AddWait(3000);
+  stats.AddHandled(4000);
+  stats.AddHandled(2000);
+
+  auto snap = stats.GetSnapshot();
+  EXPECT_EQ("stats_test", snap.name);
+  EXPECT_EQ(3, snap.received);
+  EXPECT_EQ(1, snap.rejected);
+  EXPECT_EQ(2, snap.handled);
+  EXPECT_EQ(2, snap.queue_depth);
+  EXPECT_EQ(5, snap.max_queue_depth);
+  EXPECT_EQ(3000, snap.wait_ns);
+  EXPECT_EQ(6000, snap.handle_ns);
+  EXPECT_EQ(4000, snap.max_handle_ns);
+
+  auto info = ServiceStats::Dump();
+  EXPECT_NE(std::string::npos, info.find("stats_test received: 3"));
+  EXPECT_NE(std::string::npos, info.find("avg_handle_us: 3"));
+}
+
+TEST(ServiceStatsTest, registry) {
+  auto count = ServiceStats::Collect().size();
+  {
+    ServiceStats stats("registry_test");
+    EXPECT_EQ(count + 1, ServiceStats::Collect().size());
+    // idle services are left out of the dump
+    EXPECT_EQ(std::string::npos, ServiceStats::Dump().find("registry_test"));
+  }
+  EXPECT_EQ(count, ServiceStats::Collect().size());
+}
+
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,97 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SERVICE_TRANSPORT_MODE_H_
+#define CYBER_SERVICE_TRANSPORT_MODE_H_
+
+#include <set>
+
+#include "cyber/common/global_data.h"
+#include "cyber/common/types.h"
+#include "cyber/proto/role_attributes.pb.h"
+#include "cyber/proto/transport_conf.pb.h"
+
+namespace apollo {
+namespace cyber {
+
+/**
+ * @class TransportMode
+ * @brief Picks the transport of a Service or Client from the
+ * `communication_mode` of transport_conf, the mapping HybridTransmitter uses.
+ */
+class TransportMode {
+ public:
+  TransportMode() {
+    auto& global_conf = common::GlobalData::Instance()->Config();
+    if (global_conf.has_transport_conf() &&
+        global_conf.transport_conf().has_communication_mode()) {
+      mode_.CopyFrom(global_conf.transport_conf().communication_mode());
+    }
+    modes_.insert(Get(SAME_PROC));
+    modes_.insert(Get(DIFF_PROC));
+    modes_.insert(Get(DIFF_HOST));
+  }
+
+  /**
+   * @brief All modes a Service or Client has to listen on
+   */
+  const std::set<proto::OptionalMode>& modes() const { return modes_; }
+
+  proto::OptionalMode Get(Relation relation) const {
+    proto::OptionalMode mode = proto::OptionalMode::RTPS;
+    switch (relation) {
+      case SAME_PROC:
+        mode = mode_.same_proc();
+        break;
+      case DIFF_PROC:
+        mode = mode_.diff_proc();
+        break;
+      default:
+        mode = mode_.diff_host();
+        break;
+    }
+    // a service talks to exactly one peer, there is nothing to choose from,
+    // and socket transport is meant for bulk channels only
+    if (mode == proto::OptionalMode::HYBRID ||
+        mode == proto::OptionalMode::SOCKET) {
+      return proto::OptionalMode::RTPS;
+    }
+    return mode;
+  }
+
+  /**
+   * @brief Mode to reach `peer`, a role joined in the service topology
+   */
+  proto::OptionalMode Get(const proto::RoleAttributes& peer) const {
+    auto global_data = common::GlobalData::Instance();
+    if (peer.host_name() != global_data->HostName()) {
+      return Get(DIFF_HOST);
+    }
+    if (peer.process_id() != global_data->ProcessId()) {
+      return Get(DIFF_PROC);
+    }
+    return Get(SAME_PROC);
+  }
+
+ private:
+  proto::CommunicationMode mode_;
+  std::set<proto::OptionalMode> modes_;
+};
+
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SERVICE_TRANSPORT_MODE_H_
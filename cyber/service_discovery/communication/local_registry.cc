@@ -0,0 +1,488 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/service_discovery/communication/local_registry.h"
+
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include "cyber/common/environment.h"
+#include "cyber/common/global_data.h"
+#include "cyber/common/log.h"
+#include "cyber/common/util.h"
+#include "cyber/time/time.h"
+
+namespace apollo {
+namespace cyber {
+namespace service_discovery {
+
+using common::DomainId;
+using common::Hash;
+using common::PidNamespace;
+using proto::ChangeMsg;
+using proto::OperateType;
+
+namespace {
+
+const int32_t kReclaimingOwner = -1;
+const uint32_t kReadyMagic = 0x4c524547;
+const int kWaitTimeoutMs = 1000;
+
+void FutexWait(std::atomic<uint32_t>* word, uint32_t value, int timeout_ms) {
+  struct timespec timeout;
+  timeout.tv_sec = timeout_ms / 1000;
+  timeout.tv_nsec = (timeout_ms % 1000) * 1000000L;
+  // shared between processes, so no FUTEX_PRIVATE_FLAG
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, value,
+          &timeout, nullptr, 0);
+}
+
+void FutexWakeAll(std::atomic<uint32_t>* word) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX,
+          nullptr, nullptr, 0);
+}
+
+bool IsProcessAlive(int32_t pid) {
+  return kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+}  // namespace
+
+struct LocalRegistry::Header {
+  // bumped after every slot change, listeners wait on it
+  std::atomic<uint32_t> seq = {0};
+  std::atomic<uint32_t> ready = {0};
+  uint32_t slot_num = 0;
+  uint32_t slot_size = 0;
+};
+
+struct LocalRegistry::SlotState {
+  // pid of the process that owns the slot, 0 when free
+  std::atomic<int32_t> owner = {0};
+  // odd while the slot is being written
+  std::atomic<uint32_t> version = {0};
+  // size of the role stored from this slot on, 0 in the slots it spans
+  std::atomic<uint32_t> size = {0};
+};
+
+LocalRegistry::LocalRegistry()
+    : LocalRegistry("/apollo/cyber/service_discovery/local_registry/" +
+                        DomainId() + "/" + PidNamespace(),
+                    common::GlobalData::Instance()->ProcessId()) {}
+
+LocalRegistry::LocalRegistry(const std::string& name, int process_id)
+    : process_id_(process_id) {
+  id_ = Hash(name);
+  key_ = static_cast<key_t>(id_);
+  shm_size_ = sizeof(Header) + kSlotNum * sizeof(SlotState) +
+              static_cast<size_t>(kSlotNum) * kSlotSize;
+}
+
+LocalRegistry::~LocalRegistry() { Shutdown(); }
+
+bool LocalRegistry::Init() {
+  if (!OpenOrCreate()) {
+    Reset();
+    return false;
+  }
+  states_ = reinterpret_cast<SlotState*>(reinterpret_cast<char*>(header_) +
+                                         sizeof(Header));
+  data_ = reinterpret_cast<char*>(states_ + kSlotNum);
+  return true;
+}
+
+void LocalRegistry::Start(const ChangeCallback& callback) {
+  if (!IsReady() || thread_.joinable()) {
+    return;
+  }
+  callback_ = callback;
+  versions_.assign(kSlotNum, 0);
+  joined_.resize(kSlotNum);
+  thread_ = std::thread(&LocalRegistry::ThreadFunc, this);
+}
+
+void LocalRegistry::Shutdown() {
+  if (is_shutdown_.exchange(true)) {
+    return;
+  }
+  if (header_ == nullptr) {
+    return;
+  }
+  if (thread_.joinable()) {
+    FutexWakeAll(&header_->seq);
+    thread_.join();
+  }
+
+  std::lock_guard<std::mutex> lock(own_slots_mutex_);
+  if (!own_slots_.empty()) {
+    for (auto& item : own_slots_) {
+      FreeSlots(item.second);
+    }
+    own_slots_.clear();
+    Publish();
+  }
+  Reset();
+  RemoveIfUnused();
+}
+
+bool LocalRegistry::Update(const ChangeMsg& msg) {
+  if (!IsReady()) {
+    return false;
+  }
+  if (msg.operate_type() == OperateType::OPT_JOIN) {
+    return Store(msg);
+  }
+  return Free(msg);
+}
+
+bool LocalRegistry::Store(const ChangeMsg& msg) {
+  std::string data;
+  if (!msg.SerializeToString(&data) || data.empty() ||
+      data.size() > kMaxMessageSize) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(own_slots_mutex_);
+  if (is_shutdown_.load()) {
+    return false;
+  }
+  Extent extent = {0, SlotCount(data.size())};
+  if (!ClaimSlots(extent.count, &extent.index)) {
+    AWARN_EVERY(100) << "local registry is full, announcing through rtps.";
+    return false;
+  }
+  // the first slot guards the data of all of them
+  auto& state = states_[extent.index];
+  uint32_t version = state.version.load(std::memory_order_relaxed);
+  state.version.store(version + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(data_ + static_cast<size_t>(extent.index) * kSlotSize,
+              data.data(), data.size());
+  state.size.store(static_cast<uint32_t>(data.size()),
+                   std::memory_order_relaxed);
+  state.version.store(version + 2, std::memory_order_release);
+
+  own_slots_.emplace(RoleKey(msg), extent);
+  next_slot_ = (extent.index + extent.count) % kSlotNum;
+  Publish();
+  return true;
+}
+
+bool LocalRegistry::ClaimSlots(uint32_t count, uint32_t* index) {
+  uint32_t n = 0;
+  while (n < kSlotNum) {
+    uint32_t start = (next_slot_ + n) % kSlotNum;
+    // the slots of one role are contiguous in the segment
+    if (start + count > kSlotNum) {
+      n += kSlotNum - start;
+      continue;
+    }
+    uint32_t claimed = 0;
+    for (; claimed < count; ++claimed) {
+      int32_t expected = 0;
+      if (!states_[start + claimed].owner.compare_exchange_strong(
+              expected, process_id_, std::memory_order_acq_rel)) {
+        break;
+      }
+    }
+    if (claimed == count) {
+      *index = start;
+      return true;
+    }
+    for (uint32_t i = 0; i < claimed; ++i) {
+      states_[start + i].owner.store(0, std::memory_order_release);
+    }
+    n += claimed + 1;
+  }
+  return false;
+}
+
+bool LocalRegistry::Free(const ChangeMsg& msg) {
+  std::lock_guard<std::mutex> lock(own_slots_mutex_);
+  if (is_shutdown_.load()) {
+    return false;
+  }
+  auto itr = own_slots_.find(RoleKey(msg));
+  if (itr == own_slots_.end()) {
+    return false;
+  }
+  FreeSlots(itr->second);
+  own_slots_.erase(itr);
+  Publish();
+  return true;
+}
+
+void LocalRegistry::FreeSlots(const Extent& extent) {
+  // the first slot goes first, readers of the role notice it changed
+  // before any of the other slots can be claimed again
+  for (uint32_t i = 0; i < extent.count; ++i) {
+    FreeSlot(extent.index + i);
+  }
+}
+
+void LocalRegistry::FreeSlot(uint32_t index) {
+  auto& state = states_[index];
+  // the owner may have died halfway through a write, version is odd then
+  uint32_t version = state.version.load(std::memory_order_relaxed) | 1;
+  state.version.store(version, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  state.size.store(0, std::memory_order_relaxed);
+  state.version.store(version + 1, std::memory_order_release);
+  state.owner.store(0, std::memory_order_release);
+}
+
+void LocalRegistry::Publish() {
+  header_->seq.fetch_add(1, std::memory_order_acq_rel);
+  FutexWakeAll(&header_->seq);
+}
+
+void LocalRegistry::ThreadFunc() {
+  std::vector<ChangeMsg> changes;
+  // drop what crashed processes left behind before taking it as the state
+  ReclaimDeadSlots();
+  uint32_t seq = header_->seq.load(std::memory_order_acquire);
+  Scan(&changes);
+  if (!changes.empty()) {
+    callback_(changes);
+  }
+
+  auto last_reclaim = std::chrono::steady_clock::now();
+  while (!is_shutdown_.load()) {
+    FutexWait(&header_->seq, seq, kWaitTimeoutMs);
+    if (is_shutdown_.load()) {
+      break;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_reclaim >= std::chrono::milliseconds(kWaitTimeoutMs)) {
+      // changes the seq if anything was reclaimed
+      ReclaimDeadSlots();
+      last_reclaim = now;
+    }
+    uint32_t curr_seq = header_->seq.load(std::memory_order_acquire);
+    if (curr_seq == seq) {
+      continue;
+    }
+    seq = curr_seq;
+    changes.clear();
+    Scan(&changes);
+    if (!changes.empty()) {
+      callback_(changes);
+    }
+  }
+}
+
+void LocalRegistry::Scan(std::vector<ChangeMsg>* changes) {
+  for (uint32_t i = 0; i < kSlotNum; ++i) {
+    auto& state = states_[i];
+    uint32_t version = state.version.load(std::memory_order_acquire);
+    // a slot in the middle of a write is picked up with its seq bump
+    if (version == versions_[i] || (version & 1)) {
+      continue;
+    }
+    int32_t owner = state.owner.load(std::memory_order_relaxed);
+    uint32_t size = state.size.load(std::memory_order_relaxed);
+    if (size > kMaxMessageSize || i + SlotCount(size) > kSlotNum) {
+      continue;
+    }
+    bool has_role = size > 0 && owner != process_id_;
+    if (has_role) {
+      buffer_.assign(data_ + static_cast<size_t>(i) * kSlotSize, size);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (state.version.load(std::memory_order_relaxed) != version) {
+      continue;
+    }
+    versions_[i] = version;
+
+    if (joined_[i] != nullptr) {
+      ChangeMsg leave(*joined_[i]);
+      leave.set_timestamp(Time::Now().ToNanosecond());
+      leave.set_operate_type(OperateType::OPT_LEAVE);
+      changes->emplace_back(std::move(leave));
+      joined_[i].reset();
+    }
+    if (!has_role) {
+      continue;
+    }
+    std::unique_ptr<ChangeMsg> join(new ChangeMsg());
+    if (!join->ParseFromString(buffer_)) {
+      AWARN << "invalid local registry slot " << i;
+      continue;
+    }
+    changes->emplace_back(*join);
+    joined_[i] = std::move(join);
+  }
+}
+
+void LocalRegistry::ReclaimDeadSlots() {
+  std::unordered_map<int32_t, bool> alive;
+  bool reclaimed = false;
+  for (uint32_t i = 0; i < kSlotNum; ++i) {
+    auto& state = states_[i];
+    int32_t owner = state.owner.load(std::memory_order_acquire);
+    if (owner <= 0 || owner == process_id_) {
+      continue;
+    }
+    auto itr = alive.find(owner);
+    if (itr == alive.end()) {
+      itr = alive.emplace(owner, IsProcessAlive(owner)).first;
+    }
+    if (itr->second) {
+      continue;
+    }
+    if (state.owner.compare_exchange_strong(owner, kReclaimingOwner,
+                                            std::memory_order_acq_rel)) {
+      FreeSlot(i);
+      reclaimed = true;
+    }
+  }
+  if (reclaimed) {
+    ADEBUG << "reclaimed local registry slots of dead processes.";
+    Publish();
+  }
+}
+
+std::string LocalRegistry::RoleKey(const ChangeMsg& msg) {
+  auto& attr = msg.role_attr();
+  return std::to_string(msg.change_type()) + "/" +
+         std::to_string(msg.role_type()) + "/" +
+         std::to_string(attr.node_id()) + "/" +
+         std::to_string(attr.channel_id()) + "/" +
+         std::to_string(attr.service_id()) + "/" + std::to_string(attr.id());
+}
+
+bool LocalRegistry::OpenOrCreate() {
+  int retry = 0;
+  int shmid = 0;
+  while (retry < 2) {
+    shmid = shmget(key_, shm_size_, 0644 | IPC_CREAT | IPC_EXCL);
+    if (shmid != -1) {
+      break;
+    }
+
+    if (EINVAL == errno) {
+      AINFO << "need larger space, recreate.";
+      Remove();
+      ++retry;
+    } else if (EEXIST == errno) {
+      ADEBUG << "shm already exist, open only.";
+      if (OpenOnly()) {
+        return true;
+      }
+      // left behind in another layout by processes that are gone
+      Reset();
+      if (!RemoveIfUnused()) {
+        return false;
+      }
+      ++retry;
+    } else {
+      break;
+    }
+  }
+
+  if (shmid == -1) {
+    AERROR << "create shm failed, error code: " << strerror(errno);
+    return false;
+  }
+
+  managed_shm_ = shmat(shmid, nullptr, 0);
+  if (managed_shm_ == reinterpret_cast<void*>(-1)) {
+    AERROR << "attach shm failed.";
+    managed_shm_ = nullptr;
+    shmctl(shmid, IPC_RMID, 0);
+    return false;
+  }
+
+  // the segment comes zero filled, which is every slot free
+  header_ = new (managed_shm_) Header();
+  header_->slot_num = kSlotNum;
+  header_->slot_size = kSlotSize;
+  header_->ready.store(kReadyMagic, std::memory_order_release);
+  return true;
+}
+
+bool LocalRegistry::OpenOnly() {
+  int shmid = shmget(key_, 0, 0644);
+  if (shmid == -1) {
+    AERROR << "get shm failed, error: " << strerror(errno);
+    return false;
+  }
+
+  managed_shm_ = shmat(shmid, nullptr, 0);
+  if (managed_shm_ == reinterpret_cast<void*>(-1)) {
+    AERROR << "attach shm failed, error: " << strerror(errno);
+    managed_shm_ = nullptr;
+    return false;
+  }
+
+  header_ = reinterpret_cast<Header*>(managed_shm_);
+  // the creator may still be filling in the header
+  for (int i = 0; i < 100; ++i) {
+    if (header_->ready.load(std::memory_order_acquire) == kReadyMagic) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  if (header_->ready.load(std::memory_order_acquire) != kReadyMagic ||
+      header_->slot_num != kSlotNum || header_->slot_size != kSlotSize) {
+    AERROR << "local registry layout mismatch.";
+    return false;
+  }
+  return true;
+}
+
+bool LocalRegistry::Remove() {
+  int shmid = shmget(key_, 0, 0644);
+  if (shmid == -1 || shmctl(shmid, IPC_RMID, 0) == -1) {
+    AERROR << "remove shm failed, error code: " << strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+bool LocalRegistry::RemoveIfUnused() {
+  int shmid = shmget(key_, 0, 0644);
+  struct shmid_ds shm_info;
+  if (shmid == -1 || shmctl(shmid, IPC_STAT, &shm_info) == -1 ||
+      shm_info.shm_nattch != 0) {
+    return false;
+  }
+  return shmctl(shmid, IPC_RMID, 0) == 0;
+}
+
+void LocalRegistry::Reset() {
+  header_ = nullptr;
+  states_ = nullptr;
+  data_ = nullptr;
+  if (managed_shm_ != nullptr) {
+    shmdt(managed_shm_);
+    managed_shm_ = nullptr;
+  }
+}
+
+}  // namespace service_discovery
+}  // namespace cyber
+}  // namespace apollo
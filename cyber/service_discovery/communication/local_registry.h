@@ -0,0 +1,161 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SERVICE_DISCOVERY_COMMUNICATION_LOCAL_REGISTRY_H_
+#define CYBER_SERVICE_DISCOVERY_COMMUNICATION_LOCAL_REGISTRY_H_
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "cyber/proto/topology_change.pb.h"
+
+namespace apollo {
+namespace cyber {
+namespace service_discovery {
+
+/**
+ * @class LocalRegistry
+ * @brief Host-local discovery registry in shared memory
+ *
+ * Every role a process joins is stored in one segment shared by the
+ * processes of the host, in as many consecutive slots as it needs, leaving
+ * frees them again. A change counter doubles as futex word, so listeners of
+ * other processes wake up as soon as a slot changes and turn the difference
+ * into join and leave messages, without waiting for RTPS announcements.
+ * Slots of processes that died without leaving are reclaimed by the
+ * listeners. The last process to detach removes the segment.
+ *
+ * The default segment is per CYBER_DOMAIN_ID and pid namespace: processes
+ * of other domains must not see each other, and owners are told apart and
+ * checked for liveness by pid.
+ */
+class LocalRegistry {
+ public:
+  using ChangeCallback =
+      std::function<void(const std::vector<proto::ChangeMsg>&)>;
+
+  static const uint32_t kSlotNum = 4096;
+  static const uint32_t kSlotSize = 512;
+  // serialized messages above this size are left to RTPS
+  static const uint32_t kMaxMessageSize = 64 * 1024;
+
+  /**
+   * @param name identifies the segment, processes sharing a name see each
+   * other
+   * @param process_id owner id written to the slots of this instance
+   */
+  LocalRegistry(const std::string& name, int process_id);
+  LocalRegistry();
+  virtual ~LocalRegistry();
+
+  bool Init();
+
+  /**
+   * @brief Start listening, `callback` gets the roles already registered by
+   * other processes first and every change after that
+   */
+  void Start(const ChangeCallback& callback);
+
+  /**
+   * @brief Stop listening and free the slots of this process
+   */
+  void Shutdown();
+
+  /**
+   * @brief Store a join or drop the role of a leave message
+   *
+   * @return true if the change is visible to the other processes of the
+   * host, false if it has to be announced in another way
+   */
+  bool Update(const proto::ChangeMsg& msg);
+
+  bool IsReady() const { return header_ != nullptr && !is_shutdown_.load(); }
+
+  /**
+   * @brief Tells the segment apart from those of other names, domains and
+   * pid namespaces
+   */
+  uint64_t id() const { return id_; }
+
+ private:
+  struct Header;
+  struct SlotState;
+  // consecutive slots holding one role
+  struct Extent {
+    uint32_t index;
+    uint32_t count;
+  };
+
+  bool OpenOrCreate();
+  bool OpenOnly();
+  bool Remove();
+  // called detached, removes the segment if no process is attached
+  bool RemoveIfUnused();
+  void Reset();
+
+  bool Store(const proto::ChangeMsg& msg);
+  bool Free(const proto::ChangeMsg& msg);
+  bool ClaimSlots(uint32_t count, uint32_t* index);
+  void FreeSlots(const Extent& extent);
+  void FreeSlot(uint32_t index);
+  void Publish();
+
+  void ThreadFunc();
+  void Scan(std::vector<proto::ChangeMsg>* changes);
+  void ReclaimDeadSlots();
+
+  static std::string RoleKey(const proto::ChangeMsg& msg);
+  static uint32_t SlotCount(size_t size) {
+    return static_cast<uint32_t>((size + kSlotSize - 1) / kSlotSize);
+  }
+
+  uint64_t id_ = 0;
+  key_t key_ = 0;
+  int process_id_ = 0;
+  void* managed_shm_ = nullptr;
+  size_t shm_size_ = 0;
+  Header* header_ = nullptr;
+  SlotState* states_ = nullptr;
+  char* data_ = nullptr;
+  std::atomic<bool> is_shutdown_ = {false};
+
+  // slots owned by this process, by role
+  std::unordered_multimap<std::string, Extent> own_slots_;
+  uint32_t next_slot_ = 0;
+  std::mutex own_slots_mutex_;
+
+  // listener state, slot versions seen and roles joined from them
+  std::vector<uint32_t> versions_;
+  std::vector<std::unique_ptr<proto::ChangeMsg>> joined_;
+  std::string buffer_;
+  ChangeCallback callback_;
+  std::thread thread_;
+};
+
+}  // namespace service_discovery
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SERVICE_DISCOVERY_COMMUNICATION_LOCAL_REGISTRY_H_
@@ -0,0 +1,218 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/service_discovery/communication/local_registry.h"
+
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/common/util.h"
+
+namespace apollo {
+namespace cyber {
+namespace service_discovery {
+
+using proto::ChangeMsg;
+
+namespace {
+
+const char kRegistryName[] = "/apollo/cyber/test/local_registry";
+
+class ChangeCollector {
+ public:
+  void OnChange(const std::vector<ChangeMsg>& msgs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    msgs_.insert(msgs_.end(), msgs.begin(), msgs.end());
+    cv_.notify_all();
+  }
+
+  bool WaitFor(size_t num) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, std::chrono::seconds(3),
+                        [&]() { return msgs_.size() >= num; });
+  }
+
+  std::vector<ChangeMsg> msgs() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return msgs_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<ChangeMsg> msgs_;
+};
+
+int SegmentId() {
+  return shmget(static_cast<key_t>(common::Hash(kRegistryName)), 0, 0644);
+}
+
+ChangeMsg MakeChange(proto::OperateType operate_type, uint64_t id) {
+  ChangeMsg msg;
+  msg.set_change_type(proto::ChangeType::CHANGE_CHANNEL);
+  msg.set_operate_type(operate_type);
+  msg.set_role_type(proto::RoleType::ROLE_WRITER);
+  auto attr = msg.mutable_role_attr();
+  attr->set_channel_name("/local_registry_test");
+  attr->set_channel_id(1);
+  attr->set_id(id);
+  attr->set_process_id(getpid());
+  return msg;
+}
+
+class LocalRegistryTest : public ::testing::Test {
+ protected:
+  void TearDown() override {
+    // left behind by a failed test otherwise
+    int shmid = SegmentId();
+    if (shmid != -1) {
+      shmctl(shmid, IPC_RMID, 0);
+    }
+  }
+};
+
+}  // namespace
+
+TEST_F(LocalRegistryTest, join_and_leave) {
+  // both live in this process, so pretend to be the parent on one side
+  LocalRegistry writer(kRegistryName, getpid());
+  ASSERT_TRUE(writer.Init());
+  LocalRegistry listener(kRegistryName, getppid());
+  ASSERT_TRUE(listener.Init());
+
+  EXPECT_TRUE(writer.Update(MakeChange(proto::OperateType::OPT_JOIN, 1)));
+  ChangeCollector collector;
+  listener.Start(std::bind(&ChangeCollector::OnChange, &collector,
+                           std::placeholders::_1));
+  // registered before the listener started
+  ASSERT_TRUE(collector.WaitFor(1));
+
+  EXPECT_TRUE(writer.Update(MakeChange(proto::OperateType::OPT_JOIN, 2)));
+  ASSERT_TRUE(collector.WaitFor(2));
+  EXPECT_TRUE(writer.Update(MakeChange(proto::OperateType::OPT_LEAVE, 1)));
+  ASSERT_TRUE(collector.WaitFor(3));
+  // unknown roles are left to the other discovery path
+  EXPECT_FALSE(writer.Update(MakeChange(proto::OperateType::OPT_LEAVE, 3)));
+
+  auto msgs = collector.msgs();
+  EXPECT_EQ(proto::OperateType::OPT_JOIN, msgs[0].operate_type());
+  EXPECT_EQ(1, msgs[0].role_attr().id());
+  EXPECT_EQ(proto::OperateType::OPT_JOIN, msgs[1].operate_type());
+  EXPECT_EQ(2, msgs[1].role_attr().id());
+  EXPECT_EQ(proto::OperateType::OPT_LEAVE, msgs[2].operate_type());
+  EXPECT_EQ(1, msgs[2].role_attr().id());
+
+  // leaving the registry drops every role that is left
+  writer.Shutdown();
+  ASSERT_TRUE(collector.WaitFor(4));
+  msgs = collector.msgs();
+  EXPECT_EQ(proto::OperateType::OPT_LEAVE, msgs[3].operate_type());
+  EXPECT_EQ(2, msgs[3].role_attr().id());
+  EXPECT_FALSE(writer.Update(MakeChange(proto::OperateType::OPT_JOIN, 4)));
+  listener.Shutdown();
+  // the last one to detach removes the segment
+  EXPECT_EQ(-1, SegmentId());
+}
+
+TEST_F(LocalRegistryTest, spanning_slots) {
+  LocalRegistry writer(kRegistryName, getpid());
+  ASSERT_TRUE(writer.Init());
+  LocalRegistry listener(kRegistryName, getppid());
+  ASSERT_TRUE(listener.Init());
+  ChangeCollector collector;
+  listener.Start(std::bind(&ChangeCollector::OnChange, &collector,
+                           std::placeholders::_1));
+
+  // roles larger than a slot take several, small ones fill the gaps
+  std::vector<ChangeMsg> joins;
+  for (uint64_t id = 1; id <= 4; ++id) {
+    joins.emplace_back(MakeChange(proto::OperateType::OPT_JOIN, id));
+    joins.back().mutable_role_attr()->set_proto_desc(
+        std::string(id % 2 ? 3 * LocalRegistry::kSlotSize : 10, 'a' + id));
+    EXPECT_TRUE(writer.Update(joins.back()));
+  }
+  ASSERT_TRUE(collector.WaitFor(4));
+  EXPECT_TRUE(writer.Update(MakeChange(proto::OperateType::OPT_LEAVE, 1)));
+  joins.emplace_back(MakeChange(proto::OperateType::OPT_JOIN, 5));
+  joins.back().mutable_role_attr()->set_proto_desc(
+      std::string(2 * LocalRegistry::kSlotSize, 'f'));
+  EXPECT_TRUE(writer.Update(joins.back()));
+  ASSERT_TRUE(collector.WaitFor(6));
+  writer.Shutdown();
+  ASSERT_TRUE(collector.WaitFor(10));
+
+  // every role joined intact and left once
+  std::map<uint64_t, int> joined;
+  for (auto& msg : collector.msgs()) {
+    auto id = msg.role_attr().id();
+    if (msg.operate_type() == proto::OperateType::OPT_JOIN) {
+      ++joined[id];
+      EXPECT_EQ(joins[id - 1].role_attr().proto_desc(),
+                msg.role_attr().proto_desc());
+    } else {
+      --joined[id];
+    }
+  }
+  EXPECT_EQ(5, joined.size());
+  for (auto& item : joined) {
+    EXPECT_EQ(0, item.second);
+  }
+  listener.Shutdown();
+}
+
+TEST_F(LocalRegistryTest, oversized) {
+  LocalRegistry registry(kRegistryName, getpid());
+  ASSERT_TRUE(registry.Init());
+  auto msg = MakeChange(proto::OperateType::OPT_JOIN, 1);
+  msg.mutable_role_attr()->set_proto_desc(
+      std::string(LocalRegistry::kMaxMessageSize, 'x'));
+  EXPECT_FALSE(registry.Update(msg));
+  msg.mutable_role_attr()->clear_proto_desc();
+  EXPECT_TRUE(registry.Update(msg));
+  registry.Shutdown();
+}
+
+TEST_F(LocalRegistryTest, per_domain) {
+  const char* domain = ::getenv("CYBER_DOMAIN_ID");
+  std::string saved(domain ? domain : "");
+  setenv("CYBER_DOMAIN_ID", "81", 1);
+  LocalRegistry first;
+  setenv("CYBER_DOMAIN_ID", "82", 1);
+  LocalRegistry second;
+  LocalRegistry third;
+  if (domain) {
+    setenv("CYBER_DOMAIN_ID", saved.c_str(), 1);
+  } else {
+    unsetenv("CYBER_DOMAIN_ID");
+  }
+  EXPECT_NE(first.id(), second.id());
+  EXPECT_EQ(second.id(), third.id());
+}
+
+}  // namespace service_discovery
+}  // namespace cyber
+}  // namespace apollo
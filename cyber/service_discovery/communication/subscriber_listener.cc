@@ -16,6 +16,8 @@
 
 #include "cyber/service_discovery/communication/subscriber_listener.h"
 
+#include <utility>
+
 #include "cyber/common/log.h"
 #include "cyber/transport/rtps/underlay_message.h"
 #include "cyber/transport/rtps/underlay_message_type.h"
@@ -38,10 +40,16 @@ void SubscriberListener::onNewDataMessage(eprosima::fastrtps::Subscriber* sub) {
   std::lock_guard<std::mutex> lock(mutex_);
   eprosima::fastrtps::SampleInfo_t m_info;
   cyber::transport::UnderlayMessage m;
-  RETURN_IF(!sub->takeNextData(reinterpret_cast<void*>(&m), &m_info));
-  RETURN_IF(m_info.sampleKind != eprosima::fastrtps::ALIVE);
+  // a discovery storm queues many samples, hand them over together
+  std::vector<std::string> msgs;
+  while (sub->takeNextData(reinterpret_cast<void*>(&m), &m_info)) {
+    if (m_info.sampleKind == eprosima::fastrtps::ALIVE) {
+      msgs.emplace_back(std::move(m.data()));
+    }
+  }
+  RETURN_IF(msgs.empty());
 
-  callback_(m.data());
+  callback_(msgs);
 }
 
 void SubscriberListener::onSubscriptionMatched(
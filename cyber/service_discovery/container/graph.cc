@@ -90,6 +90,8 @@ bool Edge::IsValid() const {
 
 std::string Edge::GetKey() const { return value_ + "_" + dst_.GetKey(); }
 
+const Graph::Id Graph::kInvalidId;
+
 Graph::Graph() {}
 
 Graph::~Graph() {
@@ -102,17 +104,7 @@ void Graph::Insert(const Edge& e) {
     return;
   }
   WriteLockGuard<AtomicRWLock> lock(rw_lock_);
-  auto& e_v = e.value();
-  if (edges_.find(e_v) == edges_.end()) {
-    edges_[e_v] = RelatedVertices();
-  }
-
-  if (!e.src().IsDummy()) {
-    InsertOutgoingEdge(e);
-  }
-  if (!e.dst().IsDummy()) {
-    InsertIncomingEdge(e);
-  }
+  InsertUnlocked(e);
 }
 
 void Graph::Delete(const Edge& e) {
@@ -120,26 +112,26 @@ void Graph::Delete(const Edge& e) {
     return;
   }
   WriteLockGuard<AtomicRWLock> lock(rw_lock_);
-  auto& e_v = e.value();
-  if (edges_.find(e_v) == edges_.end()) {
-    return;
-  }
+  DeleteUnlocked(e);
+}
 
-  if (!e.src().IsDummy()) {
-    DeleteOutgoingEdge(e);
-  }
-  if (!e.dst().IsDummy()) {
-    DeleteIncomingEdge(e);
+void Graph::Apply(const std::vector<Change>& changes) {
+  WriteLockGuard<AtomicRWLock> lock(rw_lock_);
+  for (auto& change : changes) {
+    if (!change.first.IsValid()) {
+      continue;
+    }
+    if (change.second) {
+      InsertUnlocked(change.first);
+    } else {
+      DeleteUnlocked(change.first);
+    }
   }
 }
 
 uint32_t Graph::GetNumOfEdge() {
   ReadLockGuard<AtomicRWLock> lock(rw_lock_);
-  uint32_t num = 0;
-  for (auto& item : list_) {
-    num += static_cast<int>(item.second.size());
-  }
-  return num;
+  return num_of_edge_;
 }
 
 FlowDirection Graph::GetDirectionOf(const Vertice& lhs, const Vertice& rhs) {
@@ -147,135 +139,169 @@ FlowDirection Graph::GetDirectionOf(const Vertice& lhs, const Vertice& rhs) {
     return UNREACHABLE;
   }
   ReadLockGuard<AtomicRWLock> lock(rw_lock_);
-  if (list_.count(lhs.GetKey()) == 0 || list_.count(rhs.GetKey()) == 0) {
+  Id lhs_id = FindVertice(lhs);
+  Id rhs_id = FindVertice(rhs);
+  if (lhs_id == kInvalidId || rhs_id == kInvalidId || !listed_[lhs_id] ||
+      !listed_[rhs_id]) {
     return UNREACHABLE;
   }
-  if (LevelTraverse(lhs, rhs)) {
+  if (LevelTraverse(lhs_id, rhs_id)) {
     return UPSTREAM;
   }
-  if (LevelTraverse(rhs, lhs)) {
+  if (LevelTraverse(rhs_id, lhs_id)) {
     return DOWNSTREAM;
   }
   return UNREACHABLE;
 }
 
-void Graph::InsertOutgoingEdge(const Edge& e) {
-  auto& e_v = e.value();
-  auto& src_v_set = edges_[e_v].src;
-  auto& src_v = e.src();
-  auto& v_k = src_v.GetKey();
-  if (src_v_set.find(v_k) != src_v_set.end()) {
-    return;
+uint32_t Graph::GetNumOfVertice() {
+  ReadLockGuard<AtomicRWLock> lock(rw_lock_);
+  return static_cast<uint32_t>(vertice_ids_.size());
+}
+
+Graph::Id Graph::InternVertice(const Vertice& v) {
+  auto result = vertice_ids_.emplace(v.GetKey(), kInvalidId);
+  if (!result.second) {
+    return result.first->second;
   }
-  src_v_set[v_k] = src_v;
-
-  auto& dst_v_set = edges_[e_v].dst;
-  Edge insert_e;
-  insert_e.set_src(src_v);
-  insert_e.set_value(e.value());
-  for (auto& item : dst_v_set) {
-    insert_e.set_dst(item.second);
-    InsertCompleteEdge(insert_e);
+  if (free_vertice_ids_.empty()) {
+    result.first->second = static_cast<Id>(list_.size());
+    list_.emplace_back();
+    listed_.push_back(false);
+    vertice_refs_.push_back(0);
+  } else {
+    result.first->second = free_vertice_ids_.back();
+    free_vertice_ids_.pop_back();
   }
+  return result.first->second;
 }
 
-void Graph::InsertIncomingEdge(const Edge& e) {
-  auto& e_v = e.value();
-  auto& dst_v_set = edges_[e_v].dst;
-  auto& dst_v = e.dst();
-  auto& v_k = dst_v.GetKey();
-  if (dst_v_set.find(v_k) != dst_v_set.end()) {
-    return;
+Graph::Id Graph::InternValue(const std::string& value) {
+  auto result = value_ids_.emplace(value, kInvalidId);
+  if (!result.second) {
+    return result.first->second;
   }
-  dst_v_set[v_k] = dst_v;
-
-  auto& src_v_set = edges_[e_v].src;
-  Edge insert_e;
-  insert_e.set_dst(dst_v);
-  insert_e.set_value(e.value());
-  for (auto& item : src_v_set) {
-    insert_e.set_src(item.second);
-    InsertCompleteEdge(insert_e);
+  // without free ids all of [0, size - 1) are taken
+  if (free_value_ids_.empty()) {
+    result.first->second = static_cast<Id>(value_ids_.size() - 1);
+  } else {
+    result.first->second = free_value_ids_.back();
+    free_value_ids_.pop_back();
   }
+  return result.first->second;
 }
 
-void Graph::InsertCompleteEdge(const Edge& e) {
-  auto& src_v_k = e.src().GetKey();
-  if (list_.find(src_v_k) == list_.end()) {
-    list_[src_v_k] = VerticeSet();
+void Graph::ReleaseVertice(const Vertice& v, Id id) {
+  if (--vertice_refs_[id] > 0) {
+    return;
   }
-  auto& dst_v_k = e.dst().GetKey();
-  if (list_.find(dst_v_k) == list_.end()) {
-    list_[dst_v_k] = VerticeSet();
+  // no edge leads to or from it any more, list_[id] is empty already
+  vertice_ids_.erase(v.GetKey());
+  list_[id].clear();
+  listed_[id] = false;
+  free_vertice_ids_.push_back(id);
+}
+
+Graph::Id Graph::FindVertice(const Vertice& v) const {
+  auto itr = vertice_ids_.find(v.GetKey());
+  if (itr == vertice_ids_.end()) {
+    return kInvalidId;
   }
-  list_[src_v_k][e.GetKey()] = e.dst();
+  return itr->second;
 }
 
-void Graph::DeleteOutgoingEdge(const Edge& e) {
-  auto& e_v = e.value();
-  auto& src_v_set = edges_[e_v].src;
-  auto& src_v = e.src();
-  auto& v_k = src_v.GetKey();
-  if (src_v_set.find(v_k) == src_v_set.end()) {
-    return;
+void Graph::InsertUnlocked(const Edge& e) {
+  auto& related = edges_[InternValue(e.value())];
+  if (!e.src().IsDummy()) {
+    Id src = InternVertice(e.src());
+    if (related.src.insert(src).second) {
+      ++vertice_refs_[src];
+      for (auto dst : related.dst) {
+        InsertCompleteEdge(src, dst);
+      }
+    }
   }
-  src_v_set.erase(v_k);
-
-  auto& dst_v_set = edges_[e_v].dst;
-  Edge delete_e;
-  delete_e.set_src(src_v);
-  delete_e.set_value(e.value());
-  for (auto& item : dst_v_set) {
-    delete_e.set_dst(item.second);
-    DeleteCompleteEdge(delete_e);
+  if (!e.dst().IsDummy()) {
+    Id dst = InternVertice(e.dst());
+    if (related.dst.insert(dst).second) {
+      ++vertice_refs_[dst];
+      for (auto src : related.src) {
+        InsertCompleteEdge(src, dst);
+      }
+    }
   }
 }
 
-void Graph::DeleteIncomingEdge(const Edge& e) {
-  auto& e_v = e.value();
-  auto& dst_v_set = edges_[e_v].dst;
-  auto& dst_v = e.dst();
-  auto& v_k = dst_v.GetKey();
-  if (dst_v_set.find(v_k) == dst_v_set.end()) {
+void Graph::DeleteUnlocked(const Edge& e) {
+  auto value_itr = value_ids_.find(e.value());
+  if (value_itr == value_ids_.end()) {
     return;
   }
-  dst_v_set.erase(v_k);
-
-  auto& src_v_set = edges_[e_v].src;
-  Edge delete_e;
-  delete_e.set_dst(dst_v);
-  delete_e.set_value(e.value());
-  for (auto& item : src_v_set) {
-    delete_e.set_src(item.second);
-    DeleteCompleteEdge(delete_e);
+  Id value = value_itr->second;
+  auto& related = edges_[value];
+  if (!e.src().IsDummy()) {
+    Id src = FindVertice(e.src());
+    if (src != kInvalidId && related.src.erase(src) > 0) {
+      for (auto dst : related.dst) {
+        DeleteCompleteEdge(src, dst);
+      }
+      ReleaseVertice(e.src(), src);
+    }
+  }
+  if (!e.dst().IsDummy()) {
+    Id dst = FindVertice(e.dst());
+    if (dst != kInvalidId && related.dst.erase(dst) > 0) {
+      for (auto src : related.src) {
+        DeleteCompleteEdge(src, dst);
+      }
+      ReleaseVertice(e.dst(), dst);
+    }
+  }
+  if (related.src.empty() && related.dst.empty()) {
+    edges_.erase(value);
+    value_ids_.erase(value_itr);
+    free_value_ids_.push_back(value);
   }
 }
 
-void Graph::DeleteCompleteEdge(const Edge& e) {
-  auto& src_v_k = e.src().GetKey();
-  list_[src_v_k].erase(e.GetKey());
+void Graph::InsertCompleteEdge(Id src, Id dst) {
+  listed_[src] = true;
+  listed_[dst] = true;
+  ++list_[src][dst];
+  ++num_of_edge_;
 }
 
-bool Graph::LevelTraverse(const Vertice& start, const Vertice& end) {
-  std::unordered_map<std::string, bool> visited;
-  visited[end.GetKey()] = false;
-  std::queue<Vertice> unvisited;
+void Graph::DeleteCompleteEdge(Id src, Id dst) {
+  auto& neighbors = list_[src];
+  auto itr = neighbors.find(dst);
+  if (itr == neighbors.end()) {
+    return;
+  }
+  if (--itr->second == 0) {
+    neighbors.erase(itr);
+  }
+  --num_of_edge_;
+}
+
+bool Graph::LevelTraverse(Id start, Id end) const {
+  std::vector<bool> visited(list_.size(), false);
+  std::queue<Id> unvisited;
   unvisited.emplace(start);
+  visited[start] = true;
   while (!unvisited.empty()) {
-    auto curr = unvisited.front();
+    Id curr = unvisited.front();
     unvisited.pop();
-    if (visited[curr.GetKey()]) {
-      continue;
-    }
-    visited[curr.GetKey()] = true;
     if (curr == end) {
-      break;
+      return true;
     }
-    for (auto& item : list_[curr.GetKey()]) {
-      unvisited.push(item.second);
+    for (auto& item : list_[curr]) {
+      if (!visited[item.first]) {
+        visited[item.first] = true;
+        unvisited.push(item.first);
+      }
     }
   }
-  return visited[end.GetKey()];
+  return false;
 }
 
 }  // namespace service_discovery
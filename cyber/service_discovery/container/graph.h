@@ -20,6 +20,9 @@
 #include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "cyber/base/atomic_rw_lock.h"
 
@@ -90,10 +93,17 @@ class Edge {
   std::string value_;
 };
 
+/**
+ * @brief Vertices and edge values are interned to dense integer ids, so the
+ * adjacency is kept on ids and every update costs one string lookup per
+ * vertice plus the number of vertices on the other side of the edge. Once
+ * no edge refers to a vertice or a value any more its id is freed and reused,
+ * so nodes and channels coming and going do not grow the graph.
+ */
 class Graph {
  public:
-  using VerticeSet = std::unordered_map<std::string, Vertice>;
-  using AdjacencyList = std::unordered_map<std::string, VerticeSet>;
+  // an edge to apply and whether it is inserted (true) or deleted (false)
+  using Change = std::pair<Edge, bool>;
 
   Graph();
   virtual ~Graph();
@@ -101,28 +111,56 @@ class Graph {
   void Insert(const Edge& e);
   void Delete(const Edge& e);
 
+  /**
+   * @brief Apply a sequence of insertions and deletions in order, taking the
+   * write lock once
+   */
+  void Apply(const std::vector<Change>& changes);
+
   uint32_t GetNumOfEdge();
+  // vertices some edge still refers to
+  uint32_t GetNumOfVertice();
   FlowDirection GetDirectionOf(const Vertice& lhs, const Vertice& rhs);
 
  private:
+  using Id = uint32_t;
+  using IdSet = std::unordered_set<Id>;
+  // destination id -> number of edge values leading there
+  using Neighbors = std::unordered_map<Id, uint32_t>;
+
   struct RelatedVertices {
     RelatedVertices() {}
 
-    VerticeSet src;
-    VerticeSet dst;
+    IdSet src;
+    IdSet dst;
   };
-  using EdgeInfo = std::unordered_map<std::string, RelatedVertices>;
+  using EdgeInfo = std::unordered_map<Id, RelatedVertices>;
+
+  static const Id kInvalidId = static_cast<Id>(-1);
+
+  Id InternVertice(const Vertice& v);
+  Id InternValue(const std::string& value);
+  Id FindVertice(const Vertice& v) const;
+  // drops one reference taken by joining the src or dst of a value
+  void ReleaseVertice(const Vertice& v, Id id);
 
-  void InsertOutgoingEdge(const Edge& e);
-  void InsertIncomingEdge(const Edge& e);
-  void InsertCompleteEdge(const Edge& e);
-  void DeleteOutgoingEdge(const Edge& e);
-  void DeleteIncomingEdge(const Edge& e);
-  void DeleteCompleteEdge(const Edge& e);
-  bool LevelTraverse(const Vertice& start, const Vertice& end);
+  void InsertUnlocked(const Edge& e);
+  void DeleteUnlocked(const Edge& e);
+  void InsertCompleteEdge(Id src, Id dst);
+  void DeleteCompleteEdge(Id src, Id dst);
+  bool LevelTraverse(Id start, Id end) const;
 
+  std::unordered_map<std::string, Id> vertice_ids_;
+  std::unordered_map<std::string, Id> value_ids_;
   EdgeInfo edges_;
-  AdjacencyList list_;
+  // indexed by vertice id, present once the vertice took part in an edge
+  std::vector<Neighbors> list_;
+  std::vector<bool> listed_;
+  // indexed by vertice id, in how many src and dst sets of edges_ it is
+  std::vector<uint32_t> vertice_refs_;
+  std::vector<Id> free_vertice_ids_;
+  std::vector<Id> free_value_ids_;
+  uint32_t num_of_edge_ = 0;
   base::AtomicRWLock rw_lock_;
 };
 
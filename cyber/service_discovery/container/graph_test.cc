@@ -17,6 +17,8 @@
 #include "cyber/service_discovery/container/graph.h"
 
 #include <string>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 namespace apollo {
@@ -205,6 +207,78 @@ TEST(GraphTest, graph) {
   g.Delete(qa);
 }
 
+TEST(GraphTest, apply) {
+  Graph g;
+  Vertice a("a");
+  Vertice b("b");
+  Vertice c("c");
+  std::vector<Graph::Change> changes;
+  changes.emplace_back(Edge(a, Vertice(), "ch1"), true);
+  changes.emplace_back(Edge(Vertice(), b, "ch1"), true);
+  changes.emplace_back(Edge(b, Vertice(), "ch2"), true);
+  changes.emplace_back(Edge(Vertice(), c, "ch2"), true);
+  // invalid edges are skipped
+  changes.emplace_back(Edge(), true);
+  g.Apply(changes);
+  EXPECT_EQ(g.GetNumOfEdge(), 2);
+  EXPECT_EQ(g.GetDirectionOf(a, c), UPSTREAM);
+  EXPECT_EQ(g.GetDirectionOf(c, a), DOWNSTREAM);
+
+  // applied in order, so a leave following a join wins
+  changes.clear();
+  changes.emplace_back(Edge(a, Vertice(), "ch2"), true);
+  changes.emplace_back(Edge(Vertice(), b, "ch1"), false);
+  changes.emplace_back(Edge(Vertice(), b, "ch1"), true);
+  changes.emplace_back(Edge(b, Vertice(), "ch2"), false);
+  g.Apply(changes);
+  EXPECT_EQ(g.GetNumOfEdge(), 2);
+  EXPECT_EQ(g.GetDirectionOf(a, b), UPSTREAM);
+  EXPECT_EQ(g.GetDirectionOf(b, c), UNREACHABLE);
+  EXPECT_EQ(g.GetDirectionOf(a, c), UPSTREAM);
+}
+
+TEST(GraphTest, recycle) {
+  Graph g;
+  // nodes and channels coming and going leave nothing behind
+  for (int round = 0; round < 3; ++round) {
+    std::vector<Edge> edges;
+    for (int i = 0; i < 10; ++i) {
+      std::string channel = "ch" + std::to_string(round * 10 + i);
+      Vertice writer("writer" + std::to_string(round * 10 + i));
+      Vertice reader("reader" + std::to_string(round * 10 + i));
+      edges.emplace_back(writer, Vertice(), channel);
+      edges.emplace_back(Vertice(), reader, channel);
+    }
+    for (auto& edge : edges) {
+      g.Insert(edge);
+    }
+    EXPECT_EQ(g.GetNumOfEdge(), 10);
+    EXPECT_EQ(g.GetNumOfVertice(), 20);
+    EXPECT_EQ(g.GetDirectionOf(edges[0].src(), edges[1].dst()), UPSTREAM);
+    // a reused id carries no edge of the vertice it belonged to
+    EXPECT_EQ(g.GetDirectionOf(edges[0].src(), edges[3].dst()), UNREACHABLE);
+    for (auto& edge : edges) {
+      g.Delete(edge);
+    }
+    EXPECT_EQ(g.GetNumOfEdge(), 0);
+    EXPECT_EQ(g.GetNumOfVertice(), 0);
+    EXPECT_EQ(g.GetDirectionOf(edges[0].src(), edges[1].dst()), UNREACHABLE);
+  }
+
+  // a vertice stays while another value still refers to it
+  Vertice a("a");
+  Vertice b("b");
+  Vertice c("c");
+  g.Insert(Edge(a, b, "ch1"));
+  g.Insert(Edge(a, c, "ch2"));
+  g.Delete(Edge(a, Vertice(), "ch1"));
+  EXPECT_EQ(g.GetNumOfVertice(), 3);
+  g.Delete(Edge(Vertice(), b, "ch1"));
+  EXPECT_EQ(g.GetNumOfVertice(), 2);
+  EXPECT_EQ(g.GetDirectionOf(a, c), UPSTREAM);
+  EXPECT_EQ(g.GetDirectionOf(a, b), UNREACHABLE);
+}
+
 }  // namespace service_discovery
 }  // namespace cyber
 }  // namespace apollo
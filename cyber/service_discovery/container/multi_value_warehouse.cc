@@ -17,6 +17,7 @@
 #include "cyber/service_discovery/container/multi_value_warehouse.h"
 
 #include <algorithm>
+#include <functional>
 #include <utility>
 
 #include "cyber/common/log.h"
@@ -30,6 +31,79 @@ using base::ReadLockGuard;
 using base::WriteLockGuard;
 using proto::RoleAttributes;
 
+uint64_t MultiValueWarehouse::IndexKey(IndexType type,
+                                       const RoleAttributes& attr) {
+  switch (type) {
+    case NODE_INDEX:
+      return attr.node_id();
+    case PROCESS_INDEX:
+      return static_cast<uint64_t>(attr.process_id());
+    default:
+      return std::hash<std::string>()(attr.host_name());
+  }
+}
+
+MultiValueWarehouse::IndexType MultiValueWarehouse::SelectIndex(
+    const RoleAttributes& target_attr) {
+  if (target_attr.has_node_id()) {
+    return NODE_INDEX;
+  }
+  if (target_attr.has_process_id()) {
+    return PROCESS_INDEX;
+  }
+  if (target_attr.has_host_name()) {
+    return HOST_INDEX;
+  }
+  return INDEX_NUM;
+}
+
+void MultiValueWarehouse::AddToIndexes(uint64_t key, const RolePtr& role) {
+  for (int i = 0; i < INDEX_NUM; ++i) {
+    auto type = static_cast<IndexType>(i);
+    indexes_[i].emplace(IndexKey(type, role->attributes()),
+                        std::make_pair(key, role));
+  }
+}
+
+void MultiValueWarehouse::RemoveFromIndexes(const RolePtr& role) {
+  for (int i = 0; i < INDEX_NUM; ++i) {
+    RemoveFromIndex(static_cast<IndexType>(i), role);
+  }
+}
+
+void MultiValueWarehouse::RemoveFromIndex(IndexType type,
+                                          const RolePtr& role) {
+  auto& index = indexes_[type];
+  auto range = index.equal_range(IndexKey(type, role->attributes()));
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.second == role) {
+      index.erase(it);
+      return;
+    }
+  }
+}
+
+template <typename Func>
+void MultiValueWarehouse::ForEachMatched(const RoleAttributes& target_attr,
+                                         Func&& func) {
+  auto type = SelectIndex(target_attr);
+  if (type == INDEX_NUM) {
+    for (auto& item : roles_) {
+      if (item.second->Match(target_attr) && func(item.first, item.second)) {
+        return;
+      }
+    }
+    return;
+  }
+  auto range = indexes_[type].equal_range(IndexKey(type, target_attr));
+  for (auto it = range.first; it != range.second; ++it) {
+    auto& role = it->second.second;
+    if (role->Match(target_attr) && func(it->second.first, role)) {
+      return;
+    }
+  }
+}
+
 bool MultiValueWarehouse::Add(uint64_t key, const RolePtr& role,
                               bool ignore_if_exist) {
   WriteLockGuard<AtomicRWLock> lock(rw_lock_);
@@ -40,12 +114,16 @@ bool MultiValueWarehouse::Add(uint64_t key, const RolePtr& role,
   }
   std::pair<uint64_t, RolePtr> role_pair(key, role);
   roles_.insert(role_pair);
+  AddToIndexes(key, role);
   return true;
 }
 
 void MultiValueWarehouse::Clear() {
   WriteLockGuard<AtomicRWLock> lock(rw_lock_);
   roles_.clear();
+  for (auto& index : indexes_) {
+    index.clear();
+  }
 }
 
 std::size_t MultiValueWarehouse::Size() {
@@ -55,7 +133,11 @@ std::size_t MultiValueWarehouse::Size() {
 
 void MultiValueWarehouse::Remove(uint64_t key) {
   WriteLockGuard<AtomicRWLock> lock(rw_lock_);
-  roles_.erase(key);
+  auto range = roles_.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    RemoveFromIndexes(it->second);
+  }
+  roles_.erase(range.first, range.second);
 }
 
 void MultiValueWarehouse::Remove(uint64_t key, const RolePtr& role) {
@@ -63,6 +145,7 @@ void MultiValueWarehouse::Remove(uint64_t key, const RolePtr& role) {
   auto range = roles_.equal_range(key);
   for (auto it = range.first; it != range.second;) {
     if (it->second->Match(role->attributes())) {
+      RemoveFromIndexes(it->second);
       it = roles_.erase(it);
     } else {
       ++it;
@@ -72,13 +155,20 @@ void MultiValueWarehouse::Remove(uint64_t key, const RolePtr& role) {
 
 void MultiValueWarehouse::Remove(const RoleAttributes& target_attr) {
   WriteLockGuard<AtomicRWLock> lock(rw_lock_);
-  for (auto it = roles_.begin(); it != roles_.end();) {
-    auto curr_role = it->second;
-    if (curr_role->Match(target_attr)) {
-      it = roles_.erase(it);
-    } else {
-      ++it;
+  std::vector<std::pair<uint64_t, RolePtr>> matched;
+  ForEachMatched(target_attr, [&matched](uint64_t key, const RolePtr& role) {
+    matched.emplace_back(key, role);
+    return false;
+  });
+  for (auto& item : matched) {
+    auto range = roles_.equal_range(item.first);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == item.second) {
+        roles_.erase(it);
+        break;
+      }
     }
+    RemoveFromIndexes(item.second);
   }
 }
 
@@ -145,14 +235,14 @@ bool MultiValueWarehouse::Search(const RoleAttributes& target_attr) {
 bool MultiValueWarehouse::Search(const RoleAttributes& target_attr,
                                  RolePtr* first_matched_role) {
   RETURN_VAL_IF_NULL(first_matched_role, false);
+  bool find = false;
   ReadLockGuard<AtomicRWLock> lock(rw_lock_);
-  for (auto& item : roles_) {
-    if (item.second->Match(target_attr)) {
-      *first_matched_role = item.second;
-      return true;
-    }
-  }
-  return false;
+  ForEachMatched(target_attr, [&](uint64_t, const RolePtr& role) {
+    *first_matched_role = role;
+    find = true;
+    return true;
+  });
+  return find;
 }
 
 bool MultiValueWarehouse::Search(const RoleAttributes& target_attr,
@@ -171,12 +261,11 @@ bool MultiValueWarehouse::Search(const RoleAttributes& target_attr,
   RETURN_VAL_IF_NULL(matched_roles, false);
   bool find = false;
   ReadLockGuard<AtomicRWLock> lock(rw_lock_);
-  for (auto& item : roles_) {
-    if (item.second->Match(target_attr)) {
-      matched_roles->emplace_back(item.second);
-      find = true;
-    }
-  }
+  ForEachMatched(target_attr, [&](uint64_t, const RolePtr& role) {
+    matched_roles->emplace_back(role);
+    find = true;
+    return false;
+  });
   return find;
 }
 
@@ -186,12 +275,11 @@ bool MultiValueWarehouse::Search(
   RETURN_VAL_IF_NULL(matched_roles_attr, false);
   bool find = false;
   ReadLockGuard<AtomicRWLock> lock(rw_lock_);
-  for (auto& item : roles_) {
-    if (item.second->Match(target_attr)) {
-      matched_roles_attr->emplace_back(item.second->attributes());
-      find = true;
-    }
-  }
+  ForEachMatched(target_attr, [&](uint64_t, const RolePtr& role) {
+    matched_roles_attr->emplace_back(role->attributes());
+    find = true;
+    return false;
+  });
   return find;
 }
 
@@ -19,6 +19,7 @@
 
 #include <cstdint>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "cyber/base/atomic_rw_lock.h"
@@ -28,6 +29,11 @@ namespace apollo {
 namespace cyber {
 namespace service_discovery {
 
+/**
+ * @brief Roles are stored by key and additionally indexed by node, process
+ * and host, so searching or removing by RoleAttributes that carry one of
+ * those only visits the roles sharing it instead of scanning everything.
+ */
 class MultiValueWarehouse : public WarehouseBase {
  public:
   using RoleMap = std::unordered_multimap<uint64_t, RolePtr>;
@@ -67,7 +73,27 @@ class MultiValueWarehouse : public WarehouseBase {
   void GetAllRoles(std::vector<proto::RoleAttributes>* roles_attr) override;
 
  private:
+  // index key -> (key in roles_, role)
+  using RoleIndex =
+      std::unordered_multimap<uint64_t, std::pair<uint64_t, RolePtr>>;
+  enum IndexType { NODE_INDEX = 0, PROCESS_INDEX, HOST_INDEX, INDEX_NUM };
+
+  static uint64_t IndexKey(IndexType type,
+                           const proto::RoleAttributes& attr);
+  // returns INDEX_NUM if target_attr can not be served by any index
+  static IndexType SelectIndex(const proto::RoleAttributes& target_attr);
+
+  void AddToIndexes(uint64_t key, const RolePtr& role);
+  void RemoveFromIndexes(const RolePtr& role);
+  void RemoveFromIndex(IndexType type, const RolePtr& role);
+
+  // calls func(key, role) for every role matching target_attr, must be
+  // called with rw_lock_ held
+  template <typename Func>
+  void ForEachMatched(const proto::RoleAttributes& target_attr, Func&& func);
+
   RoleMap roles_;
+  RoleIndex indexes_[INDEX_NUM];
   base::AtomicRWLock rw_lock_;
 };
 
@@ -17,7 +17,10 @@
 #include "cyber/service_discovery/container/multi_value_warehouse.h"
 
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 namespace apollo {
@@ -232,6 +235,63 @@ TEST(MultiValueWarehouseTest, test1) {
   }
 }
 
+TEST(MultiValueWarehouseTest, search_by_attr) {
+  MultiValueWarehouse wh;
+  RoleAttributes attr;
+  for (int host = 0; host < 2; ++host) {
+    attr.set_host_name("host_" + std::to_string(host));
+    for (int process = 0; process < 4; ++process) {
+      attr.set_process_id(process);
+      for (int node = 0; node < 8; ++node) {
+        attr.set_node_id(host * 100 + process * 10 + node);
+        attr.set_id(attr.node_id());
+        wh.Add(node, std::make_shared<RoleWriter>(attr));
+      }
+    }
+  }
+  EXPECT_EQ(wh.Size(), 64);
+
+  RoleAttributes target;
+  std::vector<RoleAttributes> matched;
+  target.set_node_id(123);
+  EXPECT_TRUE(wh.Search(target, &matched));
+  ASSERT_EQ(matched.size(), 1);
+  EXPECT_EQ(matched[0].host_name(), "host_1");
+
+  matched.clear();
+  target.Clear();
+  target.set_host_name("host_1");
+  target.set_process_id(2);
+  EXPECT_TRUE(wh.Search(target, &matched));
+  EXPECT_EQ(matched.size(), 8);
+
+  matched.clear();
+  target.clear_process_id();
+  EXPECT_TRUE(wh.Search(target, &matched));
+  EXPECT_EQ(matched.size(), 32);
+
+  // removal keeps every index consistent
+  target.set_process_id(2);
+  wh.Remove(target);
+  EXPECT_EQ(wh.Size(), 56);
+  EXPECT_FALSE(wh.Search(target));
+  target.clear_host_name();
+  matched.clear();
+  EXPECT_TRUE(wh.Search(target, &matched));
+  EXPECT_EQ(matched.size(), 8);
+
+  wh.Remove(3);
+  target.Clear();
+  target.set_node_id(3);
+  EXPECT_FALSE(wh.Search(target));
+  target.set_node_id(4);
+  RolePtr role;
+  EXPECT_TRUE(wh.Search(target, &role));
+  wh.Remove(4, role);
+  EXPECT_FALSE(wh.Search(target));
+  EXPECT_EQ(wh.Size(), 48);
+}
+
 }  // namespace service_discovery
 }  // namespace cyber
 }  // namespace apollo
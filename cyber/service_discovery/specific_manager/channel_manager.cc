@@ -232,12 +232,32 @@ bool ChannelManager::Check(const RoleAttributes& attr) {
 void ChannelManager::Dispose(const ChangeMsg& msg) {
   if (msg.operate_type() == OperateType::OPT_JOIN) {
     DisposeJoin(msg);
+    node_graph_.Insert(ToEdge(msg));
   } else {
     DisposeLeave(msg);
+    node_graph_.Delete(ToEdge(msg));
   }
   Notify(msg);
 }
 
+void ChannelManager::DisposeBatch(const std::vector<ChangeMsg>& msgs) {
+  std::vector<Graph::Change> changes;
+  changes.reserve(msgs.size());
+  for (auto& msg : msgs) {
+    bool is_join = msg.operate_type() == OperateType::OPT_JOIN;
+    if (is_join) {
+      DisposeJoin(msg);
+    } else {
+      DisposeLeave(msg);
+    }
+    changes.emplace_back(ToEdge(msg), is_join);
+  }
+  node_graph_.Apply(changes);
+  for (auto& msg : msgs) {
+    Notify(msg);
+  }
+}
+
 // 在TopologyManager::OnParticipantChange()中被调用
 void ChannelManager::OnTopoModuleLeave(const std::string& host_name,
                                        int process_id) {
@@ -253,28 +273,24 @@ void ChannelManager::OnTopoModuleLeave(const std::string& host_name,
   std::vector<RolePtr> readers_to_remove;
   channel_readers_.Search(attr, &readers_to_remove);
 
-  ChangeMsg msg;
+  std::vector<ChangeMsg> msgs(writers_to_remove.size() +
+                              readers_to_remove.size());
+  size_t i = 0;
   for (auto& writer : writers_to_remove) {
     Convert(writer->attributes(), RoleType::ROLE_WRITER, OperateType::OPT_LEAVE,
-            &msg);
-    DisposeLeave(msg);
-    Notify(msg);
+            &msgs[i++]);
   }
 
   for (auto& reader : readers_to_remove) {
     Convert(reader->attributes(), RoleType::ROLE_READER, OperateType::OPT_LEAVE,
-            &msg);
-    DisposeLeave(msg);
-    Notify(msg);
+            &msgs[i++]);
   }
+  DisposeBatch(msgs);
 }
 
 void ChannelManager::DisposeJoin(const ChangeMsg& msg) {
   ScanMessageType(msg);
 
-  Vertice v(msg.role_attr().node_name());
-  Edge e;
-  e.set_value(msg.role_attr().channel_name());
   if (msg.role_type() == RoleType::ROLE_WRITER) {
     if (msg.role_attr().has_proto_desc() &&
         msg.role_attr().proto_desc() != "") {
@@ -284,32 +300,35 @@ void ChannelManager::DisposeJoin(const ChangeMsg& msg) {
     auto role = std::make_shared<RoleWriter>(msg.role_attr(), msg.timestamp());
     node_writers_.Add(role->attributes().node_id(), role);
     channel_writers_.Add(role->attributes().channel_id(), role);
-    e.set_src(v);
   } else {
     auto role = std::make_shared<RoleReader>(msg.role_attr(), msg.timestamp());
     node_readers_.Add(role->attributes().node_id(), role);
     channel_readers_.Add(role->attributes().channel_id(), role);
-    e.set_dst(v);
   }
-  node_graph_.Insert(e);
 }
 
 void ChannelManager::DisposeLeave(const ChangeMsg& msg) {
-  Vertice v(msg.role_attr().node_name());
-  Edge e;
-  e.set_value(msg.role_attr().channel_name());
   if (msg.role_type() == RoleType::ROLE_WRITER) {
     auto role = std::make_shared<RoleWriter>(msg.role_attr());
     node_writers_.Remove(role->attributes().node_id(), role);
     channel_writers_.Remove(role->attributes().channel_id(), role);
-    e.set_src(v);
   } else {
     auto role = std::make_shared<RoleReader>(msg.role_attr());
     node_readers_.Remove(role->attributes().node_id(), role);
     channel_readers_.Remove(role->attributes().channel_id(), role);
+  }
+}
+
+Edge ChannelManager::ToEdge(const ChangeMsg& msg) const {
+  Vertice v(msg.role_attr().node_name());
+  Edge e;
+  e.set_value(msg.role_attr().channel_name());
+  if (msg.role_type() == RoleType::ROLE_WRITER) {
+    e.set_src(v);
+  } else {
     e.set_dst(v);
   }
-  node_graph_.Delete(e);
+  return e;
 }
 
 void ChannelManager::ScanMessageType(const ChangeMsg& msg) {
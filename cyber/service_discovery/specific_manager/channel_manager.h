@@ -194,10 +194,13 @@ class ChannelManager : public Manager {
  private:
   bool Check(const RoleAttributes& attr) override;
   void Dispose(const ChangeMsg& msg) override;
+  void DisposeBatch(const std::vector<ChangeMsg>& msgs) override;
   void OnTopoModuleLeave(const std::string& host_name, int process_id) override;
 
   void DisposeJoin(const ChangeMsg& msg);
   void DisposeLeave(const ChangeMsg& msg);
+  // the channel edge of the role in msg, from or to its node
+  Edge ToEdge(const ChangeMsg& msg) const;
 
   void ScanMessageType(const ChangeMsg& msg);
 
@@ -19,6 +19,7 @@
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
 #include "cyber/message/message_traits.h"
+#include "cyber/service_discovery/communication/local_registry.h"
 #include "cyber/time/time.h"
 #include "cyber/transport/qos/qos_profile_conf.h"
 #include "cyber/transport/rtps/attributes_filler.h"
@@ -40,7 +41,8 @@ Manager::Manager()
       channel_name_(""),
       publisher_(nullptr),
       subscriber_(nullptr),
-      listener_(nullptr) {
+      listener_(nullptr),
+      local_registry_(nullptr) {
   host_name_ = common::GlobalData::Instance()->HostName();
   process_id_ = common::GlobalData::Instance()->ProcessId();
 }
@@ -163,6 +165,12 @@ bool Manager::CreateSubscriber(RtpsParticipant* participant) {
   return subscriber_ != nullptr;
 }
 
+void Manager::DisposeBatch(const std::vector<ChangeMsg>& msgs) {
+  for (auto& msg : msgs) {
+    Dispose(msg);
+  }
+}
+
 bool Manager::NeedPublish(const ChangeMsg& msg) const {
   (void)msg;
   return true;
@@ -186,19 +194,49 @@ void Manager::Convert(const RoleAttributes& attr, RoleType role,
 // Notify的时候调用信号对应的槽函数
 void Manager::Notify(const ChangeMsg& msg) { signal_(msg); }
 
-void Manager::OnRemoteChange(const std::string& msg_str) {
+void Manager::OnRemoteChange(const std::vector<std::string>& msg_strs) {
   if (is_shutdown_.load()) {
     ADEBUG << "the manager has been shut down.";
     return;
   }
 
-  ChangeMsg msg;
-  RETURN_IF(!message::ParseFromString(msg_str, &msg));
-  if (IsFromSameProcess(msg)) {
+  std::vector<ChangeMsg> msgs(msg_strs.size());
+  size_t num = 0;
+  for (auto& msg_str : msg_strs) {
+    auto& msg = msgs[num];
+    if (!message::ParseFromString(msg_str, &msg) || IsFromSameProcess(msg) ||
+        IsSharedLocally(msg) || !Check(msg.role_attr())) {
+      msg.Clear();
+      continue;
+    }
+    ++num;
+  }
+  msgs.resize(num);
+  DisposeChanges(msgs);
+}
+
+void Manager::OnLocalChange(const std::vector<ChangeMsg>& msgs) {
+  if (is_shutdown_.load()) {
+    ADEBUG << "the manager has been shut down.";
     return;
   }
-  RETURN_IF(!Check(msg.role_attr()));
-  Dispose(msg);
+
+  std::vector<ChangeMsg> valid_msgs;
+  valid_msgs.reserve(msgs.size());
+  for (auto& msg : msgs) {
+    if (Check(msg.role_attr())) {
+      valid_msgs.emplace_back(msg);
+    }
+  }
+  DisposeChanges(valid_msgs);
+}
+
+void Manager::DisposeChanges(const std::vector<ChangeMsg>& msgs) {
+  if (msgs.size() == 1) {
+    Dispose(msgs.front());
+  } else if (msgs.size() > 1) {
+    DisposeBatch(msgs);
+  }
 }
 
 bool Manager::Publish(const ChangeMsg& msg) {
@@ -208,7 +246,14 @@ bool Manager::Publish(const ChangeMsg& msg) {
   }
 
   apollo::cyber::transport::UnderlayMessage m;
-  RETURN_VAL_IF(!message::SerializeToString(msg, &m.data()), false);
+  if (local_registry_ != nullptr && local_registry_->Update(msg)) {
+    // listeners on this host have it already and skip the rtps copy
+    ChangeMsg shared_msg(msg);
+    shared_msg.set_local_registry(local_registry_->id());
+    RETURN_VAL_IF(!message::SerializeToString(shared_msg, &m.data()), false);
+  } else {
+    RETURN_VAL_IF(!message::SerializeToString(msg, &m.data()), false);
+  }
   {
     std::lock_guard<std::mutex> lg(lock_);
     if (publisher_ != nullptr) {
@@ -218,6 +263,14 @@ bool Manager::Publish(const ChangeMsg& msg) {
   return true;
 }
 
+bool Manager::IsSharedLocally(const ChangeMsg& msg) {
+  // processes of other domains or pid namespaces use another registry
+  return msg.local_registry() != 0 && local_registry_ != nullptr &&
+         local_registry_->IsReady() &&
+         msg.local_registry() == local_registry_->id() &&
+         msg.role_attr().host_name() == host_name_;
+}
+
 bool Manager::IsFromSameProcess(const ChangeMsg& msg) {
   auto& host_name = msg.role_attr().host_name();
   int process_id = msg.role_attr().process_id();
@@ -21,6 +21,7 @@
 #include <functional>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "fastrtps/Domain.h"
 #include "fastrtps/attributes/PublisherAttributes.h"
@@ -37,6 +38,8 @@ namespace apollo {
 namespace cyber {
 namespace service_discovery {
 
+class LocalRegistry;
+
 using proto::ChangeMsg;
 using proto::ChangeType;
 using proto::OperateType;
@@ -135,12 +138,29 @@ class Manager {
   virtual void OnTopoModuleLeave(const std::string& host_name,
                                  int process_id) = 0;
 
+  /**
+   * @brief Announce changes to processes of this host through `registry`
+   * too, it must outlive the manager's discovery
+   */
+  void SetLocalRegistry(LocalRegistry* registry) { local_registry_ = registry; }
+
+  /**
+   * @brief Apply changes of other processes of this host, as found in the
+   * local registry
+   */
+  void OnLocalChange(const std::vector<ChangeMsg>& msgs);
+
  protected:
   bool CreatePublisher(RtpsParticipant* participant);
   bool CreateSubscriber(RtpsParticipant* participant);
 
   virtual bool Check(const RoleAttributes& attr) = 0;
   virtual void Dispose(const ChangeMsg& msg) = 0;
+  /**
+   * @brief Apply several change messages received together, in order.
+   * Disposes them one by one unless a manager can do better.
+   */
+  virtual void DisposeBatch(const std::vector<ChangeMsg>& msgs);
   virtual bool NeedPublish(const ChangeMsg& msg) const;
 
   void Convert(const RoleAttributes& attr, RoleType role, OperateType opt,
@@ -148,8 +168,10 @@ class Manager {
 
   void Notify(const ChangeMsg& msg);
   bool Publish(const ChangeMsg& msg);
-  void OnRemoteChange(const std::string& msg_str);
+  void OnRemoteChange(const std::vector<std::string>& msg_strs);
   bool IsFromSameProcess(const ChangeMsg& msg);
+  bool IsSharedLocally(const ChangeMsg& msg);
+  void DisposeChanges(const std::vector<ChangeMsg>& msgs);
 
   std::atomic<bool> is_shutdown_;
   std::atomic<bool> is_discovery_started_;
@@ -162,6 +184,7 @@ class Manager {
   std::mutex lock_;
   eprosima::fastrtps::Subscriber* subscriber_;
   SubscriberListener* listener_;
+  LocalRegistry* local_registry_;
 
   ChangeSignal signal_;
 };
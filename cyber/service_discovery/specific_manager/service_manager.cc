@@ -43,6 +43,13 @@ void ServiceManager::GetServers(RoleAttrVec* servers) {
   servers_.GetAllRoles(servers);
 }
 
+bool ServiceManager::GetServer(const std::string& service_name,
+                               RoleAttributes* server) {
+  RETURN_VAL_IF_NULL(server, false);
+  uint64_t key = common::Hash(service_name);
+  return servers_.Search(key, server);
+}
+
 void ServiceManager::GetClients(const std::string& service_name,
                                 RoleAttrVec* clients) {
   RETURN_IF_NULL(clients);
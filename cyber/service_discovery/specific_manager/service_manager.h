@@ -70,6 +70,16 @@ class ServiceManager : public Manager {
    */
   void GetServers(RoleAttrVec* servers);
 
+  /**
+   * @brief Get the Server that provides `service_name`
+   *
+   * @param service_name Name of service you want to get
+   * @param server result RoleAttr
+   * @return true if the server exists
+   * @return false if the server not exists
+   */
+  bool GetServer(const std::string& service_name, RoleAttributes* server);
+
   /**
    * @brief Get the Clients object that subscribes `service_name`
    *
@@ -66,6 +66,10 @@ TEST_F(ServiceManagerTest, server_operation) {
   EXPECT_TRUE(servers.empty());
   service_manager_->GetServers(&servers);
   EXPECT_EQ(servers.size(), 1);
+  RoleAttributes server;
+  EXPECT_TRUE(service_manager_->GetServer("service", &server));
+  EXPECT_EQ(server.process_id(), role_attr.process_id());
+  EXPECT_FALSE(service_manager_->GetServer("client", &server));
 
   // leave
   EXPECT_FALSE(service_manager_->Leave(role_attr, RoleType::ROLE_SERVER));
@@ -75,6 +79,7 @@ TEST_F(ServiceManagerTest, server_operation) {
   EXPECT_TRUE(servers.empty());
   service_manager_->GetServers(&servers);
   EXPECT_TRUE(servers.empty());
+  EXPECT_FALSE(service_manager_->GetServer("service", &server));
 }
 
 TEST_F(ServiceManagerTest, client_operation) {
@@ -43,6 +43,9 @@ void TopologyManager::Shutdown() {
     return;
   }
 
+  if (local_registry_ != nullptr) {
+    local_registry_->Shutdown();
+  }
   node_manager_->Shutdown();
   channel_manager_->Shutdown();
   service_manager_->Shutdown();
@@ -89,6 +92,7 @@ bool TopologyManager::Init() {
     return false;
   }
 
+  InitLocalRegistry();
   return true;
 }
 
@@ -105,6 +109,59 @@ bool TopologyManager::InitServiceManager() {
   return service_manager_->StartDiscovery(participant_->fastrtps_participant());
 }
 
+bool TopologyManager::InitLocalRegistry() {
+  auto& global_conf = common::GlobalData::Instance()->Config();
+  if (global_conf.has_transport_conf() &&
+      !global_conf.transport_conf().local_discovery()) {
+    return false;
+  }
+  local_registry_.reset(new LocalRegistry());
+  if (!local_registry_->Init()) {
+    AWARN << "local registry unavailable, discover through rtps only.";
+    local_registry_ = nullptr;
+    return false;
+  }
+  node_manager_->SetLocalRegistry(local_registry_.get());
+  channel_manager_->SetLocalRegistry(local_registry_.get());
+  service_manager_->SetLocalRegistry(local_registry_.get());
+  local_registry_->Start(std::bind(&TopologyManager::OnLocalChange, this,
+                                   std::placeholders::_1));
+  return true;
+}
+
+void TopologyManager::OnLocalChange(const std::vector<ChangeMsg>& msgs) {
+  if (!init_.load()) {
+    return;
+  }
+  std::vector<ChangeMsg> node_msgs;
+  std::vector<ChangeMsg> channel_msgs;
+  std::vector<ChangeMsg> service_msgs;
+  for (auto& msg : msgs) {
+    switch (msg.change_type()) {
+      case ChangeType::CHANGE_NODE:
+        node_msgs.emplace_back(msg);
+        break;
+      case ChangeType::CHANGE_CHANNEL:
+        channel_msgs.emplace_back(msg);
+        break;
+      case ChangeType::CHANGE_SERVICE:
+        service_msgs.emplace_back(msg);
+        break;
+      default:
+        break;
+    }
+  }
+  if (!node_msgs.empty()) {
+    node_manager_->OnLocalChange(node_msgs);
+  }
+  if (!channel_msgs.empty()) {
+    channel_manager_->OnLocalChange(channel_msgs);
+  }
+  if (!service_msgs.empty()) {
+    service_manager_->OnLocalChange(service_msgs);
+  }
+}
+
 bool TopologyManager::CreateParticipant() {
   // 主机名+进程Id作为participant_name
   std::string participant_name =
@@ -22,9 +22,11 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "cyber/base/signal.h"
 #include "cyber/common/macros.h"
+#include "cyber/service_discovery/communication/local_registry.h"
 #include "cyber/service_discovery/communication/participant_listener.h"
 #include "cyber/service_discovery/specific_manager/channel_manager.h"
 #include "cyber/service_discovery/specific_manager/node_manager.h"
@@ -111,9 +113,11 @@ class TopologyManager {
   bool InitNodeManager();
   bool InitChannelManager();
   bool InitServiceManager();
+  bool InitLocalRegistry();
 
   bool CreateParticipant();
   void OnParticipantChange(const PartInfo& info);
+  void OnLocalChange(const std::vector<ChangeMsg>& msgs);
   bool Convert(const PartInfo& info, ChangeMsg* change_msg);
   bool ParseParticipantName(const std::string& participant_name,
                             std::string* host_name, int* process_id);
@@ -125,6 +129,8 @@ class TopologyManager {
   /// rtps participant to publish and subscribe
   transport::ParticipantPtr participant_;
   ParticipantListener* participant_listener_;
+  /// roles of the processes on this host, consulted before rtps
+  std::unique_ptr<LocalRegistry> local_registry_;
   ChangeSignal change_signal_;           /// topology changing signal,
                                          ///< connect to `ChangeFunc`s
   PartNameContainer participant_names_;  /// other participant in the topology
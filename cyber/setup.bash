@@ -17,12 +17,14 @@ channel_path="${cyber_tool_path}/cyber_channel"
 node_path="${cyber_tool_path}/cyber_node"
 service_path="${cyber_tool_path}/cyber_service"
 monitor_path="${cyber_tool_path}/cyber_monitor"
+sched_top_path="${cyber_tool_path}/cyber_sched_top"
 visualizer_path="${bazel_bin_path}/modules/tools/visualizer"
 rosbag_to_record_path="${bazel_bin_path}/modules/data/tools/rosbag_to_record"
 
 # TODO(all): place all these in one place and add_to_path
 for entry in "${cyber_bin_path}" \
     "${recorder_path}" "${monitor_path}"  \
+    "${sched_top_path}" \
     "${channel_path}" "${node_path}" \
     "${service_path}" \
     "${launch_path}" \
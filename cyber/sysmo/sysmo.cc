@@ -16,11 +16,15 @@
 
 #include "cyber/sysmo/sysmo.h"
 
+#include <unistd.h>
+
 #include "cyber/common/environment.h"
+#include "cyber/scheduler/policy/scheduler_choreography.h"
 
 namespace apollo {
 namespace cyber {
 
+using apollo::cyber::base::LockStats;
 using apollo::cyber::common::GetEnv;
 
 SysMo::SysMo() { Start(); }
@@ -45,12 +49,55 @@ void SysMo::Shutdown() {
 }
 
 void SysMo::Checker() {
+  int elapsed_ms = 0;
   while (cyber_unlikely(!shut_down_.load())) {
     scheduler::Instance()->CheckSchedStatus();
+    elapsed_ms += sysmo_interval_ms_;
+    if (elapsed_ms >= lock_stats_interval_ms_) {
+      DumpLockStats();
+      DumpServiceStats();
+      DumpDeadlineStats();
+      DumpSchedStats();
+      elapsed_ms = 0;
+    }
     std::unique_lock<std::mutex> lk(lk_);
     cv_.wait_for(lk, std::chrono::milliseconds(sysmo_interval_ms_));
   }
 }
 
+// counters are cumulative since process start
+void SysMo::DumpLockStats() {
+  auto info = LockStats::Dump();
+  if (!info.empty()) {
+    AINFO << "lock contention:\n" << info;
+  }
+}
+
+void SysMo::DumpServiceStats() {
+  auto info = ServiceStats::Dump();
+  if (!info.empty()) {
+    AINFO << "service stats:\n" << info;
+  }
+}
+
+void SysMo::DumpDeadlineStats() {
+  auto sched = dynamic_cast<scheduler::SchedulerChoreography*>(
+      scheduler::Instance());
+  if (sched == nullptr) {
+    return;
+  }
+  auto info = sched->DumpDeadlineStats();
+  if (!info.empty()) {
+    AINFO << "choreography deadlines:\n" << info;
+  }
+}
+
+void SysMo::DumpSchedStats() {
+  auto info = scheduler::SchedStats::Instance()->Dump(getpid());
+  if (!info.empty()) {
+    AINFO << "scheduler stats:\n" << info;
+  }
+}
+
 }  // namespace cyber
 }  // namespace apollo
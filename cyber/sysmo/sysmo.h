@@ -24,7 +24,10 @@
 #include <string>
 #include <thread>
 
+#include "cyber/base/lock_stats.h"
+#include "cyber/scheduler/common/sched_stats.h"
 #include "cyber/scheduler/scheduler_factory.h"
+#include "cyber/service/service_stats.h"
 
 namespace apollo {
 namespace cyber {
@@ -38,11 +41,16 @@ class SysMo {
 
  private:
   void Checker();
+  void DumpLockStats();
+  void DumpServiceStats();
+  void DumpDeadlineStats();
+  void DumpSchedStats();
 
   std::atomic<bool> shut_down_{false};
   bool start_ = false;
 
   int sysmo_interval_ms_ = 100;
+  int lock_stats_interval_ms_ = 1000;
   std::condition_variable cv_;
   std::mutex lk_;
   std::thread sysmo_;
@@ -16,6 +16,8 @@
 
 #include "cyber/task/task_manager.h"
 
+#include <algorithm>
+
 #include "cyber/common/global_data.h"
 #include "cyber/croutine/croutine.h"
 #include "cyber/croutine/routine_factory.h"
@@ -35,14 +37,21 @@ TaskManager::TaskManager()
     throw std::runtime_error("Task queue init failed");
   }
   auto func = [this]() {
+    std::vector<std::function<void()>> tasks(kMaxBatchSize);
     while (!stop_) {
-      std::function<void()> task;
-      if (!task_queue_->Dequeue(&task)) {
+      // take a fair share of the queue so the other task routines stay busy
+      auto batch = std::min<uint64_t>(
+          kMaxBatchSize, task_queue_->Size() / num_threads_ + 1);
+      auto num = task_queue_->DequeueBulk(tasks.data(), batch);
+      if (num == 0) {
         auto routine = croutine::CRoutine::GetCurrentRoutine();
         routine->HangUp();
         continue;
       }
-      task();
+      for (uint64_t i = 0; i < num; ++i) {
+        tasks[i]();
+        tasks[i] = nullptr;
+      }
     }
   };
 
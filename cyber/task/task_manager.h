@@ -56,6 +56,7 @@ class TaskManager {
  private:
   uint32_t num_threads_ = 0;
   uint32_t task_queue_size_ = 1000;
+  const uint64_t kMaxBatchSize = 16;
   std::atomic<bool> stop_ = {false};
   std::vector<uint64_t> tasks_;
   std::shared_ptr<base::BoundedQueue<std::function<void()>>> task_queue_;
@@ -19,6 +19,7 @@
 #include <iomanip>
 #include <iostream>
 
+#include "cyber/common/global_data.h"
 #include "cyber/message/message_traits.h"
 #include "cyber/proto/role_attributes.pb.h"
 #include "cyber/proto/topology_change.pb.h"
@@ -57,9 +58,16 @@ RenderableMessage* CyberTopologyMessage::Child(int line_no) const {
   RenderableMessage* ret = nullptr;
   auto iter = findChild(line_no);
   if (iter != all_channels_map_.cend() &&
-      !GeneralChannelMessage::isErrorCode(iter->second) &&
-      iter->second->is_enabled()) {
-    ret = iter->second;
+      !GeneralChannelMessage::isErrorCode(iter->second)) {
+    GeneralChannelMessage* child = iter->second;
+    // only tracked so far, the messages are needed now
+    if (!child->is_enabled() && child->is_tracked() &&
+        !GeneralChannelMessage::isErrorCode(child->OpenChannel(iter->first))) {
+      child->add_reader(child->NodeName());
+    }
+    if (child->is_enabled()) {
+      ret = child;
+    }
   }
   return ret;
 }
@@ -149,8 +157,11 @@ void CyberTopologyMessage::AddReaderWriter(
     channelMsg = new GeneralChannelMessage(outStr.str(), this);
 
     if (channelMsg != nullptr) {
-      if (!GeneralChannelMessage::isErrorCode(
-              channelMsg->OpenChannel(channelName))) {
+      if (channelMsg->TrackChannel(channelName)) {
+        // rates come from the channel statistics, no need to subscribe
+        channelMsg->set_message_type(msgTypeName);
+      } else if (!GeneralChannelMessage::isErrorCode(
+                     channelMsg->OpenChannel(channelName))) {
         channelMsg->set_message_type(msgTypeName);
         channelMsg->add_reader(channelMsg->NodeName());
       }
@@ -171,6 +182,19 @@ void CyberTopologyMessage::AddReaderWriter(
       }
 
       channelMsg->add_writer(nodeName);
+      // messages of other hosts never show up in the statistics, and
+      // neither do those of a writer that found the page full
+      if (channelMsg->is_tracked() &&
+          (role.host_name() !=
+               apollo::cyber::common::GlobalData::Instance()->HostName() ||
+           !channelMsg->is_counted())) {
+        channelMsg->UntrackChannel();
+        if (!channelMsg->is_enabled() &&
+            !GeneralChannelMessage::isErrorCode(
+                channelMsg->OpenChannel(channelName))) {
+          channelMsg->add_reader(channelMsg->NodeName());
+        }
+      }
     } else {
       channelMsg->add_reader(nodeName);
     }
@@ -27,9 +27,12 @@
 
 namespace {
 constexpr int ReaderWriterOffset = 4;
+using apollo::cyber::common::GlobalData;
 using apollo::cyber::record::kGB;
 using apollo::cyber::record::kKB;
 using apollo::cyber::record::kMB;
+using apollo::cyber::transport::ChannelStats;
+using apollo::cyber::transport::ChannelStatsSnapshot;
 }  // namespace
 
 const char* GeneralChannelMessage::errCode2Str(
@@ -83,7 +86,61 @@ bool GeneralChannelMessage::isErrorCode(void* ptr) {
   return false;
 }
 
+bool GeneralChannelMessage::TrackChannel(const std::string& channelName) {
+  auto stats = ChannelStats::Instance();
+  if (stats == nullptr || !stats->IsReady()) {
+    return false;
+  }
+  channel_name_ = channelName;
+  stats_ = stats;
+  ChannelStatsSnapshot snapshot;
+  if (!ReadStats(&snapshot)) {
+    // no role of this host got a slot for the channel
+    stats_ = nullptr;
+    return false;
+  }
+  stats_tx_msgs_ = snapshot.tx_msgs;
+  time_last_calc_ = apollo::cyber::Time::MonoTime();
+  return true;
+}
+
+bool GeneralChannelMessage::ReadStats(ChannelStatsSnapshot* snapshot) const {
+  if (stats_ == nullptr) {
+    return false;
+  }
+  return stats_->Read(GlobalData::RegisterChannel(channel_name_), snapshot);
+}
+
+bool GeneralChannelMessage::has_message_come(void) const {
+  if (is_tracked() && !is_enabled()) {
+    ChannelStatsSnapshot snapshot;
+    return !writers_.empty() && ReadStats(&snapshot) && snapshot.tx_msgs > 0;
+  }
+  return has_message_come_;
+}
+
 double GeneralChannelMessage::frame_ratio(void) {
+  if (is_tracked()) {
+    // counted by the writers, nothing has to be received for it
+    auto time_now = apollo::cyber::Time::MonoTime();
+    auto interval = time_now - time_last_calc_;
+    ChannelStatsSnapshot snapshot;
+    if (interval.ToNanosecond() > 1000000000) {
+      if (ReadStats(&snapshot)) {
+        uint64_t frames = snapshot.tx_msgs >= stats_tx_msgs_
+                              ? snapshot.tx_msgs - stats_tx_msgs_
+                              : 0;
+        frame_ratio_ = static_cast<double>(frames) / interval.ToSecond();
+      } else {
+        // freed with the last role of the channel, a new slot counts from 0
+        frame_ratio_ = 0.0;
+        snapshot.tx_msgs = 0;
+      }
+      stats_tx_msgs_ = snapshot.tx_msgs;
+      time_last_calc_ = time_now;
+    }
+    return frame_ratio_;
+  }
   if (!is_enabled() || !has_message_come()) {
     return 0.0;
   }
@@ -114,6 +171,7 @@ GeneralChannelMessage* GeneralChannelMessage::OpenChannel(
     return castErrorCode2Ptr(ErrorCode::NoCloseChannel);
   }
 
+  channel_name_ = channelName;
   channel_node_ = apollo::cyber::CreateNode(node_name_);
   if (channel_node_ == nullptr) {
     return castErrorCode2Ptr(ErrorCode::CreateNodeFailed);
@@ -156,7 +214,7 @@ int GeneralChannelMessage::Render(const Screen* s, int key) {
 
   s->SetCurrentColor(Screen::WHITE_BLACK);
   s->AddStr(0, line_no++, "ChannelName: ");
-  s->AddStr(channel_reader_->GetChannelName().c_str());
+  s->AddStr(channel_name_.c_str());
 
   s->AddStr(0, line_no++, "MessageType: ");
   s->AddStr(message_type().c_str());
@@ -180,6 +238,15 @@ int GeneralChannelMessage::Render(const Screen* s, int key) {
 
 void GeneralChannelMessage::RenderInfo(const Screen* s, int key,
                                        int& line_no) {
+  ChannelStatsSnapshot snapshot;
+  if (ReadStats(&snapshot)) {
+    std::ostringstream outStr;
+    outStr << "Messages: " << snapshot.tx_msgs
+           << "  Bytes: " << snapshot.tx_bytes
+           << "  LastSeq: " << snapshot.last_seq;
+    s->AddStr(0, line_no++, outStr.str().c_str());
+  }
+
   page_item_count_ = s->Height() - line_no;
   pages_ = static_cast<int>(readers_.size() + writers_.size() + line_no) /
                page_item_count_ +
@@ -20,6 +20,7 @@
 #include <atomic>
 
 #include "cyber/message/raw_message.h"
+#include "cyber/transport/common/channel_stats.h"
 #include "general_message_base.h"
 
 class CyberTopologyMessage;
@@ -58,9 +59,7 @@ class GeneralChannelMessage : public GeneralMessageBase {
     }
   }
 
-  std::string GetChannelName(void) const {
-    return channel_reader_->GetChannelName();
-  }
+  const std::string& GetChannelName(void) const { return channel_name_; }
 
   void set_message_type(const std::string& msgTypeName) {
     message_type_ = msgTypeName;
@@ -68,7 +67,25 @@ class GeneralChannelMessage : public GeneralMessageBase {
   const std::string& message_type(void) const { return message_type_; }
 
   bool is_enabled(void) const { return channel_reader_ != nullptr; }
-  bool has_message_come(void) const { return has_message_come_; }
+  bool has_message_come(void) const;
+
+  /**
+   * @brief Follow the channel through the shared channel statistics, no
+   * message is received until the channel is opened
+   *
+   * The statistics only count the writers of this host, channels written
+   * from other hosts or not counted have to be untracked and opened.
+   *
+   * @return false if the statistics are not available or do not count the
+   * channel
+   */
+  bool TrackChannel(const std::string& channelName);
+  void UntrackChannel(void) { stats_ = nullptr; }
+  bool is_tracked(void) const { return stats_ != nullptr; }
+  bool is_counted(void) const {
+    apollo::cyber::transport::ChannelStatsSnapshot snapshot;
+    return ReadStats(&snapshot);
+  }
 
   double frame_ratio(void) override;
 
@@ -104,6 +121,9 @@ class GeneralChannelMessage : public GeneralMessageBase {
         current_state_(State::ShowDebugString),
         has_message_come_(false),
         message_type_(),
+        channel_name_(),
+        stats_(nullptr),
+        stats_tx_msgs_(0),
         frame_counter_(0),
         last_time_(apollo::cyber::Time::MonoTime()),
         msg_time_(last_time_.ToNanosecond() + 1),
@@ -164,10 +184,18 @@ class GeneralChannelMessage : public GeneralMessageBase {
 
   void set_has_message_come(bool b) { has_message_come_ = b; }
 
+  bool ReadStats(
+      apollo::cyber::transport::ChannelStatsSnapshot* snapshot) const;
+
   enum class State { ShowDebugString, ShowInfo } current_state_;
 
   bool has_message_come_;
   std::string message_type_;
+  std::string channel_name_;
+
+  // shared statistics of the channel, nullptr when not tracked
+  apollo::cyber::transport::ChannelStats* stats_;
+  uint64_t stats_tx_msgs_;
   std::atomic<int> frame_counter_;
   apollo::cyber::Time last_time_;
   apollo::cyber::Time msg_time_;
@@ -0,0 +1,216 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Load of the cyber processors and croutines of this host, like top.
+//
+//   cyber_sched_top [-p pid] [-d seconds] [-n iterations] [-l lines]
+//
+// Reads the scheduler statistics page the processors of every cyber process
+// write to, the busiest croutines of the last interval first.
+
+#include <getopt.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "cyber/scheduler/common/sched_stats.h"
+
+using apollo::cyber::scheduler::ProcessorStatsSnapshot;
+using apollo::cyber::scheduler::RoutineStatsSnapshot;
+using apollo::cyber::scheduler::SchedStats;
+
+namespace {
+
+struct Options {
+  int pid = 0;
+  double delay_s = 1.0;
+  int iterations = 0;
+  int lines = 30;
+};
+
+using RoutineKey = std::pair<int, uint64_t>;
+using ProcessorKey = std::pair<int, int>;
+
+void PrintHelp(const char* name) {
+  std::printf(
+      "Usage:\n  %s [option]\nOption:\n"
+      "  -p pid         only show this process\n"
+      "  -d seconds     interval between two updates, 1 by default\n"
+      "  -n iterations  exit after this many updates\n"
+      "  -l lines       croutines shown per update, 30 by default\n"
+      "  -h             print help info\n",
+      name);
+}
+
+bool ParseOptions(int argc, char* argv[], Options* options) {
+  int opt = 0;
+  while ((opt = getopt(argc, argv, "p:d:n:l:h")) != -1) {
+    switch (opt) {
+      case 'p':
+        options->pid = std::atoi(optarg);
+        break;
+      case 'd':
+        options->delay_s = std::atof(optarg);
+        break;
+      case 'n':
+        options->iterations = std::atoi(optarg);
+        break;
+      case 'l':
+        options->lines = std::atoi(optarg);
+        break;
+      default:
+        return false;
+    }
+  }
+  return options->delay_s > 0 && options->lines > 0;
+}
+
+double PerSecond(uint64_t value, double elapsed_s) {
+  return static_cast<double>(value) / elapsed_s;
+}
+
+void Print(const std::vector<ProcessorStatsSnapshot>& processors,
+           const std::map<ProcessorKey, ProcessorStatsSnapshot>& last_procs,
+           const std::vector<RoutineStatsSnapshot>& routines,
+           const std::map<RoutineKey, RoutineStatsSnapshot>& last_routines,
+           double elapsed_s, const Options& options) {
+  if (isatty(STDOUT_FILENO)) {
+    std::printf("\033[H\033[2J");
+  }
+  std::printf("cyber_sched_top - %zu processors, %zu croutines, %.1fs\n\n",
+              processors.size(), routines.size(), elapsed_s);
+
+  std::printf("%8s %8s %7s %10s %10s\n", "PID", "TID", "BUSY%", "RUNS/s",
+              "WAITS/s");
+  for (auto& proc : processors) {
+    ProcessorStatsSnapshot last;
+    auto it = last_procs.find({proc.pid, proc.tid});
+    if (it != last_procs.end()) {
+      last = it->second;
+    }
+    double busy_s = static_cast<double>(proc.busy_ns - last.busy_ns) / 1e9;
+    std::printf("%8d %8d %7.1f %10.0f %10.0f\n", proc.pid, proc.tid,
+                100.0 * busy_s / elapsed_s,
+                PerSecond(proc.runs - last.runs, elapsed_s),
+                PerSecond(proc.waits - last.waits, elapsed_s));
+  }
+
+  struct Row {
+    const RoutineStatsSnapshot* routine;
+    uint64_t runs;
+    uint64_t run_ns;
+    uint64_t wakeups;
+    uint64_t wakeup_ns;
+  };
+  std::vector<Row> rows;
+  for (auto& routine : routines) {
+    RoutineStatsSnapshot last;
+    auto it = last_routines.find({routine.pid, routine.routine_id});
+    if (it != last_routines.end()) {
+      last = it->second;
+    }
+    rows.push_back({&routine, routine.runs - last.runs,
+                    routine.run_ns - last.run_ns,
+                    routine.wakeups - last.wakeups,
+                    routine.wakeup_ns - last.wakeup_ns});
+  }
+  std::sort(rows.begin(), rows.end(), [](const Row& lhs, const Row& rhs) {
+    return lhs.run_ns != rhs.run_ns ? lhs.run_ns > rhs.run_ns
+                                    : lhs.runs > rhs.runs;
+  });
+
+  // averages over the interval, maxima since the croutine first ran
+  std::printf("\n%8s %8s %7s %10s %10s %10s %10s %10s  %s\n", "PID", "PROC",
+              "CPU%", "RUNS/s", "AVG_RUN", "MAX_RUN", "AVG_WAKE", "MAX_WAKE",
+              "NAME");
+  int lines = 0;
+  for (auto& row : rows) {
+    if (lines++ >= options.lines) {
+      break;
+    }
+    auto routine = row.routine;
+    std::printf("%8d %8d %7.1f %10.0f %8.1fus %8.1fus %8.1fus %8.1fus  %s\n",
+                routine->pid, routine->processor,
+                100.0 * static_cast<double>(row.run_ns) / 1e9 / elapsed_s,
+                PerSecond(row.runs, elapsed_s),
+                row.runs == 0 ? 0.0
+                              : static_cast<double>(row.run_ns) / 1e3 /
+                                    static_cast<double>(row.runs),
+                static_cast<double>(routine->max_run_ns) / 1e3,
+                row.wakeups == 0 ? 0.0
+                                 : static_cast<double>(row.wakeup_ns) / 1e3 /
+                                       static_cast<double>(row.wakeups),
+                static_cast<double>(routine->max_wakeup_ns) / 1e3,
+                routine->name.c_str());
+  }
+  std::fflush(stdout);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    PrintHelp(argv[0]);
+    return 1;
+  }
+
+  auto stats = SchedStats::Instance();
+  if (!stats->IsReady()) {
+    std::fprintf(stderr, "scheduler statistics are not available.\n");
+    return 1;
+  }
+
+  std::map<ProcessorKey, ProcessorStatsSnapshot> last_procs;
+  std::map<RoutineKey, RoutineStatsSnapshot> last_routines;
+  for (auto& proc : stats->ReadProcessors(options.pid)) {
+    last_procs[{proc.pid, proc.tid}] = proc;
+  }
+  for (auto& routine : stats->ReadRoutines(options.pid)) {
+    last_routines[{routine.pid, routine.routine_id}] = routine;
+  }
+  auto last = std::chrono::steady_clock::now();
+
+  for (int i = 0; options.iterations == 0 || i < options.iterations; ++i) {
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.delay_s));
+    auto processors = stats->ReadProcessors(options.pid);
+    auto routines = stats->ReadRoutines(options.pid);
+    auto now = std::chrono::steady_clock::now();
+    double elapsed_s = std::chrono::duration<double>(now - last).count();
+    last = now;
+
+    Print(processors, last_procs, routines, last_routines, elapsed_s,
+          options);
+
+    last_procs.clear();
+    for (auto& proc : processors) {
+      last_procs[{proc.pid, proc.tid}] = proc;
+    }
+    last_routines.clear();
+    for (auto& routine : routines) {
+      last_routines[{routine.pid, routine.routine_id}] = routine;
+    }
+  }
+  return 0;
+}
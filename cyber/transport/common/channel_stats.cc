@@ -0,0 +1,424 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/common/channel_stats.h"
+
+#include <signal.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#include "cyber/common/environment.h"
+#include "cyber/common/log.h"
+#include "cyber/common/util.h"
+#include "cyber/time/time.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+using common::DomainId;
+using common::Hash;
+using common::PidNamespace;
+
+namespace {
+
+const uint32_t kReadyMagic = 0x43535442;
+// keeps the slots cache line aligned
+const std::size_t kHeaderSize = 64;
+// yields before checking whether the holder of the page lock is alive
+const int kLockSpins = 1000;
+
+uint32_t IntervalBucket(uint64_t interval_ns) {
+  uint64_t us = interval_ns / 1000;
+  if (us == 0) {
+    return 0;
+  }
+  uint32_t bucket = 63 - __builtin_clzll(us);
+  return std::min(bucket, ChannelStats::kHistogramBuckets - 1);
+}
+
+bool IsProcessAlive(int32_t pid) {
+  return kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+}  // namespace
+
+struct ChannelStats::Header {
+  std::atomic<uint32_t> ready = {0};
+  uint32_t slot_num = 0;
+  uint32_t slot_size = 0;
+  // pid of the process taking or freeing a slot, 0 when unlocked
+  std::atomic<int32_t> lock = {0};
+};
+
+struct ChannelStats::Slot {
+  // 0 while the slot is free
+  std::atomic<uint64_t> channel_id;
+  // processes holding the slot, only touched under the page lock
+  uint32_t refs;
+  std::atomic<uint32_t> name_ready;
+  char channel_name[kNameSize];
+  std::atomic<uint64_t> tx_msgs;
+  std::atomic<uint64_t> tx_bytes;
+  std::atomic<uint64_t> last_seq;
+  std::atomic<uint64_t> last_tx_time;
+  std::atomic<uint64_t> rx_msgs;
+  std::atomic<uint64_t> last_rx_time;
+  std::atomic<uint64_t> interval_histogram[kHistogramBuckets];
+};
+
+const uint32_t ChannelStats::kSlotNum;
+const uint32_t ChannelStats::kNameSize;
+const uint32_t ChannelStats::kHistogramBuckets;
+
+ChannelStats::ChannelStats()
+    : ChannelStats("/apollo/cyber/channel_stats/" + DomainId() + "/" +
+                   PidNamespace()) {}
+
+ChannelStats::ChannelStats(const std::string& name) {
+  static_assert(sizeof(Header) <= kHeaderSize, "header does not fit");
+  key_ = static_cast<key_t>(Hash(name));
+  shm_size_ = kHeaderSize + kSlotNum * sizeof(Slot);
+  process_id_ = static_cast<int32_t>(getpid());
+  if (!OpenOrCreate()) {
+    AWARN << "channel statistics are not available.";
+    Reset();
+  }
+}
+
+ChannelStats::~ChannelStats() {
+  Shutdown();
+  Reset();
+}
+
+void ChannelStats::Shutdown() {
+  std::lock_guard<std::mutex> lock(held_mutex_);
+  if (is_shutdown_) {
+    return;
+  }
+  is_shutdown_ = true;
+  if (!IsReady()) {
+    return;
+  }
+  if (!held_.empty()) {
+    LockPage();
+    for (auto& item : held_) {
+      FreeSlot(item.second.first);
+    }
+    UnlockPage();
+    held_.clear();
+  }
+  // marked only, the page is gone once the last process detaches
+  RemoveIfUnused(1);
+}
+
+auto ChannelStats::GetSlot(uint64_t channel_id,
+                           const std::string& channel_name) -> Slot* {
+  if (!IsReady() || channel_id == 0) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(held_mutex_);
+  if (is_shutdown_) {
+    return nullptr;
+  }
+  auto it = held_.find(channel_id);
+  if (it != held_.end()) {
+    ++it->second.second;
+    return it->second.first;
+  }
+
+  LockPage();
+  Slot* slot = FindSlot(channel_id);
+  if (slot == nullptr) {
+    slot = ClaimSlot(channel_id, channel_name);
+  }
+  if (slot != nullptr) {
+    ++slot->refs;
+  }
+  UnlockPage();
+  if (slot == nullptr) {
+    AWARN << "channel statistics page is full, " << channel_name
+          << " is not counted.";
+    return nullptr;
+  }
+  held_[channel_id] = std::make_pair(slot, 1);
+  return slot;
+}
+
+void ChannelStats::ReleaseSlot(Slot* slot) {
+  if (slot == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(held_mutex_);
+  auto it = held_.find(slot->channel_id.load(std::memory_order_relaxed));
+  // already released by Shutdown
+  if (it == held_.end() || it->second.first != slot) {
+    return;
+  }
+  if (--it->second.second > 0) {
+    return;
+  }
+  held_.erase(it);
+  LockPage();
+  FreeSlot(slot);
+  UnlockPage();
+}
+
+void ChannelStats::LockPage() {
+  int spins = 0;
+  int32_t owner = 0;
+  while (!header_->lock.compare_exchange_weak(owner, process_id_,
+                                              std::memory_order_acquire)) {
+    if (owner != 0 && ++spins >= kLockSpins) {
+      spins = 0;
+      // the holder died with the page locked
+      if (!IsProcessAlive(owner) &&
+          header_->lock.compare_exchange_strong(owner, process_id_,
+                                                std::memory_order_acquire)) {
+        return;
+      }
+    }
+    owner = 0;
+    std::this_thread::yield();
+  }
+}
+
+void ChannelStats::UnlockPage() {
+  header_->lock.store(0, std::memory_order_release);
+}
+
+auto ChannelStats::FindSlot(uint64_t channel_id) const -> Slot* {
+  // freed slots leave holes, so the whole page is probed
+  uint32_t index = static_cast<uint32_t>(channel_id % kSlotNum);
+  for (uint32_t i = 0; i < kSlotNum; ++i) {
+    Slot* slot = &slots_[(index + i) % kSlotNum];
+    if (slot->channel_id.load(std::memory_order_acquire) == channel_id) {
+      return slot;
+    }
+  }
+  return nullptr;
+}
+
+auto ChannelStats::ClaimSlot(uint64_t channel_id,
+                             const std::string& channel_name) -> Slot* {
+  uint32_t index = static_cast<uint32_t>(channel_id % kSlotNum);
+  for (uint32_t i = 0; i < kSlotNum; ++i) {
+    Slot* slot = &slots_[(index + i) % kSlotNum];
+    if (slot->channel_id.load(std::memory_order_relaxed) != 0) {
+      continue;
+    }
+    // counters were cleared when the slot was freed
+    std::strncpy(slot->channel_name, channel_name.c_str(), kNameSize - 1);
+    slot->channel_name[kNameSize - 1] = '\0';
+    slot->channel_id.store(channel_id, std::memory_order_release);
+    slot->name_ready.store(1, std::memory_order_release);
+    return slot;
+  }
+  return nullptr;
+}
+
+void ChannelStats::FreeSlot(Slot* slot) {
+  if (slot->refs == 0 || --slot->refs > 0) {
+    return;
+  }
+  slot->name_ready.store(0, std::memory_order_relaxed);
+  slot->tx_msgs.store(0, std::memory_order_relaxed);
+  slot->tx_bytes.store(0, std::memory_order_relaxed);
+  slot->last_seq.store(0, std::memory_order_relaxed);
+  slot->last_tx_time.store(0, std::memory_order_relaxed);
+  slot->rx_msgs.store(0, std::memory_order_relaxed);
+  slot->last_rx_time.store(0, std::memory_order_relaxed);
+  for (uint32_t i = 0; i < kHistogramBuckets; ++i) {
+    slot->interval_histogram[i].store(0, std::memory_order_relaxed);
+  }
+  slot->channel_id.store(0, std::memory_order_release);
+}
+
+void ChannelStats::OnTransmit(Slot* slot, uint64_t seq, int bytes) {
+  if (slot == nullptr) {
+    return;
+  }
+  uint64_t now = Time::MonoTime().ToNanosecond();
+  slot->tx_msgs.fetch_add(1, std::memory_order_relaxed);
+  if (bytes > 0) {
+    slot->tx_bytes.fetch_add(bytes, std::memory_order_relaxed);
+  }
+  slot->last_seq.store(seq, std::memory_order_relaxed);
+  uint64_t prev = slot->last_tx_time.exchange(now, std::memory_order_relaxed);
+  if (prev != 0 && now > prev) {
+    slot->interval_histogram[IntervalBucket(now - prev)].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+}
+
+void ChannelStats::OnReceive(Slot* slot) {
+  if (slot == nullptr) {
+    return;
+  }
+  slot->rx_msgs.fetch_add(1, std::memory_order_relaxed);
+  slot->last_rx_time.store(Time::MonoTime().ToNanosecond(),
+                           std::memory_order_relaxed);
+}
+
+bool ChannelStats::Read(uint64_t channel_id,
+                        ChannelStatsSnapshot* snapshot) const {
+  if (!IsReady() || channel_id == 0) {
+    return false;
+  }
+  const Slot* slot = FindSlot(channel_id);
+  if (slot == nullptr) {
+    return false;
+  }
+  Read(*slot, snapshot);
+  return true;
+}
+
+std::vector<ChannelStatsSnapshot> ChannelStats::ReadAll() const {
+  std::vector<ChannelStatsSnapshot> snapshots;
+  if (!IsReady()) {
+    return snapshots;
+  }
+  for (uint32_t i = 0; i < kSlotNum; ++i) {
+    if (slots_[i].channel_id.load(std::memory_order_acquire) != 0) {
+      snapshots.emplace_back();
+      Read(slots_[i], &snapshots.back());
+    }
+  }
+  return snapshots;
+}
+
+void ChannelStats::Read(const Slot& slot, ChannelStatsSnapshot* snapshot) {
+  snapshot->channel_id = slot.channel_id.load(std::memory_order_acquire);
+  snapshot->channel_name.clear();
+  if (slot.name_ready.load(std::memory_order_acquire) != 0) {
+    snapshot->channel_name.assign(
+        slot.channel_name, strnlen(slot.channel_name, kNameSize));
+  }
+  snapshot->tx_msgs = slot.tx_msgs.load(std::memory_order_relaxed);
+  snapshot->tx_bytes = slot.tx_bytes.load(std::memory_order_relaxed);
+  snapshot->last_seq = slot.last_seq.load(std::memory_order_relaxed);
+  snapshot->last_tx_time = slot.last_tx_time.load(std::memory_order_relaxed);
+  snapshot->rx_msgs = slot.rx_msgs.load(std::memory_order_relaxed);
+  snapshot->last_rx_time = slot.last_rx_time.load(std::memory_order_relaxed);
+  snapshot->interval_histogram.resize(kHistogramBuckets);
+  for (uint32_t i = 0; i < kHistogramBuckets; ++i) {
+    snapshot->interval_histogram[i] =
+        slot.interval_histogram[i].load(std::memory_order_relaxed);
+  }
+}
+
+bool ChannelStats::OpenOrCreate() {
+  int retry = 0;
+  int shmid = -1;
+  while (retry < 2) {
+    shmid = shmget(key_, shm_size_, 0644 | IPC_CREAT | IPC_EXCL);
+    if (shmid != -1 || EEXIST != errno) {
+      break;
+    }
+    // left behind by processes that are gone, maybe in another layout, with
+    // slots nobody is going to free
+    if (!RemoveIfUnused(0)) {
+      ADEBUG << "shm already exist, open only.";
+      return OpenOnly();
+    }
+    ++retry;
+  }
+  if (shmid == -1) {
+    AERROR << "create shm failed, error: " << strerror(errno);
+    return false;
+  }
+
+  managed_shm_ = shmat(shmid, nullptr, 0);
+  if (managed_shm_ == reinterpret_cast<void*>(-1)) {
+    AERROR << "attach shm failed, error: " << strerror(errno);
+    managed_shm_ = nullptr;
+    shmctl(shmid, IPC_RMID, 0);
+    return false;
+  }
+
+  // the segment comes zero filled, which is every slot free
+  header_ = new (managed_shm_) Header();
+  header_->slot_num = kSlotNum;
+  header_->slot_size = sizeof(Slot);
+  slots_ = reinterpret_cast<Slot*>(static_cast<char*>(managed_shm_) +
+                                   kHeaderSize);
+  header_->ready.store(kReadyMagic, std::memory_order_release);
+  return true;
+}
+
+bool ChannelStats::OpenOnly() {
+  int shmid = shmget(key_, 0, 0644);
+  if (shmid == -1) {
+    AERROR << "get shm failed, error: " << strerror(errno);
+    return false;
+  }
+
+  managed_shm_ = shmat(shmid, nullptr, 0);
+  if (managed_shm_ == reinterpret_cast<void*>(-1)) {
+    AERROR << "attach shm failed, error: " << strerror(errno);
+    managed_shm_ = nullptr;
+    return false;
+  }
+
+  header_ = reinterpret_cast<Header*>(managed_shm_);
+  // the creator may still be filling in the header
+  for (int i = 0; i < 100; ++i) {
+    if (header_->ready.load(std::memory_order_acquire) == kReadyMagic) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  if (header_->ready.load(std::memory_order_acquire) != kReadyMagic ||
+      header_->slot_num != kSlotNum || header_->slot_size != sizeof(Slot)) {
+    AERROR << "channel statistics layout mismatch.";
+    return false;
+  }
+  slots_ = reinterpret_cast<Slot*>(static_cast<char*>(managed_shm_) +
+                                   kHeaderSize);
+  return true;
+}
+
+bool ChannelStats::RemoveIfUnused(uint64_t attached) {
+  int shmid = shmget(key_, 0, 0644);
+  struct shmid_ds shm_info;
+  if (shmid == -1 || shmctl(shmid, IPC_STAT, &shm_info) == -1 ||
+      shm_info.shm_nattch > attached) {
+    return false;
+  }
+  return shmctl(shmid, IPC_RMID, 0) == 0;
+}
+
+void ChannelStats::Reset() {
+  header_ = nullptr;
+  slots_ = nullptr;
+  if (managed_shm_ != nullptr) {
+    shmdt(managed_shm_);
+    managed_shm_ = nullptr;
+  }
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,139 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_COMMON_CHANNEL_STATS_H_
+#define CYBER_TRANSPORT_COMMON_CHANNEL_STATS_H_
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cyber/common/macros.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+struct ChannelStatsSnapshot {
+  uint64_t channel_id = 0;
+  std::string channel_name;
+  // written by all writers of the host
+  uint64_t tx_msgs = 0;
+  // serialized bytes, messages that never left their process count zero
+  uint64_t tx_bytes = 0;
+  uint64_t last_seq = 0;
+  uint64_t last_tx_time = 0;
+  // received by all reader processes of the host, once per process
+  uint64_t rx_msgs = 0;
+  uint64_t last_rx_time = 0;
+  // intervals between two messages written to the channel, bucket i counts
+  // [2^i, 2^(i+1)) us, the last one everything above
+  std::vector<uint64_t> interval_histogram;
+};
+
+/**
+ * @class ChannelStats
+ * @brief Per channel counters in a shared memory page
+ *
+ * Writers and readers of every process on the host add to the slot of their
+ * channel, so tools read rates of all channels without subscribing to the
+ * messages. Updating is a handful of relaxed atomic operations. Times are
+ * monotonic nanoseconds.
+ *
+ * A slot is freed once no process holds it anymore. The default page is per
+ * CYBER_DOMAIN_ID and pid namespace and goes away with its last process, a
+ * page left behind by crashed processes is dropped by the next one.
+ */
+class ChannelStats {
+ public:
+  struct Slot;
+
+  static const uint32_t kSlotNum = 4096;
+  static const uint32_t kNameSize = 128;
+  static const uint32_t kHistogramBuckets = 20;
+
+  /**
+   * @param name identifies the page, processes sharing a name see each other
+   */
+  explicit ChannelStats(const std::string& name);
+  virtual ~ChannelStats();
+
+  bool IsReady() const { return slots_ != nullptr; }
+
+  /**
+   * @brief Slot of the channel, taken on first use
+   *
+   * Every slot handed out has to be given back by ReleaseSlot, unless it is
+   * held until Shutdown.
+   *
+   * @return nullptr if there is no page or it is full
+   */
+  Slot* GetSlot(uint64_t channel_id, const std::string& channel_name);
+  void ReleaseSlot(Slot* slot);
+
+  /**
+   * @brief Releases the slots still held, they stay mapped for late updates
+   */
+  void Shutdown();
+
+  static void OnTransmit(Slot* slot, uint64_t seq, int bytes);
+  static void OnReceive(Slot* slot);
+
+  bool Read(uint64_t channel_id, ChannelStatsSnapshot* snapshot) const;
+  std::vector<ChannelStatsSnapshot> ReadAll() const;
+
+ private:
+  struct Header;
+
+  bool OpenOrCreate();
+  bool OpenOnly();
+  // removes the page if at most `attached` processes use it
+  bool RemoveIfUnused(uint64_t attached);
+  void Reset();
+
+  void LockPage();
+  void UnlockPage();
+  Slot* FindSlot(uint64_t channel_id) const;
+  Slot* ClaimSlot(uint64_t channel_id, const std::string& channel_name);
+  static void FreeSlot(Slot* slot);
+  static void Read(const Slot& slot, ChannelStatsSnapshot* snapshot);
+
+  key_t key_ = 0;
+  std::size_t shm_size_ = 0;
+  int32_t process_id_ = 0;
+  void* managed_shm_ = nullptr;
+  Header* header_ = nullptr;
+  Slot* slots_ = nullptr;
+
+  // slots this process holds a reference on, by channel id, with the number
+  // of local users
+  std::unordered_map<uint64_t, std::pair<Slot*, uint32_t>> held_;
+  bool is_shutdown_ = false;
+  std::mutex held_mutex_;
+
+  DECLARE_SINGLETON(ChannelStats)
+};
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_COMMON_CHANNEL_STATS_H_
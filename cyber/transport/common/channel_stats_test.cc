@@ -0,0 +1,163 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/common/channel_stats.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+namespace {
+
+const char kStatsName[] = "/apollo/cyber/test/channel_stats";
+
+}  // namespace
+
+TEST(ChannelStatsTest, count) {
+  ChannelStats writer(kStatsName);
+  ChannelStats reader(kStatsName);
+  ASSERT_TRUE(writer.IsReady());
+  ASSERT_TRUE(reader.IsReady());
+
+  const uint64_t channel_id = 0x5eed;
+  // the page outlives the test, so only look at what is added
+  ChannelStatsSnapshot before;
+  reader.Read(channel_id, &before);
+
+  auto slot = writer.GetSlot(channel_id, "/channel_stats_test");
+  ASSERT_NE(nullptr, slot);
+  EXPECT_EQ(slot, writer.GetSlot(channel_id, "/channel_stats_test"));
+  // a channel whose home slot is taken moves on to the next one
+  auto other = writer.GetSlot(channel_id + ChannelStats::kSlotNum, "/other");
+  ASSERT_NE(nullptr, other);
+  EXPECT_NE(slot, other);
+  EXPECT_EQ(nullptr, writer.GetSlot(0, "/invalid"));
+
+  ChannelStats::OnTransmit(slot, 1, 100);
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  ChannelStats::OnTransmit(slot, 2, 100);
+  // not serialized
+  ChannelStats::OnTransmit(slot, 3, 0);
+  ChannelStats::OnReceive(reader.GetSlot(channel_id, "/channel_stats_test"));
+  ChannelStats::OnTransmit(nullptr, 4, 100);
+
+  ChannelStatsSnapshot after;
+  ASSERT_TRUE(reader.Read(channel_id, &after));
+  EXPECT_EQ("/channel_stats_test", after.channel_name);
+  EXPECT_EQ(3, after.tx_msgs - before.tx_msgs);
+  EXPECT_EQ(200, after.tx_bytes - before.tx_bytes);
+  EXPECT_EQ(3, after.last_seq);
+  EXPECT_EQ(1, after.rx_msgs - before.rx_msgs);
+  EXPECT_GT(after.last_tx_time, 0);
+  ASSERT_EQ(ChannelStats::kHistogramBuckets, after.interval_histogram.size());
+  uint64_t intervals = 0;
+  uint64_t slow = 0;
+  for (uint32_t i = 0; i < ChannelStats::kHistogramBuckets; ++i) {
+    uint64_t added = after.interval_histogram[i] -
+                     (before.interval_histogram.empty()
+                          ? 0
+                          : before.interval_histogram[i]);
+    intervals += added;
+    // 2 ms and more
+    if (i >= 10) {
+      slow += added;
+    }
+  }
+  EXPECT_LE(2, intervals);
+  EXPECT_LE(1, slow);
+
+  bool found = false;
+  for (const auto& snapshot : reader.ReadAll()) {
+    found = found || snapshot.channel_id == channel_id;
+  }
+  EXPECT_TRUE(found);
+
+  ChannelStatsSnapshot unknown;
+  EXPECT_FALSE(reader.Read(0x5eed + 1, &unknown));
+}
+
+TEST(ChannelStatsTest, release) {
+  ChannelStats writer(kStatsName);
+  ChannelStats reader(kStatsName);
+  ASSERT_TRUE(writer.IsReady());
+  ASSERT_TRUE(reader.IsReady());
+
+  const uint64_t channel_id = 0xfee1;
+  // homed on the slot of channel_id, so it sits behind it
+  const uint64_t other_id = channel_id + ChannelStats::kSlotNum;
+  auto slot = writer.GetSlot(channel_id, "/release_test");
+  auto other = writer.GetSlot(other_id, "/release_test/other");
+  ASSERT_NE(nullptr, slot);
+  ASSERT_NE(nullptr, other);
+  ChannelStats::OnTransmit(other, 1, 10);
+  ChannelStats::OnReceive(reader.GetSlot(channel_id, "/release_test"));
+
+  ChannelStatsSnapshot snapshot;
+  writer.ReleaseSlot(slot);
+  // the reader still holds it
+  ASSERT_TRUE(reader.Read(channel_id, &snapshot));
+  EXPECT_EQ(1, snapshot.rx_msgs);
+  reader.ReleaseSlot(reader.GetSlot(channel_id, "/release_test"));
+  ASSERT_TRUE(reader.Read(channel_id, &snapshot));
+  reader.Shutdown();
+  EXPECT_FALSE(reader.Read(channel_id, &snapshot));
+  EXPECT_EQ(nullptr, reader.GetSlot(channel_id, "/release_test"));
+
+  // found behind the freed slot, taken again from another process
+  ChannelStats late(kStatsName);
+  ASSERT_TRUE(late.IsReady());
+  ChannelStats::OnTransmit(late.GetSlot(other_id, "/release_test/other"), 2,
+                           10);
+  ASSERT_TRUE(reader.Read(other_id, &snapshot));
+  EXPECT_EQ("/release_test/other", snapshot.channel_name);
+  EXPECT_EQ(2, snapshot.tx_msgs);
+
+  // a new slot for a freed channel starts from zero
+  slot = writer.GetSlot(channel_id, "/release_test");
+  ASSERT_NE(nullptr, slot);
+  ASSERT_TRUE(reader.Read(channel_id, &snapshot));
+  EXPECT_EQ(0, snapshot.rx_msgs);
+  writer.ReleaseSlot(slot);
+  writer.ReleaseSlot(other);
+  late.Shutdown();
+  EXPECT_FALSE(reader.Read(other_id, &snapshot));
+}
+
+TEST(ChannelStatsTest, full) {
+  ChannelStats stats(kStatsName);
+  ASSERT_TRUE(stats.IsReady());
+
+  std::vector<ChannelStats::Slot*> slots;
+  for (uint64_t id = 1; slots.size() < ChannelStats::kSlotNum; ++id) {
+    auto slot = stats.GetSlot(id, "/full_test");
+    ASSERT_NE(nullptr, slot);
+    slots.push_back(slot);
+  }
+  const uint64_t late_id = ChannelStats::kSlotNum + 1;
+  EXPECT_EQ(nullptr, stats.GetSlot(late_id, "/full_test/late"));
+  stats.ReleaseSlot(slots[7]);
+  EXPECT_NE(nullptr, stats.GetSlot(late_id, "/full_test/late"));
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
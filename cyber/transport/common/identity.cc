@@ -24,7 +24,7 @@ namespace apollo {
 namespace cyber {
 namespace transport {
 
-Identity::Identity(bool need_generate) : hash_value_(0), hash_value_str_("") {
+Identity::Identity(bool need_generate) : hash_value_(0) {
   memset(data_, 0, ID_SIZE);
   if (need_generate) {
     uuid_t uuid;
@@ -34,23 +34,6 @@ Identity::Identity(bool need_generate) : hash_value_(0), hash_value_str_("") {
   }
 }
 
-Identity::Identity(const Identity& another) {
-  memcpy(data_, another.data(), ID_SIZE);
-  hash_value_ = another.hash_value_;
-  hash_value_str_ = another.hash_value_str_;
-}
-
-Identity::~Identity() {}
-
-Identity& Identity::operator=(const Identity& another) {
-  if (this != &another) {
-    memcpy(data_, another.data(), ID_SIZE);
-    hash_value_ = another.hash_value_;
-    hash_value_str_ = another.hash_value_str_;
-  }
-  return *this;
-}
-
 bool Identity::operator==(const Identity& another) const {
   return memcmp(data_, another.data(), ID_SIZE) == 0;
 }
@@ -59,15 +42,16 @@ bool Identity::operator!=(const Identity& another) const {
   return memcmp(data_, another.data(), ID_SIZE) != 0;
 }
 
-const std::string& Identity::ToString() const { return hash_value_str_; }
+std::string Identity::ToString() const {
+  // empty until an id is set
+  return hash_value_ == 0 ? std::string() : std::to_string(hash_value_);
+}
 
 size_t Identity::Length() const { return ID_SIZE; }
 
-uint64_t Identity::HashValue() const { return hash_value_; }
-
 void Identity::Update() {
+  // the id fits the small string buffer, hashing does not allocate
   hash_value_ = common::Hash(std::string(data_, ID_SIZE));
-  hash_value_str_ = std::to_string(hash_value_);
 }
 
 }  // namespace transport
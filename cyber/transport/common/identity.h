@@ -20,6 +20,7 @@
 #include <cstdint>
 #include <cstring>
 #include <string>
+#include <type_traits>
 
 namespace apollo {
 namespace cyber {
@@ -27,19 +28,24 @@ namespace transport {
 
 const uint8_t ID_SIZE = 8;
 
+/**
+ * @class Identity
+ * @brief Id of an endpoint, carried twice by every MessageInfo
+ *
+ * Trivially copyable, so copying the metadata of a message never allocates.
+ * The hash is computed once when the id changes, the string form only on
+ * request.
+ */
 class Identity {
  public:
   explicit Identity(bool need_generate = true);
-  Identity(const Identity& another);
-  virtual ~Identity();
 
-  Identity& operator=(const Identity& another);
   bool operator==(const Identity& another) const;
   bool operator!=(const Identity& another) const;
 
-  const std::string& ToString() const;
+  std::string ToString() const;
   size_t Length() const;
-  uint64_t HashValue() const;
+  uint64_t HashValue() const { return hash_value_; }
 
   // getter and setter
   const char* data() const { return data_; }
@@ -47,7 +53,6 @@ class Identity {
     if (data == nullptr) {
       return;
     }
-    memset(data_, 0, sizeof(data_));
     memcpy(data_, data, sizeof(data_));
     Update();
   }
@@ -57,9 +62,11 @@ class Identity {
 
   char data_[ID_SIZE];
   uint64_t hash_value_;
-  std::string hash_value_str_;
 };
 
+static_assert(std::is_trivially_copyable<Identity>::value,
+              "Identity is copied with every message");
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
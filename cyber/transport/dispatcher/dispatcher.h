@@ -25,8 +25,8 @@
 #include <string>
 #include <unordered_map>
 
-#include "cyber/base/atomic_hash_map.h"
 #include "cyber/base/atomic_rw_lock.h"
+#include "cyber/base/resizable_atomic_hash_map.h"
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
 #include "cyber/proto/role_attributes.pb.h"
@@ -37,7 +37,7 @@ namespace apollo {
 namespace cyber {
 namespace transport {
 
-using apollo::cyber::base::AtomicHashMap;
+using apollo::cyber::base::ResizableAtomicHashMap;
 using apollo::cyber::base::AtomicRWLock;
 using apollo::cyber::base::ReadLockGuard;
 using apollo::cyber::base::WriteLockGuard;
@@ -79,7 +79,9 @@ class Dispatcher {
  protected:
   std::atomic<bool> is_shutdown_;
   // key: channel_id of message
-  AtomicHashMap<uint64_t, ListenerHandlerBasePtr> msg_listeners_;
+  ResizableAtomicHashMap<uint64_t, ListenerHandlerBasePtr> msg_listeners_;
+  // serializes adding and removing listeners, an entry is erased with its
+  // last listener
   base::AtomicRWLock rw_lock_;
 };
 
@@ -90,12 +92,13 @@ void Dispatcher::AddListener(const RoleAttributes& self_attr,
     return;
   }
   uint64_t channel_id = self_attr.channel_id();
+  WriteLockGuard<AtomicRWLock> lock(rw_lock_);
 
   std::shared_ptr<ListenerHandler<MessageT>> handler;
-  ListenerHandlerBasePtr* handler_base = nullptr;
+  ListenerHandlerBasePtr handler_base;
   if (msg_listeners_.Get(channel_id, &handler_base)) {
     handler =
-        std::dynamic_pointer_cast<ListenerHandler<MessageT>>(*handler_base);
+        std::dynamic_pointer_cast<ListenerHandler<MessageT>>(handler_base);
     if (handler == nullptr) {
       AERROR << "please ensure that readers with the same channel["
              << self_attr.channel_name()
@@ -119,12 +122,13 @@ void Dispatcher::AddListener(const RoleAttributes& self_attr,
     return;
   }
   uint64_t channel_id = self_attr.channel_id();
+  WriteLockGuard<AtomicRWLock> lock(rw_lock_);
 
   std::shared_ptr<ListenerHandler<MessageT>> handler;
-  ListenerHandlerBasePtr* handler_base = nullptr;
+  ListenerHandlerBasePtr handler_base;
   if (msg_listeners_.Get(channel_id, &handler_base)) {
     handler =
-        std::dynamic_pointer_cast<ListenerHandler<MessageT>>(*handler_base);
+        std::dynamic_pointer_cast<ListenerHandler<MessageT>>(handler_base);
     if (handler == nullptr) {
       AERROR << "please ensure that readers with the same channel["
              << self_attr.channel_name()
@@ -147,9 +151,13 @@ void Dispatcher::RemoveListener(const RoleAttributes& self_attr) {
   }
   uint64_t channel_id = self_attr.channel_id();
 
-  ListenerHandlerBasePtr* handler_base = nullptr;
+  WriteLockGuard<AtomicRWLock> lock(rw_lock_);
+  ListenerHandlerBasePtr handler_base;
   if (msg_listeners_.Get(channel_id, &handler_base)) {
-    (*handler_base)->Disconnect(self_attr.id());
+    handler_base->Disconnect(self_attr.id());
+    if (handler_base->Empty()) {
+      msg_listeners_.Remove(channel_id);
+    }
   }
 }
 
@@ -161,9 +169,13 @@ void Dispatcher::RemoveListener(const RoleAttributes& self_attr,
   }
   uint64_t channel_id = self_attr.channel_id();
 
-  ListenerHandlerBasePtr* handler_base = nullptr;
+  WriteLockGuard<AtomicRWLock> lock(rw_lock_);
+  ListenerHandlerBasePtr handler_base;
   if (msg_listeners_.Get(channel_id, &handler_base)) {
-    (*handler_base)->Disconnect(self_attr.id(), opposite_attr.id());
+    handler_base->Disconnect(self_attr.id(), opposite_attr.id());
+    if (handler_base->Empty()) {
+      msg_listeners_.Remove(channel_id);
+    }
   }
 }
 
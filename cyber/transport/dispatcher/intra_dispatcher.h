@@ -43,9 +43,67 @@ template <typename MessageT>
 using MessageListener =
     std::function<void(const std::shared_ptr<MessageT>&, const MessageInfo&)>;
 
+// Serializes a message for the handlers of other types at most once per
+// dispatch. OnMessage opens a cache on the publishing thread; every chain run
+// of the same channel inside it reuses the result, including the runs of a
+// handler that was itself fed from the serialized form.
+class SerializedCache {
+ public:
+  explicit SerializedCache(uint64_t channel_id)
+      : channel_id_(channel_id), prev_(Current()) {
+    Current() = this;
+  }
+  ~SerializedCache() { Current() = prev_; }
+
+  // Returns nullptr if the message can not be serialized. Without an open
+  // cache for channel_id the result is kept in storage.
+  template <typename MessageT>
+  static const SerializedMessage* Get(uint64_t channel_id,
+                                      const std::shared_ptr<MessageT>& message,
+                                      SerializedMessage* storage) {
+    SerializedCache* cache = Current();
+    if (cache == nullptr || cache->channel_id_ != channel_id) {
+      return Serialize(message, storage) ? storage : nullptr;
+    }
+    if (!cache->serialized_once_) {
+      cache->serialized_once_ = true;
+      cache->serialize_ok_ = Serialize(message, &cache->serialized_);
+    }
+    return cache->serialize_ok_ ? &cache->serialized_ : nullptr;
+  }
+
+ private:
+  static SerializedCache*& Current() {
+    static thread_local SerializedCache* current = nullptr;
+    return current;
+  }
+
+  template <typename MessageT>
+  static bool Serialize(const std::shared_ptr<MessageT>& message,
+                        SerializedMessage* serialized) {
+    serialized->type_name = message::MessageType(*message);
+    serialized->raw = std::make_shared<message::RawMessage>();
+    return message::SerializeToString(*message, &serialized->raw->message);
+  }
+
+  // a RawMessage already is the serialized form, share it as is
+  static bool Serialize(const std::shared_ptr<message::RawMessage>& message,
+                        SerializedMessage* serialized) {
+    serialized->type_name = message::MessageType(*message);
+    serialized->raw = message;
+    return true;
+  }
+
+  uint64_t channel_id_;
+  SerializedCache* prev_;
+  bool serialized_once_ = false;
+  bool serialize_ok_ = false;
+  SerializedMessage serialized_;
+};
+
 // use a channel chain to wrap specific ListenerHandler.
-// If the message is MessageT, then we use pointer directly, or we first parse
-// to a string, and use it to serialise to another message type.
+// If the message is MessageT, then we use pointer directly, or we hand the
+// serialized message from SerializedCache to the handler of the other type.
 class ChannelChain {
   using BaseHandlersType =
       std::map<uint64_t, std::map<std::string, ListenerHandlerBasePtr>>;
@@ -207,7 +265,9 @@ class ChannelChain {
     ADEBUG << GlobalData::GetChannelById(channel_id)
            << "'s chain run, size: " << channel_handlers.size()
            << ", message type: " << message_type;
-    std::string msg;
+    SerializedMessage storage;
+    const SerializedMessage* serialized = nullptr;
+    bool serialize_failed = false;
     for (const auto& ele : channel_handlers) {
       auto handler_base = ele.second;
       if (message_type == ele.first) {
@@ -220,23 +280,16 @@ class ChannelChain {
         handler->Run(message, message_info);
       } else {
         ADEBUG << "Run handler for message type: " << ele.first
-               << " from string";
-        if (msg.empty()) {
-          auto msg_size = message::FullByteSize(*message);
-          if (msg_size < 0) {
-            AERROR << "Failed to get message size. channel["
-                   << common::GlobalData::GetChannelById(channel_id) << "]";
-            continue;
-          }
-          msg.resize(msg_size);
-          if (!message::SerializeToHC(*message, const_cast<char*>(msg.data()),
-                                      msg_size)) {
+               << " from serialized message";
+        if (serialized == nullptr && !serialize_failed) {
+          serialized = SerializedCache::Get(channel_id, message, &storage);
+          if (serialized == nullptr) {
             AERROR << "Chain Serialize error for channel id: " << channel_id;
-            msg.clear();
+            serialize_failed = true;
           }
         }
-        if (!msg.empty()) {
-          (handler_base)->RunFromString(msg, message_info);
+        if (serialized != nullptr) {
+          handler_base->RunFromSerialized(*serialized, message_info);
         }
       }
     }
@@ -288,26 +341,20 @@ void IntraDispatcher::OnMessage(uint64_t channel_id,
   if (is_shutdown_.load()) {
     return;
   }
-  ListenerHandlerBasePtr* handler_base = nullptr;
+  ListenerHandlerBasePtr handler_base;
   ADEBUG << "intra on message, channel:"
          << common::GlobalData::GetChannelById(channel_id);
   if (msg_listeners_.Get(channel_id, &handler_base)) {
+    SerializedCache cache(channel_id);
     auto handler =
-        std::dynamic_pointer_cast<ListenerHandler<MessageT>>(*handler_base);
+        std::dynamic_pointer_cast<ListenerHandler<MessageT>>(handler_base);
     if (handler) {
       handler->Run(message, message_info);
     } else {
-      auto msg_size = message::FullByteSize(*message);
-      if (msg_size < 0) {
-        AERROR << "Failed to get message size. channel["
-               << common::GlobalData::GetChannelById(channel_id) << "]";
-        return;
-      }
-      std::string msg;
-      msg.resize(msg_size);
-      if (message::SerializeToHC(*message, const_cast<char*>(msg.data()),
-                                 msg_size)) {
-        (*handler_base)->RunFromString(msg, message_info);
+      SerializedMessage storage;
+      auto serialized = SerializedCache::Get(channel_id, message, &storage);
+      if (serialized != nullptr) {
+        handler_base->RunFromSerialized(*serialized, message_info);
       } else {
         AERROR << "Failed to serialize message. channel["
                << common::GlobalData::GetChannelById(channel_id) << "]";
@@ -320,11 +367,11 @@ template <typename MessageT>
 std::shared_ptr<ListenerHandler<MessageT>> IntraDispatcher::GetHandler(
     uint64_t channel_id) {
   std::shared_ptr<ListenerHandler<MessageT>> handler;
-  ListenerHandlerBasePtr* handler_base = nullptr;
+  ListenerHandlerBasePtr handler_base;
 
   if (msg_listeners_.Get(channel_id, &handler_base)) {
     handler =
-        std::dynamic_pointer_cast<ListenerHandler<MessageT>>(*handler_base);
+        std::dynamic_pointer_cast<ListenerHandler<MessageT>>(handler_base);
     if (handler == nullptr) {
       ADEBUG << "Find a new type for channel "
              << GlobalData::GetChannelById(channel_id) << " with type "
@@ -355,6 +402,7 @@ void IntraDispatcher::AddListener(const RoleAttributes& self_attr,
   bool created =
       chain_->AddListener(self_id, channel_id, message_type, listener);
 
+  WriteLockGuard<AtomicRWLock> lock(rw_lock_);
   auto handler = GetHandler<MessageT>(self_attr.channel_id());
   if (handler && created) {
     auto listener_wrapper = [this, self_id, channel_id, message_type](
@@ -383,6 +431,7 @@ void IntraDispatcher::AddListener(const RoleAttributes& self_attr,
   bool created =
       chain_->AddListener(self_id, oppo_id, channel_id, message_type, listener);
 
+  WriteLockGuard<AtomicRWLock> lock(rw_lock_);
   auto handler = GetHandler<MessageT>(self_attr.channel_id());
   if (handler && created) {
     auto listener_wrapper = [this, self_id, oppo_id, channel_id, message_type](
@@ -124,6 +124,63 @@ TEST(DispatcherTest, on_message) {
   EXPECT_EQ(0, raw_msgs.size());
 }
 
+TEST(DispatcherTest, serialize_once) {
+  auto dispatcher = IntraDispatcher::Instance();
+  std::vector<std::shared_ptr<message::RawMessage>> raw_msgs;
+  auto raw_callback = [&raw_msgs](
+                          const std::shared_ptr<message::RawMessage>& msg,
+                          const MessageInfo&) { raw_msgs.push_back(msg); };
+  int chatter_count = 0;
+  auto chatter_callback = [&chatter_count](
+                              const std::shared_ptr<proto::Chatter>& msg,
+                              const MessageInfo&) { ++chatter_count; };
+
+  const std::string channel_name = "serialize_once";
+  proto::RoleAttributes self_attr1;
+  self_attr1.set_channel_name(channel_name);
+  self_attr1.set_channel_id(common::Hash(channel_name));
+  self_attr1.set_id(Identity().HashValue());
+  proto::RoleAttributes self_attr2(self_attr1);
+  self_attr2.set_id(Identity().HashValue());
+  proto::RoleAttributes oppo_attr(self_attr1);
+  Identity oppo_identity;
+  oppo_attr.set_id(oppo_identity.HashValue());
+
+  dispatcher->AddListener<proto::Chatter>(self_attr1, chatter_callback);
+  dispatcher->AddListener<proto::Chatter>(self_attr1, oppo_attr,
+                                          chatter_callback);
+  dispatcher->AddListener<message::RawMessage>(self_attr2, raw_callback);
+  dispatcher->AddListener<message::RawMessage>(self_attr2, oppo_attr,
+                                               raw_callback);
+
+  auto chatter = std::make_shared<proto::Chatter>();
+  chatter->set_content("serialize once");
+  std::string expected;
+  chatter->SerializeToString(&expected);
+  MessageInfo msg_info;
+  msg_info.set_sender_id(oppo_identity);
+  dispatcher->OnMessage<proto::Chatter>(self_attr1.channel_id(), chatter,
+                                        msg_info);
+
+  // both chains share the message serialized once, without a copy
+  EXPECT_EQ(2, chatter_count);
+  ASSERT_EQ(2, raw_msgs.size());
+  EXPECT_EQ(raw_msgs[0].get(), raw_msgs[1].get());
+  EXPECT_EQ(expected, raw_msgs[0]->message);
+
+  // the next message is serialized on its own
+  dispatcher->OnMessage<proto::Chatter>(self_attr1.channel_id(), chatter,
+                                        msg_info);
+  ASSERT_EQ(4, raw_msgs.size());
+  EXPECT_NE(raw_msgs[0].get(), raw_msgs[2].get());
+  EXPECT_EQ(raw_msgs[2].get(), raw_msgs[3].get());
+
+  dispatcher->RemoveListener<proto::Chatter>(self_attr1);
+  dispatcher->RemoveListener<proto::Chatter>(self_attr1, oppo_attr);
+  dispatcher->RemoveListener<message::RawMessage>(self_attr2);
+  dispatcher->RemoveListener<message::RawMessage>(self_attr2, oppo_attr);
+}
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
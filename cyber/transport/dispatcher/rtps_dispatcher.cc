@@ -75,10 +75,10 @@ void RtpsDispatcher::OnMessage(uint64_t channel_id,
     return;
   }
 
-  ListenerHandlerBasePtr* handler_base = nullptr;
+  ListenerHandlerBasePtr handler_base;
   if (msg_listeners_.Get(channel_id, &handler_base)) {
     auto handler =
-        std::dynamic_pointer_cast<ListenerHandler<std::string>>(*handler_base);
+        std::dynamic_pointer_cast<ListenerHandler<std::string>>(handler_base);
     handler->Run(msg_str, msg_info);
   }
 }
@@ -88,10 +88,10 @@ void ShmDispatcher::OnMessage(uint64_t channel_id,
   if (is_shutdown_.load()) {
     return;
   }
-  ListenerHandlerBasePtr* handler_base = nullptr;
+  ListenerHandlerBasePtr handler_base;
   if (msg_listeners_.Get(channel_id, &handler_base)) {
     auto handler = std::dynamic_pointer_cast<ListenerHandler<ReadableBlock>>(
-        *handler_base);
+        handler_base);
     handler->Run(rb, msg_info);
   } else {
     AERROR << "Cannot find " << GlobalData::GetChannelById(channel_id)
@@ -0,0 +1,251 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/dispatcher/socket_dispatcher.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "cyber/scheduler/scheduler_factory.h"
+#include "cyber/transport/socket/frame.h"
+#include "cyber/transport/socket/socket_conf.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+namespace {
+
+// how often the croutines look for a shutdown while idle
+const int kIdleTimeoutMs = 100;
+const int kBindRetries = 16;
+
+}  // namespace
+
+SocketDispatcher::SocketDispatcher() {}
+
+SocketDispatcher::~SocketDispatcher() { Shutdown(); }
+
+void SocketDispatcher::Shutdown() {
+  // the croutines close their sessions once they see the flag
+  is_shutdown_.store(true);
+}
+
+const proto::SocketAddr& SocketDispatcher::addr() {
+  std::lock_guard<std::mutex> lock(init_mutex_);
+  if (!inited_) {
+    inited_ = true;
+    if (!Init()) {
+      addr_.set_port(0);
+    }
+  }
+  return addr_;
+}
+
+bool SocketDispatcher::Init() {
+  addr_.set_ip(GlobalData::Instance()->HostIp());
+  auto port = static_cast<uint16_t>(GetSocketConf().port());
+  // tcp and udp have to agree on a free port if none is configured
+  bool listening = Listen(port);
+  for (int i = 0; !listening && port == 0 && i < kBindRetries; ++i) {
+    listening = Listen(port);
+  }
+  if (!listening) {
+    AERROR << "socket dispatcher cannot listen on port " << port;
+    return false;
+  }
+
+  auto sched = scheduler::Instance();
+  if (!sched->CreateTask([this]() { AcceptConnections(); },
+                         "socket_dispatcher_accept") ||
+      !sched->CreateTask([this]() { ReadDatagrams(); },
+                         "socket_dispatcher_udp")) {
+    AERROR << "create socket dispatcher task failed.";
+    return false;
+  }
+  return true;
+}
+
+bool SocketDispatcher::Listen(uint16_t port) {
+  auto& conf = GetSocketConf();
+  int recv_buffer_size = static_cast<int>(conf.recv_buffer_size());
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(port);
+  socklen_t addr_len = sizeof(addr);
+
+  auto listen_session = std::make_shared<io::Session>();
+  auto udp_session = std::make_shared<io::Session>();
+  if (listen_session->Socket(AF_INET, SOCK_STREAM, 0) < 0 ||
+      udp_session->Socket(AF_INET, SOCK_DGRAM, 0) < 0) {
+    AERROR << "create socket failed, " << strerror(errno);
+    return false;
+  }
+  int one = 1;
+  setsockopt(listen_session->fd(), SOL_SOCKET, SO_REUSEADDR, &one,
+             sizeof(one));
+  // accepted connections inherit the buffer size
+  setsockopt(listen_session->fd(), SOL_SOCKET, SO_RCVBUF, &recv_buffer_size,
+             sizeof(recv_buffer_size));
+  setsockopt(udp_session->fd(), SOL_SOCKET, SO_RCVBUF, &recv_buffer_size,
+             sizeof(recv_buffer_size));
+
+  bool ret = false;
+  if (listen_session->Bind(reinterpret_cast<struct sockaddr*>(&addr),
+                           addr_len) == 0 &&
+      getsockname(listen_session->fd(),
+                  reinterpret_cast<struct sockaddr*>(&addr), &addr_len) == 0 &&
+      udp_session->Bind(reinterpret_cast<struct sockaddr*>(&addr),
+                        addr_len) == 0 &&
+      listen_session->Listen(SOMAXCONN) == 0) {
+    ret = true;
+  }
+  if (!ret) {
+    AWARN << "listen on port " << ntohs(addr.sin_port) << " failed, "
+          << strerror(errno);
+    listen_session->Close();
+    udp_session->Close();
+    return false;
+  }
+
+  addr_.set_port(ntohs(addr.sin_port));
+  listen_session_ = listen_session;
+  udp_session_ = udp_session;
+  ADEBUG << "socket dispatcher listens on " << addr_.ip() << ":"
+         << addr_.port();
+  return true;
+}
+
+void SocketDispatcher::AcceptConnections() {
+  while (!is_shutdown_.load()) {
+    RemoveFinishedTasks();
+    auto session = listen_session_->Accept(nullptr, nullptr, kIdleTimeoutMs);
+    if (session == nullptr) {
+      continue;
+    }
+    int one = 1;
+    setsockopt(session->fd(), IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    std::string task_name =
+        "socket_dispatcher_conn_" + std::to_string(num_connections_++);
+    if (!scheduler::Instance()->CreateTask(
+            [this, session, task_name]() { ReadStream(session, task_name); },
+            task_name)) {
+      AERROR << "create task " << task_name << " failed.";
+      session->Close();
+    }
+  }
+  listen_session_->Close();
+}
+
+void SocketDispatcher::ReadStream(const std::shared_ptr<io::Session>& session,
+                                  const std::string& task_name) {
+  FrameParser parser(std::bind(&SocketDispatcher::OnMessage, this,
+                               std::placeholders::_1, std::placeholders::_2,
+                               std::placeholders::_3),
+                     FrameParser::kDefaultBufferSize,
+                     GetSocketConf().max_message_size());
+  while (!is_shutdown_.load()) {
+    std::size_t size = 0;
+    char* buffer = parser.Buffer(&size);
+    ssize_t nbytes = session->Recv(buffer, size, 0, kIdleTimeoutMs);
+    if (nbytes == 0) {
+      // the transmitter went away
+      break;
+    }
+    if (nbytes < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        continue;
+      }
+      AWARN << "receive failed, " << strerror(errno);
+      break;
+    }
+    if (!parser.Feed(static_cast<std::size_t>(nbytes))) {
+      break;
+    }
+  }
+  session->Close();
+  std::lock_guard<std::mutex> lock(finished_tasks_mutex_);
+  finished_tasks_.emplace_back(task_name);
+}
+
+void SocketDispatcher::ReadDatagrams() {
+  auto batch = std::max(1u, GetSocketConf().recv_batch());
+  std::vector<char> buffers(batch * kMaxDatagramSize);
+  std::vector<struct iovec> iovs(batch);
+  std::vector<struct mmsghdr> mmsgs(batch);
+  for (uint32_t i = 0; i < batch; ++i) {
+    iovs[i].iov_base = buffers.data() + i * kMaxDatagramSize;
+    iovs[i].iov_len = kMaxDatagramSize;
+  }
+
+  auto callback = std::bind(&SocketDispatcher::OnMessage, this,
+                            std::placeholders::_1, std::placeholders::_2,
+                            std::placeholders::_3);
+  while (!is_shutdown_.load()) {
+    memset(mmsgs.data(), 0, mmsgs.size() * sizeof(struct mmsghdr));
+    for (uint32_t i = 0; i < batch; ++i) {
+      mmsgs[i].msg_hdr.msg_iov = &iovs[i];
+      mmsgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    int nmsgs = udp_session_->RecvMmsg(mmsgs.data(), batch, 0, kIdleTimeoutMs);
+    for (int i = 0; i < nmsgs; ++i) {
+      if (!ParseDatagram(static_cast<char*>(iovs[i].iov_base),
+                         mmsgs[i].msg_len, callback)) {
+        AWARN_EVERY(100) << "drop malformed datagram of " << mmsgs[i].msg_len
+                         << " bytes";
+      }
+    }
+  }
+  udp_session_->Close();
+}
+
+void SocketDispatcher::RemoveFinishedTasks() {
+  std::vector<std::string> tasks;
+  {
+    std::lock_guard<std::mutex> lock(finished_tasks_mutex_);
+    tasks.swap(finished_tasks_);
+  }
+  for (auto& task : tasks) {
+    scheduler::Instance()->RemoveTask(task);
+  }
+}
+
+void SocketDispatcher::OnMessage(uint64_t channel_id,
+                                 const std::shared_ptr<std::string>& msg_str,
+                                 const MessageInfo& msg_info) {
+  if (is_shutdown_.load()) {
+    return;
+  }
+
+  ListenerHandlerBasePtr handler_base;
+  if (msg_listeners_.Get(channel_id, &handler_base)) {
+    auto handler =
+        std::dynamic_pointer_cast<ListenerHandler<std::string>>(handler_base);
+    handler->Run(msg_str, msg_info);
+  }
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,128 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_DISPATCHER_SOCKET_DISPATCHER_H_
+#define CYBER_TRANSPORT_DISPATCHER_SOCKET_DISPATCHER_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cyber/common/log.h"
+#include "cyber/common/macros.h"
+#include "cyber/io/session.h"
+#include "cyber/message/message_traits.h"
+#include "cyber/proto/role_attributes.pb.h"
+#include "cyber/transport/dispatcher/dispatcher.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+class SocketDispatcher;
+using SocketDispatcherPtr = SocketDispatcher*;
+
+/**
+ * @class SocketDispatcher
+ * @brief Receives the SOCKET messages of all channels of this process
+ *
+ * One TCP and one UDP socket listen on the same port. Every accepted
+ * connection and the UDP socket are served by croutines through cyber/io,
+ * datagrams are taken in batches with recvmmsg.
+ */
+class SocketDispatcher : public Dispatcher {
+ public:
+  virtual ~SocketDispatcher();
+
+  void Shutdown() override;
+
+  template <typename MessageT>
+  void AddListener(const RoleAttributes& self_attr,
+                   const MessageListener<MessageT>& listener);
+
+  template <typename MessageT>
+  void AddListener(const RoleAttributes& self_attr,
+                   const RoleAttributes& opposite_attr,
+                   const MessageListener<MessageT>& listener);
+
+  /**
+   * @brief Address transmitters of other hosts send to, starts listening
+   * on first use. The port is 0 if listening failed.
+   */
+  const proto::SocketAddr& addr();
+
+ private:
+  bool Init();
+  bool Listen(uint16_t port);
+  void AcceptConnections();
+  void ReadStream(const std::shared_ptr<io::Session>& session,
+                  const std::string& task_name);
+  void ReadDatagrams();
+  void RemoveFinishedTasks();
+  void OnMessage(uint64_t channel_id,
+                 const std::shared_ptr<std::string>& msg_str,
+                 const MessageInfo& msg_info);
+
+  proto::SocketAddr addr_;
+  bool inited_ = false;
+  std::mutex init_mutex_;
+
+  std::shared_ptr<io::Session> listen_session_;
+  std::shared_ptr<io::Session> udp_session_;
+  std::atomic<uint64_t> num_connections_ = {0};
+  std::vector<std::string> finished_tasks_;
+  std::mutex finished_tasks_mutex_;
+
+  DECLARE_SINGLETON(SocketDispatcher)
+};
+
+template <typename MessageT>
+void SocketDispatcher::AddListener(const RoleAttributes& self_attr,
+                                   const MessageListener<MessageT>& listener) {
+  auto listener_adapter = [listener](
+                              const std::shared_ptr<std::string>& msg_str,
+                              const MessageInfo& msg_info) {
+    auto msg = std::make_shared<MessageT>();
+    RETURN_IF(!message::ParseFromString(*msg_str, msg.get()));
+    listener(msg, msg_info);
+  };
+
+  Dispatcher::AddListener<std::string>(self_attr, listener_adapter);
+}
+
+template <typename MessageT>
+void SocketDispatcher::AddListener(const RoleAttributes& self_attr,
+                                   const RoleAttributes& opposite_attr,
+                                   const MessageListener<MessageT>& listener) {
+  auto listener_adapter = [listener](
+                              const std::shared_ptr<std::string>& msg_str,
+                              const MessageInfo& msg_info) {
+    auto msg = std::make_shared<MessageT>();
+    RETURN_IF(!message::ParseFromString(*msg_str, msg.get()));
+    listener(msg, msg_info);
+  };
+
+  Dispatcher::AddListener<std::string>(self_attr, opposite_attr,
+                                       listener_adapter);
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_DISPATCHER_SOCKET_DISPATCHER_H_
@@ -23,6 +23,7 @@
 #include <unordered_map>
 
 #include "cyber/base/atomic_rw_lock.h"
+#include "cyber/base/resizable_atomic_hash_map.h"
 #include "cyber/base/signal.h"
 #include "cyber/common/log.h"
 #include "cyber/message/message_traits.h"
@@ -35,8 +36,19 @@ namespace transport {
 
 using apollo::cyber::base::AtomicRWLock;
 using apollo::cyber::base::ReadLockGuard;
+using apollo::cyber::base::ResizableAtomicHashMap;
 using apollo::cyber::base::WriteLockGuard;
 
+/**
+ * @brief Serialized form of a message shared by every handler whose type
+ * differs from the publisher's. The payload is kept in a RawMessage so that
+ * RawMessage handlers get it without another copy.
+ */
+struct SerializedMessage {
+  std::string type_name;
+  std::shared_ptr<message::RawMessage> raw;
+};
+
 class ListenerHandlerBase;
 using ListenerHandlerBasePtr = std::shared_ptr<ListenerHandlerBase>;
 
@@ -47,9 +59,13 @@ class ListenerHandlerBase {
 
   virtual void Disconnect(uint64_t self_id) = 0;
   virtual void Disconnect(uint64_t self_id, uint64_t oppo_id) = 0;
+  // true once every listener is disconnected
+  virtual bool Empty() = 0;
   inline bool IsRawMessage() const { return is_raw_message_; }
   virtual void RunFromString(const std::string& str,
                              const MessageInfo& msg_info) = 0;
+  virtual void RunFromSerialized(const SerializedMessage& serialized,
+                                 const MessageInfo& msg_info) = 0;
 
  protected:
   bool is_raw_message_ = false;
@@ -74,14 +90,17 @@ class ListenerHandler : public ListenerHandlerBase {
 
   void Disconnect(uint64_t self_id) override;
   void Disconnect(uint64_t self_id, uint64_t oppo_id) override;
+  bool Empty() override;
 
   void Run(const Message& msg, const MessageInfo& msg_info);
   void RunFromString(const std::string& str,
                      const MessageInfo& msg_info) override;
+  void RunFromSerialized(const SerializedMessage& serialized,
+                         const MessageInfo& msg_info) override;
 
  private:
   using SignalPtr = std::shared_ptr<MessageSignal>;
-  using MessageSignalMap = std::unordered_map<uint64_t, SignalPtr>;
+  using MessageSignalMap = ResizableAtomicHashMap<uint64_t, SignalPtr>;
   // used for self_id
   MessageSignal signal_;
   ConnectionMap signal_conns_;  // key: self_id
@@ -115,11 +134,13 @@ template <typename MessageT>
 void ListenerHandler<MessageT>::Connect(uint64_t self_id, uint64_t oppo_id,
                                         const Listener& listener) {
   WriteLockGuard<AtomicRWLock> lock(rw_lock_);
-  if (signals_.find(oppo_id) == signals_.end()) {
-    signals_[oppo_id] = std::make_shared<MessageSignal>();
+  SignalPtr signal;
+  if (!signals_.Get(oppo_id, &signal)) {
+    signal = std::make_shared<MessageSignal>();
+    signals_.Set(oppo_id, signal);
   }
 
-  auto connection = signals_[oppo_id]->Connect(listener);
+  auto connection = signal->Connect(listener);
   if (!connection.IsConnected()) {
     AWARN << oppo_id << " " << self_id << " connect failed!";
     return;
@@ -156,19 +177,30 @@ void ListenerHandler<MessageT>::Disconnect(uint64_t self_id, uint64_t oppo_id) {
 
   signals_conns_[oppo_id][self_id].Disconnect();
   signals_conns_[oppo_id].erase(self_id);
+  if (signals_conns_[oppo_id].empty()) {
+    signals_conns_.erase(oppo_id);
+    signals_.Remove(oppo_id);
+  }
+}
+
+template <typename MessageT>
+bool ListenerHandler<MessageT>::Empty() {
+  ReadLockGuard<AtomicRWLock> lock(rw_lock_);
+  return signal_conns_.empty() && signals_conns_.empty();
 }
 
 template <typename MessageT>
 void ListenerHandler<MessageT>::Run(const Message& msg,
                                     const MessageInfo& msg_info) {
   signal_(msg, msg_info);
-  uint64_t oppo_id = msg_info.sender_id().HashValue();
-  ReadLockGuard<AtomicRWLock> lock(rw_lock_);
-  if (signals_.find(oppo_id) == signals_.end()) {
+  if (signals_.Size() == 0) {
     return;
   }
-
-  (*signals_[oppo_id])(msg, msg_info);
+  uint64_t oppo_id = msg_info.sender_id().HashValue();
+  SignalPtr signal;
+  if (signals_.Get(oppo_id, &signal)) {
+    (*signal)(msg, msg_info);
+  }
 }
 
 template <typename MessageT>
@@ -183,6 +215,26 @@ void ListenerHandler<MessageT>::RunFromString(const std::string& str,
   }
 }
 
+template <typename MessageT>
+void ListenerHandler<MessageT>::RunFromSerialized(
+    const SerializedMessage& serialized, const MessageInfo& msg_info) {
+  auto msg = std::make_shared<MessageT>();
+  const std::string& str = serialized.raw->message;
+  message::SetTypeName(serialized.type_name, msg.get());
+  if (message::ParseFromArray(str.data(), static_cast<int>(str.size()),
+                              msg.get())) {
+    Run(msg, msg_info);
+  } else {
+    AWARN << "Failed to parse message. Content: " << str;
+  }
+}
+
+template <>
+inline void ListenerHandler<message::RawMessage>::RunFromSerialized(
+    const SerializedMessage& serialized, const MessageInfo& msg_info) {
+  Run(serialized.raw, msg_info);
+}
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
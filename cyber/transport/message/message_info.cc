@@ -35,24 +35,6 @@ MessageInfo::MessageInfo(const Identity& sender_id, uint64_t seq_num,
                          const Identity& spare_id)
     : sender_id_(sender_id), seq_num_(seq_num), spare_id_(spare_id) {}
 
-MessageInfo::MessageInfo(const MessageInfo& another)
-    : sender_id_(another.sender_id_),
-      channel_id_(another.channel_id_),
-      seq_num_(another.seq_num_),
-      spare_id_(another.spare_id_) {}
-
-MessageInfo::~MessageInfo() {}
-
-MessageInfo& MessageInfo::operator=(const MessageInfo& another) {
-  if (this != &another) {
-    sender_id_ = another.sender_id_;
-    channel_id_ = another.channel_id_;
-    seq_num_ = another.seq_num_;
-    spare_id_ = another.spare_id_;
-  }
-  return *this;
-}
-
 bool MessageInfo::operator==(const MessageInfo& another) const {
   return sender_id_ == another.sender_id_ &&
          channel_id_ == another.channel_id_ && seq_num_ == another.seq_num_ &&
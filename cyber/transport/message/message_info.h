@@ -20,6 +20,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <string>
+#include <type_traits>
 
 #include "cyber/transport/common/identity.h"
 
@@ -27,16 +28,20 @@ namespace apollo {
 namespace cyber {
 namespace transport {
 
+/**
+ * @class MessageInfo
+ * @brief Metadata delivered along with every message
+ *
+ * Trivially copyable, it is passed and copied by value on every delivery
+ * path without touching the heap.
+ */
 class MessageInfo {
  public:
   MessageInfo();
   MessageInfo(const Identity& sender_id, uint64_t seq_num);
   MessageInfo(const Identity& sender_id, uint64_t seq_num,
               const Identity& spare_id);
-  MessageInfo(const MessageInfo& another);
-  virtual ~MessageInfo();
 
-  MessageInfo& operator=(const MessageInfo& another);
   bool operator==(const MessageInfo& another) const;
   bool operator!=(const MessageInfo& another) const;
 
@@ -67,6 +72,9 @@ class MessageInfo {
   Identity spare_id_;
 };
 
+static_assert(std::is_trivially_copyable<MessageInfo>::value,
+              "MessageInfo is copied with every message");
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
@@ -16,6 +16,7 @@
 
 #include "cyber/transport/rtps/attributes_filler.h"
 
+#include <algorithm>
 #include <limits>
 
 #include "cyber/common/log.h"
@@ -25,6 +26,27 @@ namespace apollo {
 namespace cyber {
 namespace transport {
 
+namespace {
+
+const int32_t kMaxSamples = 10000;
+
+void FillInHistoryMemory(
+    const QosProfile& qos, int32_t depth,
+    eprosima::fastrtps::rtps::MemoryManagementPolicy_t* policy,
+    eprosima::fastrtps::ResourceLimitsQosPolicy* limits) {
+  limits->max_samples = kMaxSamples;
+  if (!qos.preallocate_history()) {
+    *policy = eprosima::fastrtps::rtps::DYNAMIC_RESERVE_MEMORY_MODE;
+    return;
+  }
+  // the type size only covers an empty message, so the payloads have to be
+  // able to grow, but they keep their size once they did
+  *policy = eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
+  limits->allocated_samples = std::max(1, std::min(depth, kMaxSamples));
+}
+
+}  // namespace
+
 AttributesFiller::AttributesFiller() {}
 AttributesFiller::~AttributesFiller() {}
 
@@ -109,9 +131,16 @@ bool AttributesFiller::FillInPubAttr(
 
   pub_attr->qos.m_publishMode.kind =
       eprosima::fastrtps::ASYNCHRONOUS_PUBLISH_MODE;
-  pub_attr->historyMemoryPolicy =
-      eprosima::fastrtps::DYNAMIC_RESERVE_MEMORY_MODE;
-  pub_attr->topic.resourceLimitsQos.max_samples = 10000;
+  // large fragmented messages otherwise burst out at once and get dropped
+  // by the receiving socket buffers
+  if (qos.throughput_bytes() != 0 && qos.throughput_period_ms() != 0) {
+    pub_attr->throughputController.bytesPerPeriod = qos.throughput_bytes();
+    pub_attr->throughputController.periodMillisecs =
+        qos.throughput_period_ms();
+  }
+  FillInHistoryMemory(qos, pub_attr->topic.historyQos.depth,
+                      &pub_attr->historyMemoryPolicy,
+                      &pub_attr->topic.resourceLimitsQos);
 
   return true;
 }
@@ -172,9 +201,9 @@ bool AttributesFiller::FillInSubAttr(
     return false;
   }
 
-  sub_attr->historyMemoryPolicy =
-      eprosima::fastrtps::DYNAMIC_RESERVE_MEMORY_MODE;
-  sub_attr->topic.resourceLimitsQos.max_samples = 10000;
+  FillInHistoryMemory(qos, sub_attr->topic.historyQos.depth,
+                      &sub_attr->historyMemoryPolicy,
+                      &sub_attr->topic.resourceLimitsQos);
 
   return true;
 }
@@ -0,0 +1,154 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/rtps/batch_writer.h"
+
+#include <cstring>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+namespace {
+
+const std::size_t kFrameHeaderSize = MessageInfo::kSize + sizeof(uint32_t);
+
+}  // namespace
+
+BatchWriter::BatchWriter(uint32_t latency_us, uint32_t max_bytes,
+                         const WriteFunc& write)
+    : latency_(latency_us), max_bytes_(max_bytes), write_(write) {
+  batch_.seq(0);
+  batch_.data().reserve(max_bytes_);
+  thread_ = std::thread(&BatchWriter::ThreadFunc, this);
+}
+
+BatchWriter::~BatchWriter() { Shutdown(); }
+
+bool BatchWriter::Write(const std::string& msg_str,
+                        const MessageInfo& msg_info) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (is_shutdown_) {
+    return false;
+  }
+
+  auto& data = batch_.data();
+  std::size_t frame_size = kFrameHeaderSize + msg_str.size();
+  bool ret = true;
+  if (batch_.seq() > 0 && data.size() + frame_size > max_bytes_) {
+    ret = FlushLocked();
+  }
+  if (frame_size >= max_bytes_) {
+    // too large to share a sample, nothing is gained by framing it
+    UnderlayMessage m;
+    m.seq(0);
+    m.data(msg_str);
+    return write_(&m, msg_info) && ret;
+  }
+
+  bool is_first = batch_.seq() == 0;
+  std::size_t offset = data.size();
+  data.resize(offset + kFrameHeaderSize);
+  msg_info.SerializeTo(&data[offset], MessageInfo::kSize);
+  uint32_t len = static_cast<uint32_t>(msg_str.size());
+  memcpy(&data[offset + MessageInfo::kSize], &len, sizeof(len));
+  data.append(msg_str);
+  batch_.seq(batch_.seq() + 1);
+  last_info_ = msg_info;
+
+  if (is_first) {
+    deadline_ = std::chrono::steady_clock::now() + latency_;
+    lock.unlock();
+    cv_.notify_one();
+  }
+  return ret;
+}
+
+void BatchWriter::Flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  FlushLocked();
+}
+
+void BatchWriter::Shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (is_shutdown_) {
+      return;
+    }
+    FlushLocked();
+    is_shutdown_ = true;
+  }
+  cv_.notify_one();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+bool BatchWriter::Unpack(const UnderlayMessage& msg,
+                         const FrameCallback& callback) {
+  const char* ptr = msg.data().data();
+  std::size_t left = msg.data().size();
+  for (int32_t i = 0; i < msg.seq(); ++i) {
+    if (left < kFrameHeaderSize) {
+      AWARN << "truncated batch frame header.";
+      return false;
+    }
+    MessageInfo msg_info;
+    msg_info.DeserializeFrom(ptr, MessageInfo::kSize);
+    uint32_t len = 0;
+    memcpy(&len, ptr + MessageInfo::kSize, sizeof(len));
+    ptr += kFrameHeaderSize;
+    left -= kFrameHeaderSize;
+    if (left < len) {
+      AWARN << "truncated batch frame, need " << len << " got " << left;
+      return false;
+    }
+    callback(std::make_shared<std::string>(ptr, len), msg_info);
+    ptr += len;
+    left -= len;
+  }
+  return left == 0;
+}
+
+bool BatchWriter::FlushLocked() {
+  if (batch_.seq() == 0) {
+    return true;
+  }
+  bool ret = write_(&batch_, last_info_);
+  // keep the capacity, the next batch fills the same buffer
+  batch_.data().clear();
+  batch_.seq(0);
+  return ret;
+}
+
+void BatchWriter::ThreadFunc() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!is_shutdown_) {
+    if (batch_.seq() == 0) {
+      cv_.wait(lock);
+    } else if (std::chrono::steady_clock::now() >= deadline_) {
+      FlushLocked();
+    } else {
+      cv_.wait_until(lock, deadline_);
+    }
+  }
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
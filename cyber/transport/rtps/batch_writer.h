@@ -0,0 +1,92 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_RTPS_BATCH_WRITER_H_
+#define CYBER_TRANSPORT_RTPS_BATCH_WRITER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "cyber/transport/message/message_info.h"
+#include "cyber/transport/rtps/underlay_message.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+/**
+ * @class BatchWriter
+ * @brief Coalesces small messages into one UnderlayMessage
+ *
+ * Every message is appended as a frame of its MessageInfo, its length and
+ * its bytes. The batch goes out when it reaches `max_bytes` or when its
+ * oldest message waited `latency_us`, whichever comes first. A batch
+ * carries the number of frames in `seq`, plain messages leave it at zero.
+ */
+class BatchWriter {
+ public:
+  using WriteFunc =
+      std::function<bool(UnderlayMessage* msg, const MessageInfo& msg_info)>;
+  using FrameCallback =
+      std::function<void(const std::shared_ptr<std::string>& msg_str,
+                         const MessageInfo& msg_info)>;
+
+  BatchWriter(uint32_t latency_us, uint32_t max_bytes, const WriteFunc& write);
+  virtual ~BatchWriter();
+
+  bool Write(const std::string& msg_str, const MessageInfo& msg_info);
+  void Flush();
+  void Shutdown();
+
+  static bool IsBatch(const UnderlayMessage& msg) { return msg.seq() > 0; }
+
+  /**
+   * @brief Hand every frame of a batch to `callback`
+   *
+   * @return false if the batch is malformed, frames before the broken one
+   * are still delivered
+   */
+  static bool Unpack(const UnderlayMessage& msg,
+                     const FrameCallback& callback);
+
+ private:
+  bool FlushLocked();
+  void ThreadFunc();
+
+  const std::chrono::microseconds latency_;
+  const uint32_t max_bytes_;
+  WriteFunc write_;
+
+  UnderlayMessage batch_;
+  MessageInfo last_info_;
+  std::chrono::steady_clock::time_point deadline_;
+  bool is_shutdown_ = false;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread thread_;
+};
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_RTPS_BATCH_WRITER_H_
@@ -14,8 +14,12 @@
  * limitations under the License.
  *****************************************************************************/
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "fastcdr/Cdr.h"
 #include "fastcdr/exceptions/BadParamException.h"
@@ -25,6 +29,7 @@
 #include "cyber/common/log.h"
 #include "cyber/transport/qos/qos_profile_conf.h"
 #include "cyber/transport/rtps/attributes_filler.h"
+#include "cyber/transport/rtps/batch_writer.h"
 #include "cyber/transport/rtps/participant.h"
 #include "cyber/transport/rtps/underlay_message.h"
 #include "cyber/transport/rtps/underlay_message_type.h"
@@ -136,6 +141,114 @@ TEST(AttributesFillerTest, fill_in_sub_attr_test) {
             attrs.qos.m_reliability.kind);
 }
 
+TEST(AttributesFillerTest, history_memory_and_throughput) {
+  QosProfile qos;
+  eprosima::fastrtps::PublisherAttributes pub_attrs;
+  eprosima::fastrtps::SubscriberAttributes sub_attrs;
+  qos.set_depth(16);
+  AttributesFiller::FillInPubAttr("channel", qos, &pub_attrs);
+  EXPECT_EQ(eprosima::fastrtps::rtps::DYNAMIC_RESERVE_MEMORY_MODE,
+            pub_attrs.historyMemoryPolicy);
+  EXPECT_EQ(0, pub_attrs.throughputController.bytesPerPeriod);
+
+  qos.set_preallocate_history(true);
+  qos.set_throughput_bytes(1 << 20);
+  qos.set_throughput_period_ms(10);
+  AttributesFiller::FillInPubAttr("channel", qos, &pub_attrs);
+  EXPECT_EQ(
+      eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE,
+      pub_attrs.historyMemoryPolicy);
+  EXPECT_EQ(16, pub_attrs.topic.resourceLimitsQos.allocated_samples);
+  EXPECT_EQ(1 << 20, pub_attrs.throughputController.bytesPerPeriod);
+  EXPECT_EQ(10, pub_attrs.throughputController.periodMillisecs);
+
+  AttributesFiller::FillInSubAttr("channel", qos, &sub_attrs);
+  EXPECT_EQ(
+      eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE,
+      sub_attrs.historyMemoryPolicy);
+  EXPECT_EQ(16, sub_attrs.topic.resourceLimitsQos.allocated_samples);
+}
+
+TEST(BatchWriterTest, coalesce) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<UnderlayMessage> written;
+  auto write = [&](UnderlayMessage* m, const MessageInfo& msg_info) {
+    std::lock_guard<std::mutex> lock(mutex);
+    written.emplace_back(*m);
+    cv.notify_all();
+    return true;
+  };
+
+  // large enough budget that only the size limit flushes
+  BatchWriter writer(10 * 1000 * 1000, 1024, write);
+  Identity sender;
+  for (uint64_t i = 0; i < 8; ++i) {
+    EXPECT_TRUE(writer.Write(std::string(100, 'a' + i),
+                             MessageInfo(sender, i)));
+  }
+  // a message over the limit goes out after the pending batch, unframed
+  EXPECT_TRUE(writer.Write(std::string(2048, 'z'), MessageInfo(sender, 8)));
+  ASSERT_EQ(2, written.size());
+  EXPECT_TRUE(BatchWriter::IsBatch(written[0]));
+  EXPECT_FALSE(BatchWriter::IsBatch(written[1]));
+  EXPECT_EQ(2048, written[1].data().size());
+
+  std::vector<std::pair<std::string, MessageInfo>> frames;
+  EXPECT_TRUE(BatchWriter::Unpack(
+      written[0], [&frames](const std::shared_ptr<std::string>& msg_str,
+                            const MessageInfo& msg_info) {
+        frames.emplace_back(*msg_str, msg_info);
+      }));
+  ASSERT_EQ(8, frames.size());
+  for (uint64_t i = 0; i < frames.size(); ++i) {
+    EXPECT_EQ(std::string(100, 'a' + i), frames[i].first);
+    EXPECT_EQ(i, frames[i].second.seq_num());
+    EXPECT_EQ(sender, frames[i].second.sender_id());
+  }
+
+  // truncated batches deliver what is intact
+  UnderlayMessage broken(written[0]);
+  broken.data().resize(broken.data().size() - 1);
+  frames.clear();
+  EXPECT_FALSE(BatchWriter::Unpack(
+      broken, [&frames](const std::shared_ptr<std::string>& msg_str,
+                        const MessageInfo& msg_info) {
+        frames.emplace_back(*msg_str, msg_info);
+      }));
+  EXPECT_EQ(7, frames.size());
+}
+
+TEST(BatchWriterTest, latency_budget) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<UnderlayMessage> written;
+  auto write = [&](UnderlayMessage* m, const MessageInfo& msg_info) {
+    std::lock_guard<std::mutex> lock(mutex);
+    written.emplace_back(*m);
+    cv.notify_all();
+    return true;
+  };
+
+  BatchWriter writer(1000, 64 * 1024, write);
+  EXPECT_TRUE(writer.Write("a", MessageInfo()));
+  EXPECT_TRUE(writer.Write("b", MessageInfo()));
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(1),
+                            [&written]() { return !written.empty(); }));
+    EXPECT_EQ(2, written[0].seq());
+  }
+
+  // whatever is pending leaves on shutdown
+  EXPECT_TRUE(writer.Write("c", MessageInfo()));
+  writer.Shutdown();
+  EXPECT_FALSE(writer.Write("d", MessageInfo()));
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_EQ(2, written.size());
+  EXPECT_EQ(1, written[1].seq());
+}
+
 TEST(ParticipantTest, participant_test) {
   eprosima::fastrtps::ParticipantListener listener;
   eprosima::fastrtps::ParticipantListener listener1;
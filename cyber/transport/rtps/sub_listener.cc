@@ -18,6 +18,7 @@
 
 #include "cyber/common/log.h"
 #include "cyber/common/util.h"
+#include "cyber/transport/rtps/batch_writer.h"
 
 namespace apollo {
 namespace cyber {
@@ -41,6 +42,16 @@ void SubListener::onNewDataMessage(eprosima::fastrtps::Subscriber* sub) {
   RETURN_IF(!sub->takeNextData(reinterpret_cast<void*>(&m), &m_info));
   RETURN_IF(m_info.sampleKind != eprosima::fastrtps::ALIVE);
 
+  // coalesced messages carry their own MessageInfo
+  if (BatchWriter::IsBatch(m)) {
+    BatchWriter::Unpack(m, [this, channel_id](
+                               const std::shared_ptr<std::string>& msg_str,
+                               const MessageInfo& msg_info) {
+      callback_(channel_id, msg_str, msg_info);
+    });
+    return;
+  }
+
   // fetch MessageInfo
   char* ptr =
       reinterpret_cast<char*>(&m_info.related_sample_identity.writer_guid());
@@ -16,6 +16,7 @@
 
 #include "cyber/transport/shm/block.h"
 
+#include "cyber/base/macros.h"
 #include "cyber/common/log.h"
 
 namespace apollo {
@@ -30,12 +31,18 @@ Block::Block() : msg_size_(0), msg_info_size_(0) {}
 
 Block::~Block() {}
 
+LockStats* Block::Stats() {
+  static auto stats = new LockStats("shm::Block");
+  return stats;
+}
+
 bool Block::TryLockForWrite() {
   int32_t rw_lock_free = kRWLockFree;
   if (!lock_num_.compare_exchange_weak(rw_lock_free, kWriteExclusive,
                                        std::memory_order_acq_rel,
                                        std::memory_order_relaxed)) {
     ADEBUG << "lock num: " << lock_num_.load();
+    Stats()->AddContended(0);
     return false;
   }
   return true;
@@ -45,22 +52,32 @@ bool Block::TryLockForRead() {
   int32_t lock_num = lock_num_.load();
   if (lock_num < kRWLockFree) {
     AINFO << "block is being written.";
+    Stats()->AddContended(0);
     return false;
   }
 
+  // other readers only, back off a little so the CAS can succeed
   int32_t try_times = 0;
+  uint64_t spins = 0;
   while (!lock_num_.compare_exchange_weak(lock_num, lock_num + 1,
                                           std::memory_order_acq_rel,
                                           std::memory_order_relaxed)) {
     ++try_times;
     if (try_times == kMaxTryLockTimes) {
       AINFO << "fail to add read lock num, curr num: " << lock_num;
+      Stats()->AddContended(spins);
       return false;
     }
 
+    for (int32_t i = 0; i < (1 << try_times); ++i) {
+      cpu_relax();
+    }
+    spins += 1 << try_times;
+
     lock_num = lock_num_.load();
     if (lock_num < kRWLockFree) {
       AINFO << "block is being written.";
+      Stats()->AddContended(spins);
       return false;
     }
   }
@@ -20,10 +20,14 @@
 #include <atomic>
 #include <cstdint>
 
+#include "cyber/base/lock_stats.h"
+
 namespace apollo {
 namespace cyber {
 namespace transport {
 
+using apollo::cyber::base::LockStats;
+
 class Block {
   friend class Segment;
 
@@ -43,6 +47,9 @@ class Block {
   static const int32_t kWriteExclusive;
   static const int32_t kMaxTryLockTimes;
 
+  // failed try-locks of this process, blocks never wait
+  static LockStats* Stats();
+
  private:
   bool TryLockForWrite();
   bool TryLockForRead();
@@ -20,6 +20,7 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 
+#include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
 #include "cyber/common/util.h"
 #include "cyber/transport/shm/block.h"
@@ -30,8 +31,14 @@ namespace apollo {
 namespace cyber {
 namespace transport {
 
+using apollo::cyber::common::GlobalData;
+
 PosixSegment::PosixSegment(uint64_t channel_id) : Segment(channel_id) {
   shm_name_ = std::to_string(channel_id);
+  if (hugepage_) {
+    auto& conf = GlobalData::Instance()->Config().transport_conf().shm_conf();
+    hugepage_file_ = conf.hugepage_path() + "/" + shm_name_;
+  }
 }
 
 PosixSegment::~PosixSegment() { Destroy(); }
@@ -41,46 +48,80 @@ bool PosixSegment::OpenOrCreate() {
     return true;
   }
 
-  // create managed_shm_  创建或者打开共享内存文件
-  int fd = shm_open(shm_name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
-  if (fd < 0) {
-    if (EEXIST == errno) {
+  // hugetlbfs first, /dev/shm is used when no huge pages are free. A segment
+  // that fell back to /dev/shm wins over hugetlbfs, so processes that find
+  // huge pages later still join it.
+  on_hugepage_ = false;
+  bool hugepage_file_left = false;
+  if (hugepage_) {
+    int fd = shm_open(shm_name_.c_str(), O_RDWR, 0644);
+    if (fd >= 0) {
+      close(fd);
+      ADEBUG << "shm already exist, open only.";
+      return OpenOnly();
+    }
+    fd = open(hugepage_file_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0 && EEXIST == errno) {
       ADEBUG << "shm already exist, open only.";
       return OpenOnly();
+    }
+    if (fd >= 0) {
+      on_hugepage_ = MapHugePage(fd);
+      hugepage_file_left = !on_hugepage_;
     } else {
-      AERROR << "create shm failed, error: " << strerror(errno);
-      return false;
+      AINFO << "open " << hugepage_file_ << " failed: " << strerror(errno)
+            << ", fall back to normal pages.";
     }
   }
 
- // 重置文件大小
-  if (ftruncate(fd, conf_.managed_shm_size()) < 0) {
-    AERROR << "ftruncate failed: " << strerror(errno);
-    close(fd);
-    return false;
-  }
+  if (!on_hugepage_) {
+    // create managed_shm_  创建或者打开共享内存文件
+    int fd = shm_open(shm_name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    // kept until now so no one creates the segment on hugetlbfs meanwhile
+    if (hugepage_file_left) {
+      unlink(hugepage_file_.c_str());
+    }
+    if (fd < 0) {
+      if (EEXIST == errno) {
+        ADEBUG << "shm already exist, open only.";
+        return OpenOnly();
+      } else {
+        AERROR << "create shm failed, error: " << strerror(errno);
+        return false;
+      }
+    }
+
+    // 重置文件大小
+    if (ftruncate(fd, conf_.managed_shm_size()) < 0) {
+      AERROR << "ftruncate failed: " << strerror(errno);
+      close(fd);
+      return false;
+    }
+
+    // attach managed_shm_  将打开的文件映射到内存
+    mapped_size_ = conf_.managed_shm_size();
+    managed_shm_ = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED, fd, 0);
+    if (managed_shm_ == MAP_FAILED) {
+      AERROR << "attach shm failed:" << strerror(errno);
+      close(fd);
+      managed_shm_ = nullptr;
+      // 删除/dev/shm目录的文件,shm_unlink 删除的文件是由shm_open函数创建于/dev/shm目录的
+      shm_unlink(shm_name_.c_str());
+      return false;
+    }
 
-  // attach managed_shm_  将打开的文件映射到内存
-  managed_shm_ = mmap(nullptr, conf_.managed_shm_size(), PROT_READ | PROT_WRITE,
-                      MAP_SHARED, fd, 0);
-  if (managed_shm_ == MAP_FAILED) {
-    AERROR << "attach shm failed:" << strerror(errno);
     close(fd);
-    // 删除/dev/shm目录的文件,shm_unlink 删除的文件是由shm_open函数创建于/dev/shm目录的
-    shm_unlink(shm_name_.c_str());
-    return false;
   }
 
-  close(fd);
-
   // create field state_
   state_ = new (managed_shm_) State(conf_.ceiling_msg_size());
   if (state_ == nullptr) {
     AERROR << "create state failed.";
     //只是将映射的内存从进程的地址空间撤销，如果不调用这个函数，则在进程终止前，该片区域将得不到释放
-    munmap(managed_shm_, conf_.managed_shm_size());
+    munmap(managed_shm_, mapped_size_);
     managed_shm_ = nullptr;
-    shm_unlink(shm_name_.c_str());
+    Unlink();
     return false;
   }
 
@@ -93,9 +134,9 @@ bool PosixSegment::OpenOrCreate() {
     AERROR << "create blocks failed.";
     state_->~State();
     state_ = nullptr;
-    munmap(managed_shm_, conf_.managed_shm_size());
+    munmap(managed_shm_, mapped_size_);
     managed_shm_ = nullptr;
-    shm_unlink(shm_name_.c_str());
+    Unlink();
     return false;
   }
 
@@ -124,9 +165,9 @@ bool PosixSegment::OpenOrCreate() {
       std::lock_guard<std::mutex> lg(block_buf_lock_);
       block_buf_addrs_.clear();
     }
-    munmap(managed_shm_, conf_.managed_shm_size());
+    munmap(managed_shm_, mapped_size_);
     managed_shm_ = nullptr;
-    shm_unlink(shm_name_.c_str());
+    Unlink();
     return false;
   }
 
@@ -140,8 +181,13 @@ bool PosixSegment::OpenOnly() {
     return true;
   }
 
-  // get managed_shm_
+  // get managed_shm_, /dev/shm first like OpenOrCreate
   int fd = shm_open(shm_name_.c_str(), O_RDWR, 0644);
+  on_hugepage_ = false;
+  if (fd == -1 && hugepage_) {
+    fd = open(hugepage_file_.c_str(), O_RDWR, 0644);
+    on_hugepage_ = fd != -1;
+  }
   if (fd == -1) {
     AERROR << "get shm failed: " << strerror(errno);
     return false;
@@ -155,11 +201,13 @@ bool PosixSegment::OpenOnly() {
   }
 
   // attach managed_shm_
-  managed_shm_ = mmap(nullptr, file_attr.st_size, PROT_READ | PROT_WRITE,
+  mapped_size_ = file_attr.st_size;
+  managed_shm_ = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE,
                       MAP_SHARED, fd, 0);
   if (managed_shm_ == MAP_FAILED) {
     AERROR << "attach shm failed: " << strerror(errno);
     close(fd);
+    managed_shm_ = nullptr;
     return false;
   }
 
@@ -168,7 +216,7 @@ bool PosixSegment::OpenOnly() {
   state_ = reinterpret_cast<State*>(managed_shm_);
   if (state_ == nullptr) {
     AERROR << "get state failed.";
-    munmap(managed_shm_, file_attr.st_size);
+    munmap(managed_shm_, mapped_size_);
     managed_shm_ = nullptr;
     return false;
   }
@@ -181,7 +229,7 @@ bool PosixSegment::OpenOnly() {
   if (blocks_ == nullptr) {
     AERROR << "get blocks failed.";
     state_ = nullptr;
-    munmap(managed_shm_, conf_.managed_shm_size());
+    munmap(managed_shm_, mapped_size_);
     managed_shm_ = nullptr;
     return false;
   }
@@ -206,9 +254,9 @@ bool PosixSegment::OpenOnly() {
       std::lock_guard<std::mutex> lg(block_buf_lock_);
       block_buf_addrs_.clear();
     }
-    munmap(managed_shm_, conf_.managed_shm_size());
+    munmap(managed_shm_, mapped_size_);
     managed_shm_ = nullptr;
-    shm_unlink(shm_name_.c_str());
+    Unlink();
     return false;
   }
 
@@ -219,13 +267,37 @@ bool PosixSegment::OpenOnly() {
 }
 
 bool PosixSegment::Remove() {
-  if (shm_unlink(shm_name_.c_str()) < 0) {
-    AERROR << "shm_unlink failed: " << strerror(errno);
+  if (Unlink() < 0) {
+    AERROR << "unlink shm failed: " << strerror(errno);
     return false;
   }
   return true;
 }
 
+bool PosixSegment::MapHugePage(int fd) {
+  mapped_size_ = HugePageShmSize();
+  if (ftruncate(fd, mapped_size_) == 0) {
+    managed_shm_ = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED, fd, 0);
+    if (managed_shm_ != MAP_FAILED) {
+      close(fd);
+      return true;
+    }
+  }
+  AINFO << "no huge pages for " << hugepage_file_ << ": " << strerror(errno)
+        << ", fall back to normal pages.";
+  managed_shm_ = nullptr;
+  close(fd);
+  return false;
+}
+
+int PosixSegment::Unlink() {
+  if (on_hugepage_) {
+    return unlink(hugepage_file_.c_str());
+  }
+  return shm_unlink(shm_name_.c_str());
+}
+
 void PosixSegment::Reset() {
   state_ = nullptr;
   blocks_ = nullptr;
@@ -234,7 +306,7 @@ void PosixSegment::Reset() {
     block_buf_addrs_.clear();
   }
   if (managed_shm_ != nullptr) {
-    munmap(managed_shm_, conf_.managed_shm_size());
+    munmap(managed_shm_, mapped_size_);
     managed_shm_ = nullptr;
     return;
   }
@@ -38,8 +38,14 @@ class PosixSegment : public Segment {
   bool Remove() override;
   bool OpenOnly() override;
   bool OpenOrCreate() override;
+  // maps a freshly created hugetlbfs file, false if no huge pages are free,
+  // the file is left for the caller to unlink then
+  bool MapHugePage(int fd);
+  int Unlink();
 
   std::string shm_name_;
+  std::string hugepage_file_;
+  bool on_hugepage_ = false;
 };
 
 }  // namespace transport
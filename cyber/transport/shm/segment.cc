@@ -16,7 +16,9 @@
 
 #include "cyber/transport/shm/segment.h"
 
+#include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
+#include "cyber/common/numa.h"
 #include "cyber/common/util.h"
 #include "cyber/transport/shm/shm_conf.h"
 
@@ -24,13 +26,21 @@ namespace apollo {
 namespace cyber {
 namespace transport {
 
+using apollo::cyber::common::GlobalData;
+
 Segment::Segment(uint64_t channel_id)
     : init_(false),
+      hugepage_(GlobalData::Instance()
+                    ->Config()
+                    .transport_conf()
+                    .shm_conf()
+                    .hugepage()),
       conf_(),
       channel_id_(channel_id),
       state_(nullptr),
       blocks_(nullptr),
       managed_shm_(nullptr),
+      mapped_size_(0),
       block_buf_lock_(),
       block_buf_addrs_() {}
 
@@ -76,9 +86,12 @@ void Segment::ReleaseWrittenBlock(const WritableBlock& writable_block) {
 
 bool Segment::AcquireBlockToRead(ReadableBlock* readable_block) {
   RETURN_VAL_IF_NULL(readable_block, false);
-  if (!init_ && !OpenOnly()) {
-    AERROR << "failed to open shared memory, can't read now.";
-    return false;
+  if (!init_) {
+    if (!OpenOnly()) {
+      AERROR << "failed to open shared memory, can't read now.";
+      return false;
+    }
+    BindToProcessorNodes();
   }
 
   auto index = readable_block->index;
@@ -90,6 +103,9 @@ bool Segment::AcquireBlockToRead(ReadableBlock* readable_block) {
   bool result = true;
   if (state_->need_remap()) {
     result = Remap();
+    if (result) {
+      BindToProcessorNodes();
+    }
   }
 
   if (!result) {
@@ -150,6 +166,29 @@ bool Segment::Recreate(const uint64_t& msg_size) {
   return OpenOrCreate();
 }
 
+std::size_t Segment::HugePageShmSize() {
+  auto page = common::HugePageSize();
+  return (conf_.managed_shm_size() + page - 1) / page * page;
+}
+
+// Subscribers touch the payload last, so the segment follows the numa nodes
+// of their processors. The policy is shared by every process mapping the
+// segment: blocks that are not faulted in yet are allocated there, and pages
+// only this process maps are migrated. With subscribers on several nodes the
+// last one to open the segment wins.
+void Segment::BindToProcessorNodes() {
+  auto& transport_conf = GlobalData::Instance()->Config().transport_conf();
+  if (!transport_conf.shm_conf().numa_bind()) {
+    return;
+  }
+  auto nodes = common::NumaNodesOfCpus(GlobalData::Instance()->ProcessorCpus());
+  if (nodes.empty()) {
+    return;
+  }
+  // a range that ends inside a huge page is rejected
+  common::BindToNumaNodes(managed_shm_, mapped_size_, nodes);
+}
+
 uint32_t Segment::GetNextWritableBlockIndex() {
   const auto block_num = conf_.block_num();
   while (1) {
@@ -58,19 +58,27 @@ class Segment {
   virtual bool OpenOnly() = 0;
   virtual bool OpenOrCreate() = 0;
 
+  // size of the segment rounded up to whole huge pages
+  std::size_t HugePageShmSize();
+
   bool init_;
+  // back the segment with huge pages if there are free ones
+  bool hugepage_;
   ShmConf conf_;
   uint64_t channel_id_;
 
   State* state_;
   Block* blocks_;
   void* managed_shm_;
+  // bytes mapped at managed_shm_, whole huge pages when on hugetlb
+  std::size_t mapped_size_;
   std::mutex block_buf_lock_;
   std::unordered_map<uint32_t, uint8_t*> block_buf_addrs_;
 
  private:
   bool Remap();
   bool Recreate(const uint64_t& msg_size);
+  void BindToProcessorNodes();
   uint32_t GetNextWritableBlockIndex();
 };
 
@@ -29,6 +29,19 @@ namespace apollo {
 namespace cyber {
 namespace transport {
 
+namespace {
+
+// the size the segment was created with, whole huge pages on hugetlb
+std::size_t ShmSize(int shmid) {
+  struct shmid_ds shm_attr;
+  if (shmctl(shmid, IPC_STAT, &shm_attr) != 0) {
+    return 0;
+  }
+  return shm_attr.shm_segsz;
+}
+
+}  // namespace
+
 XsiSegment::XsiSegment(uint64_t channel_id) : Segment(channel_id) {
   key_ = static_cast<key_t>(channel_id);
 }
@@ -44,7 +57,7 @@ bool XsiSegment::OpenOrCreate() {
   int retry = 0;
   int shmid = 0;
   while (retry < 2) {
-    shmid = shmget(key_, conf_.managed_shm_size(), 0644 | IPC_CREAT | IPC_EXCL);
+    shmid = CreateShm();
     if (shmid != -1) {
       break;
     }
@@ -75,6 +88,7 @@ bool XsiSegment::OpenOrCreate() {
     shmctl(shmid, IPC_RMID, 0);
     return false;
   }
+  mapped_size_ = ShmSize(shmid);
 
   // create field state_
   // （placement new）在已分配的原始内存中初始化一个对象
@@ -156,6 +170,7 @@ bool XsiSegment::OpenOnly() {
     AERROR << "attach shm failed, error: " << strerror(errno);
     return false;
   }
+  mapped_size_ = ShmSize(shmid);
 
   // get field state_
   state_ = reinterpret_cast<State*>(managed_shm_);
@@ -214,6 +229,19 @@ bool XsiSegment::OpenOnly() {
   return true;
 }
 
+int XsiSegment::CreateShm() {
+  int flags = 0644 | IPC_CREAT | IPC_EXCL;
+  if (hugepage_) {
+    int shmid = shmget(key_, HugePageShmSize(), flags | SHM_HUGETLB);
+    if (shmid != -1 || EEXIST == errno) {
+      return shmid;
+    }
+    AINFO << "no huge pages for shm, fall back to normal pages: "
+          << strerror(errno);
+  }
+  return shmget(key_, conf_.managed_shm_size(), flags);
+}
+
 bool XsiSegment::Remove() {
   int shmid = shmget(key_, 0, 0644);
   if (shmid == -1 || shmctl(shmid, IPC_RMID, 0) == -1) {
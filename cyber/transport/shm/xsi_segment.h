@@ -36,6 +36,8 @@ class XsiSegment : public Segment {
   bool Remove() override;
   bool OpenOnly() override;
   bool OpenOrCreate() override;
+  // tries huge pages first when enabled, returns the shmid or -1
+  int CreateShm();
 
   key_t key_;
 };
@@ -0,0 +1,132 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/socket/frame.h"
+
+#include <cstring>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+namespace {
+
+MessageInfo ToMessageInfo(const FrameHeader& header) {
+  MessageInfo msg_info;
+  msg_info.DeserializeFrom(header.msg_info, sizeof(header.msg_info));
+  return msg_info;
+}
+
+}  // namespace
+
+void FillFrameHeader(uint64_t channel_id, const std::string& msg_str,
+                     const MessageInfo& msg_info, FrameHeader* header) {
+  header->magic = kFrameMagic;
+  header->length = static_cast<uint32_t>(msg_str.size());
+  header->channel_id = channel_id;
+  msg_info.SerializeTo(header->msg_info, sizeof(header->msg_info));
+}
+
+bool ParseDatagram(const char* data, std::size_t size,
+                   const FrameCallback& callback) {
+  FrameHeader header;
+  if (size < sizeof(header)) {
+    return false;
+  }
+  memcpy(&header, data, sizeof(header));
+  if (header.magic != kFrameMagic ||
+      header.length != size - sizeof(header)) {
+    return false;
+  }
+  callback(header.channel_id,
+           std::make_shared<std::string>(data + sizeof(header), header.length),
+           ToMessageInfo(header));
+  return true;
+}
+
+FrameParser::FrameParser(const FrameCallback& callback,
+                         std::size_t buffer_size,
+                         std::size_t max_message_size)
+    : callback_(callback),
+      max_message_size_(max_message_size),
+      buffer_(buffer_size) {}
+
+char* FrameParser::Buffer(std::size_t* size) {
+  if (msg_str_ != nullptr) {
+    *size = msg_str_->size() - filled_;
+    return &(*msg_str_)[filled_];
+  }
+  if (begin_ == end_) {
+    begin_ = end_ = 0;
+  } else if (buffer_.size() - end_ < buffer_.size() / 4) {
+    // move the partial frame to the front, it fits into the buffer
+    memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+    end_ -= begin_;
+    begin_ = 0;
+  }
+  *size = buffer_.size() - end_;
+  return buffer_.data() + end_;
+}
+
+bool FrameParser::Feed(std::size_t size) {
+  if (msg_str_ != nullptr) {
+    filled_ += size;
+    if (filled_ == msg_str_->size()) {
+      Deliver(msg_str_);
+      msg_str_ = nullptr;
+    }
+    return true;
+  }
+
+  end_ += size;
+  while (end_ - begin_ >= sizeof(header_)) {
+    memcpy(&header_, buffer_.data() + begin_, sizeof(header_));
+    if (header_.magic != kFrameMagic) {
+      AERROR << "bad frame magic " << header_.magic;
+      return false;
+    }
+    if (header_.length > max_message_size_) {
+      AERROR << "frame of " << header_.length << " bytes exceeds the "
+             << max_message_size_ << " bytes of max_message_size";
+      return false;
+    }
+    const char* data = buffer_.data() + begin_ + sizeof(header_);
+    std::size_t available = end_ - begin_ - sizeof(header_);
+    if (available >= header_.length) {
+      Deliver(std::make_shared<std::string>(data, header_.length));
+      begin_ += sizeof(header_) + header_.length;
+      continue;
+    }
+    if (sizeof(header_) + header_.length > buffer_.size()) {
+      msg_str_ = std::make_shared<std::string>(header_.length, '\0');
+      memcpy(&(*msg_str_)[0], data, available);
+      filled_ = available;
+      begin_ = end_ = 0;
+    }
+    break;
+  }
+  return true;
+}
+
+void FrameParser::Deliver(const std::shared_ptr<std::string>& msg_str) {
+  callback_(header_.channel_id, msg_str, ToMessageInfo(header_));
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
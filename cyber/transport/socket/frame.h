@@ -0,0 +1,110 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_SOCKET_FRAME_H_
+#define CYBER_TRANSPORT_SOCKET_FRAME_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cyber/transport/message/message_info.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+/**
+ * @brief Header in front of every message on a SOCKET link, the bytes of
+ * the serialized message follow directly. Fields are in host byte order
+ * like MessageInfo.
+ */
+struct FrameHeader {
+  uint32_t magic;
+  uint32_t length;
+  uint64_t channel_id;
+  char msg_info[2 * ID_SIZE + sizeof(uint64_t)];
+};
+
+static_assert(sizeof(FrameHeader) == 40, "FrameHeader must not be padded");
+
+const uint32_t kFrameMagic = 0x46425943;  // "CYBF"
+// largest udp payload, a datagram holds exactly one frame
+const std::size_t kMaxDatagramSize = 65507;
+
+using FrameCallback = std::function<void(
+    uint64_t channel_id, const std::shared_ptr<std::string>& msg_str,
+    const MessageInfo& msg_info)>;
+
+void FillFrameHeader(uint64_t channel_id, const std::string& msg_str,
+                     const MessageInfo& msg_info, FrameHeader* header);
+
+/**
+ * @brief Hand the frame of one datagram to `callback`
+ */
+bool ParseDatagram(const char* data, std::size_t size,
+                   const FrameCallback& callback);
+
+/**
+ * @class FrameParser
+ * @brief Cuts the frames out of a byte stream
+ *
+ * The caller reads into Buffer() and reports the bytes with Feed(). Small
+ * frames are collected in one buffer so that a single read yields many of
+ * them, a frame that does not fit is read straight into its message. The
+ * length of a frame comes from the peer, frames announcing more than
+ * `max_message_size` bytes are not accepted.
+ */
+class FrameParser {
+ public:
+  static const std::size_t kDefaultBufferSize = 256 * 1024;
+  static const std::size_t kDefaultMaxMessageSize = 256 * 1024 * 1024;
+
+  explicit FrameParser(const FrameCallback& callback,
+                       std::size_t buffer_size = kDefaultBufferSize,
+                       std::size_t max_message_size = kDefaultMaxMessageSize);
+  virtual ~FrameParser() = default;
+
+  char* Buffer(std::size_t* size);
+
+  /**
+   * @return false if the stream is corrupted and has to be closed
+   */
+  bool Feed(std::size_t size);
+
+ private:
+  void Deliver(const std::shared_ptr<std::string>& msg_str);
+
+  FrameCallback callback_;
+  std::size_t max_message_size_;
+  std::vector<char> buffer_;
+  std::size_t begin_ = 0;
+  std::size_t end_ = 0;
+
+  // frame larger than the buffer
+  FrameHeader header_;
+  std::shared_ptr<std::string> msg_str_;
+  std::size_t filled_ = 0;
+};
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_SOCKET_FRAME_H_
@@ -0,0 +1,55 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/socket/socket_conf.h"
+
+#include "cyber/common/global_data.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+const proto::SocketConf& GetSocketConf() {
+  auto& global_conf = common::GlobalData::Instance()->Config();
+  if (global_conf.has_transport_conf() &&
+      global_conf.transport_conf().has_socket_conf()) {
+    return global_conf.transport_conf().socket_conf();
+  }
+  return proto::SocketConf::default_instance();
+}
+
+bool IsSocketChannel(const std::string& channel_name) {
+  for (auto& channel : GetSocketConf().channel()) {
+    if (channel.channel_name() == channel_name) {
+      return true;
+    }
+  }
+  return false;
+}
+
+proto::SocketProtocol GetSocketProtocol(const std::string& channel_name) {
+  auto& conf = GetSocketConf();
+  for (auto& channel : conf.channel()) {
+    if (channel.channel_name() == channel_name) {
+      return channel.protocol();
+    }
+  }
+  return conf.protocol();
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
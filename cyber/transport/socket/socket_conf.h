@@ -0,0 +1,44 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_SOCKET_SOCKET_CONF_H_
+#define CYBER_TRANSPORT_SOCKET_SOCKET_CONF_H_
+
+#include <string>
+
+#include "cyber/proto/transport_conf.pb.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+/**
+ * @brief socket_conf of transport_conf, the defaults if there is none
+ */
+const proto::SocketConf& GetSocketConf();
+
+/**
+ * @brief Whether `channel_name` is listed to go over SOCKET to other hosts
+ */
+bool IsSocketChannel(const std::string& channel_name);
+
+proto::SocketProtocol GetSocketProtocol(const std::string& channel_name);
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_SOCKET_SOCKET_CONF_H_
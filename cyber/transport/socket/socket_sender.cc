@@ -0,0 +1,408 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/socket/socket_sender.h"
+
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include "cyber/common/log.h"
+#include "cyber/transport/socket/frame.h"
+#include "cyber/transport/socket/socket_conf.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+namespace {
+
+// a peer that refused a connection is not tried again before this
+const std::chrono::milliseconds kReconnectInterval(1000);
+
+}  // namespace
+
+SocketSender::SocketSender(uint64_t channel_id,
+                           proto::SocketProtocol protocol)
+    : channel_id_(channel_id),
+      protocol_(protocol),
+      peer_list_(std::make_shared<PeerList>()) {
+  auto& conf = GetSocketConf();
+  send_timeout_ms_ = static_cast<int>(conf.send_timeout_ms());
+  send_buffer_size_ = static_cast<int>(conf.send_buffer_size());
+}
+
+SocketSender::~SocketSender() {
+  Close();
+  {
+    std::lock_guard<std::mutex> lock(work_mutex_);
+    is_shutdown_ = true;
+  }
+  cv_.notify_one();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+bool SocketSender::AddPeer(uint64_t id, const proto::SocketAddr& addr) {
+  auto peer = std::make_shared<Peer>();
+  memset(&peer->addr, 0, sizeof(peer->addr));
+  peer->addr.sin_family = AF_INET;
+  peer->addr.sin_port = htons(static_cast<uint16_t>(addr.port()));
+  if (addr.port() == 0 ||
+      inet_pton(AF_INET, addr.ip().c_str(), &peer->addr.sin_addr) != 1) {
+    AWARN << "invalid socket address " << addr.ip() << ":" << addr.port();
+    return false;
+  }
+
+  std::string key = addr.ip() + ":" + std::to_string(addr.port());
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto itr = peers_.find(key);
+  if (itr == peers_.end()) {
+    itr = peers_.emplace(key, peer).first;
+    UpdatePeerList();
+  }
+  itr->second->ids.insert(id);
+  return true;
+}
+
+void SocketSender::RemovePeer(uint64_t id) {
+  PeerPtr removed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto itr = peers_.begin(); itr != peers_.end(); ++itr) {
+      if (itr->second->ids.erase(id) == 0) {
+        continue;
+      }
+      if (itr->second->ids.empty()) {
+        removed = itr->second;
+        peers_.erase(itr);
+        UpdatePeerList();
+      }
+      break;
+    }
+  }
+  if (removed != nullptr) {
+    ClosePeer(removed);
+  }
+}
+
+bool SocketSender::HasPeer() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !peers_.empty();
+}
+
+bool SocketSender::Send(const std::string& msg_str,
+                        const MessageInfo& msg_info) {
+  FrameHeader header;
+  FillFrameHeader(channel_id_, msg_str, msg_info, &header);
+  struct iovec iov[2];
+  iov[0].iov_base = &header;
+  iov[0].iov_len = sizeof(header);
+  iov[1].iov_base = const_cast<char*>(msg_str.data());
+  iov[1].iov_len = msg_str.size();
+
+  std::shared_ptr<const PeerList> peer_list;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (peers_.empty()) {
+      return true;
+    }
+    if (protocol_ == proto::SocketProtocol::SOCKET_UDP) {
+      return SendDatagrams(iov, 2);
+    }
+    peer_list = peer_list_;
+  }
+  bool ret = true;
+  for (auto& peer : *peer_list) {
+    ret = SendStream(peer, iov, 2) && ret;
+  }
+  return ret;
+}
+
+void SocketSender::Close() {
+  std::vector<PeerPtr> peers;
+  std::shared_ptr<io::Session> udp_session;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& item : peers_) {
+      peers.emplace_back(item.second);
+    }
+    peers_.clear();
+    UpdatePeerList();
+    udp_session = udp_session_;
+    udp_session_ = nullptr;
+  }
+  for (auto& peer : peers) {
+    ClosePeer(peer);
+  }
+  CloseSession(udp_session);
+}
+
+bool SocketSender::SendStream(const PeerPtr& peer, const struct iovec* iov,
+                              std::size_t iovcnt) {
+  std::lock_guard<std::mutex> lock(peer->mutex);
+  if (peer->closed) {
+    return true;
+  }
+  if (peer->busy) {
+    // keep the order, the frame goes after the ones already waiting
+    return Enqueue(peer, iov, iovcnt, 0);
+  }
+  if (peer->session == nullptr) {
+    if (std::chrono::steady_clock::now() < peer->next_connect) {
+      return false;
+    }
+    return Enqueue(peer, iov, iovcnt, 0);
+  }
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = const_cast<struct iovec*>(iov);
+  msg.msg_iovlen = iovcnt;
+  ssize_t nbytes = peer->session->SendMsg(&msg, MSG_NOSIGNAL, 0);
+  if (nbytes < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+    AWARN << "send to " << inet_ntoa(peer->addr.sin_addr) << ":"
+          << ntohs(peer->addr.sin_port) << " failed, " << strerror(errno);
+    CloseSession(peer->session);
+    peer->session = nullptr;
+    return false;
+  }
+  std::size_t sent = nbytes < 0 ? 0 : static_cast<std::size_t>(nbytes);
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < iovcnt; ++i) {
+    total += iov[i].iov_len;
+  }
+  if (sent == total) {
+    return true;
+  }
+  // part of the frame may be out, the rest has to follow before anything
+  // else is written to the stream
+  return Enqueue(peer, iov, iovcnt, sent);
+}
+
+bool SocketSender::SendDatagrams(struct iovec* iov, std::size_t iovcnt) {
+  if (iov[0].iov_len + iov[1].iov_len > kMaxDatagramSize) {
+    AWARN_EVERY(100) << "message of " << iov[1].iov_len
+                     << " bytes does not fit a datagram, use SOCKET_TCP";
+    return false;
+  }
+  if (udp_session_ == nullptr) {
+    auto session = std::make_shared<io::Session>();
+    if (session->Socket(AF_INET, SOCK_DGRAM, 0) < 0) {
+      AERROR << "create udp socket failed, " << strerror(errno);
+      return false;
+    }
+    setsockopt(session->fd(), SOL_SOCKET, SO_SNDBUF, &send_buffer_size_,
+               sizeof(send_buffer_size_));
+    udp_session_ = session;
+  }
+
+  mmsgs_.resize(peers_.size());
+  memset(mmsgs_.data(), 0, mmsgs_.size() * sizeof(struct mmsghdr));
+  std::size_t i = 0;
+  for (auto& item : peers_) {
+    auto& hdr = mmsgs_[i++].msg_hdr;
+    hdr.msg_name = &item.second->addr;
+    hdr.msg_namelen = sizeof(item.second->addr);
+    hdr.msg_iov = iov;
+    hdr.msg_iovlen = iovcnt;
+  }
+  std::size_t sent = 0;
+  while (sent < mmsgs_.size()) {
+    int nmsgs = udp_session_->SendMmsg(
+        mmsgs_.data() + sent, static_cast<unsigned int>(mmsgs_.size() - sent),
+        MSG_DONTWAIT, 0);
+    if (nmsgs < 0) {
+      AWARN_EVERY(100) << "sendmmsg dropped " << mmsgs_.size() - sent
+                       << " datagrams, " << strerror(errno);
+      return false;
+    }
+    sent += nmsgs;
+  }
+  return true;
+}
+
+bool SocketSender::Enqueue(const PeerPtr& peer, const struct iovec* iov,
+                           std::size_t iovcnt, std::size_t offset) {
+  std::size_t size = 0;
+  for (std::size_t i = 0; i < iovcnt; ++i) {
+    size += iov[i].iov_len;
+  }
+  size -= offset;
+  std::size_t limit = static_cast<std::size_t>(send_buffer_size_);
+  if (!peer->pending.empty() && peer->pending_bytes + size > limit) {
+    AWARN_EVERY(100) << inet_ntoa(peer->addr.sin_addr) << ":"
+                     << ntohs(peer->addr.sin_port)
+                     << " does not keep up, frame dropped";
+    return false;
+  }
+
+  std::string frame;
+  frame.reserve(size);
+  for (std::size_t i = 0; i < iovcnt; ++i) {
+    const char* base = static_cast<const char*>(iov[i].iov_base);
+    std::size_t skip = std::min(offset, iov[i].iov_len);
+    frame.append(base + skip, iov[i].iov_len - skip);
+    offset -= skip;
+  }
+  peer->pending.emplace_back(std::move(frame));
+  peer->pending_bytes += size;
+  if (peer->busy) {
+    return true;
+  }
+
+  peer->busy = true;
+  {
+    std::lock_guard<std::mutex> lock(work_mutex_);
+    if (!thread_.joinable()) {
+      thread_ = std::thread(&SocketSender::ThreadFunc, this);
+    }
+    work_.emplace_back(peer);
+  }
+  cv_.notify_one();
+  return true;
+}
+
+void SocketSender::ClosePeer(const PeerPtr& peer) {
+  std::lock_guard<std::mutex> lock(peer->mutex);
+  peer->closed = true;
+  if (peer->busy) {
+    // the sender thread closes the session when it is done with it
+    return;
+  }
+  CloseSession(peer->session);
+  peer->session = nullptr;
+}
+
+void SocketSender::UpdatePeerList() {
+  auto peer_list = std::make_shared<PeerList>();
+  peer_list->reserve(peers_.size());
+  for (auto& item : peers_) {
+    peer_list->emplace_back(item.second);
+  }
+  peer_list_ = peer_list;
+}
+
+void SocketSender::ThreadFunc() {
+  while (true) {
+    PeerPtr peer;
+    {
+      std::unique_lock<std::mutex> lock(work_mutex_);
+      cv_.wait(lock, [this] { return is_shutdown_ || !work_.empty(); });
+      if (work_.empty()) {
+        return;
+      }
+      peer = work_.front();
+      work_.pop_front();
+    }
+    Flush(peer);
+  }
+}
+
+void SocketSender::Flush(const PeerPtr& peer) {
+  std::unique_lock<std::mutex> lock(peer->mutex);
+  if (!peer->closed && peer->session == nullptr) {
+    lock.unlock();
+    auto session = Connect(peer->addr);
+    lock.lock();
+    if (session == nullptr) {
+      peer->next_connect =
+          std::chrono::steady_clock::now() + kReconnectInterval;
+      DropPending(peer.get());
+    }
+    peer->session = session;
+  }
+
+  while (!peer->closed && !peer->pending.empty()) {
+    std::string frame = std::move(peer->pending.front());
+    peer->pending.pop_front();
+    peer->pending_bytes -= frame.size();
+    auto session = peer->session;
+    lock.unlock();
+    bool ok = SendAll(session, frame);
+    lock.lock();
+    if (!ok) {
+      AWARN << "send to " << inet_ntoa(peer->addr.sin_addr) << ":"
+            << ntohs(peer->addr.sin_port) << " failed, " << strerror(errno);
+      CloseSession(peer->session);
+      peer->session = nullptr;
+      DropPending(peer.get());
+    }
+  }
+
+  if (peer->closed) {
+    CloseSession(peer->session);
+    peer->session = nullptr;
+    DropPending(peer.get());
+  }
+  peer->busy = false;
+}
+
+std::shared_ptr<io::Session> SocketSender::Connect(
+    const struct sockaddr_in& addr) {
+  auto session = std::make_shared<io::Session>();
+  if (session->Socket(AF_INET, SOCK_STREAM, 0) < 0) {
+    AERROR << "create tcp socket failed, " << strerror(errno);
+    return nullptr;
+  }
+  int one = 1;
+  setsockopt(session->fd(), IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  setsockopt(session->fd(), SOL_SOCKET, SO_SNDBUF, &send_buffer_size_,
+             sizeof(send_buffer_size_));
+  if (session->Connect(reinterpret_cast<const struct sockaddr*>(&addr),
+                       sizeof(addr), send_timeout_ms_) < 0) {
+    AWARN << "connect to " << inet_ntoa(addr.sin_addr) << ":"
+          << ntohs(addr.sin_port) << " failed, " << strerror(errno);
+    session->Close();
+    return nullptr;
+  }
+  return session;
+}
+
+bool SocketSender::SendAll(const std::shared_ptr<io::Session>& session,
+                           const std::string& frame) {
+  std::size_t sent = 0;
+  while (sent < frame.size()) {
+    ssize_t nbytes = session->Send(frame.data() + sent, frame.size() - sent,
+                                   MSG_NOSIGNAL, send_timeout_ms_);
+    if (nbytes < 0) {
+      return false;
+    }
+    sent += static_cast<std::size_t>(nbytes);
+  }
+  return true;
+}
+
+void SocketSender::DropPending(Peer* peer) {
+  peer->pending.clear();
+  peer->pending_bytes = 0;
+}
+
+void SocketSender::CloseSession(const std::shared_ptr<io::Session>& session) {
+  if (session != nullptr && session->fd() != -1) {
+    session->Close();
+  }
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
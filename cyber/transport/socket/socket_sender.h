@@ -0,0 +1,140 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_SOCKET_SOCKET_SENDER_H_
+#define CYBER_TRANSPORT_SOCKET_SOCKET_SENDER_H_
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "cyber/io/session.h"
+#include "cyber/proto/role_attributes.pb.h"
+#include "cyber/proto/transport_conf.pb.h"
+#include "cyber/transport/message/message_info.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+/**
+ * @class SocketSender
+ * @brief Sends the messages of one channel to the readers of other hosts
+ *
+ * Header and message leave with one scatter-gather call, no copy of the
+ * message is made. Over TCP every reader process gets its own connection.
+ * Send() never waits: it only writes what the socket takes right away.
+ * Connecting and the rest of a frame the socket did not take are left to a
+ * sender thread, later frames of that peer queue behind them, up to
+ * `send_buffer_size` bytes. Over UDP one datagram per reader process is
+ * sent, all of them with a single sendmmsg, datagrams the socket does not
+ * take are dropped.
+ */
+class SocketSender {
+ public:
+  SocketSender(uint64_t channel_id, proto::SocketProtocol protocol);
+  virtual ~SocketSender();
+
+  /**
+   * @param id reader role, readers of one process share `addr`
+   */
+  bool AddPeer(uint64_t id, const proto::SocketAddr& addr);
+  void RemovePeer(uint64_t id);
+  bool HasPeer() const;
+
+  /**
+   * @return false if the message was dropped for at least one peer
+   */
+  bool Send(const std::string& msg_str, const MessageInfo& msg_info);
+
+  /**
+   * @brief Drop all peers and their connections
+   */
+  void Close();
+
+ private:
+  struct Peer {
+    struct sockaddr_in addr;
+    // guarded by SocketSender::mutex_
+    std::set<uint64_t> ids;
+
+    // held only around calls that do not block
+    std::mutex mutex;
+    std::shared_ptr<io::Session> session;
+    // frames waiting for the sender thread
+    std::deque<std::string> pending;
+    std::size_t pending_bytes = 0;
+    // the sender thread owns the session while set
+    bool busy = false;
+    bool closed = false;
+    std::chrono::steady_clock::time_point next_connect;
+  };
+  using PeerPtr = std::shared_ptr<Peer>;
+  using PeerList = std::vector<PeerPtr>;
+
+  bool SendStream(const PeerPtr& peer, const struct iovec* iov,
+                  std::size_t iovcnt);
+  bool SendDatagrams(struct iovec* iov, std::size_t iovcnt);
+  bool Enqueue(const PeerPtr& peer, const struct iovec* iov,
+               std::size_t iovcnt, std::size_t offset);
+  void ClosePeer(const PeerPtr& peer);
+  void UpdatePeerList();
+
+  void ThreadFunc();
+  void Flush(const PeerPtr& peer);
+  std::shared_ptr<io::Session> Connect(const struct sockaddr_in& addr);
+  bool SendAll(const std::shared_ptr<io::Session>& session,
+               const std::string& frame);
+  static void DropPending(Peer* peer);
+  static void CloseSession(const std::shared_ptr<io::Session>& session);
+
+  uint64_t channel_id_;
+  proto::SocketProtocol protocol_;
+  int send_timeout_ms_;
+  int send_buffer_size_;
+
+  // key: ip:port of the reader process
+  std::unordered_map<std::string, PeerPtr> peers_;
+  // copy of the peers for Send(), replaced whenever peers_ changes
+  std::shared_ptr<const PeerList> peer_list_;
+  std::shared_ptr<io::Session> udp_session_;
+  std::vector<struct mmsghdr> mmsgs_;
+  mutable std::mutex mutex_;
+
+  // peers the sender thread has to connect or flush
+  std::deque<PeerPtr> work_;
+  bool is_shutdown_ = false;
+  std::mutex work_mutex_;
+  std::condition_variable cv_;
+  std::thread thread_;
+};
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_SOCKET_SOCKET_SENDER_H_
@@ -0,0 +1,306 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/transport/socket/frame.h"
+#include "cyber/transport/socket/socket_sender.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+namespace {
+
+struct Received {
+  uint64_t channel_id = 0;
+  std::string msg;
+  MessageInfo info;
+};
+
+FrameCallback Collect(std::vector<Received>* received) {
+  return [received](uint64_t channel_id,
+                    const std::shared_ptr<std::string>& msg_str,
+                    const MessageInfo& msg_info) {
+    Received r;
+    r.channel_id = channel_id;
+    r.msg = *msg_str;
+    r.info = msg_info;
+    received->emplace_back(std::move(r));
+  };
+}
+
+std::string Frame(uint64_t channel_id, const std::string& msg,
+                  const MessageInfo& info) {
+  FrameHeader header;
+  FillFrameHeader(channel_id, msg, info, &header);
+  std::string frame(reinterpret_cast<const char*>(&header), sizeof(header));
+  return frame + msg;
+}
+
+// bound to an ephemeral loopback port
+int ListenSocket(int type, proto::SocketAddr* addr) {
+  int fd = socket(AF_INET, type, 0);
+  struct sockaddr_in sin;
+  std::memset(&sin, 0, sizeof(sin));
+  sin.sin_family = AF_INET;
+  sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  sin.sin_port = 0;
+  if (bind(fd, reinterpret_cast<struct sockaddr*>(&sin), sizeof(sin)) != 0) {
+    close(fd);
+    return -1;
+  }
+  socklen_t len = sizeof(sin);
+  getsockname(fd, reinterpret_cast<struct sockaddr*>(&sin), &len);
+  addr->set_ip("127.0.0.1");
+  addr->set_port(ntohs(sin.sin_port));
+  if (type == SOCK_STREAM) {
+    listen(fd, 4);
+  }
+  return fd;
+}
+
+}  // namespace
+
+TEST(FrameTest, stream) {
+  std::vector<Received> received;
+  // a small buffer so that the large message bypasses it
+  FrameParser parser(Collect(&received), 256);
+
+  MessageInfo info(Identity(), 7);
+  std::string stream = Frame(1, "small", info);
+  stream += Frame(2, std::string(4096, 'x'), info);
+  stream += Frame(3, "", info);
+
+  // odd sized pieces cut through headers and messages alike
+  std::size_t pos = 0;
+  while (pos < stream.size()) {
+    std::size_t size = 0;
+    char* buffer = parser.Buffer(&size);
+    ASSERT_GT(size, 0);
+    size = std::min<std::size_t>({size, 37, stream.size() - pos});
+    std::memcpy(buffer, stream.data() + pos, size);
+    ASSERT_TRUE(parser.Feed(size));
+    pos += size;
+  }
+
+  ASSERT_EQ(3, received.size());
+  EXPECT_EQ(1, received[0].channel_id);
+  EXPECT_EQ("small", received[0].msg);
+  EXPECT_EQ(2, received[1].channel_id);
+  EXPECT_EQ(std::string(4096, 'x'), received[1].msg);
+  EXPECT_EQ(3, received[2].channel_id);
+  EXPECT_TRUE(received[2].msg.empty());
+  EXPECT_EQ(info.sender_id(), received[2].info.sender_id());
+  EXPECT_EQ(7, received[2].info.seq_num());
+
+  std::size_t size = 0;
+  char* buffer = parser.Buffer(&size);
+  std::memset(buffer, 0xab, size);
+  EXPECT_FALSE(parser.Feed(size));
+}
+
+TEST(FrameTest, max_message_size) {
+  std::vector<Received> received;
+  FrameParser parser(Collect(&received), 256, 1024);
+  MessageInfo info(Identity(), 1);
+  std::string stream = Frame(1, std::string(1024, 'x'), info);
+  // a peer must not make the parser allocate whatever it announces
+  FrameHeader header;
+  FillFrameHeader(2, std::string(1025, 'y'), info, &header);
+  stream.append(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  std::size_t pos = 0;
+  bool ok = true;
+  while (ok && pos < stream.size()) {
+    std::size_t size = 0;
+    char* buffer = parser.Buffer(&size);
+    size = std::min(size, stream.size() - pos);
+    std::memcpy(buffer, stream.data() + pos, size);
+    ok = parser.Feed(size);
+    pos += size;
+  }
+  EXPECT_FALSE(ok);
+  ASSERT_EQ(1, received.size());
+  EXPECT_EQ(1024, received[0].msg.size());
+}
+
+TEST(FrameTest, datagram) {
+  std::vector<Received> received;
+  MessageInfo info(Identity(), 9);
+  auto frame = Frame(5, "datagram", info);
+  EXPECT_TRUE(ParseDatagram(frame.data(), frame.size(), Collect(&received)));
+  ASSERT_EQ(1, received.size());
+  EXPECT_EQ(5, received[0].channel_id);
+  EXPECT_EQ("datagram", received[0].msg);
+  EXPECT_EQ(9, received[0].info.seq_num());
+
+  // truncated
+  EXPECT_FALSE(
+      ParseDatagram(frame.data(), frame.size() - 1, Collect(&received)));
+  EXPECT_FALSE(
+      ParseDatagram(frame.data(), sizeof(FrameHeader) - 1, Collect(&received)));
+  EXPECT_EQ(1, received.size());
+}
+
+TEST(SocketSenderTest, tcp) {
+  proto::SocketAddr addr;
+  int listen_fd = ListenSocket(SOCK_STREAM, &addr);
+  ASSERT_NE(-1, listen_fd);
+
+  const int kNum = 100;
+  std::vector<Received> received;
+  std::thread server([&]() {
+    int fd = accept(listen_fd, nullptr, nullptr);
+    FrameParser parser(Collect(&received));
+    while (received.size() < kNum) {
+      std::size_t size = 0;
+      char* buffer = parser.Buffer(&size);
+      auto res = read(fd, buffer, size);
+      if (res <= 0 || !parser.Feed(res)) {
+        break;
+      }
+    }
+    close(fd);
+  });
+
+  SocketSender sender(11, proto::SOCKET_TCP);
+  EXPECT_FALSE(sender.HasPeer());
+  EXPECT_TRUE(sender.AddPeer(1, addr));
+  // a second reader of the same process shares the connection
+  EXPECT_TRUE(sender.AddPeer(2, addr));
+  EXPECT_TRUE(sender.HasPeer());
+
+  Identity sender_id;
+  for (int i = 0; i < kNum; ++i) {
+    // every tenth message does not fit into the receive buffer
+    std::string msg(i % 10 == 0 ? 512 * 1024 : 100, static_cast<char>(i));
+    EXPECT_TRUE(sender.Send(msg, MessageInfo(sender_id, i)));
+  }
+  server.join();
+  close(listen_fd);
+
+  ASSERT_EQ(kNum, received.size());
+  for (int i = 0; i < kNum; ++i) {
+    EXPECT_EQ(11, received[i].channel_id);
+    EXPECT_EQ(i, received[i].info.seq_num());
+    EXPECT_EQ(sender_id, received[i].info.sender_id());
+    EXPECT_EQ(i % 10 == 0 ? 512 * 1024 : 100, received[i].msg.size());
+  }
+
+  sender.RemovePeer(1);
+  EXPECT_TRUE(sender.HasPeer());
+  sender.RemovePeer(2);
+  EXPECT_FALSE(sender.HasPeer());
+  // nothing to do without readers
+  EXPECT_TRUE(sender.Send("nobody", MessageInfo(sender_id, 0)));
+}
+
+TEST(SocketSenderTest, slow_peer) {
+  proto::SocketAddr addr;
+  // the connection is accepted by the kernel but never read
+  int listen_fd = ListenSocket(SOCK_STREAM, &addr);
+  ASSERT_NE(-1, listen_fd);
+
+  SocketSender sender(13, proto::SOCKET_TCP);
+  EXPECT_TRUE(sender.AddPeer(1, addr));
+  Identity sender_id;
+  std::string msg(1024 * 1024, 'x');
+  int dropped = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 64; ++i) {
+    if (!sender.Send(msg, MessageInfo(sender_id, i))) {
+      ++dropped;
+    }
+  }
+  // the writer neither waits for the connection nor for the reader
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(500));
+  EXPECT_GT(dropped, 0);
+
+  sender.RemovePeer(1);
+  EXPECT_FALSE(sender.HasPeer());
+  close(listen_fd);
+}
+
+TEST(SocketSenderTest, unreachable_peer) {
+  proto::SocketAddr addr;
+  int listen_fd = ListenSocket(SOCK_STREAM, &addr);
+  ASSERT_NE(-1, listen_fd);
+  close(listen_fd);
+
+  SocketSender sender(14, proto::SOCKET_TCP);
+  EXPECT_TRUE(sender.AddPeer(1, addr));
+  Identity sender_id;
+  // the first message waits for the connection, which is refused
+  EXPECT_TRUE(sender.Send("first", MessageInfo(sender_id, 0)));
+  bool dropped = false;
+  for (int i = 0; i < 100 && !dropped; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    dropped = !sender.Send("retry", MessageInfo(sender_id, 1));
+  }
+  // and the peer is left alone for a while
+  EXPECT_TRUE(dropped);
+}
+
+TEST(SocketSenderTest, udp) {
+  proto::SocketAddr addr1;
+  proto::SocketAddr addr2;
+  int fd1 = ListenSocket(SOCK_DGRAM, &addr1);
+  int fd2 = ListenSocket(SOCK_DGRAM, &addr2);
+  ASSERT_NE(-1, fd1);
+  ASSERT_NE(-1, fd2);
+
+  SocketSender sender(12, proto::SOCKET_UDP);
+  EXPECT_TRUE(sender.AddPeer(1, addr1));
+  EXPECT_TRUE(sender.AddPeer(2, addr2));
+
+  Identity sender_id;
+  EXPECT_TRUE(sender.Send("fan out", MessageInfo(sender_id, 3)));
+  // a frame has to fit into one datagram
+  EXPECT_FALSE(sender.Send(std::string(kMaxDatagramSize, 'x'),
+                           MessageInfo(sender_id, 4)));
+
+  for (int fd : {fd1, fd2}) {
+    std::vector<char> buffer(kMaxDatagramSize);
+    auto res = recv(fd, buffer.data(), buffer.size(), 0);
+    ASSERT_GT(res, 0);
+    std::vector<Received> received;
+    EXPECT_TRUE(ParseDatagram(buffer.data(), res, Collect(&received)));
+    ASSERT_EQ(1, received.size());
+    EXPECT_EQ(12, received[0].channel_id);
+    EXPECT_EQ("fan out", received[0].msg);
+    EXPECT_EQ(3, received[0].info.seq_num());
+    close(fd);
+  }
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -33,9 +33,11 @@
 #include "cyber/task/task.h"
 #include "cyber/transport/message/history.h"
 #include "cyber/transport/rtps/participant.h"
+#include "cyber/transport/socket/socket_conf.h"
 #include "cyber/transport/transmitter/intra_transmitter.h"
 #include "cyber/transport/transmitter/rtps_transmitter.h"
 #include "cyber/transport/transmitter/shm_transmitter.h"
+#include "cyber/transport/transmitter/socket_transmitter.h"
 #include "cyber/transport/transmitter/transmitter.h"
 
 namespace apollo {
@@ -141,7 +143,7 @@ void HybridTransmitter<M>::Enable(const RoleAttributes& opposite_attr) {
   uint64_t id = opposite_attr.id();
   std::lock_guard<std::mutex> lock(mutex_);
   receivers_[mapping_table_[relation]].insert(id);
-  transmitters_[mapping_table_[relation]]->Enable();
+  transmitters_[mapping_table_[relation]]->Enable(opposite_attr);
   TransmitHistoryMsg(opposite_attr);
 }
 
@@ -154,9 +156,13 @@ void HybridTransmitter<M>::Disable(const RoleAttributes& opposite_attr) {
 
   uint64_t id = opposite_attr.id();
   std::lock_guard<std::mutex> lock(mutex_);
-  receivers_[mapping_table_[relation]].erase(id);
-  if (receivers_[mapping_table_[relation]].empty()) {
-    transmitters_[mapping_table_[relation]]->Disable();
+  auto mode = mapping_table_[relation];
+  receivers_[mode].erase(id);
+  if (mode == OptionalMode::SOCKET) {
+    // every reader is a destination of its own
+    transmitters_[mode]->Disable(opposite_attr);
+  } else if (receivers_[mode].empty()) {
+    transmitters_[mode]->Disable();
   }
 }
 
@@ -185,10 +191,12 @@ void HybridTransmitter<M>::ObtainConfig() {
   if (!global_conf.has_transport_conf()) {
     return;
   }
-  if (!global_conf.transport_conf().has_communication_mode()) {
-    return;
+  if (global_conf.transport_conf().has_communication_mode()) {
+    mode_->CopyFrom(global_conf.transport_conf().communication_mode());
+  }
+  if (IsSocketChannel(this->attr_.channel_name())) {
+    mode_->set_diff_host(OptionalMode::SOCKET);
   }
-  mode_->CopyFrom(global_conf.transport_conf().communication_mode());
 
   mapping_table_[SAME_PROC] = mode_->same_proc();
   mapping_table_[DIFF_PROC] = mode_->diff_proc();
@@ -221,6 +229,10 @@ void HybridTransmitter<M>::InitTransmitters() {
       case OptionalMode::SHM:
         transmitters_[mode] = std::make_shared<ShmTransmitter<M>>(this->attr_);
         break;
+      case OptionalMode::SOCKET:
+        transmitters_[mode] =
+            std::make_shared<SocketTransmitter<M>>(this->attr_);
+        break;
       default:
         transmitters_[mode] =
             std::make_shared<RtpsTransmitter<M>>(this->attr_, participant_);
@@ -23,6 +23,7 @@
 #include "cyber/common/log.h"
 #include "cyber/message/message_traits.h"
 #include "cyber/transport/rtps/attributes_filler.h"
+#include "cyber/transport/rtps/batch_writer.h"
 #include "cyber/transport/rtps/participant.h"
 #include "cyber/transport/transmitter/transmitter.h"
 #include "fastrtps/Domain.h"
@@ -50,9 +51,11 @@ class RtpsTransmitter : public Transmitter<M> {
 
  private:
   bool Transmit(const M& msg, const MessageInfo& msg_info);
+  bool Write(UnderlayMessage* m, const MessageInfo& msg_info);
 
   ParticipantPtr participant_;
   eprosima::fastrtps::Publisher* publisher_;
+  std::unique_ptr<BatchWriter> batch_writer_;
 };
 
 template <typename M>
@@ -79,12 +82,25 @@ void RtpsTransmitter<M>::Enable() {
   publisher_ = eprosima::fastrtps::Domain::createPublisher(
       participant_->fastrtps_participant(), pub_attr);
   RETURN_IF_NULL(publisher_);
+
+  auto& qos = this->attr_.qos_profile();
+  if (qos.batch_latency_us() > 0) {
+    batch_writer_.reset(new BatchWriter(
+        qos.batch_latency_us(), qos.batch_max_bytes(),
+        std::bind(&RtpsTransmitter<M>::Write, this, std::placeholders::_1,
+                  std::placeholders::_2)));
+  }
   this->enabled_ = true;
 }
 
 template <typename M>
 void RtpsTransmitter<M>::Disable() {
   if (this->enabled_) {
+    // pending batch goes out while the publisher is still there
+    if (batch_writer_ != nullptr) {
+      batch_writer_->Shutdown();
+      batch_writer_ = nullptr;
+    }
     publisher_ = nullptr;
     this->enabled_ = false;
   }
@@ -103,9 +119,20 @@ bool RtpsTransmitter<M>::Transmit(const M& msg, const MessageInfo& msg_info) {
     return false;
   }
 
+  if (batch_writer_ != nullptr) {
+    std::string msg_str;
+    RETURN_VAL_IF(!message::SerializeToString(msg, &msg_str), false);
+    return batch_writer_->Write(msg_str, msg_info);
+  }
+
   UnderlayMessage m;
   RETURN_VAL_IF(!message::SerializeToString(msg, &m.data()), false);
+  return Write(&m, msg_info);
+}
 
+template <typename M>
+bool RtpsTransmitter<M>::Write(UnderlayMessage* m,
+                               const MessageInfo& msg_info) {
   eprosima::fastrtps::rtps::WriteParams wparams;
 
   char* ptr =
@@ -122,7 +149,7 @@ bool RtpsTransmitter<M>::Transmit(const M& msg, const MessageInfo& msg_info) {
   if (participant_->is_shutdown()) {
     return false;
   }
-  return publisher_->write(reinterpret_cast<void*>(&m), wparams);
+  return publisher_->write(reinterpret_cast<void*>(m), wparams);
 }
 
 }  // namespace transport
@@ -0,0 +1,118 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_TRANSMITTER_SOCKET_TRANSMITTER_H_
+#define CYBER_TRANSPORT_TRANSMITTER_SOCKET_TRANSMITTER_H_
+
+#include <memory>
+#include <string>
+
+#include "cyber/common/log.h"
+#include "cyber/message/message_traits.h"
+#include "cyber/transport/socket/socket_conf.h"
+#include "cyber/transport/socket/socket_sender.h"
+#include "cyber/transport/transmitter/transmitter.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+/**
+ * @class SocketTransmitter
+ * @brief Sends to readers of other hosts over plain TCP or UDP, the
+ * readers are known from the `socket_addr` of their attributes
+ */
+template <typename M>
+class SocketTransmitter : public Transmitter<M> {
+ public:
+  using MessagePtr = std::shared_ptr<M>;
+
+  explicit SocketTransmitter(const RoleAttributes& attr);
+  virtual ~SocketTransmitter();
+
+  void Enable() override;
+  void Disable() override;
+
+  void Enable(const RoleAttributes& opposite_attr) override;
+  void Disable(const RoleAttributes& opposite_attr) override;
+
+  bool Transmit(const MessagePtr& msg, const MessageInfo& msg_info) override;
+
+ private:
+  SocketSender sender_;
+};
+
+template <typename M>
+SocketTransmitter<M>::SocketTransmitter(const RoleAttributes& attr)
+    : Transmitter<M>(attr),
+      sender_(attr.channel_id(), GetSocketProtocol(attr.channel_name())) {}
+
+template <typename M>
+SocketTransmitter<M>::~SocketTransmitter() {
+  Disable();
+}
+
+template <typename M>
+void SocketTransmitter<M>::Enable() {
+  this->enabled_ = true;
+}
+
+template <typename M>
+void SocketTransmitter<M>::Disable() {
+  if (this->enabled_) {
+    sender_.Close();
+    this->enabled_ = false;
+  }
+}
+
+template <typename M>
+void SocketTransmitter<M>::Enable(const RoleAttributes& opposite_attr) {
+  if (!opposite_attr.has_socket_addr()) {
+    AWARN << "reader of channel " << opposite_attr.channel_name()
+          << " has no socket address.";
+    return;
+  }
+  if (sender_.AddPeer(opposite_attr.id(), opposite_attr.socket_addr())) {
+    this->enabled_ = true;
+  }
+}
+
+template <typename M>
+void SocketTransmitter<M>::Disable(const RoleAttributes& opposite_attr) {
+  sender_.RemovePeer(opposite_attr.id());
+}
+
+template <typename M>
+bool SocketTransmitter<M>::Transmit(const MessagePtr& msg,
+                                    const MessageInfo& msg_info) {
+  if (!this->enabled_) {
+    ADEBUG << "not enable.";
+    return false;
+  }
+  if (!sender_.HasPeer()) {
+    return true;
+  }
+
+  std::string msg_str;
+  RETURN_VAL_IF(!message::SerializeToString(*msg, &msg_str), false);
+  return sender_.Send(msg_str, msg_info);
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_TRANSMITTER_SOCKET_TRANSMITTER_H_
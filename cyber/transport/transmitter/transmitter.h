@@ -22,6 +22,8 @@
 #include <string>
 
 #include "cyber/event/perf_event_cache.h"
+#include "cyber/message/message_traits.h"
+#include "cyber/transport/common/channel_stats.h"
 #include "cyber/transport/common/endpoint.h"
 #include "cyber/transport/message/message_info.h"
 
@@ -56,6 +58,7 @@ class Transmitter : public Endpoint {
  protected:
   uint64_t seq_num_;
   MessageInfo msg_info_;
+  ChannelStats::Slot* stats_slot_ = nullptr;
 };
 
 template <typename M>
@@ -63,17 +66,29 @@ Transmitter<M>::Transmitter(const RoleAttributes& attr)
     : Endpoint(attr), seq_num_(0) {
   msg_info_.set_sender_id(this->id_);
   msg_info_.set_seq_num(this->seq_num_);
+  auto stats = ChannelStats::Instance();
+  if (stats != nullptr) {
+    stats_slot_ = stats->GetSlot(attr.channel_id(), attr.channel_name());
+  }
 }
 
 template <typename M>
-Transmitter<M>::~Transmitter() {}
+Transmitter<M>::~Transmitter() {
+  if (stats_slot_ != nullptr) {
+    ChannelStats::Instance()->ReleaseSlot(stats_slot_);
+  }
+}
 
 template <typename M>
 bool Transmitter<M>::Transmit(const MessagePtr& msg) {
   msg_info_.set_seq_num(NextSeqNum());
   PerfEventCache::Instance()->AddTransportEvent(
       TransPerf::TRANSMIT_BEGIN, attr_.channel_id(), msg_info_.seq_num());
-  return Transmit(msg, msg_info_);
+  bool ret = Transmit(msg, msg_info_);
+  // serialized by now unless the message stayed in this process
+  ChannelStats::OnTransmit(stats_slot_, msg_info_.seq_num(),
+                           message::CachedByteSize(*msg));
+  return ret;
 }
 
 template <typename M>
@@ -27,18 +27,21 @@
 #include "cyber/transport/dispatcher/intra_dispatcher.h"
 #include "cyber/transport/dispatcher/rtps_dispatcher.h"
 #include "cyber/transport/dispatcher/shm_dispatcher.h"
+#include "cyber/transport/dispatcher/socket_dispatcher.h"
 #include "cyber/transport/qos/qos_profile_conf.h"
 #include "cyber/transport/receiver/hybrid_receiver.h"
 #include "cyber/transport/receiver/intra_receiver.h"
 #include "cyber/transport/receiver/receiver.h"
 #include "cyber/transport/receiver/rtps_receiver.h"
 #include "cyber/transport/receiver/shm_receiver.h"
+#include "cyber/transport/receiver/socket_receiver.h"
 #include "cyber/transport/rtps/participant.h"
 #include "cyber/transport/shm/notifier_factory.h"
 #include "cyber/transport/transmitter/hybrid_transmitter.h"
 #include "cyber/transport/transmitter/intra_transmitter.h"
 #include "cyber/transport/transmitter/rtps_transmitter.h"
 #include "cyber/transport/transmitter/shm_transmitter.h"
+#include "cyber/transport/transmitter/socket_transmitter.h"
 #include "cyber/transport/transmitter/transmitter.h"
 
 namespace apollo {
@@ -75,6 +78,7 @@ class Transport {
   IntraDispatcherPtr intra_dispatcher_ = nullptr;
   ShmDispatcherPtr shm_dispatcher_ = nullptr;
   RtpsDispatcherPtr rtps_dispatcher_ = nullptr;
+  SocketDispatcherPtr socket_dispatcher_ = nullptr;
 
   DECLARE_SINGLETON(Transport)
 };
@@ -109,6 +113,10 @@ auto Transport::CreateTransmitter(const RoleAttributes& attr,
           std::make_shared<RtpsTransmitter<M>>(modified_attr, participant());
       break;
 
+    case OptionalMode::SOCKET:
+      transmitter = std::make_shared<SocketTransmitter<M>>(modified_attr);
+      break;
+
     default:
       transmitter =
           std::make_shared<HybridTransmitter<M>>(modified_attr, participant());
@@ -153,6 +161,11 @@ auto Transport::CreateReceiver(
       receiver = std::make_shared<RtpsReceiver<M>>(modified_attr, msg_listener);
       break;
 
+    case OptionalMode::SOCKET:
+      receiver =
+          std::make_shared<SocketReceiver<M>>(modified_attr, msg_listener);
+      break;
+
     default:
       receiver = std::make_shared<HybridReceiver<M>>(
           modified_attr, msg_listener, participant());